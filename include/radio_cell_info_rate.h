@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+#ifndef RADIO_CELL_INFO_RATE_H
+#define RADIO_CELL_INFO_RATE_H
+
+/* This API exists since 1.6.7 */
+
+#include <radio_types.h>
+
+/*
+ * RadioCellInfoRate manages setCellInfoListRate on behalf of several
+ * subscribers. Each subscriber asks for the longest interval between
+ * cellInfoList indications it can live with (zero meaning every change)
+ * and the modem gets the shortest of them.
+ *
+ * When nobody is subscribed, cell info indications get disabled after
+ * the idle timeout. The timeout avoids toggling the rate back and forth
+ * when subscribers come and go. It's also applied when there are no
+ * subscribers from the start, to undo whatever rate somebody may have
+ * set before.
+ *
+ * The rate is re-programmed after the client (re)connects. Works with
+ * any version of IRadio, and with AIDL IRadioNetwork.
+ */
+
+G_BEGIN_DECLS
+
+#define RADIO_CELL_INFO_RATE_DEFAULT_IDLE_TIMEOUT_MS (10000)
+
+RadioCellInfoRate*
+radio_cell_info_rate_new(
+    RadioClient* client)
+    G_GNUC_WARN_UNUSED_RESULT;
+
+RadioCellInfoRate*
+radio_cell_info_rate_ref(
+    RadioCellInfoRate* rate);
+
+void
+radio_cell_info_rate_unref(
+    RadioCellInfoRate* rate);
+
+void
+radio_cell_info_rate_set_idle_timeout(
+    RadioCellInfoRate* rate,
+    guint ms);
+
+/* Returns zero if the client doesn't support cell info */
+guint
+radio_cell_info_rate_add(
+    RadioCellInfoRate* rate,
+    guint max_interval_ms);
+
+void
+radio_cell_info_rate_remove(
+    RadioCellInfoRate* rate,
+    guint id);
+
+G_END_DECLS
+
+#endif /* RADIO_CELL_INFO_RATE_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -111,6 +111,24 @@ radio_client_set_default_timeout(
     RadioClient* client,
     int milliseconds);
 
+/*
+ * In power save, requests marked with radio_request_set_background()
+ * are held in the queue and submitted together when the batch window
+ * expires, a regular request is submitted or power save is turned off.
+ * While at least one client of the instance is in power save, the
+ * modem is told about it with sendDeviceState and the indication filter
+ * is reduced to the essential indications (if the interface has those).
+ */
+void
+radio_client_set_power_save(
+    RadioClient* client,
+    gboolean power_save); /* Since 1.6.7 */
+
+void
+radio_client_set_batch_window(
+    RadioClient* client,
+    guint milliseconds); /* Since 1.6.7, zero for the default (10 s) */
+
 gulong
 radio_client_add_indication_handler(
     RadioClient* client,
@@ -90,6 +90,18 @@ radio_config_new_with_version_and_interface_type(
     RADIO_INTERFACE_TYPE interface_type)
     G_GNUC_WARN_UNUSED_RESULT; /* Since 1.6.0 */
 
+gulong
+radio_config_new_async(
+    RADIO_CONFIG_INTERFACE max_version,
+    RADIO_INTERFACE_TYPE interface_type,
+    RadioConfigFunc func,
+    GDestroyNotify destroy,
+    gpointer user_data); /* Since 1.6.7 */
+
+void
+radio_config_cancel_new(
+    gulong id); /* Since 1.6.7 */
+
 RadioConfig*
 radio_config_ref(
     RadioConfig* config);
@@ -130,6 +142,21 @@ radio_config_ind_name(
     RadioConfig* config,
     RADIO_CONFIG_IND ind);
 
+RADIO_CONFIG_REQ
+radio_config_req_from_name(
+    RadioConfig* config,
+    const char* name); /* Since 1.6.7 */
+
+RADIO_CONFIG_RESP
+radio_config_resp_from_name(
+    RadioConfig* config,
+    const char* name); /* Since 1.6.7 */
+
+RADIO_CONFIG_IND
+radio_config_ind_from_name(
+    RadioConfig* config,
+    const char* name); /* Since 1.6.7 */
+
 gulong
 radio_config_add_death_handler(
     RadioConfig* config,
@@ -195,6 +222,25 @@ radio_config_remove_handlers(
 #define radio_config_remove_all_handlers(config,ids) \
     radio_config_remove_handlers(config, ids, G_N_ELEMENTS(ids))
 
+/* See radio_recorder.h */
+void
+radio_config_set_recorder(
+    RadioConfig* config,
+    RadioRecorder* recorder); /* Since 1.6.7 */
+
+/* See radio_instance_set_ind_meter() */
+void
+radio_config_set_ind_meter(
+    RadioConfig* config,
+    guint half_life_ms); /* Since 1.6.7 */
+
+RadioIndRate*
+radio_config_get_ind_rates(
+    RadioConfig* config,
+    RADIO_IND_RATE_ORDER order,
+    guint max,
+    guint* count); /* Since 1.6.7 */
+
 G_END_DECLS
 
 #endif /* RADIO_CONFIG_H */
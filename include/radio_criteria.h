@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef RADIO_CRITERIA_H
+#define RADIO_CRITERIA_H
+
+/* This API exists since 1.6.7 */
+
+#include <radio_types.h>
+
+/*
+ * RadioCriteria programs signal strength and link capacity reporting
+ * criteria on behalf of several subscribers. Each subscriber asks for
+ * the smallest change worth reporting (step) and the minimum time
+ * between the reports (hysteresis), per access network and (for the
+ * signal strength) measurement. The modem gets the coarsest criteria
+ * satisfying all of them, i.e. the smallest step and hysteresis. When
+ * the last subscriber goes away, the criteria are reset to the default.
+ *
+ * The signal strength is reported when it crosses one of the thresholds
+ * placed at the multiples of the step across the measurement range.
+ * The link capacity has no thresholds, it's reported when it changes by
+ * the step.
+ *
+ * The modem keeps separate criteria for each access network and applies
+ * the ones matching the current one, so the criteria for every access
+ * network with subscribers are programmed right away. Everything gets
+ * re-programmed after the client (re)connects.
+ *
+ * Requires IRadio 1.2 or newer, or AIDL IRadioNetwork. Measurements
+ * other than the basic one for each access network (RSSI for GERAN and
+ * CDMA2000, RSCP for UTRAN and RSRP for EUTRAN) and NGRAN require
+ * IRadio 1.5 or IRadioNetwork.
+ */
+
+G_BEGIN_DECLS
+
+RadioCriteria*
+radio_criteria_new(
+    RadioClient* client)
+    G_GNUC_WARN_UNUSED_RESULT;
+
+RadioCriteria*
+radio_criteria_ref(
+    RadioCriteria* criteria);
+
+void
+radio_criteria_unref(
+    RadioCriteria* criteria);
+
+/* These return zero if the combination of arguments isn't supported */
+guint
+radio_criteria_add_signal(
+    RadioCriteria* criteria,
+    RADIO_ACCESS_NETWORK ran,
+    RADIO_SIGNAL_MEASUREMENT measurement,
+    guint step_db,
+    guint hysteresis_ms);
+
+guint
+radio_criteria_add_link_capacity(
+    RadioCriteria* criteria,
+    RADIO_ACCESS_NETWORK ran,
+    guint step_dl_kbps,
+    guint step_ul_kbps,
+    guint hysteresis_ms);
+
+void
+radio_criteria_remove(
+    RadioCriteria* criteria,
+    guint id);
+
+G_END_DECLS
+
+#endif /* RADIO_CRITERIA_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -135,6 +135,67 @@ void
     guint32 serial,
     gpointer user_data);
 
+typedef
+void
+(*RadioInstanceSpecFunc)(
+    RadioInstance* radio,
+    guint index,
+    gpointer user_data); /* Since 1.6.7 */
+
+/*
+ * radio_instance_new_all_async() invokes RadioInstanceSpecFunc once for
+ * each RadioInstanceSpec as soon as that particular instance is ready
+ * (or has failed, in which case radio is NULL), index is the position
+ * of the spec in the array. GDestroyNotify is invoked after the last one.
+ */
+typedef struct radio_instance_spec {
+    const char* name;
+    const char* modem;
+    int slot;
+    RADIO_INTERFACE version;
+    RADIO_AIDL_INTERFACE aidl_interface;
+} RadioInstanceSpec; /* Since 1.6.7 */
+
+/* Since 1.6.7 */
+typedef struct radio_ack_stats {
+    guint64 requested;  /* Unhandled ACK_EXP indications and responses */
+    guint64 sent;       /* responseAcknowledgement transactions sent */
+} RadioAckStats;
+
+/* Since 1.6.7 */
+typedef enum radio_handler_type {
+    RADIO_HANDLER_REQUEST_OBSERVER,
+    RADIO_HANDLER_RESPONSE_OBSERVER,
+    RADIO_HANDLER_INDICATION_OBSERVER,
+    RADIO_HANDLER_RESPONSE,
+    RADIO_HANDLER_INDICATION,
+    RADIO_HANDLER_TYPE_COUNT
+} RADIO_HANDLER_TYPE;
+
+/*
+ * Per-handler stats carry the handler id and the code it has been
+ * registered for (zero for ANY). Per-code stats have zero id and the
+ * code of the actual transaction, summed over all the callbacks.
+ */
+typedef struct radio_handler_stats {
+    gulong id;
+    RADIO_HANDLER_TYPE type;
+    guint code;
+    guint calls;
+    guint slow_calls;
+    guint max_usec;
+    guint64 total_usec;
+} RadioHandlerStats; /* Since 1.6.7 */
+
+typedef
+void
+(*RadioSlowHandlerFunc)(
+    RadioInstance* radio,
+    const RadioHandlerStats* handler,
+    guint code,
+    guint usec,
+    gpointer user_data); /* Since 1.6.7 */
+
 GType radio_instance_get_type();
 #define RADIO_TYPE_INSTANCE (radio_instance_get_type())
 #define RADIO_INSTANCE(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj), \
@@ -175,6 +236,31 @@ radio_instance_new_with_modem_slot_version_and_interface(
     RADIO_INTERFACE version,
     RADIO_AIDL_INTERFACE aidl_interface); /* Since 1.6.0 */
 
+gulong
+radio_instance_new_async(
+    const char* dev,
+    const char* name,
+    const char* modem,
+    int slot,
+    RADIO_INTERFACE version,
+    RADIO_AIDL_INTERFACE aidl_interface,
+    RadioInstanceFunc func,
+    GDestroyNotify destroy,
+    gpointer user_data); /* Since 1.6.7 */
+
+gulong
+radio_instance_new_all_async(
+    const char* dev,
+    const RadioInstanceSpec* specs,
+    guint count,
+    RadioInstanceSpecFunc func,
+    GDestroyNotify destroy,
+    gpointer user_data); /* Since 1.6.7 */
+
+void
+radio_instance_cancel_new(
+    gulong id); /* Since 1.6.7 */
+
 RadioInstance*
 radio_instance_get(
     const char* dev,
@@ -190,6 +276,33 @@ RadioInstance* const*
 radio_instance_get_all(
     void);
 
+/*
+ * Allocation-free enumeration of the existing instances. The
+ * generation number changes whenever an instance is added or removed,
+ * which also terminates any iteration in progress.
+ *
+ * radio_instance_get_all() returns the same array until the generation
+ * changes.
+ */
+typedef struct radio_instance_iter {
+    /*< private >*/
+    GHashTableIter it;
+    guint gen;
+    gboolean valid;
+} RadioInstanceIter; /* Since 1.6.7 */
+
+guint
+radio_instance_generation(
+    void); /* Since 1.6.7 */
+
+void
+radio_instance_iter_init(
+    RadioInstanceIter* iter); /* Since 1.6.7 */
+
+RadioInstance*
+radio_instance_iter_next(
+    RadioInstanceIter* iter); /* Since 1.6.7 */
+
 RadioInstance*
 radio_instance_ref(
     RadioInstance* radio);
@@ -222,6 +335,101 @@ gboolean
 radio_instance_ack(
     RadioInstance* radio);
 
+void
+radio_instance_set_ack_batching(
+    RadioInstance* radio,
+    gboolean batching); /* Since 1.6.7 */
+
+void
+radio_instance_get_ack_stats(
+    RadioInstance* radio,
+    RadioAckStats* stats); /* Since 1.6.7 */
+
+/*
+ * Indications, responses, death notifications and transaction
+ * completions get delivered on the specified context (NULL means the
+ * default one). The context is supposed to be iterated by a dedicated
+ * thread, and the instance (together with the clients created after
+ * this call) must only be used from that thread.
+ */
+void
+radio_instance_set_context(
+    RadioInstance* radio,
+    GMainContext* context); /* Since 1.6.7 */
+
+/*
+ * Attaches RadioRecorder (see radio_recorder.h) to the instance, or
+ * detaches it if the recorder is NULL.
+ */
+void
+radio_instance_set_recorder(
+    RadioInstance* radio,
+    RadioRecorder* recorder); /* Since 1.6.7 */
+
+/*
+ * Measures how long each observer and handler callback takes. Those
+ * taking slow_ms or longer are logged and passed to RadioSlowHandlerFunc
+ * (zero slow_ms disables that). Enabling the timing resets the stats.
+ *
+ * The stats arrays are sorted by the total time, the biggest first,
+ * and must be deallocated with g_free().
+ */
+void
+radio_instance_set_handler_timing(
+    RadioInstance* radio,
+    gboolean enabled,
+    guint slow_ms); /* Since 1.6.7 */
+
+RadioHandlerStats*
+radio_instance_get_handler_stats(
+    RadioInstance* radio,
+    guint* count); /* Since 1.6.7 */
+
+RadioHandlerStats*
+radio_instance_get_code_stats(
+    RadioInstance* radio,
+    guint* count); /* Since 1.6.7 */
+
+/*
+ * Counts indications per code and keeps their exponentially decayed
+ * rates. Zero half_life_ms turns the meter off and drops the data.
+ * The array returned by radio_instance_get_ind_rates() contains at
+ * most max entries (zero means no limit), the chattiest first, and
+ * must be deallocated with g_free().
+ */
+void
+radio_instance_set_ind_meter(
+    RadioInstance* radio,
+    guint half_life_ms); /* Since 1.6.7 */
+
+RadioIndRate*
+radio_instance_get_ind_rates(
+    RadioInstance* radio,
+    RADIO_IND_RATE_ORDER order,
+    guint max,
+    guint* count); /* Since 1.6.7 */
+
+/*
+ * In the automatic mode the instance maintains the modem's indication
+ * filter (setIndicationFilter) so that only the indications which have
+ * observers or handlers (including those registered with RadioClient)
+ * are enabled. The filter is updated as the handlers come and go, and
+ * restored to the default when the automatic mode is turned off. The
+ * application shouldn't set the filter itself while it's on.
+ *
+ * Returns FALSE if the interface has no indication filter (only IRadio
+ * and IRadioNetwork have it). radio_instance_get_ind_filter() returns
+ * the last filter sent to the modem (initially, the default one).
+ */
+gboolean
+radio_instance_set_auto_ind_filter(
+    RadioInstance* radio,
+    gboolean enabled); /* Since 1.6.7 */
+
+RADIO_IND_FILTER
+radio_instance_get_ind_filter(
+    RadioInstance* radio); /* Since 1.6.7 */
+
 GBinderLocalRequest*
 radio_instance_new_request(
     RadioInstance* radio,
@@ -321,6 +529,12 @@ radio_instance_add_connected_handler(
     RadioInstanceFunc func,
     gpointer user_data); /* Since 1.4.3 */
 
+gulong
+radio_instance_add_slow_handler_handler(
+    RadioInstance* radio,
+    RadioSlowHandlerFunc func,
+    gpointer user_data); /* Since 1.6.7 */
+
 void
 radio_instance_remove_handler(
     RadioInstance* radio,
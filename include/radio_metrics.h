@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef RADIO_METRICS_H
+#define RADIO_METRICS_H
+
+/* This API exists since 1.6.7 */
+
+#include <radio_types.h>
+
+/*
+ * Runtime metrics in the Prometheus text exposition format. Every
+ * RadioClient, RadioConfig and RadioInstance added to RadioMetrics
+ * (the objects are referenced until removed) contributes:
+ *
+ *   radio_requests_queued, radio_requests_pending (gauges)
+ *   radio_requests_{submitted,completed,failed,timeouts,retries}_total
+ *   radio_request_latency_seconds (summary, per request code)
+ *   radio_request_latency_max_seconds (per request code)
+ *   radio_instance_connected, radio_instance_dead (gauges)
+ *   radio_instance_{connects,deaths}_total (since the object was added)
+ *   radio_acks_{requested,sent}_total
+ *   radio_indications_total, radio_indication_bytes_total
+ *   radio_indication_rate, radio_indication_byte_rate (per second)
+ *
+ * Each sample is labeled with slot and iface ("radio" for HIDL IRadio,
+ * "modem", "sim" etc. for AIDL). IRadioConfig samples are labeled with
+ * iface="config" and version ("1.1", "aidl1" etc.) instead. Request
+ * counters come from RadioClient and RadioConfig, the clients sharing
+ * the same instance are told apart by the client label (0, 1 and so on
+ * in the order they were added). Instance level metrics are reported
+ * once per instance, however many of its clients are added. Adding the
+ * same object twice has no effect. Indication counters require the
+ * indication meter to be enabled, see radio_instance_set_ind_meter()
+ * and radio_config_set_ind_meter().
+ *
+ * The text can be fetched with radio_metrics_format(), periodically
+ * written to a file (atomically replacing it) or served over a local
+ * UNIX socket, one snapshot per connection. The exporters run on the
+ * default main context.
+ */
+
+G_BEGIN_DECLS
+
+RadioMetrics*
+radio_metrics_new(
+    void)
+    G_GNUC_WARN_UNUSED_RESULT;
+
+RadioMetrics*
+radio_metrics_ref(
+    RadioMetrics* metrics);
+
+void
+radio_metrics_unref(
+    RadioMetrics* metrics);
+
+void
+radio_metrics_add_client(
+    RadioMetrics* metrics,
+    RadioClient* client);
+
+void
+radio_metrics_remove_client(
+    RadioMetrics* metrics,
+    RadioClient* client);
+
+void
+radio_metrics_add_config(
+    RadioMetrics* metrics,
+    RadioConfig* config);
+
+void
+radio_metrics_remove_config(
+    RadioMetrics* metrics,
+    RadioConfig* config);
+
+/* Clients contribute their instances, this is for bare instances */
+void
+radio_metrics_add_instance(
+    RadioMetrics* metrics,
+    RadioInstance* instance);
+
+void
+radio_metrics_remove_instance(
+    RadioMetrics* metrics,
+    RadioInstance* instance);
+
+/* Free with g_free() */
+char*
+radio_metrics_format(
+    RadioMetrics* metrics)
+    G_GNUC_WARN_UNUSED_RESULT;
+
+/* Writes the file right away and then every interval_ms (NULL to stop) */
+gboolean
+radio_metrics_export_file(
+    RadioMetrics* metrics,
+    const char* path,
+    guint interval_ms);
+
+/* Listens on the UNIX socket (NULL to stop) */
+gboolean
+radio_metrics_export_socket(
+    RadioMetrics* metrics,
+    const char* path);
+
+G_END_DECLS
+
+#endif /* RADIO_METRICS_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
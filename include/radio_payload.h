@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef RADIO_PAYLOAD_H
+#define RADIO_PAYLOAD_H
+
+/* This API exists since 1.6.7 */
+
+#include <radio_types.h>
+
+/*
+ * Zero-copy views of HIDL response and indication payloads.
+ *
+ * The returned pointers point directly into the parcel buffer and remain
+ * valid for as long as the parcel itself, i.e. normally until the handler
+ * returns. The size of the structure (or vector element) is checked
+ * against the one expected for the particular code, NULL is returned if
+ * the payload doesn't match.
+ *
+ * Response readers are expected to be positioned right after the
+ * RadioResponseInfo, indication readers - right after the indication
+ * type. That's exactly what response and indication handlers receive.
+ * The reader is advanced past the payload.
+ *
+ * AIDL payloads are parcelables and are not covered by this API.
+ */
+
+G_BEGIN_DECLS
+
+typedef enum radio_payload_type {
+    RADIO_PAYLOAD_NONE,
+    RADIO_PAYLOAD_STRUCT,
+    RADIO_PAYLOAD_VEC
+} RADIO_PAYLOAD_TYPE;
+
+/* p(NAME,Type) */
+#define RADIO_RESP_PAYLOAD_STRUCT(p) \
+    p(GET_ICC_CARD_STATUS,RadioCardStatus) \
+    p(GET_SIGNAL_STRENGTH,RadioSignalStrength) \
+    p(GET_VOICE_REGISTRATION_STATE,RadioVoiceRegStateResult) \
+    p(GET_DATA_REGISTRATION_STATE,RadioDataRegStateResult) \
+    p(SETUP_DATA_CALL,RadioDataCall) \
+    p(GET_RADIO_CAPABILITY,RadioCapability) \
+    p(GET_ICC_CARD_STATUS_1_2,RadioCardStatus_1_2) \
+    p(GET_SIGNAL_STRENGTH_1_2,RadioSignalStrength_1_2) \
+    p(GET_VOICE_REGISTRATION_STATE_1_2,RadioVoiceRegStateResult_1_2) \
+    p(GET_DATA_REGISTRATION_STATE_1_2,RadioDataRegStateResult_1_2) \
+    p(SETUP_DATA_CALL_1_4,RadioDataCall_1_4) \
+    p(GET_SIGNAL_STRENGTH_1_4,RadioSignalStrength_1_4) \
+    p(GET_DATA_REGISTRATION_STATE_1_4,RadioDataRegStateResult_1_4) \
+    p(GET_ICC_CARD_STATUS_1_4,RadioCardStatus_1_4) \
+    p(SETUP_DATA_CALL_1_5,RadioDataCall_1_5) \
+    p(GET_VOICE_REGISTRATION_STATE_1_5,RadioRegStateResult_1_5) \
+    p(GET_DATA_REGISTRATION_STATE_1_5,RadioRegStateResult_1_5) \
+    p(GET_ICC_CARD_STATUS_1_5,RadioCardStatus_1_5)
+
+#define RADIO_RESP_PAYLOAD_VEC(p) \
+    p(GET_CURRENT_CALLS,RadioCall) \
+    p(GET_AVAILABLE_NETWORKS,RadioOperatorInfo) \
+    p(GET_DATA_CALL_LIST,RadioDataCall) \
+    p(GET_CELL_INFO_LIST,RadioCellInfo) \
+    p(GET_HARDWARE_CONFIG,RadioHardwareConfig) \
+    p(GET_CELL_INFO_LIST_1_2,RadioCellInfo_1_2) \
+    p(GET_CURRENT_CALLS_1_2,RadioCall_1_2) \
+    p(GET_CELL_INFO_LIST_1_4,RadioCellInfo_1_4) \
+    p(GET_DATA_CALL_LIST_1_4,RadioDataCall_1_4) \
+    p(GET_DATA_CALL_LIST_1_5,RadioDataCall_1_5) \
+    p(GET_CELL_INFO_LIST_1_5,RadioCellInfo_1_5)
+
+#define RADIO_IND_PAYLOAD_STRUCT(p) \
+    p(CURRENT_SIGNAL_STRENGTH,RadioSignalStrength) \
+    p(SUPP_SVC_NOTIFY,RadioSuppSvcNotification) \
+    p(SIM_REFRESH,RadioSimRefresh) \
+    p(RADIO_CAPABILITY_INDICATION,RadioCapability) \
+    p(NETWORK_SCAN_RESULT,RadioNetworkScanResult) \
+    p(NETWORK_SCAN_RESULT_1_2,RadioNetworkScanResult) \
+    p(CURRENT_SIGNAL_STRENGTH_1_2,RadioSignalStrength_1_2) \
+    p(NETWORK_SCAN_RESULT_1_4,RadioNetworkScanResult) \
+    p(CURRENT_SIGNAL_STRENGTH_1_4,RadioSignalStrength_1_4) \
+    p(NETWORK_SCAN_RESULT_1_5,RadioNetworkScanResult)
+
+#define RADIO_IND_PAYLOAD_VEC(p) \
+    p(DATA_CALL_LIST_CHANGED,RadioDataCall) \
+    p(CELL_INFO_LIST,RadioCellInfo) \
+    p(HARDWARE_CONFIG_CHANGED,RadioHardwareConfig) \
+    p(CELL_INFO_LIST_1_2,RadioCellInfo_1_2) \
+    p(CURRENT_PHYSICAL_CHANNEL_CONFIGS,RadioPhysicalChannelConfig) \
+    p(CURRENT_EMERGENCY_NUMBER_LIST,RadioEmergencyNumber) \
+    p(CELL_INFO_LIST_1_4,RadioCellInfo_1_4) \
+    p(CURRENT_PHYSICAL_CHANNEL_CONFIGS_1_4,RadioPhysicalChannelConfig_1_4) \
+    p(DATA_CALL_LIST_CHANGED_1_4,RadioDataCall_1_4) \
+    p(CELL_INFO_LIST_1_5,RadioCellInfo_1_5) \
+    p(DATA_CALL_LIST_CHANGED_1_5,RadioDataCall_1_5)
+
+/* RadioRespPayload_GET_SIGNAL_STRENGTH_1_4 etc. */
+#define RADIO_RESP_PAYLOAD_TYPEDEF_(NAME,Type) \
+    typedef Type RadioRespPayload_##NAME;
+RADIO_RESP_PAYLOAD_STRUCT(RADIO_RESP_PAYLOAD_TYPEDEF_)
+RADIO_RESP_PAYLOAD_VEC(RADIO_RESP_PAYLOAD_TYPEDEF_)
+#undef RADIO_RESP_PAYLOAD_TYPEDEF_
+
+/* RadioIndPayload_CURRENT_SIGNAL_STRENGTH_1_4 etc. */
+#define RADIO_IND_PAYLOAD_TYPEDEF_(NAME,Type) \
+    typedef Type RadioIndPayload_##NAME;
+RADIO_IND_PAYLOAD_STRUCT(RADIO_IND_PAYLOAD_TYPEDEF_)
+RADIO_IND_PAYLOAD_VEC(RADIO_IND_PAYLOAD_TYPEDEF_)
+#undef RADIO_IND_PAYLOAD_TYPEDEF_
+
+RADIO_PAYLOAD_TYPE
+radio_resp_payload_type(
+    RADIO_RESP resp,
+    gsize* size);
+
+RADIO_PAYLOAD_TYPE
+radio_ind_payload_type(
+    RADIO_IND ind,
+    gsize* size);
+
+const void*
+radio_resp_payload(
+    RADIO_RESP resp,
+    GBinderReader* reader,
+    gsize* count);
+
+const void*
+radio_ind_payload(
+    RADIO_IND ind,
+    GBinderReader* reader,
+    gsize* count);
+
+/*
+ * Typed wrappers, e.g.
+ *
+ * const RadioSignalStrength_1_4* ss =
+ *     RADIO_IND_VIEW(CURRENT_SIGNAL_STRENGTH_1_4, &reader);
+ *
+ * const RadioCellInfo_1_5* cells =
+ *     RADIO_RESP_VEC_VIEW(GET_CELL_INFO_LIST_1_5, &reader, &count);
+ *
+ * Using a code which has no payload description won't compile.
+ */
+#define RADIO_RESP_VIEW(NAME,reader) \
+    ((const RadioRespPayload_##NAME*) \
+    radio_resp_payload(RADIO_RESP_##NAME, reader, NULL))
+#define RADIO_RESP_VEC_VIEW(NAME,reader,count) \
+    ((const RadioRespPayload_##NAME*) \
+    radio_resp_payload(RADIO_RESP_##NAME, reader, count))
+#define RADIO_IND_VIEW(NAME,reader) \
+    ((const RadioIndPayload_##NAME*) \
+    radio_ind_payload(RADIO_IND_##NAME, reader, NULL))
+#define RADIO_IND_VEC_VIEW(NAME,reader,count) \
+    ((const RadioIndPayload_##NAME*) \
+    radio_ind_payload(RADIO_IND_##NAME, reader, count))
+
+/*
+ * Iterator over vector payloads, yields one element at a time. HIDL
+ * vectors are walked in place, AIDL arrays of parcelables are read from
+ * the parcel as the iteration goes, so the reader must remain valid
+ * until the iteration is finished. The iteration stops at the first
+ * element which can't be read.
+ *
+ * RadioVecIter it;
+ *
+ * if (radio_resp_vec_iter_init(&it, RADIO_RESP_GET_CELL_INFO_LIST_1_5,
+ *     &reader)) {
+ *     const RadioCellInfo_1_5* cell;
+ *
+ *     while ((cell = RADIO_VEC_ITER_NEXT(&it, RadioCellInfo_1_5))) {
+ *         if (cell->registered) {
+ *             ...
+ *         }
+ *     }
+ * }
+ */
+typedef struct radio_vec_iter {
+    guint count;
+    guint index;
+    /*< private >*/
+    gconstpointer ptr;
+    gsize elem_size;
+    GBinderReader* reader;
+} RadioVecIter;
+
+gboolean
+radio_vec_iter_init(
+    RadioVecIter* iter,
+    GBinderReader* reader,
+    gsize elem_size);
+
+gboolean
+radio_vec_iter_init_hidl(
+    RadioVecIter* iter,
+    const GBinderHidlVec* vec,
+    gsize elem_size);
+
+gboolean
+radio_vec_iter_init_aidl(
+    RadioVecIter* iter,
+    GBinderReader* reader);
+
+gboolean
+radio_resp_vec_iter_init(
+    RadioVecIter* iter,
+    RADIO_RESP resp,
+    GBinderReader* reader);
+
+gboolean
+radio_ind_vec_iter_init(
+    RadioVecIter* iter,
+    RADIO_IND ind,
+    GBinderReader* reader);
+
+const void*
+radio_vec_iter_next(
+    RadioVecIter* iter,
+    gsize* size);
+
+#define RADIO_VEC_ITER_NEXT(iter,Type) \
+    ((const Type*)radio_vec_iter_next(iter, NULL))
+
+G_END_DECLS
+
+#endif /* RADIO_PAYLOAD_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
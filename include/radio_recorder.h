@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef RADIO_RECORDER_H
+#define RADIO_RECORDER_H
+
+/* This API exists since 1.6.7 */
+
+#include <radio_types.h>
+
+/*
+ * Binary transaction recorder. Once attached to a RadioInstance or
+ * a RadioConfig, it copies every outgoing request, every response and
+ * every indication into a fixed size ring of slots, overwriting the
+ * oldest records. Records are numbered with a single atomic increment
+ * and nothing ever waits, so several objects (even running on different
+ * threads) can share one recorder. If the ring is so small that a writer
+ * wraps onto a slot which is still being written, its record is dropped.
+ * Nothing is recorded (and nothing is paid) when no recorder is attached.
+ *
+ * The memory image of the recorder is exactly what gets written to
+ * a file: RadioRecorderHeader followed by count slots, slot_size bytes
+ * each. Every slot starts with RadioRecord followed by the first
+ * (slot_size - sizeof(RadioRecord)) bytes of the raw parcel. All
+ * numbers are in host byte order.
+ *
+ * radio_recorder_new_mapped() keeps the ring in a shared file mapping,
+ * so the records survive a crash of the process. radio_recorder_dump()
+ * writes a consistent snapshot of any recorder on demand, but refuses
+ * to overwrite the recorder's own file. The records contain raw parcels
+ * (PINs, SMS, subscriber identity and location), so the files are only
+ * readable by the owner. They are created under a temporary name and
+ * then renamed, which never truncates a file mapped by another recorder.
+ */
+
+G_BEGIN_DECLS
+
+#define RADIO_RECORDER_MAGIC (0x43455252) /* "RREC" */
+#define RADIO_RECORDER_FORMAT (1)
+
+typedef struct radio_recorder_header {
+    guint32 magic;          /* RADIO_RECORDER_MAGIC */
+    guint16 format;         /* RADIO_RECORDER_FORMAT */
+    guint16 header_size;    /* sizeof(RadioRecorderHeader) */
+    guint32 count;          /* Number of slots, a power of 2 */
+    guint32 slot_size;      /* Size of each slot, including RadioRecord */
+    guint32 next;           /* Sequence number of the next record */
+    guint32 reserved;
+    gint64 mono_time;       /* g_get_monotonic_time() when the recorder
+                             * was created or the dump was taken */
+    gint64 real_time;       /* g_get_real_time() at the same moment */
+} RadioRecorderHeader;
+
+typedef enum radio_record_type {
+    RADIO_RECORD_NONE,
+    RADIO_RECORD_REQUEST,
+    RADIO_RECORD_RESPONSE,
+    RADIO_RECORD_INDICATION
+} RADIO_RECORD_TYPE;
+
+typedef enum radio_record_flags {
+    RADIO_RECORD_FLAGS_NONE = 0x00,
+    RADIO_RECORD_FLAG_CONFIG = 0x01,    /* Recorded by RadioConfig */
+    RADIO_RECORD_FLAG_TRUNCATED = 0x02  /* Parcel didn't fit */
+} RADIO_RECORD_FLAGS;
+
+typedef struct radio_record {
+    guint32 seq;            /* Sequence number, starting with 1 */
+    guint8 type;            /* RADIO_RECORD_TYPE */
+    guint8 flags;           /* RADIO_RECORD_FLAGS */
+    guint8 interface_type;  /* RADIO_INTERFACE_TYPE */
+    gint8 interface;        /* RADIO_INTERFACE, RADIO_AIDL_INTERFACE or
+                             * RADIO_CONFIG_INTERFACE, depending on the
+                             * above two */
+    guint32 code;           /* RADIO_REQ, RADIO_RESP etc. */
+    guint32 serial;         /* Serial, zero for indications */
+    gint32 extra;           /* RADIO_ERROR, RADIO_IND_TYPE or, for
+                             * a resubmitted request, its original
+                             * serial (zero for the first submission) */
+    guint32 size;           /* Full size of the parcel */
+    gint64 time;            /* g_get_monotonic_time() */
+} RadioRecord;
+
+G_STATIC_ASSERT(sizeof(RadioRecorderHeader) == 40);
+G_STATIC_ASSERT(sizeof(RadioRecord) == 32);
+
+RadioRecorder*
+radio_recorder_new(
+    guint count,
+    gsize max_data)
+    G_GNUC_WARN_UNUSED_RESULT;
+
+RadioRecorder*
+radio_recorder_new_mapped(
+    const char* path,
+    guint count,
+    gsize max_data)
+    G_GNUC_WARN_UNUSED_RESULT;
+
+RadioRecorder*
+radio_recorder_ref(
+    RadioRecorder* recorder);
+
+void
+radio_recorder_unref(
+    RadioRecorder* recorder);
+
+guint
+radio_recorder_count(
+    RadioRecorder* recorder);
+
+gboolean
+radio_recorder_dump(
+    RadioRecorder* recorder,
+    const char* path);
+
+G_END_DECLS
+
+#endif /* RADIO_RECORDER_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -173,6 +173,16 @@ radio_request_set_blocking(
     RadioRequest* req,
     gboolean blocking);
 
+/*
+ * Background requests may be held in the queue while the owner is in
+ * power save (see radio_client_set_power_save) and then submitted in
+ * a batch. Must be set before the request is submitted.
+ */
+void
+radio_request_set_background(
+    RadioRequest* req,
+    gboolean background); /* Since 1.6.7 */
+
 void
 radio_request_set_timeout(
     RadioRequest* req,
@@ -197,6 +207,31 @@ RadioRequest*
 radio_request_try_submit(
     RadioRequest* req); /* Since 1.6.2 */
 
+/*
+ * radio_request_post() can be invoked on any thread. The request is
+ * submitted by the thread running the context of the RadioClient or
+ * RadioConfig which created it (default context unless changed with
+ * radio_instance_set_context()). Requests posted from several threads
+ * are submitted in batches, in the order in which they were posted.
+ *
+ * The caller's reference is consumed, i.e. the request must not be
+ * touched after this call by the posting thread except from within
+ * the completion callback. If context is not NULL, the completion
+ * callback is invoked on that context, otherwise on the owner's
+ * context. The destroy notification is always invoked on the owner's
+ * context. If the request can't be submitted or gets dropped before
+ * completion (e.g. together with its owner), the completion callback
+ * receives RADIO_TX_STATUS_FAILED, still on the requested context.
+ *
+ * radio_request_new() (without a group) and radio_config_request_new()
+ * can be used from any thread to create requests for posting.
+ * Request groups are not thread-safe.
+ */
+gboolean
+radio_request_post(
+    RadioRequest* req,
+    GMainContext* context); /* Since 1.6.7 */
+
 gboolean
 radio_request_retry(
     RadioRequest* req);
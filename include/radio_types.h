@@ -42,9 +42,13 @@
 
 G_BEGIN_DECLS
 
+typedef struct radio_cell_info_rate RadioCellInfoRate; /* Since 1.6.7 */
 typedef struct radio_client RadioClient;
 typedef struct radio_config RadioConfig;
+typedef struct radio_criteria RadioCriteria; /* Since 1.6.7 */
 typedef struct radio_instance RadioInstance;
+typedef struct radio_metrics RadioMetrics; /* Since 1.6.7 */
+typedef struct radio_recorder RadioRecorder; /* Since 1.6.7 */
 typedef struct radio_registry RadioRegistry;
 typedef struct radio_request RadioRequest;
 typedef struct radio_request_group RadioRequestGroup;
@@ -90,6 +94,20 @@ typedef enum radio_observer_priority {
     RADIO_OBSERVER_PRIORITY_HIGHEST = 7
 } RADIO_OBSERVER_PRIORITY; /* Since 1.4.6 */
 
+typedef enum radio_ind_rate_order {
+    RADIO_IND_RATE_BY_COUNT,
+    RADIO_IND_RATE_BY_BYTES
+} RADIO_IND_RATE_ORDER; /* Since 1.6.7 */
+
+/* Rates are per second, exponentially decayed */
+typedef struct radio_ind_rate {
+    guint code;
+    guint64 count;
+    guint64 bytes;
+    gdouble rate;
+    gdouble byte_rate;
+} RadioIndRate; /* Since 1.6.7 */
+
 #define RADIO_IFACE_PREFIX     "android.hardware.radio@"
 #define RADIO_IFACE            "IRadio"
 #define RADIO_RESPONSE_IFACE   "IRadioResponse"
@@ -569,6 +587,20 @@ typedef enum radio_access_networks {
 } RADIO_ACCESS_NETWORKS; /* Since 1.5.3 */
 G_STATIC_ASSERT(sizeof(RADIO_ACCESS_NETWORKS) == 4);
 
+/* This is SignalMeasurementType from 1.5/types.hal */
+typedef enum radio_signal_measurement {
+    RADIO_SIGNAL_MEASUREMENT_NONE,
+    RADIO_SIGNAL_MEASUREMENT_RSSI,      /* GERAN, CDMA2000 (dBm) */
+    RADIO_SIGNAL_MEASUREMENT_RSCP,      /* UTRAN (dBm) */
+    RADIO_SIGNAL_MEASUREMENT_RSRP,      /* EUTRAN (dBm) */
+    RADIO_SIGNAL_MEASUREMENT_RSRQ,      /* EUTRAN (dB) */
+    RADIO_SIGNAL_MEASUREMENT_RSSNR,     /* EUTRAN (dB) */
+    RADIO_SIGNAL_MEASUREMENT_SSRSRP,    /* NGRAN (dBm) */
+    RADIO_SIGNAL_MEASUREMENT_SSRSRQ,    /* NGRAN (dB) */
+    RADIO_SIGNAL_MEASUREMENT_SSSINR     /* NGRAN (dB) */
+} RADIO_SIGNAL_MEASUREMENT; /* Since 1.6.7 */
+G_STATIC_ASSERT(sizeof(RADIO_SIGNAL_MEASUREMENT) == 4);
+
 typedef enum radio_data_profile_type {
     RADIO_DATA_PROFILE_COMMON,
     RADIO_DATA_PROFILE_3GPP,
@@ -2042,6 +2074,15 @@ typedef struct radio_signal_strength_1_4 {
 } RADIO_ALIGNED(4) RadioSignalStrength_1_4; /* Since 1.2.5 */
 G_STATIC_ASSERT(sizeof(RadioSignalStrength_1_4) == 108);
 
+typedef struct radio_signal_threshold_info {
+    RADIO_SIGNAL_MEASUREMENT signalMeasurement RADIO_ALIGNED(4);
+    gint32 hysteresisMs RADIO_ALIGNED(4);
+    gint32 hysteresisDb RADIO_ALIGNED(4);
+    GBinderHidlVec thresholds RADIO_ALIGNED(8); /* vec<int32_t> */
+    guint8 isEnabled RADIO_ALIGNED(1);
+} RADIO_ALIGNED(8) RadioSignalThresholdInfo; /* Since 1.6.7 */
+G_STATIC_ASSERT(sizeof(RadioSignalThresholdInfo) == 40);
+
 typedef struct radio_cell_info_gsm {
     RadioCellIdentityGsm cellIdentityGsm RADIO_ALIGNED(8);
     RadioSignalStrengthGsm signalStrengthGsm RADIO_ALIGNED(4);
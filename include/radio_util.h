@@ -68,6 +68,25 @@ radio_ind_name2(
     RadioInstance* instance,
     RADIO_IND ind); /* Since 1.6.0 */
 
+/*
+ * Reverse lookup, returns zero (RADIO_REQ_NONE etc.) if the name is
+ * unknown. NULL instance means IRadio (HIDL), same as for name2 calls.
+ */
+RADIO_REQ
+radio_req_from_name(
+    RadioInstance* instance,
+    const char* name); /* Since 1.6.7 */
+
+RADIO_RESP
+radio_resp_from_name(
+    RadioInstance* instance,
+    const char* name); /* Since 1.6.7 */
+
+RADIO_IND
+radio_ind_from_name(
+    RadioInstance* instance,
+    const char* name); /* Since 1.6.7 */
+
 RADIO_RESP
 radio_req_resp(
     RADIO_REQ req)
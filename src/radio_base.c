@@ -38,10 +38,13 @@
 #define GLIB_DISABLE_DEPRECATION_WARNINGS
 
 #include "radio_base.h"
+#include "radio_probe_p.h"
 #include "radio_request_p.h"
-#include "radio_util.h"
+#include "radio_util_p.h"
 #include "radio_log.h"
 
+#include <stdlib.h>
+
 /*
  * Requests are considered pending for no longer than pending_timeout
  * because pending requests prevent blocking requests from being
@@ -49,8 +52,17 @@
  */
 #define DEFAULT_PENDING_TIMEOUT_MS (30000)
 
+/* How long background requests may be held in power save */
+#define DEFAULT_BATCH_WINDOW_MS (10000)
+
 #define KEY(serial) GUINT_TO_POINTER(serial)
 
+/*
+ * Requests may be created and posted by other threads, the lock
+ * protects the serial counter and priv->requests tables.
+ */
+G_LOCK_DEFINE_STATIC(radio_base_requests);
+
 struct radio_base_priv {
     GHashTable* requests;       /* All requests (weak references)  */
     GHashTable* active;         /* Requests in QUEUED and PENDING states  */
@@ -63,7 +75,16 @@ struct radio_base_priv {
 
     gint64 next_wakeup;         /* When the next timer is scheduled */
     guint default_timeout_ms;   /* Default PENDING timeout, milliseconds */
+    gboolean power_save;        /* Holding background requests */
+    guint batch_window_ms;      /* Max time to hold them, milliseconds */
+    gint64 batch_release;       /* When the held batch is released */
     guint timeout_id;
+    RadioBaseClock clock;       /* Time source and timers */
+    RadioBaseStats stats;       /* Cost and outcome counters */
+    GHashTable* latency;        /* code => RadioBaseLatency */
+    GMainContext* context;      /* NULL for the default one */
+    GBinderRemoteRequest* resp_msg; /* Response being handled */
+    RadioRequest* inbox;        /* Posted by other threads (LIFO) */
 };
 
 #define PARENT_CLASS radio_base_parent_class
@@ -89,6 +110,63 @@ guint
 radio_base_submit_queued_requests(
     RadioBase* self);
 
+/*==========================================================================*
+ * Default clock
+ *==========================================================================*/
+
+static
+gint64
+radio_base_clock_now(
+    gpointer user_data)
+{
+    return g_get_monotonic_time();
+}
+
+static
+guint
+radio_base_clock_timeout_add(
+    GMainContext* context,
+    guint ms,
+    GSourceFunc func,
+    gpointer data,
+    gpointer user_data)
+{
+    return radio_timeout_add(context, ms, func, data);
+}
+
+static
+void
+radio_base_clock_source_remove(
+    GMainContext* context,
+    guint id,
+    gpointer user_data)
+{
+    radio_source_remove(context, id);
+}
+
+static const RadioBaseClock radio_base_default_clock = {
+    radio_base_clock_now,
+    radio_base_clock_timeout_add,
+    radio_base_clock_source_remove,
+    NULL
+};
+
+static inline gint64
+radio_base_priv_now(RadioBasePriv* priv)
+    { return priv->clock.now(priv->clock.user_data); }
+
+static
+void
+radio_base_stop_timer(
+    RadioBasePriv* priv)
+{
+    if (priv->timeout_id) {
+        priv->clock.source_remove(priv->context, priv->timeout_id,
+            priv->clock.user_data);
+        priv->timeout_id = 0;
+    }
+}
+
 /*==========================================================================*
  * Implementation
  *==========================================================================*/
@@ -144,6 +222,7 @@ radio_base_dequeue_request(
     RadioRequest* prev = NULL;
 
     while (ptr) {
+        q->stats.queue_visits++;
         if (ptr == req) {
             radio_base_unlink_request(q, req, prev);
             return TRUE;
@@ -154,6 +233,50 @@ radio_base_dequeue_request(
     return FALSE;
 }
 
+static
+void
+radio_base_release_batch(
+    RadioBase* self,
+    gint64 now)
+{
+    RadioBasePriv* priv = self->priv;
+    RadioRequest* req;
+
+    /*
+     * Everything held so far goes out together. The batch may be released
+     * before the window expires, the timeouts start ticking right now.
+     */
+    for (req = priv->queue_first; req; req = req->queue_next) {
+        priv->stats.queue_visits++;
+        if (req->held) {
+            req->held = FALSE;
+            req->scheduled = 0;
+            req->deadline = now + MICROSEC(radio_base_timeout_ms(self, req));
+        }
+    }
+    priv->batch_release = 0;
+}
+
+static
+void
+radio_base_hold_request(
+    RadioBasePriv* priv,
+    RadioRequest* req,
+    gint64 now)
+{
+    if (!priv->batch_release) {
+        /* This one opens a new batch */
+        priv->batch_release = now + MICROSEC(priv->batch_window_ms);
+    }
+
+    /* The deadline gets recalculated when the batch is released */
+    GDEBUG("Holding request %u (%08x)", req->code, req->serial);
+    RADIO_PROBE2(request_deferred, req->serial, req->code);
+    req->held = TRUE;
+    req->scheduled = priv->batch_release;
+    req->deadline += priv->batch_release - now;
+}
+
 static
 void
 radio_base_deactivate_request(
@@ -215,6 +338,8 @@ radio_base_fail_request(
 {
     radio_request_ref(req);
     req->state = state;
+    self->priv->stats.failed++;
+    RADIO_PROBE3(request_complete, req->serial, req->code, status);
     if (req->complete) {
         RadioRequestCompleteFunc complete = req->complete;
 
@@ -264,19 +389,21 @@ radio_base_submit_transaction(
         const guint32 used = req->serial2;
 
         /* Pick another serial and record it */
+        G_LOCK(radio_base_requests);
         req->serial2 = radio_base_reserve_serial(self);
         g_hash_table_insert(priv->requests, KEY(req->serial2), req);
-        g_hash_table_insert(priv->active, KEY(req->serial2),
-            radio_request_ref(req));
-
-        /* Drop the old one */
-        g_hash_table_remove(priv->pending, KEY(used));
-        g_hash_table_remove(priv->active, KEY(used));
 
         /* Keep the original serial in priv->requests */
         if (used != req->serial) {
             g_hash_table_remove(priv->requests, KEY(used));
         }
+        G_UNLOCK(radio_base_requests);
+
+        /* Drop the old one */
+        g_hash_table_insert(priv->active, KEY(req->serial2),
+            radio_request_ref(req));
+        g_hash_table_remove(priv->pending, KEY(used));
+        g_hash_table_remove(priv->active, KEY(used));
 
         /* Update the RPC header */
         radio_request_update_serial(req, req->serial2);
@@ -285,12 +412,15 @@ radio_base_submit_transaction(
     } else {
         /* First submission */
         req->serial2 = req->serial;
+        req->submitted = radio_base_priv_now(priv);
     }
 
     /* Actually submit the transaction */
     req->tx_id = RADIO_BASE_GET_CLASS(self)->send_request(self, req,
         radio_base_request_sent);
     if (req->tx_id) {
+        priv->stats.submitted++;
+        RADIO_PROBE2(request_sent, req->serial2, req->code);
         req->scheduled = 0; /* Not scheduled anymore */
         req->state = RADIO_REQUEST_STATE_PENDING;
         g_hash_table_insert(priv->pending, KEY(req->serial2),
@@ -301,6 +431,51 @@ radio_base_submit_transaction(
     }
 }
 
+static
+void
+radio_base_request_done(
+    RadioBasePriv* priv,
+    RadioRequest* req)
+{
+    priv->stats.completed++;
+    if (req->submitted) {
+        const gint64 usec = radio_base_priv_now(priv) - req->submitted;
+        RadioBaseLatency* lat;
+
+        if (!priv->latency) {
+            priv->latency = g_hash_table_new_full(g_direct_hash,
+                g_direct_equal, NULL, g_free);
+        }
+        lat = g_hash_table_lookup(priv->latency, KEY(req->code));
+        if (!lat) {
+            lat = g_new0(RadioBaseLatency, 1);
+            lat->code = req->code;
+            g_hash_table_insert(priv->latency, KEY(req->code), lat);
+        }
+        lat->count++;
+        if (usec > 0) {
+            const guint us = (guint) MIN(usec, G_MAXUINT);
+
+            lat->total_usec += us;
+            if (lat->max_usec < us) {
+                lat->max_usec = us;
+            }
+        }
+    }
+}
+
+static
+int
+radio_base_latency_compare(
+    const void* a,
+    const void* b)
+{
+    const RadioBaseLatency* l1 = a;
+    const RadioBaseLatency* l2 = b;
+
+    return (l1->code < l2->code) ? (-1) : (l1->code > l2->code) ? 1 : 0;
+}
+
 static
 gboolean
 radio_base_can_set_owner(
@@ -322,6 +497,7 @@ radio_base_can_set_owner(
         while (g_hash_table_iter_next(&it, NULL, &value)) {
             RadioRequest* req = value;
 
+            priv->stats.table_visits++;
             DEBUG_ASSERT(req->state == RADIO_REQUEST_STATE_PENDING);
             if (req->group != group) {
                 /*
@@ -409,6 +585,7 @@ radio_base_queue_request(
     RadioRequest* req)
 {
     req->state = RADIO_REQUEST_STATE_QUEUED;
+    RADIO_PROBE2(request_queued, req->serial, req->code);
     if (priv->queue_last) {
         priv->queue_last->queue_next = req;
     } else {
@@ -428,11 +605,12 @@ radio_base_submit_queued_requests(
     if (RADIO_BASE_GET_CLASS(self)->can_submit_requests(self)) {
         RadioRequest* prev = NULL;
         RadioRequest* req = priv->queue_first;
-        const gint64 now = g_get_monotonic_time();
+        const gint64 now = radio_base_priv_now(priv);
 
         while (req) {
             RadioRequest* next = req->queue_next;
 
+            priv->stats.queue_visits++;
             if (radio_base_can_submit_request(priv, req) &&
                 /* If the request is scheduled, don't submit it too early */
                 (!req->scheduled || now >= req->scheduled)) {
@@ -470,7 +648,7 @@ radio_base_timeout(
 {
     RadioBase* self = THIS(user_data);
     RadioBasePriv* priv = self->priv;
-    const gint64 now = g_get_monotonic_time();
+    const gint64 now = radio_base_priv_now(priv);
     GHashTableIter it;
     gpointer value;
     GSList* expired = NULL;
@@ -483,6 +661,7 @@ radio_base_timeout(
     g_hash_table_iter_init(&it, priv->active);
     while (g_hash_table_iter_next(&it, NULL, &value)) {
         req = value;
+        priv->stats.table_visits++;
         if (req->deadline <= now) {
             GDEBUG("Request %u (%08x/%08x) expired",
                 req->code, req->serial, req->serial2);
@@ -510,6 +689,8 @@ radio_base_timeout(
          */
         for (l = expired; l; l = l->next) {
             req = l->data;
+            priv->stats.timeouts++;
+            RADIO_PROBE2(request_timeout, req->serial, req->code);
             radio_base_fail_request(self, req,
                 RADIO_REQUEST_STATE_FAILED,
                 RADIO_TX_STATUS_TIMEOUT);
@@ -521,6 +702,11 @@ radio_base_timeout(
         g_slist_free(expired);
     }
 
+    /* The batch window may have expired too */
+    if (priv->batch_release && priv->batch_release <= now) {
+        radio_base_release_batch(self, now);
+    }
+
     /* A retry timeout may have expired, check if we need to submit requests */
     radio_base_submit_queued_requests(self);
     radio_base_reset_timeout(self);
@@ -528,6 +714,49 @@ radio_base_timeout(
     return G_SOURCE_REMOVE;
 }
 
+static
+gboolean
+radio_base_drain_inbox(
+    gpointer user_data)
+{
+    RadioBase* self = THIS(user_data);
+    RadioBasePriv* priv = self->priv;
+    RadioRequest* batch = NULL;
+    RadioRequest* req;
+
+    /* Grab everything posted so far and restore the FIFO order */
+    do {
+        req = g_atomic_pointer_get(&priv->inbox);
+    } while (!g_atomic_pointer_compare_and_exchange(&priv->inbox, req, NULL));
+    while (req) {
+        RadioRequest* next = req->inbox_next;
+
+        req->inbox_next = batch;
+        batch = req;
+        req = next;
+    }
+
+    while (batch) {
+        req = batch;
+        batch = req->inbox_next;
+        req->inbox_next = NULL;
+        if (!radio_request_submit(req) &&
+            req->state == RADIO_REQUEST_STATE_NEW) {
+            /* Nobody is there to check the return value */
+            req->state = RADIO_REQUEST_STATE_FAILED;
+            if (req->complete) {
+                RadioRequestCompleteFunc complete = req->complete;
+
+                req->complete = NULL;
+                complete(req, RADIO_TX_STATUS_FAILED, RADIO_RESP_NONE,
+                    RADIO_ERROR_NONE, NULL, req->user_data);
+            }
+        }
+        radio_request_unref(req);
+    }
+    return G_SOURCE_REMOVE;
+}
+
 /*==========================================================================*
  * Internal API
  *==========================================================================*/
@@ -547,8 +776,11 @@ radio_base_register_request(
     RadioBasePriv* priv = self->priv;
 
     req->object = self;
+    G_LOCK(radio_base_requests);
     req->serial = radio_base_reserve_serial(self);
     g_hash_table_insert(priv->requests, KEY(req->serial), req);
+    G_UNLOCK(radio_base_requests);
+    RADIO_PROBE2(request_create, req->serial, req->code);
 }
 
 void
@@ -561,8 +793,10 @@ radio_base_unregister_request(
         RadioBasePriv* priv = self->priv;
 
         GVERBOSE_("request %u %p (%08x) done", req->code, req, req->serial);
+        G_LOCK(radio_base_requests);
         g_hash_table_remove(priv->requests, KEY(req->serial));
         g_hash_table_remove(priv->requests, KEY(req->serial2));
+        G_UNLOCK(radio_base_requests);
         req->serial = req->serial2 = 0;
         req->object = NULL;
     }
@@ -583,9 +817,20 @@ radio_base_submit_request(
         RadioBasePriv* priv = self->priv;
         RadioRequestCompleteFunc complete = req->complete;
         const guint timeout = radio_base_timeout_ms(self, req);
+        const gint64 now = radio_base_priv_now(priv);
 
         /* Queue the request */
-        req->deadline = g_get_monotonic_time() + MICROSEC(timeout);
+        req->deadline = now + MICROSEC(timeout);
+        if (priv->batch_release && priv->batch_release <= now) {
+            /* Should have been released by the timer */
+            radio_base_release_batch(self, now);
+        }
+        if (priv->power_save && req->background) {
+            radio_base_hold_request(priv, req, now);
+        } else if (priv->batch_release) {
+            /* The modem is woken up anyway, take the batch along */
+            radio_base_release_batch(self, now);
+        }
         radio_base_queue_request(priv, req);
 
         /* Create an internal reference to the request */
@@ -594,7 +839,7 @@ radio_base_submit_request(
 
         /* Don't complete the request if it fails right away */
         req->complete = NULL;
-        if (radio_base_submit_queued_requests(self)) {
+        if (radio_base_submit_queued_requests(self) || req->held) {
             radio_base_reset_timeout(self);
         }
         if (req->state < RADIO_REQUEST_STATE_FAILED) {
@@ -605,6 +850,35 @@ radio_base_submit_request(
     return FALSE;
 }
 
+void
+radio_base_post_request(
+    RadioBase* self,
+    RadioRequest* req)
+{
+    /*
+     * Caller makes sure that both arguments are not NULL. This one is
+     * invoked on an arbitrary thread and consumes the reference.
+     */
+    RadioBasePriv* priv = self->priv;
+    RadioRequest* head;
+
+    do {
+        head = g_atomic_pointer_get(&priv->inbox);
+        req->inbox_next = head;
+    } while (!g_atomic_pointer_compare_and_exchange(&priv->inbox, head, req));
+
+    if (!head) {
+        /* The inbox was empty, wake up the owner */
+        GSource* source = g_idle_source_new();
+
+        g_source_set_priority(source, G_PRIORITY_DEFAULT);
+        g_source_set_callback(source, radio_base_drain_inbox,
+            g_object_ref(self), g_object_unref);
+        g_source_attach(source, priv->context);
+        g_source_unref(source);
+    }
+}
+
 gboolean
 radio_base_retry_request(
     RadioBase* self,
@@ -618,6 +892,8 @@ radio_base_retry_request(
         g_hash_table_remove(priv->pending, KEY(req->serial2));
         radio_base_cancel_request(self, req);
         req->retry_count++;
+        priv->stats.retries++;
+        RADIO_PROBE3(request_retry, req->serial, req->code, req->retry_count);
         radio_base_queue_request(priv, req);
         if (radio_base_submit_queued_requests(self)) {
             radio_base_reset_timeout(self);
@@ -657,7 +933,7 @@ radio_base_reset_timeout(
 
     if (g_hash_table_size(priv->active)) {
         GHashTableIter it;
-        const gint64 now = g_get_monotonic_time();
+        const gint64 now = radio_base_priv_now(priv);
         gint64 next_wakeup = 0;
         gpointer value;
 
@@ -670,6 +946,7 @@ radio_base_reset_timeout(
         while (g_hash_table_iter_next(&it, NULL, &value)) {
             RadioRequest* req = value;
 
+            priv->stats.table_visits++;
             GVERBOSE_("%p %" G_GINT64_FORMAT " %" G_GINT64_FORMAT, req,
                 req->deadline, req->scheduled);
             if (!next_wakeup || next_wakeup > req->deadline) {
@@ -692,21 +969,15 @@ radio_base_reset_timeout(
                 (guint)(((next_wakeup - now) + 999)/1000) : 0;
 
             /* Start or restart the timer (should it be suspend-aware?) */
-            if (priv->timeout_id) {
-                g_source_remove(priv->timeout_id);
-            }
+            radio_base_stop_timer(priv);
             GVERBOSE("Next timeout check in %u ms", timeout_ms);
             priv->next_wakeup = next_wakeup;
-            priv->timeout_id = timeout_ms ?
-                g_timeout_add(timeout_ms, radio_base_timeout, self) :
-                g_idle_add(radio_base_timeout, self);
+            priv->timeout_id = priv->clock.timeout_add(priv->context,
+                timeout_ms, radio_base_timeout, self, priv->clock.user_data);
         }
     } else {
         /* No more pending requests, cancel the timeout */
-        if (priv->timeout_id) {
-            g_source_remove(priv->timeout_id);
-            priv->timeout_id = 0;
-        }
+        radio_base_stop_timer(priv);
     }
 }
 
@@ -784,7 +1055,8 @@ radio_base_handle_resp(
     RadioBase* self,
     guint32 code,
     const RadioResponseInfo* info,
-    const GBinderReader* reader)
+    const GBinderReader* reader,
+    GBinderRemoteRequest* msg)
 {
     RadioBasePriv* priv = self->priv;
     RadioRequest* req = g_hash_table_lookup(priv->active, KEY(info->serial));
@@ -792,6 +1064,8 @@ radio_base_handle_resp(
     if (req) {
         RadioRequestRetryFunc retry = req->retry;
 
+        RADIO_PROBE3(request_response, req->serial, code, info->error);
+
         /* Temporary ref */
         g_object_ref(self);
 
@@ -806,19 +1080,29 @@ radio_base_handle_resp(
             code, info->error, reader, req->user_data)) {
             /* Re-queue the request */
             req->retry_count++;
-            req->scheduled = g_get_monotonic_time() +
+            priv->stats.retries++;
+            RADIO_PROBE3(request_retry, req->serial, req->code,
+                req->retry_count);
+            req->scheduled = radio_base_priv_now(priv) +
                 MICROSEC(req->retry_delay_ms);
             radio_base_queue_request(priv, req);
         } else if (g_hash_table_steal(priv->active, KEY(info->serial))) {
             req->state = RADIO_REQUEST_STATE_DONE;
+            radio_base_request_done(priv, req);
+            RADIO_PROBE3(request_complete, req->serial, req->code,
+                RADIO_TX_STATUS_OK);
             radio_base_deactivate_request(self, req);
             radio_base_move_owner_queue(self);
             if (req->complete) {
                 RadioRequestCompleteFunc fn = req->complete;
+                GBinderRemoteRequest* prev = priv->resp_msg;
 
+                /* The message which owns the reader's data */
+                priv->resp_msg = msg;
                 req->complete = NULL;
                 fn(req, RADIO_TX_STATUS_OK, code, info->error, reader,
                     req->user_data);
+                priv->resp_msg = prev;
             }
             radio_request_unref(req);
         }
@@ -842,6 +1126,7 @@ radio_base_handle_ack(
 
     if (req) {
         GDEBUG("%08x acked", serial);
+        RADIO_PROBE1(request_acked, req->serial);
         req->acked = TRUE;
     } else {
         GWARN("%08x unexpected ack", serial);
@@ -863,6 +1148,7 @@ radio_base_handle_death(
      * build the list of dead requests.
      */
     priv->queue_first = priv->queue_last = NULL;
+    priv->batch_release = 0;
 
     /* Steal all active requests from the table */
     g_hash_table_remove_all(priv->pending);
@@ -909,12 +1195,56 @@ radio_base_cancel_request(
     RadioRequest* req)
 {
     req->scheduled = 0;
+    req->held = FALSE;
     if (req->tx_id) {
         RADIO_BASE_GET_CLASS(self)->cancel_request(self, req->tx_id);
         req->tx_id = 0;
     }
 }
 
+GMainContext*
+radio_base_context(
+    RadioBase* self)
+{
+    /* Caller checks object pointer for NULL */
+    return self->priv->context;
+}
+
+gint64
+radio_base_now(
+    RadioBase* self)
+{
+    /* Caller checks object pointer for NULL */
+    return radio_base_priv_now(self->priv);
+}
+
+GBinderRemoteRequest*
+radio_base_resp_message(
+    RadioBase* self)
+{
+    /* Caller checks object pointer for NULL */
+    return self->priv->resp_msg;
+}
+
+void
+radio_base_set_context(
+    RadioBase* self,
+    GMainContext* context)
+{
+    /* Caller checks object pointer for NULL */
+    RadioBasePriv* priv = self->priv;
+
+    if (priv->context != context) {
+        /* Move the timer to the new context */
+        radio_base_stop_timer(priv);
+        if (priv->context) {
+            g_main_context_unref(priv->context);
+        }
+        priv->context = context ? g_main_context_ref(context) : NULL;
+        radio_base_reset_timeout(self);
+    }
+}
+
 void
 radio_base_set_default_timeout(
     RadioBase* self,
@@ -937,6 +1267,7 @@ radio_base_set_default_timeout(
         while (g_hash_table_iter_next(&it, NULL, &value)) {
             RadioRequest* req = value;
 
+            priv->stats.table_visits++;
             if (!req->timeout_ms) {
                 /* This request is using the default timeout */
                 req->deadline += MICROSEC(delta);
@@ -950,6 +1281,91 @@ radio_base_set_default_timeout(
     }
 }
 
+void
+radio_base_set_power_save(
+    RadioBase* self,
+    gboolean power_save)
+{
+    /* Caller checks object pointer for NULL */
+    RadioBasePriv* priv = self->priv;
+
+    if (priv->power_save != power_save) {
+        priv->power_save = power_save;
+        if (!power_save && priv->batch_release) {
+            radio_base_release_batch(self, radio_base_priv_now(priv));
+            radio_base_submit_queued_requests(self);
+            radio_base_reset_timeout(self);
+        }
+    }
+}
+
+void
+radio_base_set_batch_window(
+    RadioBase* self,
+    guint ms)
+{
+    /* Caller checks object pointer for NULL. Applies to the next batch */
+    self->priv->batch_window_ms = ms ? ms : DEFAULT_BATCH_WINDOW_MS;
+}
+
+void
+radio_base_set_clock(
+    RadioBase* self,
+    const RadioBaseClock* clock)
+{
+    /* Caller checks object pointer for NULL */
+    RadioBasePriv* priv = self->priv;
+
+    /* Deadlines of the active requests are not converted */
+    radio_base_stop_timer(priv);
+    priv->clock = clock ? *clock : radio_base_default_clock;
+    radio_base_reset_timeout(self);
+}
+
+void
+radio_base_get_stats(
+    RadioBase* self,
+    RadioBaseStats* stats)
+{
+    RadioBasePriv* priv = self->priv;
+    const RadioRequest* req;
+
+    /* Caller checks both pointers for NULL */
+    *stats = priv->stats;
+    stats->queued = 0;
+    for (req = priv->queue_first; req; req = req->queue_next) {
+        stats->queued++;
+    }
+    stats->pending = g_hash_table_size(priv->pending);
+}
+
+RadioBaseLatency*
+radio_base_get_latency(
+    RadioBase* self,
+    guint* count)
+{
+    RadioBasePriv* priv = self->priv;
+    RadioBaseLatency* result = NULL;
+    guint n = 0;
+
+    /* Caller checks the object pointer for NULL */
+    if (priv->latency && g_hash_table_size(priv->latency)) {
+        GHashTableIter it;
+        gpointer value;
+
+        result = g_new(RadioBaseLatency, g_hash_table_size(priv->latency));
+        g_hash_table_iter_init(&it, priv->latency);
+        while (g_hash_table_iter_next(&it, NULL, &value)) {
+            result[n++] = *(RadioBaseLatency*)value;
+        }
+        qsort(result, n, sizeof(result[0]), radio_base_latency_compare);
+    }
+    if (count) {
+        *count = n;
+    }
+    return result;
+}
+
 gulong
 radio_base_add_owner_changed_handler(
     RadioBase* self,
@@ -981,6 +1397,8 @@ radio_base_init(
     priv->pending = g_hash_table_new_full(g_direct_hash, g_direct_equal,
         NULL, radio_request_unref_func);
     priv->default_timeout_ms = DEFAULT_PENDING_TIMEOUT_MS;
+    priv->batch_window_ms = DEFAULT_BATCH_WINDOW_MS;
+    priv->clock = radio_base_default_clock;
 }
 
 static
@@ -991,13 +1409,17 @@ radio_base_object_finalize(
     RadioBase* self = THIS(object);
     RadioBasePriv* priv = self->priv;
 
-    if (priv->timeout_id) {
-        g_source_remove(priv->timeout_id);
+    radio_base_stop_timer(priv);
+    if (priv->context) {
+        g_main_context_unref(priv->context);
     }
     g_hash_table_foreach(priv->requests, radio_base_detach_req, self);
     g_hash_table_destroy(priv->requests);
     g_hash_table_destroy(priv->active);
     g_hash_table_destroy(priv->pending);
+    if (priv->latency) {
+        g_hash_table_destroy(priv->latency);
+    }
     G_OBJECT_CLASS(PARENT_CLASS)->finalize(object);
 }
 
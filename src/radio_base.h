@@ -55,6 +55,41 @@ void
     RadioRequest* req,
     int status);
 
+/*
+ * Time source and timer backend. The default one is based on
+ * g_get_monotonic_time() and GLib timeouts, tests may replace
+ * it with a virtual clock.
+ */
+typedef struct radio_base_clock {
+    gint64 (*now)(gpointer user_data); /* Microseconds */
+    guint (*timeout_add)(GMainContext* context, guint ms, GSourceFunc func,
+        gpointer data, gpointer user_data);
+    void (*source_remove)(GMainContext* context, guint id,
+        gpointer user_data);
+    gpointer user_data;
+} RadioBaseClock;
+
+/* Counts elements looked at by the scheduler and request outcomes */
+typedef struct radio_base_stats {
+    guint64 queue_visits;       /* Queued requests */
+    guint64 table_visits;       /* Active and pending table entries */
+    guint64 submitted;          /* Transactions, including retries */
+    guint64 completed;          /* Requests completed with a response */
+    guint64 failed;             /* Requests failed, including timeouts */
+    guint64 timeouts;           /* Requests which didn't get a response */
+    guint64 retries;            /* Requests re-queued for another attempt */
+    guint queued;               /* Current queue depth */
+    guint pending;              /* Requests waiting for a response */
+} RadioBaseStats;
+
+/* Time from the first transaction to the response, per request code */
+typedef struct radio_base_latency {
+    guint code;
+    guint count;
+    guint max_usec;
+    guint64 total_usec;
+} RadioBaseLatency;
+
 typedef struct radio_base_priv RadioBasePriv;
 
 struct radio_base {
@@ -104,6 +139,12 @@ radio_base_submit_request(
     RadioRequest* req)
     RADIO_INTERNAL;
 
+void
+radio_base_post_request(
+    RadioBase* base,
+    RadioRequest* req)
+    RADIO_INTERNAL;
+
 gboolean
 radio_base_retry_request(
     RadioBase* base,
@@ -149,7 +190,8 @@ radio_base_handle_resp(
     RadioBase* base,
     guint32 code,
     const RadioResponseInfo* info,
-    const GBinderReader* reader)
+    const GBinderReader* reader,
+    GBinderRemoteRequest* msg)
     RADIO_INTERNAL;
 
 void
@@ -174,12 +216,66 @@ radio_base_cancel_request(
     RadioRequest* req)
     RADIO_INTERNAL;
 
+GMainContext*
+radio_base_context(
+    RadioBase* base)
+    RADIO_INTERNAL;
+
+/* Monotonic time in microseconds, according to the object's clock */
+gint64
+radio_base_now(
+    RadioBase* base)
+    RADIO_INTERNAL;
+
+GBinderRemoteRequest*
+radio_base_resp_message(
+    RadioBase* base)
+    RADIO_INTERNAL;
+
+void
+radio_base_set_context(
+    RadioBase* base,
+    GMainContext* context)
+    RADIO_INTERNAL;
+
 void
 radio_base_set_default_timeout(
     RadioBase* self,
     int ms)
     RADIO_INTERNAL;
 
+/* Background requests are held in power save */
+void
+radio_base_set_power_save(
+    RadioBase* base,
+    gboolean power_save)
+    RADIO_INTERNAL;
+
+void
+radio_base_set_batch_window(
+    RadioBase* base,
+    guint ms) /* Zero for the default */
+    RADIO_INTERNAL;
+
+void
+radio_base_set_clock(
+    RadioBase* base,
+    const RadioBaseClock* clock) /* NULL for the default one */
+    RADIO_INTERNAL;
+
+void
+radio_base_get_stats(
+    RadioBase* base,
+    RadioBaseStats* stats)
+    RADIO_INTERNAL;
+
+/* Sorted by code, free with g_free() */
+RadioBaseLatency*
+radio_base_get_latency(
+    RadioBase* base,
+    guint* count)
+    RADIO_INTERNAL;
+
 gulong
 radio_base_add_owner_changed_handler(
     RadioBase* base,
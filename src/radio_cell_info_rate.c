@@ -0,0 +1,292 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#define GLIB_DISABLE_DEPRECATION_WARNINGS
+
+#include "radio_cell_info_rate.h"
+#include "radio_client_p.h"
+#include "radio_instance_p.h"
+#include "radio_network_types.h"
+#include "radio_request.h"
+#include "radio_util_p.h"
+#include "radio_log.h"
+
+#include <gbinder.h>
+
+#include <gutil_macros.h>
+
+#include <limits.h>
+
+/* This API exists since 1.6.7 */
+
+/* INT_MAX tells the modem to never send cellInfoList */
+#define RADIO_CELL_INFO_RATE_DISABLED INT_MAX
+#define RADIO_CELL_INFO_RATE_UNKNOWN (-1)
+
+struct radio_cell_info_rate {
+    gint refcount;
+    RadioClient* client;
+    GMainContext* context;
+    RADIO_REQ req;              /* Zero if not supported */
+    GHashTable* subs;           /* id => max interval */
+    guint idle_timeout_ms;
+    gint rate;                  /* Last programmed one */
+    gulong connected_id;
+    guint update_id;
+    guint last_id;
+};
+
+/*==========================================================================*
+ * Implementation
+ *==========================================================================*/
+
+static
+gint
+radio_cell_info_rate_wanted(
+    RadioCellInfoRate* self)
+{
+    gint rate = RADIO_CELL_INFO_RATE_DISABLED;
+    GHashTableIter it;
+    gpointer value;
+
+    /* The most demanding subscriber wins */
+    g_hash_table_iter_init(&it, self->subs);
+    while (g_hash_table_iter_next(&it, NULL, &value)) {
+        rate = MIN(rate, (gint)MIN(GPOINTER_TO_UINT(value),
+            RADIO_CELL_INFO_RATE_DISABLED - 1));
+    }
+    return rate;
+}
+
+static
+void
+radio_cell_info_rate_complete(
+    RadioRequest* req,
+    RADIO_TX_STATUS status,
+    RADIO_RESP resp,
+    RADIO_ERROR error,
+    const GBinderReader* args,
+    gpointer user_data)
+{
+    if (status != RADIO_TX_STATUS_OK) {
+        GWARN("Failed to set cell info rate (tx status %d)", status);
+    } else if (error != RADIO_ERROR_NONE) {
+        GWARN("Failed to set cell info rate (error %d)", error);
+    }
+}
+
+static
+gboolean
+radio_cell_info_rate_update(
+    gpointer user_data)
+{
+    RadioCellInfoRate* self = user_data;
+    GBinderWriter writer;
+    RadioRequest* req;
+
+    self->update_id = 0;
+    self->rate = radio_cell_info_rate_wanted(self);
+    if (self->rate == RADIO_CELL_INFO_RATE_DISABLED) {
+        GDEBUG("Disabling cell info");
+    } else {
+        GDEBUG("Cell info rate %d ms", self->rate);
+    }
+
+    req = radio_request_new(self->client, self->req, &writer,
+        radio_cell_info_rate_complete, NULL, NULL);
+    gbinder_writer_append_int32(&writer, self->rate);
+    radio_request_submit(req);
+    radio_request_unref(req);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+radio_cell_info_rate_check(
+    RadioCellInfoRate* self)
+{
+    const gint rate = radio_cell_info_rate_wanted(self);
+
+    /* Subscriptions tend to come and go in bunches, coalesce the updates */
+    if (self->update_id) {
+        radio_source_remove(self->context, self->update_id);
+        self->update_id = 0;
+    }
+    if (rate != self->rate && radio_client_connected(self->client)) {
+        self->update_id = radio_timeout_add(self->context,
+            (rate == RADIO_CELL_INFO_RATE_DISABLED) ?
+            self->idle_timeout_ms : 0, radio_cell_info_rate_update, self);
+    }
+}
+
+static
+void
+radio_cell_info_rate_connected(
+    RadioClient* client,
+    gpointer user_data)
+{
+    RadioCellInfoRate* self = user_data;
+
+    /* Don't assume anything about the modem's state */
+    self->rate = RADIO_CELL_INFO_RATE_UNKNOWN;
+    radio_cell_info_rate_check(self);
+}
+
+static
+void
+radio_cell_info_rate_free(
+    RadioCellInfoRate* self)
+{
+    if (self->update_id) {
+        radio_source_remove(self->context, self->update_id);
+    }
+    radio_client_remove_handler(self->client, self->connected_id);
+    radio_client_unref(self->client);
+    g_hash_table_destroy(self->subs);
+    gutil_slice_free(self);
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+RadioCellInfoRate*
+radio_cell_info_rate_new(
+    RadioClient* client)
+{
+    if (G_LIKELY(client)) {
+        RadioCellInfoRate* self = g_slice_new0(RadioCellInfoRate);
+
+        g_atomic_int_set(&self->refcount, 1);
+        self->client = radio_client_ref(client);
+        self->context = radio_instance_context(radio_client_instance(client));
+        self->subs = g_hash_table_new(g_direct_hash, g_direct_equal);
+        self->idle_timeout_ms = RADIO_CELL_INFO_RATE_DEFAULT_IDLE_TIMEOUT_MS;
+        self->rate = RADIO_CELL_INFO_RATE_UNKNOWN;
+        switch (radio_client_aidl_interface(client)) {
+        case RADIO_AIDL_INTERFACE_NONE:
+            self->req = RADIO_REQ_SET_CELL_INFO_LIST_RATE;
+            break;
+        case RADIO_NETWORK_INTERFACE:
+            self->req = RADIO_NETWORK_REQ_SET_CELL_INFO_LIST_RATE;
+            break;
+        default:
+            break;
+        }
+        if (self->req) {
+            self->connected_id = radio_client_add_connected_handler(client,
+                radio_cell_info_rate_connected, self);
+            radio_cell_info_rate_check(self);
+        }
+        return self;
+    }
+    return NULL;
+}
+
+RadioCellInfoRate*
+radio_cell_info_rate_ref(
+    RadioCellInfoRate* self)
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->refcount > 0);
+        g_atomic_int_inc(&self->refcount);
+    }
+    return self;
+}
+
+void
+radio_cell_info_rate_unref(
+    RadioCellInfoRate* self)
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->refcount > 0);
+        if (g_atomic_int_dec_and_test(&self->refcount)) {
+            radio_cell_info_rate_free(self);
+        }
+    }
+}
+
+void
+radio_cell_info_rate_set_idle_timeout(
+    RadioCellInfoRate* self,
+    guint ms)
+{
+    if (G_LIKELY(self) && self->idle_timeout_ms != ms) {
+        self->idle_timeout_ms = ms;
+        if (self->req) {
+            /* Restarts the pending timeout, if any */
+            radio_cell_info_rate_check(self);
+        }
+    }
+}
+
+guint
+radio_cell_info_rate_add(
+    RadioCellInfoRate* self,
+    guint max_interval_ms)
+{
+    if (G_LIKELY(self) && self->req) {
+        /* Zero is never a valid id */
+        do {
+            self->last_id++;
+        } while (!self->last_id || g_hash_table_contains(self->subs,
+            GUINT_TO_POINTER(self->last_id)));
+
+        g_hash_table_insert(self->subs, GUINT_TO_POINTER(self->last_id),
+            GUINT_TO_POINTER(max_interval_ms));
+        radio_cell_info_rate_check(self);
+        return self->last_id;
+    }
+    return 0;
+}
+
+void
+radio_cell_info_rate_remove(
+    RadioCellInfoRate* self,
+    guint id)
+{
+    if (G_LIKELY(self) && id &&
+        g_hash_table_remove(self->subs, GUINT_TO_POINTER(id))) {
+        radio_cell_info_rate_check(self);
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -36,7 +36,7 @@
  */
 
 #include "radio_base.h"
-#include "radio_client.h"
+#include "radio_client_p.h"
 #include "radio_instance_p.h"
 #include "radio_request_p.h"
 #include "radio_util.h"
@@ -60,6 +60,7 @@ struct radio_client {
     RadioBase base;
     RadioInstance* instance;
     gulong event_ids[RADIO_EVENT_COUNT];
+    gboolean power_save;
 };
 
 typedef RadioBaseClass RadioClientClass;
@@ -75,6 +76,12 @@ typedef struct radio_client_call {
     RadioBaseRequestSentFunc callback;
 } RadioClientCall;
 
+/* Attached to the indication handler closures */
+typedef struct radio_client_ind_interest {
+    RadioInstance* instance;
+    RADIO_IND code;
+} RadioClientIndInterest;
+
 enum radio_client_signal {
     SIGNAL_INDICATION,
     SIGNAL_DEATH,
@@ -101,6 +108,19 @@ radio_client_call_free(
     gutil_slice_free(call);
 }
 
+static
+void
+radio_client_ind_interest_free(
+    gpointer data,
+    GClosure* closure)
+{
+    RadioClientIndInterest* interest = data;
+
+    radio_instance_ind_interest_unref(interest->instance, interest->code);
+    radio_instance_unref(interest->instance);
+    gutil_slice_free(interest);
+}
+
 static
 void
 radio_client_call_destroy(
@@ -180,7 +200,8 @@ radio_client_handle_resp(
     const GBinderReader* reader,
     gpointer user_data)
 {
-    if (!radio_base_handle_resp(RADIO_BASE(user_data), code, info, reader)) {
+    if (!radio_base_handle_resp(RADIO_BASE(user_data), code, info, reader,
+        radio_instance_resp_message(instance))) {
         const char* name = radio_resp_name2(instance, code);
 
         /* Most likely this is a response to a cancelled request */
@@ -202,6 +223,17 @@ radio_client_add_handler(
              g_cclosure_new(G_CALLBACK(fn), user_data, NULL), FALSE) : 0;
 }
 
+/*==========================================================================*
+ * Internal API
+ *==========================================================================*/
+
+RadioInstance*
+radio_client_instance(
+    RadioClient* self)
+{
+    return G_LIKELY(self) ? self->instance : NULL;
+}
+
 /*==========================================================================*
  * API
  *==========================================================================*/
@@ -215,9 +247,10 @@ radio_client_new(
     if (G_LIKELY(instance)) {
         self = g_object_new(THIS_TYPE, NULL);
         radio_base_initialize(&self->base);
+        radio_base_set_context(&self->base, radio_instance_context(instance));
         self->instance = radio_instance_ref(instance);
         self->event_ids[RADIO_EVENT_IND] =
-            radio_instance_add_indication_observer(instance, RADIO_IND_ANY,
+            radio_instance_add_indication_relay(instance,
                 radio_client_handle_ind, self);
         self->event_ids[RADIO_EVENT_RESP] =
             radio_instance_add_response_observer(instance, RADIO_RESP_ANY,
@@ -323,6 +356,32 @@ radio_client_set_default_timeout(
     }
 }
 
+void
+radio_client_set_power_save(
+    RadioClient* self,
+    gboolean power_save) /* Since 1.6.7 */
+{
+    if (G_LIKELY(self) && self->power_save != power_save) {
+        self->power_save = power_save;
+        radio_base_set_power_save(&self->base, power_save);
+        if (power_save) {
+            radio_instance_power_save_ref(self->instance);
+        } else {
+            radio_instance_power_save_unref(self->instance);
+        }
+    }
+}
+
+void
+radio_client_set_batch_window(
+    RadioClient* self,
+    guint milliseconds) /* Since 1.6.7 */
+{
+    if (G_LIKELY(self)) {
+        radio_base_set_batch_window(&self->base, milliseconds);
+    }
+}
+
 gulong
 radio_client_add_indication_handler(
     RadioClient* self,
@@ -330,11 +389,25 @@ radio_client_add_indication_handler(
     RadioClientIndicationFunc fn,
     gpointer user_data)
 {
-    return (G_LIKELY(self) && G_LIKELY(fn)) ?
-        g_signal_connect_closure_by_id(self,
+    if (G_LIKELY(self) && G_LIKELY(fn)) {
+        RadioClientIndInterest* interest =
+            g_slice_new(RadioClientIndInterest);
+        GClosure* closure = g_cclosure_new(G_CALLBACK(fn), user_data, NULL);
+
+        /*
+         * The interest is dropped when the closure is finalized, which
+         * may happen after the client is gone, hence the instance ref.
+         */
+        interest->instance = radio_instance_ref(self->instance);
+        interest->code = code;
+        radio_instance_ind_interest_ref(interest->instance, code);
+        g_closure_add_finalize_notifier(closure, interest,
+            radio_client_ind_interest_free);
+        return g_signal_connect_closure_by_id(self,
             radio_client_signals[SIGNAL_INDICATION],
-            radio_instance_ind_quark(self->instance, code),
-            g_cclosure_new(G_CALLBACK(fn), user_data, NULL), FALSE) : 0;
+            radio_instance_ind_quark(self->instance, code), closure, FALSE);
+    }
+    return 0;
 }
 
 gulong
@@ -425,9 +498,16 @@ radio_client_send_request(
 
     call->callback = callback;
     call->req = radio_request_ref(req);
-    tx_id = radio_instance_send_request(THIS(base)->instance,
-        req->code, req->args, radio_client_call_complete,
-        radio_client_call_destroy, base, call);
+    if (req->serial2 != req->serial) {
+        /* Let the recorder link the retry to the original request */
+        tx_id = radio_instance_resend_request(THIS(base)->instance,
+            req->code, req->serial, req->args, radio_client_call_complete,
+            radio_client_call_destroy, base, call);
+    } else {
+        tx_id = radio_instance_send_request(THIS(base)->instance,
+            req->code, req->args, radio_client_call_complete,
+            radio_client_call_destroy, base, call);
+    }
     if (tx_id) {
         return tx_id;
     } else {
@@ -463,6 +543,9 @@ radio_client_finalize(
 {
     RadioClient* self = THIS(object);
 
+    if (self->power_save) {
+        radio_instance_power_save_unref(self->instance);
+    }
     radio_instance_remove_all_handlers(self->instance, self->event_ids);
     radio_instance_unref(self->instance);
     G_OBJECT_CLASS(PARENT_CLASS)->finalize(object);
@@ -37,9 +37,13 @@
 
 #include "radio_base.h"
 #include "radio_config.h"
+#include "radio_ind_meter_p.h"
 #include "radio_log.h"
+#include "radio_probe_p.h"
+#include "radio_recorder_p.h"
 #include "radio_request_p.h"
 #include "radio_util_p.h"
+#include "radio_version_cache_p.h"
 
 #include <gbinder.h>
 
@@ -65,6 +69,10 @@ struct radio_config {
     GHashTable* ind_quarks;
     gulong death_id;
     gboolean dead;
+    RadioRecorder* recorder;
+    gulong recorder_id[3];
+    guint32 resend_serial; /* Original serial of the request being resent */
+    RadioIndMeter* ind_meter;
 };
 
 typedef RadioBaseClass RadioConfigClass;
@@ -354,6 +362,48 @@ static const RadioConfigInterfaceDesc radio_config_aidl_interfaces[] = {
 G_STATIC_ASSERT(G_N_ELEMENTS(radio_config_aidl_interfaces) ==
     RADIO_CONFIG_AIDL_INTERFACE_COUNT);
 
+typedef struct radio_config_family {
+    RadioConfig** instances;
+    const RadioConfigInterfaceDesc* interfaces;
+    gsize num_interfaces;
+    const char* dev;
+} RadioConfigFamily;
+
+static const RadioConfigFamily radio_config_families[] = {
+    {
+        radio_config_instance,
+        radio_config_interfaces,
+        G_N_ELEMENTS(radio_config_interfaces),
+        GBINDER_DEFAULT_HWBINDER
+    },{
+        radio_config_aidl_instance,
+        radio_config_aidl_interfaces,
+        G_N_ELEMENTS(radio_config_aidl_interfaces),
+        GBINDER_DEFAULT_BINDER
+    }
+};
+
+typedef struct radio_config_new_op {
+    gulong id;
+    const RadioConfigFamily* family;
+    RADIO_CONFIG_INTERFACE max_version;
+    gsize next;
+    GBinderServiceManager* sm;
+    gulong sm_call_id;
+    RadioConfig* config;
+    gulong tx_id;
+    GMainContext* context;
+    guint idle_id;
+    RadioConfigFunc func;
+    GDestroyNotify destroy;
+    gpointer user_data;
+} RadioConfigNewOp;
+
+#define RADIO_CONFIG_CACHE_KEY "IRadioConfig"
+
+static GSList* radio_config_new_ops = NULL;
+static gulong radio_config_new_last_id = 0;
+
 /*==========================================================================*
  * Implementation
  *==========================================================================*/
@@ -380,6 +430,33 @@ radio_config_call_complete(
     call->callback(call->object, call->req, status);
 }
 
+static
+const char*
+radio_config_req_name_cb(
+    gconstpointer desc,
+    guint code)
+{
+    return ((const RadioConfigInterfaceDesc*)desc)->req_name(code);
+}
+
+static
+const char*
+radio_config_resp_name_cb(
+    gconstpointer desc,
+    guint code)
+{
+    return ((const RadioConfigInterfaceDesc*)desc)->resp_name(code);
+}
+
+static
+const char*
+radio_config_ind_name_cb(
+    gconstpointer desc,
+    guint code)
+{
+    return ((const RadioConfigInterfaceDesc*)desc)->ind_name(code);
+}
+
 static
 GQuark
 radio_config_quark(
@@ -468,11 +545,20 @@ radio_config_indication(
             const guint* signals = radio_config_signals +
                 SIGNAL_OBSERVE_INDICATION_0;
 
+            if (self->ind_meter) {
+                gsize size = 0;
+
+                gbinder_reader_get_data(&args, &size);
+                radio_ind_meter_add(self->ind_meter, code, size,
+                    g_get_monotonic_time());
+            }
+            RADIO_PROBE1(config_indication, code);
             for (i = RADIO_OBSERVER_PRIORITY_COUNT - 1; i >=0; i--) {
                 if (signals[i]) {
                     g_signal_emit(self, signals[i], quark, code, &args);
                 }
             }
+            RADIO_PROBE1(config_indication_done, code);
             *status = GBINDER_STATUS_OK;
         } else {
             GWARN("Failed to decode IRadioConfig indication %u", code);
@@ -515,6 +601,7 @@ radio_config_response(
         const guint* signals = radio_config_signals +
             SIGNAL_OBSERVE_RESPONSE_0;
 
+        RADIO_PROBE2(config_response, code, info->serial);
         radio_config_ref(self);
 
         /* High-priority observers get notified first */
@@ -527,7 +614,7 @@ radio_config_response(
         }
 
         /* Then the response is actually processed */
-        if (!radio_base_handle_resp(&self->base, code, info, &args)) {
+        if (!radio_base_handle_resp(&self->base, code, info, &args, req)) {
             const char* name = desc->resp_name(code);
 
             /* Most likely this is a response to a cancelled request */
@@ -543,6 +630,7 @@ radio_config_response(
                 g_signal_emit(self, signals[i], quark, code, info, &args);
             }
         }
+        RADIO_PROBE1(config_response_done, code);
         radio_config_unref(self);
         *status = GBINDER_STATUS_OK;
     }
@@ -609,15 +697,12 @@ radio_config_died(
 
 static
 RadioConfig*
-radio_config_create(
+radio_config_new_desc(
     GBinderServiceManager* sm,
     GBinderRemoteObject* remote,
     const RadioConfigInterfaceDesc* desc)
 {
     RadioConfig* self = g_object_new(THIS_TYPE, NULL);
-    GBinderLocalRequest* req;
-    GBinderWriter writer;
-    int status;
 
     GDEBUG("Using %s config api", desc->api_name);
     radio_base_initialize(&self->base);
@@ -634,6 +719,18 @@ radio_config_create(
 
     gbinder_local_object_set_stability(self->indication, desc->stability);
     gbinder_local_object_set_stability(self->response, desc->stability);
+    return self;
+}
+
+static
+GBinderLocalRequest*
+radio_config_set_response_functions_req(
+    RadioConfig* self)
+{
+    const RadioConfigInterfaceDesc* desc = self->desc;
+    GBinderLocalRequest* req = gbinder_client_new_request2(self->client,
+        desc->set_response_functions_req);
+    GBinderWriter writer;
 
     /*
      * IRadioConfig.hal:
@@ -644,11 +741,23 @@ radio_config_create(
      * void setResponseFunctions(in IRadioConfigResponse radioConfigResponse,
      *     in IRadioConfigIndication radioConfigIndication);
      */
-    req = gbinder_client_new_request2(self->client,
-        desc->set_response_functions_req);
     gbinder_local_request_init_writer(req, &writer);
     gbinder_writer_append_local_object(&writer, self->response);
     gbinder_writer_append_local_object(&writer, self->indication);
+    return req;
+}
+
+static
+RadioConfig*
+radio_config_create(
+    GBinderServiceManager* sm,
+    GBinderRemoteObject* remote,
+    const RadioConfigInterfaceDesc* desc)
+{
+    RadioConfig* self = radio_config_new_desc(sm, remote, desc);
+    GBinderLocalRequest* req = radio_config_set_response_functions_req(self);
+    int status;
+
     gbinder_remote_reply_unref(gbinder_client_transact_sync_reply(self->client,
         desc->set_response_functions_req, req, &status));
     GVERBOSE_("IRadioConfig::setResponseFunctions status %d", status);
@@ -656,6 +765,277 @@ radio_config_create(
     return self;
 }
 
+static
+void
+radio_config_reset_response_functions(
+    RadioConfig* self)
+{
+    GBinderLocalRequest* req = radio_config_set_response_functions_req(self);
+
+    /* Goes after whatever has already completed */
+    gbinder_client_transact(self->client,
+        self->desc->set_response_functions_req, 0, req, NULL, NULL, NULL);
+    gbinder_local_request_unref(req);
+}
+
+static
+void
+radio_config_share(
+    RadioConfig* self,
+    RadioConfig** instances)
+{
+    *(self->shared = instances + self->desc->version) = self;
+    g_object_weak_ref(G_OBJECT(self), radio_config_gone, self->shared);
+}
+
+static
+const RadioConfigFamily*
+radio_config_family(
+    RADIO_INTERFACE_TYPE interface_type,
+    RADIO_CONFIG_INTERFACE* max_version)
+{
+    if (interface_type == RADIO_INTERFACE_TYPE_HIDL) {
+        /* Validate the requested version to avoid out-of-bounds access */
+        if (*max_version < RADIO_CONFIG_INTERFACE_1_0) {
+            *max_version = RADIO_CONFIG_INTERFACE_1_0;
+        } else if (*max_version > RADIO_CONFIG_INTERFACE_MAX) {
+            *max_version = RADIO_CONFIG_INTERFACE_MAX;
+        }
+        return radio_config_families + 0;
+    } else if (interface_type == RADIO_INTERFACE_TYPE_AIDL) {
+        /* Only RADIO_CONFIG_AIDL_INTERFACE_1 is supported for now */
+        *max_version = RADIO_CONFIG_AIDL_INTERFACE_1;
+        return radio_config_families + 1;
+    } else {
+        GWARN("Wrong interface_type %d (neither HIDL nor AIDL)", interface_type);
+        return NULL;
+    }
+}
+
+static
+void
+radio_config_new_op_free(
+    RadioConfigNewOp* op)
+{
+    if (op->sm_call_id) {
+        gbinder_servicemanager_cancel(op->sm, op->sm_call_id);
+    }
+    if (op->tx_id) {
+        gbinder_client_cancel(op->config->client, op->tx_id);
+    }
+    if (op->idle_id) {
+        radio_source_remove(op->context, op->idle_id);
+    }
+    if (op->destroy) {
+        op->destroy(op->user_data);
+    }
+    gbinder_servicemanager_unref(op->sm);
+    radio_config_unref(op->config);
+    g_main_context_unref(op->context);
+    gutil_slice_free(op);
+}
+
+static
+void
+radio_config_new_op_complete(
+    RadioConfigNewOp* op)
+{
+    radio_config_new_ops = g_slist_remove(radio_config_new_ops, op);
+    op->sm_call_id = 0;
+    op->tx_id = 0;
+    op->idle_id = 0;
+    op->func(op->config, op->user_data);
+    radio_config_new_op_free(op);
+}
+
+static
+gboolean
+radio_config_new_op_idle(
+    gpointer user_data)
+{
+    RadioConfigNewOp* op = user_data;
+
+    op->idle_id = 0;
+    radio_config_new_op_complete(op);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+radio_config_new_op_tx_done(
+    GBinderClient* client,
+    GBinderRemoteReply* reply,
+    int status,
+    void* user_data)
+{
+    RadioConfigNewOp* op = user_data;
+    RadioConfig* config = op->config;
+    RadioConfig** instances = op->family->instances;
+    RadioConfig* existing = instances[config->desc->version];
+
+    GVERBOSE_("IRadioConfig::setResponseFunctions status %d", status);
+    op->tx_id = 0;
+    if (existing) {
+        /*
+         * Someone else got there while we were waiting. Our own
+         * setResponseFunctions may have landed after theirs and
+         * redirected the callbacks to the objects which are about
+         * to be dropped. Point the remote back to the shared ones.
+         */
+        radio_config_reset_response_functions(existing);
+        op->config = radio_config_ref(existing);
+        radio_config_unref(config);
+    } else if (status == GBINDER_STATUS_OK) {
+        /* Only now it's ready to be shared */
+        radio_config_share(config, instances);
+    } else {
+        GWARN("IRadioConfig::setResponseFunctions failed (status %d)",
+            status);
+        op->config = NULL;
+        radio_config_unref(config);
+    }
+    radio_config_new_op_complete(op);
+}
+
+static
+gboolean
+radio_config_new_op_next(
+    RadioConfigNewOp* op);
+
+static
+void
+radio_config_new_op_get_service_done(
+    GBinderServiceManager* sm,
+    GBinderRemoteObject* obj,
+    int status,
+    void* user_data)
+{
+    RadioConfigNewOp* op = user_data;
+    const RadioConfigInterfaceDesc* desc = op->family->interfaces + op->next;
+    RadioConfig** instances = op->family->instances;
+
+    op->sm_call_id = 0;
+    if (!obj) {
+        op->next++;
+        if (!radio_config_new_op_next(op)) {
+            radio_config_new_op_complete(op);
+        }
+    } else if (instances[desc->version]) {
+        /* desc->version isn't necessarily equal to max_version */
+        op->config = radio_config_ref(instances[desc->version]);
+        radio_config_new_op_complete(op);
+    } else {
+        RadioConfig* config;
+        GBinderLocalRequest* req;
+
+        GINFO("Connected to %s", desc->fqname);
+        config = op->config = radio_config_new_desc(sm, obj, desc);
+
+        /*
+         * It's not shared until setResponseFunctions completes, so the
+         * operation holds the only reference and the transaction can be
+         * safely cancelled.
+         */
+        req = radio_config_set_response_functions_req(config);
+        op->tx_id = gbinder_client_transact(config->client,
+            desc->set_response_functions_req, 0, req,
+            radio_config_new_op_tx_done, NULL, op);
+        gbinder_local_request_unref(req);
+        if (!op->tx_id) {
+            GWARN("Failed to submit IRadioConfig::setResponseFunctions");
+            op->config = NULL;
+            radio_config_unref(config);
+            radio_config_new_op_complete(op);
+        }
+    }
+}
+
+static
+gboolean
+radio_config_new_op_next(
+    RadioConfigNewOp* op)
+{
+    const RadioConfigFamily* family = op->family;
+
+    /* Find maximum available version not exceeding the requested one */
+    while (op->next < family->num_interfaces) {
+        const RadioConfigInterfaceDesc* desc = family->interfaces + op->next;
+
+        if (desc->version <= op->max_version) {
+            op->sm_call_id = gbinder_servicemanager_get_service(op->sm,
+                desc->fqname, radio_config_new_op_get_service_done, op);
+            if (op->sm_call_id) {
+                return TRUE;
+            }
+        }
+        op->next++;
+    }
+    return FALSE;
+}
+
+static
+void
+radio_config_record_init(
+    RadioConfig* self,
+    RadioRecord* rec,
+    RADIO_RECORD_TYPE type,
+    guint code)
+{
+    memset(rec, 0, sizeof(*rec));
+    rec->type = type;
+    rec->flags = RADIO_RECORD_FLAG_CONFIG;
+    rec->interface_type = self->desc->interface_type;
+    rec->interface = self->desc->version;
+    rec->code = code;
+}
+
+static
+void
+radio_config_record_request(
+    RadioConfig* self,
+    RADIO_CONFIG_REQ code,
+    GBinderLocalRequest* args,
+    gpointer recorder)
+{
+    RadioRecord rec;
+
+    radio_config_record_init(self, &rec, RADIO_RECORD_REQUEST, code);
+    rec.extra = (gint32) self->resend_serial;
+    radio_recorder_add_request(recorder, &rec, args,
+        radio_config_rpc_header_size(self, code));
+}
+
+static
+void
+radio_config_record_response(
+    RadioConfig* self,
+    RADIO_CONFIG_RESP code,
+    const RadioResponseInfo* info,
+    const GBinderReader* args,
+    gpointer recorder)
+{
+    RadioRecord rec;
+
+    radio_config_record_init(self, &rec, RADIO_RECORD_RESPONSE, code);
+    rec.serial = info->serial;
+    rec.extra = info->error;
+    radio_recorder_add_reader(recorder, &rec, args);
+}
+
+static
+void
+radio_config_record_indication(
+    RadioConfig* self,
+    RADIO_CONFIG_IND code,
+    const GBinderReader* args,
+    gpointer recorder)
+{
+    RadioRecord rec;
+
+    radio_config_record_init(self, &rec, RADIO_RECORD_INDICATION, code);
+    radio_recorder_add_reader(recorder, &rec, args);
+}
+
 /*==========================================================================*
  * API
  *==========================================================================*/
@@ -680,74 +1060,73 @@ radio_config_new_with_version_and_interface_type(
     RADIO_CONFIG_INTERFACE max_version,
     RADIO_INTERFACE_TYPE interface_type)
 {
-    static RadioConfig** instances = NULL;
-    const RadioConfigInterfaceDesc* interfaces = NULL;
-    gsize num_interfaces = 0;
-    const char* binder_device = GBINDER_DEFAULT_HWBINDER;
+    const RadioConfigFamily* family = radio_config_family(interface_type,
+        &max_version);
 
-    if (interface_type == RADIO_INTERFACE_TYPE_HIDL) {
-        /* Validate the requested version to avoid out-of-bounds access */
-        if (max_version < RADIO_CONFIG_INTERFACE_1_0) {
-            max_version = RADIO_CONFIG_INTERFACE_1_0;
-        } else if (max_version > RADIO_CONFIG_INTERFACE_MAX) {
-            max_version = RADIO_CONFIG_INTERFACE_MAX;
-        }
-        instances = radio_config_instance;
-        interfaces = radio_config_interfaces;
-        num_interfaces = G_N_ELEMENTS(radio_config_interfaces);
-    } else if (interface_type == RADIO_INTERFACE_TYPE_AIDL) {
-        /* Only RADIO_CONFIG_AIDL_INTERFACE_1 is supported for now */
-        max_version = RADIO_CONFIG_AIDL_INTERFACE_1;
-        binder_device = GBINDER_DEFAULT_BINDER;
-        instances = radio_config_aidl_instance;
-        interfaces = radio_config_aidl_interfaces;
-        num_interfaces = G_N_ELEMENTS(radio_config_aidl_interfaces);
-    } else {
-        GWARN("Wrong interface_type %d (neither HIDL nor AIDL)", interface_type);
+    if (!family) {
         return NULL;
-    }
-
-    if (instances[max_version]) {
+    } else if (family->instances[max_version]) {
         /* The requested instance already exists */
-        return radio_config_ref(instances[max_version]);
+        return radio_config_ref(family->instances[max_version]);
     } else {
         /* Assume /dev/hwbinder for HIDL, /dev/binder for AIDL */
-        GBinderServiceManager* sm =
-            gbinder_servicemanager_new(binder_device);
+        GBinderServiceManager* sm = gbinder_servicemanager_new(family->dev);
 
         if (sm) {
-            guint i;
+            RadioConfig** instances = family->instances;
+            const char* names[RADIO_CONFIG_INTERFACE_COUNT];
+            const RadioConfigInterfaceDesc* descs[RADIO_CONFIG_INTERFACE_COUNT];
+            guint order[RADIO_CONFIG_INTERFACE_COUNT];
+            guint i, n = 0;
             GBinderRemoteObject* obj = NULL; /* autoreleased */
             const RadioConfigInterfaceDesc* desc;
             RadioConfig* config = NULL;
 
             /* Find maximum available version not exceeding the requested one */
-            for (i=0; i<num_interfaces && !obj; i++) {
-                desc = interfaces + i;
+            for (i=0; i<family->num_interfaces; i++) {
+                desc = family->interfaces + i;
                 if (desc->version <= max_version) {
-                    obj = gbinder_servicemanager_get_service_sync(sm,
-                        desc->fqname, NULL);
-                    if (obj) {
-                        /*
-                         * desc->version isn't necessarily equal to
-                         * max_version
-                         */
-                        if (instances[desc->version]) {
-                            config = radio_config_ref(instances[desc->version]);
-                        } else {
-                            GINFO("Connected to %s", desc->fqname);
-                            config = radio_config_create(sm, obj, desc);
+                    descs[n] = desc;
+                    names[n++] = desc->fqname;
+                }
+            }
+
+            /* The cache only makes sense if there's more than one option */
+            if (interface_type == RADIO_INTERFACE_TYPE_HIDL) {
+                n = radio_version_cache_order(sm, family->dev,
+                    RADIO_CONFIG_CACHE_KEY, names, n, order);
+            } else {
+                for (i = 0; i < n; i++) {
+                    order[i] = i;
+                }
+            }
+
+            for (i = 0; i < n && !obj; i++) {
+                desc = descs[order[i]];
+                obj = gbinder_servicemanager_get_service_sync(sm,
+                    desc->fqname, NULL);
+                if (obj) {
+                    /*
+                     * desc->version isn't necessarily equal to
+                     * max_version
+                     */
+                    if (instances[desc->version]) {
+                        config = radio_config_ref(instances[desc->version]);
+                    } else {
+                        GINFO("Connected to %s", desc->fqname);
+                        config = radio_config_create(sm, obj, desc);
+                        if (interface_type == RADIO_INTERFACE_TYPE_HIDL) {
+                            radio_version_cache_update(family->dev,
+                                RADIO_CONFIG_CACHE_KEY, desc->fqname);
                         }
-                        break;
                     }
+                    break;
                 }
             }
 
             gbinder_servicemanager_unref(sm);
             if (config) {
-                *(config->shared = instances + desc->version) = config;
-                g_object_weak_ref(G_OBJECT(config), radio_config_gone,
-                    config->shared);
+                radio_config_share(config, instances);
                 return config;
             }
         }
@@ -755,6 +1134,65 @@ radio_config_new_with_version_and_interface_type(
     return NULL;
 }
 
+gulong
+radio_config_new_async(
+    RADIO_CONFIG_INTERFACE max_version,
+    RADIO_INTERFACE_TYPE interface_type,
+    RadioConfigFunc func,
+    GDestroyNotify destroy,
+    gpointer user_data) /* Since 1.6.7 */
+{
+    const RadioConfigFamily* family = func ?
+        radio_config_family(interface_type, &max_version) : NULL;
+
+    if (family) {
+        RadioConfigNewOp* op = g_slice_new0(RadioConfigNewOp);
+
+        op->family = family;
+        op->max_version = max_version;
+        op->context = g_main_context_ref_thread_default();
+        op->func = func;
+        op->destroy = destroy;
+        op->user_data = user_data;
+        if (family->instances[max_version]) {
+            /* Complete on the next main loop iteration */
+            op->config = radio_config_ref(family->instances[max_version]);
+            op->idle_id = radio_timeout_add(op->context, 0,
+                radio_config_new_op_idle, op);
+        } else {
+            op->sm = gbinder_servicemanager_new(family->dev);
+            if (!op->sm || !radio_config_new_op_next(op)) {
+                op->idle_id = radio_timeout_add(op->context, 0,
+                    radio_config_new_op_idle, op);
+            }
+        }
+        if (!++radio_config_new_last_id) {
+            radio_config_new_last_id = 1;
+        }
+        op->id = radio_config_new_last_id;
+        radio_config_new_ops = g_slist_append(radio_config_new_ops, op);
+        return op->id;
+    }
+    return 0;
+}
+
+void
+radio_config_cancel_new(
+    gulong id) /* Since 1.6.7 */
+{
+    GSList* l;
+
+    for (l = id ? radio_config_new_ops : NULL; l; l = l->next) {
+        RadioConfigNewOp* op = l->data;
+
+        if (op->id == id) {
+            radio_config_new_ops = g_slist_delete_link(radio_config_new_ops, l);
+            radio_config_new_op_free(op);
+            break;
+        }
+    }
+}
+
 RadioConfig*
 radio_config_ref(
     RadioConfig* self)
@@ -810,6 +1248,42 @@ radio_config_rpc_header_size(
     return 0;
 }
 
+RADIO_CONFIG_REQ
+radio_config_req_from_name(
+    RadioConfig* self,
+    const char* name) /* Since 1.6.7 */
+{
+    static gsize names[2];
+
+    return G_LIKELY(self) ? radio_name_to_code(names +
+        (self->desc->interface_type == RADIO_INTERFACE_TYPE_AIDL),
+        radio_config_req_name_cb, self->desc, name) : RADIO_CONFIG_REQ_NONE;
+}
+
+RADIO_CONFIG_RESP
+radio_config_resp_from_name(
+    RadioConfig* self,
+    const char* name) /* Since 1.6.7 */
+{
+    static gsize names[2];
+
+    return G_LIKELY(self) ? radio_name_to_code(names +
+        (self->desc->interface_type == RADIO_INTERFACE_TYPE_AIDL),
+        radio_config_resp_name_cb, self->desc, name) : RADIO_CONFIG_RESP_NONE;
+}
+
+RADIO_CONFIG_IND
+radio_config_ind_from_name(
+    RadioConfig* self,
+    const char* name) /* Since 1.6.7 */
+{
+    static gsize names[2];
+
+    return G_LIKELY(self) ? radio_name_to_code(names +
+        (self->desc->interface_type == RADIO_INTERFACE_TYPE_AIDL),
+        radio_config_ind_name_cb, self->desc, name) : RADIO_CONFIG_IND_NONE;
+}
+
 const char*
 radio_config_req_name(
     RadioConfig* self,
@@ -985,6 +1459,57 @@ radio_config_remove_handlers(
     gutil_disconnect_handlers(self, ids, count);
 }
 
+void
+radio_config_set_recorder(
+    RadioConfig* self,
+    RadioRecorder* recorder) /* Since 1.6.7 */
+{
+    if (G_LIKELY(self) && self->recorder != recorder) {
+        gutil_disconnect_handlers(self, self->recorder_id,
+            G_N_ELEMENTS(self->recorder_id));
+        radio_recorder_unref(self->recorder);
+        self->recorder = radio_recorder_ref(recorder);
+        if (recorder) {
+            self->recorder_id[0] =
+                radio_config_add_request_observer_with_priority(self,
+                    RADIO_OBSERVER_PRIORITY_HIGHEST, RADIO_CONFIG_REQ_ANY,
+                    radio_config_record_request, recorder);
+            self->recorder_id[1] =
+                radio_config_add_response_observer_with_priority(self,
+                    RADIO_OBSERVER_PRIORITY_HIGHEST, RADIO_CONFIG_RESP_ANY,
+                    radio_config_record_response, recorder);
+            self->recorder_id[2] =
+                radio_config_add_indication_observer_with_priority(self,
+                    RADIO_OBSERVER_PRIORITY_HIGHEST, RADIO_CONFIG_IND_ANY,
+                    radio_config_record_indication, recorder);
+        }
+    }
+}
+
+void
+radio_config_set_ind_meter(
+    RadioConfig* self,
+    guint half_life_ms) /* Since 1.6.7 */
+{
+    if (G_LIKELY(self) &&
+        radio_ind_meter_half_life_ms(self->ind_meter) != half_life_ms) {
+        radio_ind_meter_free(self->ind_meter);
+        self->ind_meter = half_life_ms ?
+            radio_ind_meter_new(half_life_ms) : NULL;
+    }
+}
+
+RadioIndRate*
+radio_config_get_ind_rates(
+    RadioConfig* self,
+    RADIO_IND_RATE_ORDER order,
+    guint max,
+    guint* count) /* Since 1.6.7 */
+{
+    return radio_ind_meter_top(G_LIKELY(self) ? self->ind_meter : NULL,
+        order, max, g_get_monotonic_time(), count);
+}
+
 /*==========================================================================*
  * Methods
  *==========================================================================*/
@@ -1032,6 +1557,7 @@ radio_config_send_request(
     call->req = radio_request_ref(req);
 
     /* Notify the observers first */
+    self->resend_serial = (req->serial2 != req->serial) ? req->serial : 0;
     for (i = RADIO_OBSERVER_PRIORITY_COUNT - 1; i >= 0; i--) {
         guint id = radio_config_signals[SIGNAL_OBSERVE_REQUEST_0 + i];
 
@@ -1042,6 +1568,7 @@ radio_config_send_request(
             g_signal_emit(self, id, quark, req->code, req->args);
         }
     }
+    self->resend_serial = 0;
 
     /* Then actually submit the request */
     tx_id = gbinder_client_transact(self->client, req->code,
@@ -1090,6 +1617,8 @@ radio_config_finalize(
     g_hash_table_destroy(self->req_quarks);
     g_hash_table_destroy(self->resp_quarks);
     g_hash_table_destroy(self->ind_quarks);
+    radio_recorder_unref(self->recorder);
+    radio_ind_meter_free(self->ind_meter);
     G_OBJECT_CLASS(PARENT_CLASS)->finalize(object);
 }
 
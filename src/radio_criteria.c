@@ -0,0 +1,651 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#define GLIB_DISABLE_DEPRECATION_WARNINGS
+
+#include "radio_client_p.h"
+#include "radio_criteria.h"
+#include "radio_instance_p.h"
+#include "radio_network_types.h"
+#include "radio_request.h"
+#include "radio_util_p.h"
+#include "radio_log.h"
+
+#include <gbinder.h>
+
+#include <gutil_macros.h>
+#include <gutil_misc.h>
+
+#include <string.h>
+
+/* This API exists since 1.6.7 */
+
+typedef enum radio_criteria_api {
+    RADIO_CRITERIA_API_NONE,
+    RADIO_CRITERIA_API_1_2,     /* IRadio 1.2..1.4 */
+    RADIO_CRITERIA_API_1_5,     /* IRadio 1.5 and newer */
+    RADIO_CRITERIA_API_AIDL     /* IRadioNetwork */
+} RADIO_CRITERIA_API;
+
+typedef enum radio_criteria_kind {
+    RADIO_CRITERIA_SIGNAL = 1,
+    RADIO_CRITERIA_LINK_CAPACITY
+} RADIO_CRITERIA_KIND;
+
+/* Signal strength criteria use only the first step */
+typedef struct radio_criteria_params {
+    guint step[2];              /* dB or DL/UL kbps */
+    guint hysteresis_ms;
+} RadioCriteriaParams;
+
+typedef struct radio_criteria_sub {
+    guint key;
+    RadioCriteriaParams params;
+} RadioCriteriaSub;
+
+/* Valid measurement ranges, from SignalThresholdInfo description */
+typedef struct radio_criteria_range {
+    gint min;
+    gint max;
+} RadioCriteriaRange;
+
+/* Indexed by RADIO_SIGNAL_MEASUREMENT */
+static const RadioCriteriaRange radio_criteria_ranges[] = {
+    { 0, 0 },       /* NONE */
+    { -113, -51 },  /* RSSI */
+    { -120, -24 },  /* RSCP */
+    { -140, -44 },  /* RSRP */
+    { -34, 3 },     /* RSRQ */
+    { -20, 30 },    /* RSSNR */
+    { -140, -44 },  /* SSRSRP */
+    { -43, 20 },    /* SSRSRQ */
+    { -23, 40 }     /* SSSINR */
+};
+G_STATIC_ASSERT(G_N_ELEMENTS(radio_criteria_ranges) ==
+    RADIO_SIGNAL_MEASUREMENT_SSSINR + 1);
+
+/* Enough for the widest range with 1 dB step */
+#define RADIO_CRITERIA_MAX_THRESHOLDS (128)
+
+#define RADIO_CRITERIA_KEY(kind,ran,measurement) \
+    (((kind) << 16) | ((ran) << 8) | (measurement))
+#define RADIO_CRITERIA_KEY_KIND(key) ((key) >> 16)
+#define RADIO_CRITERIA_KEY_RAN(key) (((key) >> 8) & 0xff)
+#define RADIO_CRITERIA_KEY_MEASUREMENT(key) ((key) & 0xff)
+
+struct radio_criteria {
+    gint refcount;
+    RadioClient* client;
+    GMainContext* context;
+    RADIO_CRITERIA_API api;
+    GHashTable* subs;           /* id => RadioCriteriaSub */
+    GHashTable* programmed;     /* key => RadioCriteriaParams */
+    gulong connected_id;
+    guint update_id;
+    guint last_id;
+};
+
+/*==========================================================================*
+ * Implementation
+ *==========================================================================*/
+
+static
+RADIO_CRITERIA_API
+radio_criteria_api(
+    RadioClient* client)
+{
+    switch (radio_client_aidl_interface(client)) {
+    case RADIO_NETWORK_INTERFACE:
+        return RADIO_CRITERIA_API_AIDL;
+    case RADIO_AIDL_INTERFACE_NONE:
+        if (radio_client_interface(client) >= RADIO_INTERFACE_1_5) {
+            return RADIO_CRITERIA_API_1_5;
+        } else if (radio_client_interface(client) >= RADIO_INTERFACE_1_2) {
+            return RADIO_CRITERIA_API_1_2;
+        }
+        break;
+    default:
+        break;
+    }
+    return RADIO_CRITERIA_API_NONE;
+}
+
+static
+gboolean
+radio_criteria_signal_supported(
+    RADIO_CRITERIA_API api,
+    RADIO_ACCESS_NETWORK ran,
+    RADIO_SIGNAL_MEASUREMENT measurement)
+{
+    /* IRadio 1.2 only takes the basic measurement for each network */
+    switch (ran) {
+    case RADIO_ACCESS_NETWORK_GERAN:
+    case RADIO_ACCESS_NETWORK_CDMA2000:
+        return measurement == RADIO_SIGNAL_MEASUREMENT_RSSI;
+    case RADIO_ACCESS_NETWORK_UTRAN:
+        return measurement == RADIO_SIGNAL_MEASUREMENT_RSCP;
+    case RADIO_ACCESS_NETWORK_EUTRAN:
+        return measurement == RADIO_SIGNAL_MEASUREMENT_RSRP ||
+            (api != RADIO_CRITERIA_API_1_2 &&
+            (measurement == RADIO_SIGNAL_MEASUREMENT_RSRQ ||
+             measurement == RADIO_SIGNAL_MEASUREMENT_RSSNR));
+    case RADIO_ACCESS_NETWORK_NGRAN:
+        return api != RADIO_CRITERIA_API_1_2 &&
+            (measurement == RADIO_SIGNAL_MEASUREMENT_SSRSRP ||
+             measurement == RADIO_SIGNAL_MEASUREMENT_SSRSRQ ||
+             measurement == RADIO_SIGNAL_MEASUREMENT_SSSINR);
+    case RADIO_ACCESS_NETWORK_UNKNOWN:
+    case RADIO_ACCESS_NETWORK_IWLAN:
+        break;
+    }
+    return FALSE;
+}
+
+static
+guint
+radio_criteria_thresholds(
+    RADIO_SIGNAL_MEASUREMENT measurement,
+    guint step,
+    gint32* thresholds)
+{
+    const RadioCriteriaRange* range = radio_criteria_ranges + measurement;
+    const gint s = step;
+    gint value = range->min - range->min % s;
+    guint n = 0;
+
+    /* Multiples of the step within the valid range */
+    if (value < range->min) value += s;
+    for (; value <= range->max && n < RADIO_CRITERIA_MAX_THRESHOLDS;
+         value += s) {
+        thresholds[n++] = value;
+    }
+    return n;
+}
+
+static
+void
+radio_criteria_append_int_vec(
+    RadioCriteria* self,
+    GBinderWriter* writer,
+    const gint32* values,
+    guint count)
+{
+    if (self->api == RADIO_CRITERIA_API_AIDL) {
+        guint i;
+
+        gbinder_writer_append_int32(writer, count);
+        for (i = 0; i < count; i++) {
+            gbinder_writer_append_int32(writer, values[i]);
+        }
+    } else {
+        gbinder_writer_append_hidl_vec(writer, values, count,
+            sizeof(values[0]));
+    }
+}
+
+static
+void
+radio_criteria_append_signal_1_5(
+    GBinderWriter* writer,
+    RADIO_SIGNAL_MEASUREMENT measurement,
+    const RadioCriteriaParams* params,
+    const gint32* thresholds,
+    guint count)
+{
+    RadioSignalThresholdInfo* info = gbinder_writer_new0(writer,
+        RadioSignalThresholdInfo);
+    GBinderParent parent;
+
+    info->signalMeasurement = measurement;
+    if (params) {
+        info->hysteresisMs = params->hysteresis_ms;
+        info->hysteresisDb = params->step[0] / 2;
+        info->thresholds.count = count;
+        info->thresholds.data.ptr = gbinder_writer_memdup(writer,
+            thresholds, count * sizeof(thresholds[0]));
+        info->isEnabled = TRUE;
+    }
+    info->thresholds.owns_buffer = TRUE;
+
+    /* The vector buffer is written even if the vector is empty */
+    parent.index = gbinder_writer_append_buffer_object(writer, info,
+        sizeof(*info));
+    parent.offset = G_STRUCT_OFFSET(RadioSignalThresholdInfo, thresholds) +
+        GBINDER_HIDL_VEC_BUFFER_OFFSET;
+    gbinder_writer_append_buffer_object_with_parent(writer,
+        info->thresholds.data.ptr, info->thresholds.count *
+        sizeof(thresholds[0]), &parent);
+}
+
+static
+void
+radio_criteria_append_signal_aidl(
+    GBinderWriter* writer,
+    RADIO_ACCESS_NETWORK ran,
+    RADIO_SIGNAL_MEASUREMENT measurement,
+    const RadioCriteriaParams* params,
+    const gint32* thresholds,
+    guint count)
+{
+    gsize size_offset;
+    guint i;
+
+    /* SignalThresholdInfo[] with a single non-null element */
+    gbinder_writer_append_int32(writer, 1);
+    gbinder_writer_append_int32(writer, 1);
+    size_offset = gbinder_writer_bytes_written(writer);
+    gbinder_writer_append_int32(writer, 0); /* Size, filled in below */
+    gbinder_writer_append_int32(writer, measurement);
+    gbinder_writer_append_int32(writer, params ? params->hysteresis_ms : 0);
+    gbinder_writer_append_int32(writer, params ? params->step[0] / 2 : 0);
+    gbinder_writer_append_int32(writer, count);
+    for (i = 0; i < count; i++) {
+        gbinder_writer_append_int32(writer, thresholds[i]);
+    }
+    gbinder_writer_append_bool(writer, params != NULL);
+    gbinder_writer_append_int32(writer, ran);
+    gbinder_writer_overwrite_int32(writer, size_offset,
+        gbinder_writer_bytes_written(writer) - size_offset);
+}
+
+static
+void
+radio_criteria_request_complete(
+    RadioRequest* req,
+    RADIO_TX_STATUS status,
+    RADIO_RESP resp,
+    RADIO_ERROR error,
+    const GBinderReader* args,
+    gpointer user_data)
+{
+    if (status != RADIO_TX_STATUS_OK) {
+        GWARN("Failed to set reporting criteria (tx status %d)", status);
+    } else if (error != RADIO_ERROR_NONE) {
+        GWARN("Failed to set reporting criteria (error %d)", error);
+    }
+}
+
+/* NULL params resets the criteria to the default */
+static
+void
+radio_criteria_send(
+    RadioCriteria* self,
+    guint key,
+    const RadioCriteriaParams* params)
+{
+    const RADIO_ACCESS_NETWORK ran = RADIO_CRITERIA_KEY_RAN(key);
+    const gboolean aidl = (self->api == RADIO_CRITERIA_API_AIDL);
+    GBinderWriter writer;
+    RadioRequest* req;
+    RADIO_REQ code;
+
+    if (RADIO_CRITERIA_KEY_KIND(key) == RADIO_CRITERIA_SIGNAL) {
+        const RADIO_SIGNAL_MEASUREMENT measurement =
+            RADIO_CRITERIA_KEY_MEASUREMENT(key);
+        gint32 thresholds[RADIO_CRITERIA_MAX_THRESHOLDS];
+        const guint count = params ? radio_criteria_thresholds(measurement,
+            params->step[0], thresholds) : 0;
+
+        GDEBUG("Signal criteria %d/%d: step %u dB, hysteresis %u ms",
+            ran, measurement, params ? params->step[0] : 0,
+            params ? params->hysteresis_ms : 0);
+        switch (self->api) {
+        case RADIO_CRITERIA_API_1_2:
+            code = RADIO_REQ_SET_SIGNAL_STRENGTH_REPORTING_CRITERIA;
+            req = radio_request_new(self->client, code, &writer,
+                radio_criteria_request_complete, NULL, NULL);
+            gbinder_writer_append_int32(&writer,
+                params ? params->hysteresis_ms : 0);
+            gbinder_writer_append_int32(&writer,
+                params ? params->step[0] / 2 : 0);
+            radio_criteria_append_int_vec(self, &writer, thresholds, count);
+            break;
+        case RADIO_CRITERIA_API_1_5:
+            code = RADIO_REQ_SET_SIGNAL_STRENGTH_REPORTING_CRITERIA_1_5;
+            req = radio_request_new(self->client, code, &writer,
+                radio_criteria_request_complete, NULL, NULL);
+            radio_criteria_append_signal_1_5(&writer, measurement, params,
+                thresholds, count);
+            break;
+        case RADIO_CRITERIA_API_AIDL:
+            code = RADIO_NETWORK_REQ_SET_SIGNAL_STRENGTH_REPORTING_CRITERIA;
+            req = radio_request_new(self->client, code, &writer,
+                radio_criteria_request_complete, NULL, NULL);
+            radio_criteria_append_signal_aidl(&writer, ran, measurement,
+                params, thresholds, count);
+            break;
+        case RADIO_CRITERIA_API_NONE:
+        default:
+            return;
+        }
+    } else {
+        const guint hysteresis_ms = params ? params->hysteresis_ms : 0;
+        const guint dl = params ? params->step[0] : 0;
+        const guint ul = params ? params->step[1] : 0;
+
+        GDEBUG("Link capacity criteria %d: step %u/%u kbps, hysteresis "
+            "%u ms", ran, dl, ul, hysteresis_ms);
+        code = aidl ? RADIO_NETWORK_REQ_SET_LINK_CAPACITY_REPORTING_CRITERIA :
+            (self->api == RADIO_CRITERIA_API_1_5) ?
+            RADIO_REQ_SET_LINK_CAPACITY_REPORTING_CRITERIA_1_5 :
+            RADIO_REQ_SET_LINK_CAPACITY_REPORTING_CRITERIA;
+        req = radio_request_new(self->client, code, &writer,
+            radio_criteria_request_complete, NULL, NULL);
+
+        /* No thresholds, the hysteresis alone triggers the reports */
+        gbinder_writer_append_int32(&writer, hysteresis_ms);
+        gbinder_writer_append_int32(&writer, dl);
+        gbinder_writer_append_int32(&writer, ul);
+        radio_criteria_append_int_vec(self, &writer, NULL, 0);
+        radio_criteria_append_int_vec(self, &writer, NULL, 0);
+    }
+
+    /* AIDL SignalThresholdInfo carries the access network by itself */
+    if (!aidl || RADIO_CRITERIA_KEY_KIND(key) != RADIO_CRITERIA_SIGNAL) {
+        gbinder_writer_append_int32(&writer, ran);
+    }
+    radio_request_submit(req);
+    radio_request_unref(req);
+}
+
+static
+gint
+radio_criteria_compare_keys(
+    gconstpointer a,
+    gconstpointer b)
+{
+    const guint k1 = *(const guint*)a;
+    const guint k2 = *(const guint*)b;
+
+    return (k1 < k2) ? -1 : (k1 > k2) ? 1 : 0;
+}
+
+static
+void
+radio_criteria_update(
+    RadioCriteria* self)
+{
+    GHashTable* wanted = g_hash_table_new_full(g_direct_hash,
+        g_direct_equal, NULL, g_free);
+    GArray* keys = g_array_new(FALSE, FALSE, sizeof(guint));
+    GHashTableIter it;
+    gpointer key, value;
+    guint i;
+
+    /* Merge the subscriptions, the finest criteria win */
+    g_hash_table_iter_init(&it, self->subs);
+    while (g_hash_table_iter_next(&it, NULL, &value)) {
+        const RadioCriteriaSub* sub = value;
+        RadioCriteriaParams* params = g_hash_table_lookup(wanted,
+            GUINT_TO_POINTER(sub->key));
+
+        if (params) {
+            params->step[0] = MIN(params->step[0], sub->params.step[0]);
+            params->step[1] = MIN(params->step[1], sub->params.step[1]);
+            params->hysteresis_ms = MIN(params->hysteresis_ms,
+                sub->params.hysteresis_ms);
+        } else {
+            g_hash_table_insert(wanted, GUINT_TO_POINTER(sub->key),
+                gutil_memdup(&sub->params, sizeof(sub->params)));
+            g_array_append_val(keys, sub->key);
+        }
+    }
+
+    /* And the programmed ones which aren't wanted anymore */
+    g_hash_table_iter_init(&it, self->programmed);
+    while (g_hash_table_iter_next(&it, &key, NULL)) {
+        if (!g_hash_table_contains(wanted, key)) {
+            const guint k = GPOINTER_TO_UINT(key);
+
+            g_array_append_val(keys, k);
+        }
+    }
+
+    /* Predictable order of requests */
+    g_array_sort(keys, radio_criteria_compare_keys);
+    for (i = 0; i < keys->len; i++) {
+        const guint k = g_array_index(keys, guint, i);
+        gpointer hkey = GUINT_TO_POINTER(k);
+        const RadioCriteriaParams* want = g_hash_table_lookup(wanted, hkey);
+        const RadioCriteriaParams* have = g_hash_table_lookup(self->
+            programmed, hkey);
+
+        if (!want) {
+            radio_criteria_send(self, k, NULL);
+            g_hash_table_remove(self->programmed, hkey);
+        } else if (!have || memcmp(want, have, sizeof(*want))) {
+            radio_criteria_send(self, k, want);
+            g_hash_table_insert(self->programmed, hkey,
+                gutil_memdup(want, sizeof(*want)));
+        }
+    }
+
+    g_array_free(keys, TRUE);
+    g_hash_table_destroy(wanted);
+}
+
+static
+gboolean
+radio_criteria_update_idle(
+    gpointer user_data)
+{
+    RadioCriteria* self = user_data;
+
+    self->update_id = 0;
+    if (radio_client_connected(self->client)) {
+        radio_criteria_update(self);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+radio_criteria_schedule_update(
+    RadioCriteria* self)
+{
+    /* Subscriptions tend to come and go in bunches, coalesce the updates */
+    if (!self->update_id) {
+        self->update_id = radio_timeout_add(self->context, 0,
+            radio_criteria_update_idle, self);
+    }
+}
+
+static
+void
+radio_criteria_connected(
+    RadioClient* client,
+    gpointer user_data)
+{
+    RadioCriteria* self = user_data;
+
+    /* The modem has forgotten everything, start from scratch */
+    g_hash_table_remove_all(self->programmed);
+    radio_criteria_schedule_update(self);
+}
+
+static
+guint
+radio_criteria_add(
+    RadioCriteria* self,
+    guint key,
+    guint step1,
+    guint step2,
+    guint hysteresis_ms)
+{
+    RadioCriteriaSub* sub = g_slice_new(RadioCriteriaSub);
+
+    /* Zero is never a valid id */
+    do {
+        self->last_id++;
+    } while (!self->last_id || g_hash_table_contains(self->subs,
+        GUINT_TO_POINTER(self->last_id)));
+
+    sub->key = key;
+    sub->params.step[0] = step1;
+    sub->params.step[1] = step2;
+    sub->params.hysteresis_ms = hysteresis_ms;
+    g_hash_table_insert(self->subs, GUINT_TO_POINTER(self->last_id), sub);
+    radio_criteria_schedule_update(self);
+    return self->last_id;
+}
+
+static
+void
+radio_criteria_sub_free(
+    gpointer sub)
+{
+    g_slice_free(RadioCriteriaSub, sub);
+}
+
+static
+void
+radio_criteria_free(
+    RadioCriteria* self)
+{
+    if (self->update_id) {
+        radio_source_remove(self->context, self->update_id);
+    }
+    radio_client_remove_handler(self->client, self->connected_id);
+    radio_client_unref(self->client);
+    g_hash_table_destroy(self->subs);
+    g_hash_table_destroy(self->programmed);
+    gutil_slice_free(self);
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+RadioCriteria*
+radio_criteria_new(
+    RadioClient* client)
+{
+    if (G_LIKELY(client)) {
+        RadioCriteria* self = g_slice_new0(RadioCriteria);
+
+        g_atomic_int_set(&self->refcount, 1);
+        self->client = radio_client_ref(client);
+        self->context = radio_instance_context(radio_client_instance(client));
+        self->api = radio_criteria_api(client);
+        self->subs = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+            NULL, radio_criteria_sub_free);
+        self->programmed = g_hash_table_new_full(g_direct_hash,
+            g_direct_equal, NULL, g_free);
+        self->connected_id = radio_client_add_connected_handler(client,
+            radio_criteria_connected, self);
+        return self;
+    }
+    return NULL;
+}
+
+RadioCriteria*
+radio_criteria_ref(
+    RadioCriteria* self)
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->refcount > 0);
+        g_atomic_int_inc(&self->refcount);
+    }
+    return self;
+}
+
+void
+radio_criteria_unref(
+    RadioCriteria* self)
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->refcount > 0);
+        if (g_atomic_int_dec_and_test(&self->refcount)) {
+            radio_criteria_free(self);
+        }
+    }
+}
+
+guint
+radio_criteria_add_signal(
+    RadioCriteria* self,
+    RADIO_ACCESS_NETWORK ran,
+    RADIO_SIGNAL_MEASUREMENT measurement,
+    guint step_db,
+    guint hysteresis_ms)
+{
+    if (G_LIKELY(self) && step_db && self->api != RADIO_CRITERIA_API_NONE &&
+        radio_criteria_signal_supported(self->api, ran, measurement)) {
+        return radio_criteria_add(self, RADIO_CRITERIA_KEY
+            (RADIO_CRITERIA_SIGNAL, ran, measurement), step_db, 0,
+            hysteresis_ms);
+    }
+    return 0;
+}
+
+guint
+radio_criteria_add_link_capacity(
+    RadioCriteria* self,
+    RADIO_ACCESS_NETWORK ran,
+    guint step_dl_kbps,
+    guint step_ul_kbps,
+    guint hysteresis_ms)
+{
+    if (G_LIKELY(self) && step_dl_kbps && step_ul_kbps &&
+        self->api != RADIO_CRITERIA_API_NONE &&
+        ran > RADIO_ACCESS_NETWORK_UNKNOWN &&
+        ran <= RADIO_ACCESS_NETWORK_NGRAN &&
+        (ran != RADIO_ACCESS_NETWORK_NGRAN ||
+         self->api != RADIO_CRITERIA_API_1_2)) {
+        return radio_criteria_add(self, RADIO_CRITERIA_KEY
+            (RADIO_CRITERIA_LINK_CAPACITY, ran, 0), step_dl_kbps,
+            step_ul_kbps, hysteresis_ms);
+    }
+    return 0;
+}
+
+void
+radio_criteria_remove(
+    RadioCriteria* self,
+    guint id)
+{
+    if (G_LIKELY(self) && id &&
+        g_hash_table_remove(self->subs, GUINT_TO_POINTER(id))) {
+        radio_criteria_schedule_update(self);
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
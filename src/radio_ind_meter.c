@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "radio_ind_meter_p.h"
+
+#include <stdlib.h>
+
+typedef struct radio_ind_meter_entry {
+    guint code;
+    guint64 count;
+    guint64 bytes;
+    gdouble level;          /* Decayed count at the time of last update */
+    gdouble byte_level;     /* Decayed byte count */
+    gint64 last;
+} RadioIndMeterEntry;
+
+struct radio_ind_meter {
+    GHashTable* entries;    /* code => RadioIndMeterEntry */
+    guint half_life_ms;
+    gint64 half_life;       /* Microseconds */
+    gdouble scale;          /* Converts decayed level into rate per second */
+};
+
+/*
+ * 2^(-dt/half_life) without dragging in libm. The whole half-lives are
+ * taken care of by halving, the remaining fraction (x < ln 2) by a few
+ * terms of the Taylor series which is accurate to ~0.05%
+ */
+static
+gdouble
+radio_ind_meter_decay(
+    RadioIndMeter* self,
+    gint64 dt)
+{
+    if (dt <= 0) {
+        return 1;
+    } else {
+        gint64 halves = dt / self->half_life;
+
+        if (halves >= 64) {
+            return 0;
+        } else {
+            const gdouble x = G_LN2 * (dt % self->half_life) / self->half_life;
+            gdouble f = 1 - x * (1 - x / 2 * (1 - x / 3 * (1 - x / 4 *
+                (1 - x / 5))));
+
+            while (halves-- > 0) {
+                f /= 2;
+            }
+            return f;
+        }
+    }
+}
+
+static
+int
+radio_ind_meter_compare_count(
+    const void* a,
+    const void* b)
+{
+    const RadioIndRate* r1 = a;
+    const RadioIndRate* r2 = b;
+
+    /* Biggest first */
+    return (r1->rate > r2->rate) ? (-1) : (r1->rate < r2->rate) ? 1 :
+        (r1->count > r2->count) ? (-1) : (r1->count < r2->count) ? 1 :
+        ((int)r1->code - (int)r2->code);
+}
+
+static
+int
+radio_ind_meter_compare_bytes(
+    const void* a,
+    const void* b)
+{
+    const RadioIndRate* r1 = a;
+    const RadioIndRate* r2 = b;
+
+    return (r1->byte_rate > r2->byte_rate) ? (-1) :
+        (r1->byte_rate < r2->byte_rate) ? 1 :
+        (r1->bytes > r2->bytes) ? (-1) : (r1->bytes < r2->bytes) ? 1 :
+        ((int)r1->code - (int)r2->code);
+}
+
+/*==========================================================================*
+ * Internal API
+ *==========================================================================*/
+
+RadioIndMeter*
+radio_ind_meter_new(
+    guint half_life_ms)
+{
+    RadioIndMeter* self = g_new0(RadioIndMeter, 1);
+
+    self->entries = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+        NULL, g_free);
+    self->half_life_ms = MAX(half_life_ms, 1);
+    self->half_life = (gint64) self->half_life_ms * 1000;
+
+    /* Constant rate r settles at the level of r * half_life / ln 2 */
+    self->scale = G_LN2 * G_USEC_PER_SEC / self->half_life;
+    return self;
+}
+
+void
+radio_ind_meter_free(
+    RadioIndMeter* self)
+{
+    if (self) {
+        g_hash_table_destroy(self->entries);
+        g_free(self);
+    }
+}
+
+guint
+radio_ind_meter_half_life_ms(
+    RadioIndMeter* self)
+{
+    return self ? self->half_life_ms : 0;
+}
+
+void
+radio_ind_meter_add(
+    RadioIndMeter* self,
+    guint code,
+    gsize bytes,
+    gint64 now)
+{
+    gpointer key = GUINT_TO_POINTER(code);
+    RadioIndMeterEntry* entry = g_hash_table_lookup(self->entries, key);
+
+    if (entry) {
+        const gdouble f = radio_ind_meter_decay(self, now - entry->last);
+
+        entry->level *= f;
+        entry->byte_level *= f;
+    } else {
+        entry = g_new0(RadioIndMeterEntry, 1);
+        entry->code = code;
+        g_hash_table_insert(self->entries, key, entry);
+    }
+    entry->count++;
+    entry->bytes += bytes;
+    entry->level += 1;
+    entry->byte_level += bytes;
+    entry->last = now;
+}
+
+RadioIndRate*
+radio_ind_meter_top(
+    RadioIndMeter* self,
+    RADIO_IND_RATE_ORDER order,
+    guint max,
+    gint64 now,
+    guint* count)
+{
+    const guint size = self ? g_hash_table_size(self->entries) : 0;
+    RadioIndRate* result = NULL;
+    guint n = 0;
+
+    if (size) {
+        GHashTableIter it;
+        gpointer value;
+
+        result = g_new(RadioIndRate, size);
+        g_hash_table_iter_init(&it, self->entries);
+        while (g_hash_table_iter_next(&it, NULL, &value)) {
+            const RadioIndMeterEntry* entry = value;
+            const gdouble f = self->scale *
+                radio_ind_meter_decay(self, now - entry->last);
+            RadioIndRate* rate = result + (n++);
+
+            rate->code = entry->code;
+            rate->count = entry->count;
+            rate->bytes = entry->bytes;
+            rate->rate = entry->level * f;
+            rate->byte_rate = entry->byte_level * f;
+        }
+        qsort(result, n, sizeof(result[0]), (order == RADIO_IND_RATE_BY_BYTES)
+            ? radio_ind_meter_compare_bytes : radio_ind_meter_compare_count);
+        if (max && n > max) {
+            n = max;
+        }
+    }
+    if (count) {
+        *count = n;
+    }
+    return result;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
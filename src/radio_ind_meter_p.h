@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef RADIO_IND_METER_PRIVATE_H
+#define RADIO_IND_METER_PRIVATE_H
+
+#include "radio_types_p.h"
+
+/*
+ * Per-code indication counters and exponentially decayed rates.
+ * Timestamps are in microseconds. The half-life defines how quickly
+ * the rates forget the past.
+ */
+
+typedef struct radio_ind_meter RadioIndMeter;
+
+RadioIndMeter*
+radio_ind_meter_new(
+    guint half_life_ms)
+    RADIO_INTERNAL;
+
+void
+radio_ind_meter_free(
+    RadioIndMeter* meter)
+    RADIO_INTERNAL;
+
+guint
+radio_ind_meter_half_life_ms(
+    RadioIndMeter* meter)
+    RADIO_INTERNAL;
+
+void
+radio_ind_meter_add(
+    RadioIndMeter* meter,
+    guint code,
+    gsize bytes,
+    gint64 now)
+    RADIO_INTERNAL;
+
+/* Returns at most max entries (zero means all), free with g_free() */
+RadioIndRate*
+radio_ind_meter_top(
+    RadioIndMeter* meter,
+    RADIO_IND_RATE_ORDER order,
+    guint max,
+    gint64 now,
+    guint* count)
+    RADIO_INTERNAL;
+
+#endif /* RADIO_IND_METER_PRIVATE_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -37,9 +37,13 @@
 
 #define GLIB_DISABLE_DEPRECATION_WARNINGS
 
+#include "radio_ind_meter_p.h"
 #include "radio_instance_p.h"
+#include "radio_probe_p.h"
+#include "radio_recorder_p.h"
 #include "radio_registry_p.h"
 #include "radio_util_p.h"
+#include "radio_version_cache_p.h"
 #include "radio_log.h"
 
 #include <gbinder.h>
@@ -51,9 +55,47 @@
 
 #include <glib-object.h>
 
+#include <stdlib.h>
+
 typedef struct radio_interface_desc RadioInterfaceDesc;
 
 typedef GObjectClass RadioInstanceClass;
+
+typedef struct radio_instance_timing {
+    guint slow_usec;
+    GHashTable* codes[RADIO_HANDLER_TYPE_COUNT]; /* RadioHandlerStats */
+} RadioInstanceTiming;
+
+/* Attached to the observer and handler closures */
+typedef struct radio_instance_handler {
+    RadioInstance* instance;
+    RadioHandlerStats stats;
+    gint64 start;
+    guint depth;
+    gboolean ind_interest;
+} RadioInstanceHandler;
+
+/* Indication filter bit controlling the particular indication */
+typedef struct radio_ind_filter_bit {
+    guint code;
+    guint32 bit;
+} RadioIndFilterBit;
+
+typedef struct radio_ind_filter_desc {
+    guint req;
+    guint32 mask; /* Bits supported by the interface */
+    const RadioIndFilterBit* bits;
+    guint count;
+} RadioIndFilterDesc;
+
+/* Table key doesn't own the strings, they belong to the instance */
+typedef struct radio_instance_key {
+    const char* dev;
+    const char* name;
+    RADIO_INTERFACE version;
+    RADIO_AIDL_INTERFACE aidl_interface;
+} RadioInstanceKey;
+
 struct radio_instance_priv {
     const RadioInterfaceDesc* desc;
     GUtilIdlePool* idle;
@@ -61,6 +103,7 @@ struct radio_instance_priv {
     GBinderRemoteObject* remote;
     GBinderLocalObject* response;
     GBinderLocalObject* indication;
+    GHashTable* unknown_names; /* Numeric names of unknown codes */
     GHashTable* req_quarks;
     GHashTable* resp_quarks;
     GHashTable* ind_quarks;
@@ -69,6 +112,28 @@ struct radio_instance_priv {
     char* slot;
     char* key;
     char* modem;
+    gboolean ack_batching;
+    guint acks_pending;
+    guint ack_idle_id;
+    RadioAckStats ack_stats;
+    GMainContext* context;
+    GBinderRemoteRequest* resp_msg;
+    RadioInstanceKey table_key;
+    RadioRecorder* recorder;
+    gulong recorder_id[3];
+    guint32 resend_serial; /* Original serial of the request being resent */
+    GHashTable* handlers; /* Set of RadioInstanceHandler */
+    RadioInstanceTiming* timing;
+    guint dispatch_code;
+    RadioIndMeter* ind_meter;
+    const RadioIndFilterDesc* ind_filter_desc;
+    gboolean ind_filter_auto;
+    guint32 ind_filter; /* Last sent (or the default one) */
+    guint ind_filter_id;
+    GHashTable* ind_interest; /* Code => number of listeners */
+    guint ind_interest_any;
+    guint power_save; /* Number of clients in power save */
+    gboolean power_save_sent; /* Last sendDeviceState */
 };
 
 G_DEFINE_TYPE(RadioInstance, radio_instance, G_TYPE_OBJECT)
@@ -89,6 +154,7 @@ typedef enum radio_instance_signal {
     SIGNAL_DEATH,
     SIGNAL_ENABLED,
     SIGNAL_CONNECTED,
+    SIGNAL_SLOW_HANDLER,
     SIGNAL_COUNT
 } RADIO_INSTANCE_SIGNAL;
 
@@ -119,10 +185,14 @@ static const char* radio_instance_signal_observe_indication_name[] = {
 #define SIGNAL_DEATH_NAME              "radio-instance-death"
 #define SIGNAL_ENABLED_NAME            "radio-instance-enabled"
 #define SIGNAL_CONNECTED_NAME          "radio-instance-connected"
+#define SIGNAL_SLOW_HANDLER_NAME       "radio-instance-slow-handler"
 
 static guint radio_instance_signals[SIGNAL_COUNT] = { 0 };
 
 static GHashTable* radio_instance_table = NULL;
+static guint radio_instance_table_gen = 0;
+static RadioInstance** radio_instance_all = NULL;
+static guint radio_instance_all_gen = 0;
 
 #define DEFAULT_INTERFACE RADIO_INTERFACE_1_0
 
@@ -260,6 +330,79 @@ static const RadioInterfaceDesc radio_aidl_interfaces[] = {
 };
 G_STATIC_ASSERT(G_N_ELEMENTS(radio_aidl_interfaces) == RADIO_AIDL_INTERFACE_COUNT);
 
+static const RadioIndFilterBit radio_ind_filter_bits[] = {
+    { RADIO_IND_CURRENT_SIGNAL_STRENGTH,
+      RADIO_IND_FILTER_SIGNAL_STRENGTH },
+    { RADIO_IND_CURRENT_SIGNAL_STRENGTH_1_2,
+      RADIO_IND_FILTER_SIGNAL_STRENGTH },
+    { RADIO_IND_CURRENT_SIGNAL_STRENGTH_1_4,
+      RADIO_IND_FILTER_SIGNAL_STRENGTH },
+    { RADIO_IND_NETWORK_STATE_CHANGED,
+      RADIO_IND_FILTER_FULL_NETWORK_STATE },
+    { RADIO_IND_DATA_CALL_LIST_CHANGED,
+      RADIO_IND_FILTER_DATA_CALL_DORMANCY },
+    { RADIO_IND_DATA_CALL_LIST_CHANGED_1_4,
+      RADIO_IND_FILTER_DATA_CALL_DORMANCY },
+    { RADIO_IND_DATA_CALL_LIST_CHANGED_1_5,
+      RADIO_IND_FILTER_DATA_CALL_DORMANCY },
+    { RADIO_IND_CURRENT_LINK_CAPACITY_ESTIMATE,
+      RADIO_IND_FILTER_LINK_CAPACITY_ESTIMATE },
+    { RADIO_IND_CURRENT_PHYSICAL_CHANNEL_CONFIGS,
+      RADIO_IND_FILTER_PHYSICAL_CHANNEL_CONFIG },
+    { RADIO_IND_CURRENT_PHYSICAL_CHANNEL_CONFIGS_1_4,
+      RADIO_IND_FILTER_PHYSICAL_CHANNEL_CONFIG },
+    { RADIO_IND_REGISTRATION_FAILED,
+      RADIO_IND_FILTER_REGISTRATION_FAILURE },
+    { RADIO_IND_BARRING_INFO_CHANGED,
+      RADIO_IND_FILTER_BARRING_INFO }
+};
+
+/*
+ * dataCallListChanged belongs to IRadioData, the corresponding bit
+ * is always left set for IRadioNetwork.
+ */
+static const RadioIndFilterBit radio_network_ind_filter_bits[] = {
+    { RADIO_NETWORK_IND_CURRENT_SIGNAL_STRENGTH,
+      RADIO_IND_FILTER_SIGNAL_STRENGTH },
+    { RADIO_NETWORK_IND_NETWORK_STATE_CHANGED,
+      RADIO_IND_FILTER_FULL_NETWORK_STATE },
+    { RADIO_NETWORK_IND_CURRENT_LINK_CAPACITY_ESTIMATE,
+      RADIO_IND_FILTER_LINK_CAPACITY_ESTIMATE },
+    { RADIO_NETWORK_IND_CURRENT_PHYSICAL_CHANNEL_CONFIGS,
+      RADIO_IND_FILTER_PHYSICAL_CHANNEL_CONFIG },
+    { RADIO_NETWORK_IND_REGISTRATION_FAILED,
+      RADIO_IND_FILTER_REGISTRATION_FAILURE },
+    { RADIO_NETWORK_IND_BARRING_INFO_CHANGED,
+      RADIO_IND_FILTER_BARRING_INFO }
+};
+
+#define RADIO_IND_FILTER_MASK_1_5 (RADIO_IND_FILTER_ALL_1_2 | \
+    RADIO_IND_FILTER_REGISTRATION_FAILURE | RADIO_IND_FILTER_BARRING_INFO)
+
+/* What's left enabled in power save, same as Android with screen off */
+#define RADIO_IND_FILTER_POWER_SAVE (RADIO_IND_FILTER_REGISTRATION_FAILURE | \
+    RADIO_IND_FILTER_BARRING_INFO)
+
+static const RadioIndFilterDesc radio_ind_filter_1_0 = {
+    RADIO_REQ_SET_INDICATION_FILTER, RADIO_IND_FILTER_ALL,
+    radio_ind_filter_bits, G_N_ELEMENTS(radio_ind_filter_bits)
+};
+
+static const RadioIndFilterDesc radio_ind_filter_1_2 = {
+    RADIO_REQ_SET_INDICATION_FILTER_1_2, RADIO_IND_FILTER_ALL_1_2,
+    radio_ind_filter_bits, G_N_ELEMENTS(radio_ind_filter_bits)
+};
+
+static const RadioIndFilterDesc radio_ind_filter_1_5 = {
+    RADIO_REQ_SET_INDICATION_FILTER_1_5, RADIO_IND_FILTER_MASK_1_5,
+    radio_ind_filter_bits, G_N_ELEMENTS(radio_ind_filter_bits)
+};
+
+static const RadioIndFilterDesc radio_network_ind_filter = {
+    RADIO_NETWORK_REQ_SET_INDICATION_FILTER, RADIO_IND_FILTER_MASK_1_5,
+    radio_network_ind_filter_bits, G_N_ELEMENTS(radio_network_ind_filter_bits)
+};
+
 typedef struct radio_instance_tx {
     RadioInstance* instance;
     RadioInstanceTxCompleteFunc complete;
@@ -267,12 +410,99 @@ typedef struct radio_instance_tx {
     gulong id;
     void* user_data1;
     void* user_data2;
+    gboolean completed;
+    int status;
 } RadioInstanceTx;
 
+typedef struct radio_instance_event {
+    RadioInstance* instance;
+    GBinderRemoteRequest* req;
+    guint code;
+    guint flags;
+} RadioInstanceEvent;
+
+typedef struct radio_instance_new_call {
+    gulong id;
+    RadioInstanceFunc func;
+    GDestroyNotify destroy;
+    gpointer user_data;
+} RadioInstanceNewCall;
+
+typedef struct radio_instance_new_op {
+    char* key;
+    char* dev;
+    char* slot;
+    char* modem;
+    int slot_index;
+    RADIO_INTERFACE max_version;
+    RADIO_AIDL_INTERFACE aidl_interface;
+    const RadioInterfaceDesc* interfaces;
+    gsize num_interfaces;
+    gsize next;
+    GBinderServiceManager* sm;
+    gulong sm_call_id;
+    RadioInstance* instance;
+    gulong tx_id;
+    GMainContext* context;
+    guint idle_id;
+    GSList* calls;
+} RadioInstanceNewOp;
+
+typedef struct radio_instance_batch RadioInstanceBatch;
+
+typedef struct radio_instance_batch_entry {
+    RadioInstanceBatch* batch;
+    guint index;
+    gulong id;
+    gboolean failed;
+} RadioInstanceBatchEntry;
+
+struct radio_instance_batch {
+    gulong id;
+    guint refs;
+    guint idle_id;
+    guint count;
+    RadioInstanceBatchEntry* entries;
+    GBinderServiceManager* sm;
+    RadioInstanceSpecFunc func;
+    GDestroyNotify destroy;
+    gpointer user_data;
+};
+
+static GSList* radio_instance_new_ops = NULL;
+static GSList* radio_instance_batches = NULL;
+static gulong radio_instance_new_last_id = 0;
+
 /*==========================================================================*
  * Implementation
  *==========================================================================*/
 
+static
+const char*
+radio_instance_unknown_name(
+    RadioInstance* self,
+    guint code)
+{
+    if (G_LIKELY(self)) {
+        RadioInstancePriv* priv = self->priv;
+        gpointer key = GUINT_TO_POINTER(code);
+        char* str;
+
+        /* Formatted once, stays around as long as the instance */
+        if (!priv->unknown_names) {
+            priv->unknown_names = g_hash_table_new_full(g_direct_hash,
+                g_direct_equal, NULL, g_free);
+        }
+        str = g_hash_table_lookup(priv->unknown_names, key);
+        if (!str) {
+            str = g_strdup_printf("%u", code);
+            g_hash_table_insert(priv->unknown_names, key, str);
+        }
+        return str;
+    }
+    return NULL;
+}
+
 static
 GQuark
 radio_instance_req_quark(
@@ -332,11 +562,17 @@ void
 radio_instance_notify_request_observers(
     RadioInstance* self,
     RADIO_REQ code,
+    guint32 resend_serial,
     GBinderLocalRequest* args)
 {
+    RadioInstancePriv* priv = self->priv;
+    const guint prev_code = priv->dispatch_code;
+    const guint32 prev_serial = priv->resend_serial;
     GQuark quark = 0;
     int i;
 
+    priv->dispatch_code = code;
+    priv->resend_serial = resend_serial;
     for (i = RADIO_OBSERVER_PRIORITY_COUNT - 1; i >= 0; i--) {
         guint id = radio_instance_signals[SIGNAL_OBSERVE_REQUEST_0 + i];
 
@@ -347,258 +583,1003 @@ radio_instance_notify_request_observers(
             g_signal_emit(self, id, quark, code, args);
         }
     }
+    priv->dispatch_code = prev_code;
+    priv->resend_serial = prev_serial;
 }
 
 static
-GBinderLocalReply*
-radio_instance_indication(
-    GBinderLocalObject* obj,
-    GBinderRemoteRequest* req,
-    guint code,
-    guint flags,
-    int* status,
-    void* user_data)
+const char*
+radio_instance_handler_code_name(
+    RadioInstance* self,
+    RADIO_HANDLER_TYPE type,
+    guint code)
 {
-    RadioInstance* self = RADIO_INSTANCE(user_data);
-    const RadioInterfaceDesc* desc = self->priv->desc;
-    const char* iface = gbinder_remote_request_interface(req);
-
-    if (gutil_strv_contains((const GStrV*)desc->ind_ifaces, iface)) {
-        GBinderReader reader;
-        guint type;
-
-        /* All these should be one-way */
-        GASSERT(flags & GBINDER_TX_FLAG_ONEWAY);
-        gbinder_remote_request_init_reader(req, &reader);
-        if (gbinder_reader_read_uint32(&reader, &type) &&
-            (type == RADIO_IND_UNSOLICITED || type == RADIO_IND_ACK_EXP)) {
-            const GQuark quark = radio_instance_ind_quark(self, code);
-            const guint* signals = radio_instance_signals +
-                SIGNAL_OBSERVE_INDICATION_0;
-            int p = RADIO_OBSERVER_PRIORITY_HIGHEST;
-            gboolean handled = FALSE;
-
-            /* High-priority observers are notified first */
-            for (; p > RADIO_OBSERVER_PRIORITY_DEFAULT; p--) {
-                if (signals[RADIO_OBSERVER_PRIORITY_INDEX(p)]) {
-                    g_signal_emit(self, signals
-                        [RADIO_OBSERVER_PRIORITY_INDEX(p)],
-                        quark, code, type, &reader);
-                }
-            }
-
-            /* rilConnected is a special case */
-            if (code == desc->ril_connected_ind) {
-                if (G_UNLIKELY(self->connected)) {
-                    /* We are only supposed to receive it once */
-                    GWARN("%s received unexpected rilConnected", self->slot);
-                } else {
-                    GDEBUG("%s connected", self->slot);
-                    self->connected = TRUE;
-                    g_signal_emit(self, radio_instance_signals
-                        [SIGNAL_CONNECTED], 0);
-                }
-            }
-
-            /* Notify handlers */
-            g_signal_emit(self, radio_instance_signals
-                [SIGNAL_HANDLE_INDICATION],
-                quark, code, type, &reader, &handled);
-
-            /* And then remaining observers in their priority order */
-            for (; p >= RADIO_OBSERVER_PRIORITY_LOWEST; p--) {
-                if (signals[RADIO_OBSERVER_PRIORITY_INDEX(p)]) {
-                    g_signal_emit(self, signals
-                        [RADIO_OBSERVER_PRIORITY_INDEX(p)],
-                        quark, code, type, &reader);
-                }
-            }
-
-            /* Ack unhandled indications */
-            if (type == RADIO_IND_ACK_EXP && !handled) {
-                GDEBUG("ack unhandled indication");
-                radio_instance_ack(self);
-            }
-            *status = GBINDER_STATUS_OK;
-        } else {
-            GWARN("Failed to decode indication %u", code);
-            *status = GBINDER_STATUS_FAILED;
-        }
-    } else {
-        GWARN("Unexpected indication %s %u", iface, code);
-        *status = GBINDER_STATUS_FAILED;
+    switch (type) {
+    case RADIO_HANDLER_REQUEST_OBSERVER:
+        return radio_instance_req_name(self, code);
+    case RADIO_HANDLER_RESPONSE_OBSERVER:
+    case RADIO_HANDLER_RESPONSE:
+        return radio_instance_resp_name(self, code);
+    case RADIO_HANDLER_INDICATION_OBSERVER:
+    case RADIO_HANDLER_INDICATION:
+        return radio_instance_ind_name(self, code);
+    case RADIO_HANDLER_TYPE_COUNT:
+        break;
     }
     return NULL;
 }
 
 static
-GBinderLocalReply*
-radio_instance_response(
-    GBinderLocalObject* obj,
-    GBinderRemoteRequest* req,
-    guint code,
-    guint flags,
-    int* status,
-    void* user_data)
+void
+radio_instance_handler_stats_add(
+    RadioHandlerStats* stats,
+    guint usec,
+    gboolean slow)
 {
-    RadioInstance* self = RADIO_INSTANCE(user_data);
-    RadioInstancePriv* priv = self->priv;
-    const RadioInterfaceDesc* desc = priv->desc;
-    const char* iface = gbinder_remote_request_interface(req);
-    const RadioResponseInfo* info = NULL;
-    GBinderReader reader;
-    gint32 ack_serial = 0;
-
-    gbinder_remote_request_init_reader(req, &reader);
-    if (gutil_strv_contains((GStrV*)desc->resp_ifaces, iface)) {
-        /* Weird terminology - response that requests an ack (request) */
-        if (code == desc->resp_ack_req) {
-            gbinder_reader_read_int32(&reader, &ack_serial);
-        } else {
-            /* All other responses have RadioResponseInfo */
-            info = desc->read_response_info(&reader);
-        }
-    } else {
-        GWARN("Unexpected response %s %u", iface, code);
-        *status = GBINDER_STATUS_FAILED;
-        return NULL;
+    stats->calls++;
+    stats->total_usec += usec;
+    if (stats->max_usec < usec) {
+        stats->max_usec = usec;
     }
-
-    /* All these should be one-way transactions */
-    GASSERT(flags & GBINDER_TX_FLAG_ONEWAY);
-
-    if (ack_serial) {
-        GDEBUG("%s %u acknowledgeRequest", iface, code);
-        g_signal_emit(self, radio_instance_signals[SIGNAL_ACK], 0,
-            ack_serial);
-    } else if (info) {
-        const GQuark quark = radio_instance_resp_quark(self, code);
-        const guint* signals = radio_instance_signals +
-            SIGNAL_OBSERVE_RESPONSE_0;
-        int p = RADIO_OBSERVER_PRIORITY_HIGHEST;
-        gboolean handled = FALSE;
-
-        /* High-priority observers are notified first */
-        for (; p > RADIO_OBSERVER_PRIORITY_DEFAULT; p--) {
-            if (signals[RADIO_OBSERVER_PRIORITY_INDEX(p)]) {
-                g_signal_emit(self, signals
-                    [RADIO_OBSERVER_PRIORITY_INDEX(p)],
-                    quark, code, info, &reader);
-            }
-        }
-
-        /* Then handlers */
-        g_signal_emit(self, radio_instance_signals
-            [SIGNAL_HANDLE_RESPONSE],
-            quark, code, info, &reader, &handled);
-
-        /* And then remaining observers in their priority order */
-        for (; p >= RADIO_OBSERVER_PRIORITY_LOWEST; p--) {
-            if (signals[RADIO_OBSERVER_PRIORITY_INDEX(p)]) {
-                g_signal_emit(self, signals
-                    [RADIO_OBSERVER_PRIORITY_INDEX(p)],
-                    quark, code, info, &reader);
-            }
-        }
-
-        /* Ack unhandled responses */
-        if (info->type == RADIO_RESP_SOLICITED_ACK_EXP && !handled) {
-            GDEBUG("ack unhandled response");
-            radio_instance_ack(self);
-        }
+    if (slow) {
+        stats->slow_calls++;
     }
-    *status = GBINDER_STATUS_OK;
-    return NULL;
 }
 
 static
 void
-radio_instance_drop_binder(
-    RadioInstance* self)
+radio_instance_handler_account(
+    RadioInstanceHandler* handler,
+    guint usec)
 {
+    RadioInstance* self = handler->instance;
     RadioInstancePriv* priv = self->priv;
-
-    if (priv->indication) {
-        gbinder_local_object_drop(priv->indication);
-        priv->indication = NULL;
-    }
-    if (priv->response) {
-        gbinder_local_object_drop(priv->response);
-        priv->response = NULL;
+    RadioInstanceTiming* timing = priv->timing;
+    const RADIO_HANDLER_TYPE type = handler->stats.type;
+    const guint code = priv->dispatch_code;
+    GHashTable* codes = timing->codes[type];
+    RadioHandlerStats* stats = g_hash_table_lookup(codes,
+        GUINT_TO_POINTER(code));
+    const gboolean slow = timing->slow_usec && usec >= timing->slow_usec;
+
+    if (!stats) {
+        stats = g_new0(RadioHandlerStats, 1);
+        stats->type = type;
+        stats->code = code;
+        g_hash_table_insert(codes, GUINT_TO_POINTER(code), stats);
     }
-    if (priv->remote) {
-        gbinder_remote_object_remove_handler(priv->remote, priv->death_id);
-        gbinder_remote_object_unref(priv->remote);
-        priv->death_id = 0;
-        priv->remote = NULL;
+    radio_instance_handler_stats_add(&handler->stats, usec, slow);
+    radio_instance_handler_stats_add(stats, usec, slow);
+    if (slow) {
+        GWARN("%s handler %lu took %u.%03u ms to process %s", self->slot,
+            handler->stats.id, usec / 1000, usec % 1000,
+            radio_instance_handler_code_name(self, type, code));
+        g_signal_emit(self, radio_instance_signals[SIGNAL_SLOW_HANDLER], 0,
+            &handler->stats, code, usec);
     }
 }
 
 static
 void
-radio_instance_remove(
-    const char* key)
+radio_instance_handler_pre(
+    gpointer data,
+    GClosure* closure)
 {
-    if (radio_instance_table &&
-        g_hash_table_contains(radio_instance_table, key)) {
-        g_hash_table_remove(radio_instance_table, key);
-        radio_registry_instance_removed(key);
-        if (g_hash_table_size(radio_instance_table) == 0) {
-            g_hash_table_unref(radio_instance_table);
-            radio_instance_table = NULL;
-        }
+    RadioInstanceHandler* handler = data;
+
+    /* Only the outermost invocation is timed */
+    if (!handler->depth++) {
+        handler->start = handler->instance->priv->timing ?
+            g_get_monotonic_time() : 0;
     }
 }
 
 static
 void
-radio_instance_died(
-    GBinderRemoteObject* obj,
-    void* user_data)
+radio_instance_handler_post(
+    gpointer data,
+    GClosure* closure)
 {
-    RadioInstance* self = RADIO_INSTANCE(user_data);
+    RadioInstanceHandler* handler = data;
 
-    self->dead = TRUE;
-    self->connected = FALSE;
-    GWARN("%s died", self->key);
-    radio_instance_ref(self);
-    radio_instance_drop_binder(self);
-    g_signal_emit(self, radio_instance_signals[SIGNAL_DEATH], 0);
-    radio_instance_remove(self->key);
-    radio_instance_unref(self);
+    if (!--handler->depth && handler->start &&
+        handler->instance->priv->timing) {
+        const gint64 usec = g_get_monotonic_time() - handler->start;
+
+        radio_instance_handler_account(handler, (guint) MIN(MAX(usec, 0),
+            G_MAXUINT));
+    }
 }
 
 static
 void
-radio_instance_gone(
-    gpointer key_ptr,
-    GObject* dead)
+radio_instance_handler_free(
+    gpointer data,
+    GClosure* closure)
 {
-    char* key = key_ptr;
+    RadioInstanceHandler* handler = data;
+    RadioInstancePriv* priv = handler->instance->priv;
 
-    GVERBOSE_("%s", key);
-    radio_instance_remove(key);
-    g_free(key);
+    g_hash_table_remove(priv->handlers, handler);
+    if (handler->ind_interest) {
+        radio_instance_ind_interest_unref(handler->instance,
+            handler->stats.code);
+    }
+    gutil_slice_free(handler);
 }
 
 static
-RadioInstance*
-radio_instance_create_desc(
-    GBinderServiceManager* sm,
-    GBinderRemoteObject* remote,
-    const char* dev,
-    const char* slot,
-    const char* key,
-    const char* modem,
-    int slot_index,
-    const RadioInterfaceDesc* desc)
-{
-    RadioInstance* self = g_object_new(RADIO_TYPE_INSTANCE, NULL);
-    RadioInstancePriv* priv = self->priv;
-    GBinderLocalRequest* req;
-    GBinderWriter writer;
+gulong
+radio_instance_connect_handler_full(
+    RadioInstance* self,
+    guint signal,
+    GQuark detail,
+    RADIO_HANDLER_TYPE type,
+    guint code,
+    gboolean ind_interest,
+    GCallback func,
+    gpointer user_data)
+{
+    RadioInstancePriv* priv = self->priv;
+    RadioInstanceHandler* handler = g_slice_new0(RadioInstanceHandler);
+    GClosure* closure = g_cclosure_new(func, user_data, NULL);
+    gulong id;
+
+    /* The guards are cheap unless handler timing is enabled */
+    handler->instance = self;
+    handler->stats.type = type;
+    handler->stats.code = code;
+    g_closure_add_marshal_guards(closure,
+        handler, radio_instance_handler_pre,
+        handler, radio_instance_handler_post);
+    g_closure_add_finalize_notifier(closure, handler,
+        radio_instance_handler_free);
+    g_hash_table_add(priv->handlers, handler);
+    if (ind_interest) {
+        handler->ind_interest = TRUE;
+        radio_instance_ind_interest_ref(self, code);
+    }
+    id = g_signal_connect_closure_by_id(self, signal, detail, closure, FALSE);
+    handler->stats.id = id;
+    return id;
+}
+
+static
+gulong
+radio_instance_connect_handler(
+    RadioInstance* self,
+    guint signal,
+    GQuark detail,
+    RADIO_HANDLER_TYPE type,
+    guint code,
+    GCallback func,
+    gpointer user_data)
+{
+    /* Indication observers and handlers keep those coming */
+    return radio_instance_connect_handler_full(self, signal, detail, type,
+        code, type == RADIO_HANDLER_INDICATION_OBSERVER ||
+        type == RADIO_HANDLER_INDICATION, func, user_data);
+}
+
+static
+gint
+radio_instance_handler_stats_compare(
+    gconstpointer a,
+    gconstpointer b)
+{
+    const RadioHandlerStats* s1 = a;
+    const RadioHandlerStats* s2 = b;
+
+    /* Biggest first */
+    return (s1->total_usec > s2->total_usec) ? (-1) :
+        (s1->total_usec < s2->total_usec) ? 1 : 0;
+}
+
+static
+void
+radio_instance_timing_free(
+    RadioInstanceTiming* timing)
+{
+    int i;
+
+    for (i = 0; i < RADIO_HANDLER_TYPE_COUNT; i++) {
+        g_hash_table_destroy(timing->codes[i]);
+    }
+    g_free(timing);
+}
+
+static
+void
+radio_instance_record_init(
+    RadioInstance* self,
+    RadioRecord* rec,
+    RADIO_RECORD_TYPE type,
+    guint code)
+{
+    memset(rec, 0, sizeof(*rec));
+    rec->type = type;
+    rec->interface_type = self->interface_type;
+    rec->interface = (self->interface_type == RADIO_INTERFACE_TYPE_AIDL) ?
+        self->interface_aidl : self->version;
+    rec->code = code;
+}
+
+static
+void
+radio_instance_record_request(
+    RadioInstance* self,
+    RADIO_REQ code,
+    GBinderLocalRequest* args,
+    gpointer recorder)
+{
+    RadioRecord rec;
+
+    radio_instance_record_init(self, &rec, RADIO_RECORD_REQUEST, code);
+    rec.extra = (gint32) self->priv->resend_serial;
+    radio_recorder_add_request(recorder, &rec, args,
+        radio_instance_rpc_header_size(self, code));
+}
+
+static
+void
+radio_instance_record_response(
+    RadioInstance* self,
+    RADIO_RESP code,
+    const RadioResponseInfo* info,
+    const GBinderReader* args,
+    gpointer recorder)
+{
+    RadioRecord rec;
+
+    radio_instance_record_init(self, &rec, RADIO_RECORD_RESPONSE, code);
+    rec.serial = info->serial;
+    rec.extra = info->error;
+    radio_recorder_add_reader(recorder, &rec, args);
+}
+
+static
+void
+radio_instance_record_indication(
+    RadioInstance* self,
+    RADIO_IND code,
+    RADIO_IND_TYPE type,
+    const GBinderReader* args,
+    gpointer recorder)
+{
+    RadioRecord rec;
+
+    radio_instance_record_init(self, &rec, RADIO_RECORD_INDICATION, code);
+    rec.extra = type;
+    radio_recorder_add_reader(recorder, &rec, args);
+}
+
+static
+void
+radio_instance_ack_flush(
+    RadioInstance* self)
+{
+    RadioInstancePriv* priv = self->priv;
+
+    if (priv->ack_idle_id) {
+        radio_source_remove(priv->context, priv->ack_idle_id);
+        priv->ack_idle_id = 0;
+    }
+    if (priv->acks_pending) {
+        const guint32 code = priv->desc->ack_req;
+        GBinderLocalRequest* req = gbinder_client_new_request2(priv->client,
+            code);
+
+        /* One responseAcknowledgement covers everything received so far */
+        GDEBUG("%s acking %u unhandled message(s)", self->slot,
+            priv->acks_pending);
+        priv->acks_pending = 0;
+        radio_instance_notify_request_observers(self, code, 0, req);
+        if (gbinder_client_transact(priv->client, code,
+            GBINDER_TX_FLAG_ONEWAY, req, NULL, NULL, NULL)) {
+            priv->ack_stats.sent++;
+        }
+        gbinder_local_request_unref(req);
+    }
+}
+
+static
+gboolean
+radio_instance_ack_idle(
+    gpointer user_data)
+{
+    RadioInstance* self = RADIO_INSTANCE(user_data);
+
+    self->priv->ack_idle_id = 0;
+    radio_instance_ack_flush(self);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+radio_instance_ack_unhandled(
+    RadioInstance* self)
+{
+    RadioInstancePriv* priv = self->priv;
+
+    priv->ack_stats.requested++;
+    if (!priv->ack_batching) {
+        if (radio_instance_ack(self)) {
+            priv->ack_stats.sent++;
+        }
+    } else if (priv->desc->ack_req != RADIO_REQ_NONE) {
+        /* Defer the ack until the current burst has been dispatched */
+        priv->acks_pending++;
+        if (!priv->ack_idle_id) {
+            priv->ack_idle_id = radio_timeout_add(priv->context, 0,
+                radio_instance_ack_idle, self);
+        }
+    }
+}
+
+static
+const RadioIndFilterDesc*
+radio_instance_ind_filter_desc(
+    const RadioInterfaceDesc* desc)
+{
+    switch (desc->interface_type) {
+    case RADIO_INTERFACE_TYPE_HIDL:
+        return (desc->version >= RADIO_INTERFACE_1_5) ?
+            &radio_ind_filter_1_5 :
+            (desc->version >= RADIO_INTERFACE_1_2) ?
+            &radio_ind_filter_1_2 :
+            &radio_ind_filter_1_0;
+    case RADIO_INTERFACE_TYPE_AIDL:
+        if (desc->aidl_interface == RADIO_NETWORK_INTERFACE) {
+            return &radio_network_ind_filter;
+        }
+        break;
+    case RADIO_INTERFACE_TYPE_NONE:
+        break;
+    }
+    /* The interface has no indication filter */
+    return NULL;
+}
+
+static
+guint32
+radio_instance_ind_filter_wanted(
+    RadioInstance* self)
+{
+    RadioInstancePriv* priv = self->priv;
+    const RadioIndFilterDesc* fd = priv->ind_filter_desc;
+    guint32 filter = fd->mask;
+
+    if (priv->ind_filter_auto && !priv->ind_interest_any) {
+        guint32 controlled = 0, wanted = 0;
+        guint i;
+
+        for (i = 0; i < fd->count; i++) {
+            const RadioIndFilterBit* fb = fd->bits + i;
+
+            controlled |= fb->bit;
+            if (priv->ind_interest && g_hash_table_contains
+                (priv->ind_interest, GUINT_TO_POINTER(fb->code))) {
+                wanted |= fb->bit;
+            }
+        }
+
+        /* Bits which don't control any indications stay set */
+        filter = (fd->mask & ~controlled) | (fd->mask & wanted);
+    }
+
+    /* Power save trumps everything */
+    return priv->power_save ? (filter & RADIO_IND_FILTER_POWER_SAVE) : filter;
+}
+
+static
+void
+radio_instance_ind_filter_update(
+    RadioInstance* self)
+{
+    RadioInstancePriv* priv = self->priv;
+    const RadioIndFilterDesc* fd = priv->ind_filter_desc;
+
+    if (fd && !self->dead && self->connected) {
+        const guint32 filter = radio_instance_ind_filter_wanted(self);
+
+        if (priv->ind_filter != filter) {
+            GBinderLocalRequest* req = gbinder_client_new_request2(priv->client,
+                fd->req);
+            GBinderWriter writer;
+
+            /* Serial 0 is never used by RadioBase, the response is ignored */
+            GDEBUG("%s indication filter 0x%02x => 0x%02x", self->slot,
+                priv->ind_filter, filter);
+            gbinder_local_request_init_writer(req, &writer);
+            gbinder_writer_append_int32(&writer, 0);
+            gbinder_writer_append_int32(&writer, filter);
+            radio_instance_notify_request_observers(self, fd->req, 0, req);
+            if (gbinder_client_transact(priv->client, fd->req,
+                GBINDER_TX_FLAG_ONEWAY, req, NULL, NULL, NULL)) {
+                priv->ind_filter = filter;
+            }
+            gbinder_local_request_unref(req);
+        }
+    }
+}
+
+static
+void
+radio_instance_device_state_update(
+    RadioInstance* self)
+{
+    RadioInstancePriv* priv = self->priv;
+    const gboolean power_save = (priv->power_save > 0);
+
+    /* The modem starts in the normal mode */
+    if (!self->dead && self->connected && priv->client &&
+        priv->power_save_sent != power_save) {
+        const RadioInterfaceDesc* desc = priv->desc;
+        GBinderLocalRequest* req;
+        GBinderWriter writer;
+        guint32 code;
+
+        if (desc->interface_type == RADIO_INTERFACE_TYPE_HIDL) {
+            code = RADIO_REQ_SEND_DEVICE_STATE;
+        } else if (desc->aidl_interface == RADIO_MODEM_INTERFACE) {
+            code = RADIO_MODEM_REQ_SEND_DEVICE_STATE;
+        } else {
+            /* This interface doesn't have sendDeviceState */
+            return;
+        }
+
+        /* Serial 0 is never used by RadioBase, the response is ignored */
+        GDEBUG("%s power save %s", self->slot, power_save ? "on" : "off");
+        req = gbinder_client_new_request2(priv->client, code);
+        gbinder_local_request_init_writer(req, &writer);
+        gbinder_writer_append_int32(&writer, 0);
+        gbinder_writer_append_int32(&writer,
+            RADIO_DEVICE_STATE_POWER_SAVE_MODE);
+        gbinder_writer_append_bool(&writer, power_save);
+        radio_instance_notify_request_observers(self, code, 0, req);
+        if (gbinder_client_transact(priv->client, code,
+            GBINDER_TX_FLAG_ONEWAY, req, NULL, NULL, NULL)) {
+            priv->power_save_sent = power_save;
+        }
+        gbinder_local_request_unref(req);
+    }
+}
+
+static
+gboolean
+radio_instance_ind_filter_idle(
+    gpointer user_data)
+{
+    RadioInstance* self = RADIO_INSTANCE(user_data);
+
+    self->priv->ind_filter_id = 0;
+    radio_instance_ind_filter_update(self);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+radio_instance_ind_filter_changed(
+    RadioInstance* self)
+{
+    RadioInstancePriv* priv = self->priv;
+
+    /* Handlers tend to come and go in bunches, coalesce the updates */
+    if ((priv->ind_filter_auto || priv->power_save) &&
+        !priv->ind_filter_id && priv->client) {
+        priv->ind_filter_id = radio_timeout_add(priv->context, 0,
+            radio_instance_ind_filter_idle, self);
+    }
+}
+
+static
+gboolean
+radio_instance_foreign_context(
+    RadioInstance* self)
+{
+    GMainContext* context = self->priv->context;
+
+    /* TRUE if the call has to be marshalled to the instance's context */
+    return context && !g_main_context_is_owner(context);
+}
+
+static
+void
+radio_instance_invoke(
+    RadioInstance* self,
+    GSourceFunc func,
+    gpointer data,
+    GDestroyNotify destroy)
+{
+    GSource* source = g_idle_source_new();
+
+    /*
+     * Always go through the queue, even if the context happens to be
+     * available to this thread right now, to preserve the order of
+     * the events and never run the handlers on the binder thread.
+     */
+    g_source_set_priority(source, G_PRIORITY_DEFAULT);
+    g_source_set_callback(source, func, data, destroy);
+    g_source_attach(source, self->priv->context);
+    g_source_unref(source);
+}
+
+static
+void
+radio_instance_event_free(
+    gpointer data)
+{
+    RadioInstanceEvent* event = data;
+
+    gbinder_remote_request_unref(event->req);
+    radio_instance_unref(event->instance);
+    gutil_slice_free(event);
+}
+
+static
+void
+radio_instance_post_event(
+    RadioInstance* self,
+    GSourceFunc func,
+    GBinderRemoteRequest* req,
+    guint code,
+    guint flags)
+{
+    RadioInstanceEvent* event = g_slice_new(RadioInstanceEvent);
+
+    event->instance = radio_instance_ref(self);
+    event->req = gbinder_remote_request_ref(req);
+    event->code = code;
+    event->flags = flags;
+    radio_instance_invoke(self, func, event, radio_instance_event_free);
+}
+
+static
+GBinderLocalReply*
+radio_instance_handle_indication(
+    GBinderLocalObject* obj,
+    GBinderRemoteRequest* req,
+    guint code,
+    guint flags,
+    int* status,
+    void* user_data)
+{
+    RadioInstance* self = RADIO_INSTANCE(user_data);
+    const RadioInterfaceDesc* desc = self->priv->desc;
+    const char* iface = gbinder_remote_request_interface(req);
+
+    if (gutil_strv_contains((const GStrV*)desc->ind_ifaces, iface)) {
+        GBinderReader reader;
+        guint type;
+
+        /* All these should be one-way */
+        GASSERT(flags & GBINDER_TX_FLAG_ONEWAY);
+        gbinder_remote_request_init_reader(req, &reader);
+        if (gbinder_reader_read_uint32(&reader, &type) &&
+            (type == RADIO_IND_UNSOLICITED || type == RADIO_IND_ACK_EXP)) {
+            const GQuark quark = radio_instance_ind_quark(self, code);
+            const guint* signals = radio_instance_signals +
+                SIGNAL_OBSERVE_INDICATION_0;
+            RadioInstancePriv* priv = self->priv;
+            const guint prev_code = priv->dispatch_code;
+            int p = RADIO_OBSERVER_PRIORITY_HIGHEST;
+            gboolean handled = FALSE;
+
+            if (priv->ind_meter) {
+                gsize size = 0;
+
+                gbinder_reader_get_data(&reader, &size);
+                radio_ind_meter_add(priv->ind_meter, code, size,
+                    g_get_monotonic_time());
+            }
+
+            RADIO_PROBE3(indication, priv->slot, code, type);
+            priv->dispatch_code = code;
+
+            /* High-priority observers are notified first */
+            for (; p > RADIO_OBSERVER_PRIORITY_DEFAULT; p--) {
+                if (signals[RADIO_OBSERVER_PRIORITY_INDEX(p)]) {
+                    g_signal_emit(self, signals
+                        [RADIO_OBSERVER_PRIORITY_INDEX(p)],
+                        quark, code, type, &reader);
+                }
+            }
+
+            /* rilConnected is a special case */
+            if (code == desc->ril_connected_ind) {
+                if (G_UNLIKELY(self->connected)) {
+                    /* We are only supposed to receive it once */
+                    GWARN("%s received unexpected rilConnected", self->slot);
+                } else {
+                    GDEBUG("%s connected", self->slot);
+                    self->connected = TRUE;
+                    radio_instance_device_state_update(self);
+                    radio_instance_ind_filter_changed(self);
+                    g_signal_emit(self, radio_instance_signals
+                        [SIGNAL_CONNECTED], 0);
+                }
+            }
+
+            /* Notify handlers */
+            g_signal_emit(self, radio_instance_signals
+                [SIGNAL_HANDLE_INDICATION],
+                quark, code, type, &reader, &handled);
+
+            /* And then remaining observers in their priority order */
+            for (; p >= RADIO_OBSERVER_PRIORITY_LOWEST; p--) {
+                if (signals[RADIO_OBSERVER_PRIORITY_INDEX(p)]) {
+                    g_signal_emit(self, signals
+                        [RADIO_OBSERVER_PRIORITY_INDEX(p)],
+                        quark, code, type, &reader);
+                }
+            }
+
+            priv->dispatch_code = prev_code;
+            RADIO_PROBE2(indication_done, priv->slot, code);
+
+            /* Ack unhandled indications */
+            if (type == RADIO_IND_ACK_EXP && !handled) {
+                GDEBUG("ack unhandled indication");
+                radio_instance_ack_unhandled(self);
+            }
+            *status = GBINDER_STATUS_OK;
+        } else {
+            GWARN("Failed to decode indication %u", code);
+            *status = GBINDER_STATUS_FAILED;
+        }
+    } else {
+        GWARN("Unexpected indication %s %u", iface, code);
+        *status = GBINDER_STATUS_FAILED;
+    }
+    return NULL;
+}
+
+static
+GBinderLocalReply*
+radio_instance_handle_response(
+    GBinderLocalObject* obj,
+    GBinderRemoteRequest* req,
+    guint code,
+    guint flags,
+    int* status,
+    void* user_data)
+{
+    RadioInstance* self = RADIO_INSTANCE(user_data);
+    RadioInstancePriv* priv = self->priv;
+    const RadioInterfaceDesc* desc = priv->desc;
+    const char* iface = gbinder_remote_request_interface(req);
+    const RadioResponseInfo* info = NULL;
+    GBinderReader reader;
+    gint32 ack_serial = 0;
+
+    gbinder_remote_request_init_reader(req, &reader);
+    if (gutil_strv_contains((GStrV*)desc->resp_ifaces, iface)) {
+        /* Weird terminology - response that requests an ack (request) */
+        if (code == desc->resp_ack_req) {
+            gbinder_reader_read_int32(&reader, &ack_serial);
+        } else {
+            /* All other responses have RadioResponseInfo */
+            info = desc->read_response_info(&reader);
+        }
+    } else {
+        GWARN("Unexpected response %s %u", iface, code);
+        *status = GBINDER_STATUS_FAILED;
+        return NULL;
+    }
+
+    /* All these should be one-way transactions */
+    GASSERT(flags & GBINDER_TX_FLAG_ONEWAY);
+
+    if (ack_serial) {
+        GDEBUG("%s %u acknowledgeRequest", iface, code);
+        g_signal_emit(self, radio_instance_signals[SIGNAL_ACK], 0,
+            ack_serial);
+    } else if (info) {
+        const GQuark quark = radio_instance_resp_quark(self, code);
+        const guint* signals = radio_instance_signals +
+            SIGNAL_OBSERVE_RESPONSE_0;
+        int p = RADIO_OBSERVER_PRIORITY_HIGHEST;
+        gboolean handled = FALSE;
+        GBinderRemoteRequest* prev = priv->resp_msg;
+        const guint prev_code = priv->dispatch_code;
+
+        RADIO_PROBE3(response, priv->slot, code, info->serial);
+
+        /* The reader refers to the data owned by this message */
+        priv->resp_msg = req;
+        priv->dispatch_code = code;
+
+        /* High-priority observers are notified first */
+        for (; p > RADIO_OBSERVER_PRIORITY_DEFAULT; p--) {
+            if (signals[RADIO_OBSERVER_PRIORITY_INDEX(p)]) {
+                g_signal_emit(self, signals
+                    [RADIO_OBSERVER_PRIORITY_INDEX(p)],
+                    quark, code, info, &reader);
+            }
+        }
+
+        /* Then handlers */
+        g_signal_emit(self, radio_instance_signals
+            [SIGNAL_HANDLE_RESPONSE],
+            quark, code, info, &reader, &handled);
+
+        /* And then remaining observers in their priority order */
+        for (; p >= RADIO_OBSERVER_PRIORITY_LOWEST; p--) {
+            if (signals[RADIO_OBSERVER_PRIORITY_INDEX(p)]) {
+                g_signal_emit(self, signals
+                    [RADIO_OBSERVER_PRIORITY_INDEX(p)],
+                    quark, code, info, &reader);
+            }
+        }
+
+        priv->resp_msg = prev;
+        priv->dispatch_code = prev_code;
+        RADIO_PROBE2(response_done, priv->slot, code);
+
+        /* Ack unhandled responses */
+        if (info->type == RADIO_RESP_SOLICITED_ACK_EXP && !handled) {
+            GDEBUG("ack unhandled response");
+            radio_instance_ack_unhandled(self);
+        }
+    }
+    *status = GBINDER_STATUS_OK;
+    return NULL;
+}
+
+static
+gboolean
+radio_instance_indication_event(
+    gpointer data)
+{
+    RadioInstanceEvent* event = data;
+    int status;
+
+    radio_instance_handle_indication(NULL, event->req, event->code,
+        event->flags, &status, event->instance);
+    return G_SOURCE_REMOVE;
+}
+
+static
+GBinderLocalReply*
+radio_instance_indication(
+    GBinderLocalObject* obj,
+    GBinderRemoteRequest* req,
+    guint code,
+    guint flags,
+    int* status,
+    void* user_data)
+{
+    RadioInstance* self = RADIO_INSTANCE(user_data);
+
+    if (radio_instance_foreign_context(self)) {
+        /* One-way transaction, nobody is waiting for the status */
+        radio_instance_post_event(self, radio_instance_indication_event,
+            req, code, flags);
+        *status = GBINDER_STATUS_OK;
+        return NULL;
+    } else {
+        return radio_instance_handle_indication(obj, req, code, flags,
+            status, user_data);
+    }
+}
+
+static
+gboolean
+radio_instance_response_event(
+    gpointer data)
+{
+    RadioInstanceEvent* event = data;
     int status;
 
+    radio_instance_handle_response(NULL, event->req, event->code,
+        event->flags, &status, event->instance);
+    return G_SOURCE_REMOVE;
+}
+
+static
+GBinderLocalReply*
+radio_instance_response(
+    GBinderLocalObject* obj,
+    GBinderRemoteRequest* req,
+    guint code,
+    guint flags,
+    int* status,
+    void* user_data)
+{
+    RadioInstance* self = RADIO_INSTANCE(user_data);
+
+    if (radio_instance_foreign_context(self)) {
+        radio_instance_post_event(self, radio_instance_response_event,
+            req, code, flags);
+        *status = GBINDER_STATUS_OK;
+        return NULL;
+    } else {
+        return radio_instance_handle_response(obj, req, code, flags,
+            status, user_data);
+    }
+}
+
+static
+void
+radio_instance_drop_binder(
+    RadioInstance* self)
+{
+    RadioInstancePriv* priv = self->priv;
+
+    if (priv->ack_idle_id) {
+        radio_source_remove(priv->context, priv->ack_idle_id);
+        priv->ack_idle_id = 0;
+    }
+    if (priv->ind_filter_id) {
+        radio_source_remove(priv->context, priv->ind_filter_id);
+        priv->ind_filter_id = 0;
+    }
+    priv->acks_pending = 0;
+    if (priv->indication) {
+        gbinder_local_object_drop(priv->indication);
+        priv->indication = NULL;
+    }
+    if (priv->response) {
+        gbinder_local_object_drop(priv->response);
+        priv->response = NULL;
+    }
+    if (priv->remote) {
+        gbinder_remote_object_remove_handler(priv->remote, priv->death_id);
+        gbinder_remote_object_unref(priv->remote);
+        priv->death_id = 0;
+        priv->remote = NULL;
+    }
+}
+
+static
+guint
+radio_instance_key_hash(
+    gconstpointer key)
+{
+    const RadioInstanceKey* k = key;
+
+    return ((g_str_hash(k->dev) * 31 + g_str_hash(k->name)) * 31 +
+        k->version) * 31 + k->aidl_interface;
+}
+
+static
+gboolean
+radio_instance_key_equal(
+    gconstpointer a,
+    gconstpointer b)
+{
+    const RadioInstanceKey* k1 = a;
+    const RadioInstanceKey* k2 = b;
+
+    return k1->version == k2->version &&
+        k1->aidl_interface == k2->aidl_interface &&
+        !g_strcmp0(k1->name, k2->name) &&
+        !g_strcmp0(k1->dev, k2->dev);
+}
+
+static
+RadioInstance*
+radio_instance_lookup(
+    const char* dev,
+    const char* name,
+    RADIO_INTERFACE version,
+    RADIO_AIDL_INTERFACE aidl_interface)
+{
+    if (radio_instance_table) {
+        RadioInstanceKey key;
+
+        key.dev = dev;
+        key.name = name;
+        key.version = version;
+        key.aidl_interface = aidl_interface;
+        return g_hash_table_lookup(radio_instance_table, &key);
+    }
+    return NULL;
+}
+
+static
+gboolean
+radio_instance_free_all_idle(
+    gpointer all)
+{
+    g_free(all);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+radio_instance_remove(
+    RadioInstance* self)
+{
+    const RadioInstanceKey* key = &self->priv->table_key;
+
+    /* Make sure that it's not another instance with the same key */
+    if (radio_instance_table &&
+        g_hash_table_lookup(radio_instance_table, key) == self) {
+        g_hash_table_remove(radio_instance_table, key);
+        radio_instance_table_gen++;
+        radio_registry_instance_removed(self->key);
+        if (g_hash_table_size(radio_instance_table) == 0) {
+            g_hash_table_unref(radio_instance_table);
+            radio_instance_table = NULL;
+            if (radio_instance_all) {
+                /*
+                 * The last snapshot may still be in use by the caller
+                 * of radio_instance_get_all() and there's no instance
+                 * left whose idle pool could take care of it.
+                 */
+                g_idle_add(radio_instance_free_all_idle, radio_instance_all);
+                radio_instance_all = NULL;
+            }
+        }
+    }
+}
+
+static
+gboolean
+radio_instance_died_event(
+    gpointer user_data)
+{
+    RadioInstance* self = RADIO_INSTANCE(user_data);
+
+    if (!self->dead) {
+        self->dead = TRUE;
+        self->connected = FALSE;
+        GWARN("%s died", self->key);
+        RADIO_PROBE1(instance_death, self->slot);
+        radio_instance_drop_binder(self);
+        g_signal_emit(self, radio_instance_signals[SIGNAL_DEATH], 0);
+        radio_instance_remove(self);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+radio_instance_died(
+    GBinderRemoteObject* obj,
+    void* user_data)
+{
+    RadioInstance* self = RADIO_INSTANCE(user_data);
+
+    radio_instance_ref(self);
+    if (radio_instance_foreign_context(self)) {
+        radio_instance_invoke(self, radio_instance_died_event, self,
+            g_object_unref);
+    } else {
+        radio_instance_died_event(self);
+        radio_instance_unref(self);
+    }
+}
+
+static
+void
+radio_instance_gone(
+    gpointer user_data,
+    GObject* dead)
+{
+    RadioInstance* self = RADIO_INSTANCE(dead);
+
+    /* Weak refs are notified before the instance is finalized */
+    GVERBOSE_("%s", self->key);
+    radio_instance_remove(self);
+}
+
+static
+RadioInstance*
+radio_instance_new_desc(
+    GBinderServiceManager* sm,
+    GBinderRemoteObject* remote,
+    const char* dev,
+    const char* slot,
+    const char* key,
+    const char* modem,
+    int slot_index,
+    const RadioInterfaceDesc* desc)
+{
+    RadioInstance* self = g_object_new(RADIO_TYPE_INSTANCE, NULL);
+    RadioInstancePriv* priv = self->priv;
+
     self->slot = priv->slot = g_strdup(slot);
     self->dev = priv->dev = g_strdup(dev);
     self->key = priv->key = g_strdup(key);
@@ -610,6 +1591,11 @@ radio_instance_create_desc(
     self->connected = !desc->ril_connected_ind; /* no signal => connected */
 
     priv->desc = desc;
+    priv->ind_filter_desc = radio_instance_ind_filter_desc(desc);
+    if (priv->ind_filter_desc) {
+        /* Everything is enabled by default */
+        priv->ind_filter = priv->ind_filter_desc->mask;
+    }
     priv->remote = gbinder_remote_object_ref(remote);
     priv->indication = gbinder_servicemanager_new_local_object2(sm,
         desc->ind_ifaces, radio_instance_indication, self);
@@ -620,140 +1606,644 @@ radio_instance_create_desc(
     priv->client = gbinder_client_new2(remote, desc->iface_info,
         desc->iface_info_count);
 
-    gbinder_local_object_set_stability(priv->indication, desc->stability);
-    gbinder_local_object_set_stability(priv->response, desc->stability);
+    gbinder_local_object_set_stability(priv->indication, desc->stability);
+    gbinder_local_object_set_stability(priv->response, desc->stability);
+
+    GDEBUG("Instance '%s'", slot);
+    RADIO_PROBE3(instance_create, self->slot, desc->interface_type,
+        desc->version);
+
+    /*
+     * Don't destroy GBinderServiceManager right away in case if we
+     * have another slot to initialize.
+     */
+    gutil_idle_pool_add(priv->idle, gbinder_servicemanager_ref(sm),
+        (GDestroyNotify) gbinder_servicemanager_unref);
+    return self;
+}
+
+static
+GBinderLocalRequest*
+radio_instance_set_response_functions_req(
+    RadioInstance* self)
+{
+    RadioInstancePriv* priv = self->priv;
+    GBinderLocalRequest* req = gbinder_client_new_request2(priv->client,
+        priv->desc->set_response_functions_req);
+    GBinderWriter writer;
+
+    /* IRadio::setResponseFunctions */
+    gbinder_local_request_init_writer(req, &writer);
+    gbinder_writer_append_local_object(&writer, priv->response);
+    gbinder_writer_append_local_object(&writer, priv->indication);
+    return req;
+}
+
+static
+RadioInstance*
+radio_instance_create_desc(
+    GBinderServiceManager* sm,
+    GBinderRemoteObject* remote,
+    const char* dev,
+    const char* slot,
+    const char* key,
+    const char* modem,
+    int slot_index,
+    const RadioInterfaceDesc* desc)
+{
+    RadioInstance* self = radio_instance_new_desc(sm, remote, dev, slot,
+        key, modem, slot_index, desc);
+    GBinderLocalRequest* req = radio_instance_set_response_functions_req(self);
+    int status;
+
+    gbinder_remote_reply_unref(gbinder_client_transact_sync_reply
+        (self->priv->client, desc->set_response_functions_req, req, &status));
+    GVERBOSE_("setResponseFunctions %s status %d", slot, status);
+    gbinder_local_request_unref(req);
+    return self;
+}
+
+static
+void
+radio_instance_reset_response_functions(
+    RadioInstance* self)
+{
+    RadioInstancePriv* priv = self->priv;
+    GBinderLocalRequest* req = radio_instance_set_response_functions_req(self);
+
+    /* Goes after whatever has already completed */
+    gbinder_client_transact(priv->client,
+        priv->desc->set_response_functions_req, 0, req, NULL, NULL, NULL);
+    gbinder_local_request_unref(req);
+}
+
+static
+const RadioInterfaceDesc*
+radio_instance_interfaces(
+    RADIO_AIDL_INTERFACE aidl_interface,
+    gsize* count)
+{
+    if (aidl_interface == RADIO_AIDL_INTERFACE_NONE) {
+        *count = G_N_ELEMENTS(radio_hidl_interfaces);
+        return radio_hidl_interfaces;
+    } else if (aidl_interface > RADIO_AIDL_INTERFACE_NONE &&
+        aidl_interface < RADIO_AIDL_INTERFACE_COUNT) {
+        *count = 1;
+        return radio_aidl_interfaces + aidl_interface;
+    } else {
+        *count = 0;
+        return NULL;
+    }
+}
+
+static
+RadioInstance*
+radio_instance_create(
+    const char* dev,
+    const char* slot,
+    const char* key,
+    const char* modem,
+    int slot_index,
+    RADIO_INTERFACE max_version,
+    RADIO_AIDL_INTERFACE aidl_interface)
+{
+    RadioInstance* self = NULL;
+    GBinderServiceManager* sm = gbinder_servicemanager_new(dev);
+    const RadioInterfaceDesc* interfaces;
+    const RadioInterfaceDesc* descs[RADIO_INTERFACE_COUNT];
+    char* names[RADIO_INTERFACE_COUNT + 1];
+    guint order[RADIO_INTERFACE_COUNT];
+    char* cache_key = NULL;
+    gsize i, n = 0, num_interfaces;
+
+    if (!sm) {
+        GERR_("Failed to get ServiceManager on %s", dev);
+        return NULL;
+    }
+
+    interfaces = radio_instance_interfaces(aidl_interface, &num_interfaces);
+    for (i = 0; i < num_interfaces; i++) {
+        const RadioInterfaceDesc* desc = interfaces + i;
+
+        if (desc->version <= max_version) {
+            descs[n] = desc;
+            names[n++] = g_strconcat(desc->radio_iface, "/", slot, NULL);
+        }
+    }
+    names[n] = NULL;
+
+    /* There's nothing to choose from for AIDL */
+    if (aidl_interface == RADIO_AIDL_INTERFACE_NONE) {
+        cache_key = g_strconcat("IRadio/", slot, NULL);
+        n = radio_version_cache_order(sm, dev, cache_key,
+            (const char* const*) names, n, order);
+    } else {
+        for (i = 0; i < n; i++) {
+            order[i] = i;
+        }
+    }
+
+    for (i = 0; i < n && !self; i++) {
+        const char* fqname = names[order[i]];
+        GBinderRemoteObject* obj = /* autoreleased */
+            gbinder_servicemanager_get_service_sync(sm, fqname, NULL);
+
+        if (obj) {
+            GINFO("Connected to %s", fqname);
+            self = radio_instance_create_desc(sm, obj, dev, slot,
+                key, modem, slot_index, descs[order[i]]);
+            if (cache_key) {
+                radio_version_cache_update(dev, cache_key, fqname);
+            }
+        }
+    }
+
+    g_strfreev(names);
+    g_free(cache_key);
+    gbinder_servicemanager_unref(sm);
+
+    return self;
+}
+
+static
+void
+radio_instance_add(
+    RadioInstance* self,
+    RADIO_INTERFACE version,
+    RADIO_AIDL_INTERFACE aidl_interface)
+{
+    RadioInstanceKey* key = &self->priv->table_key;
+
+    /* The key is what was requested, not what we have got */
+    key->dev = self->dev;
+    key->name = self->slot;
+    key->version = version;
+    key->aidl_interface = aidl_interface;
+    if (!radio_instance_table) {
+        radio_instance_table = g_hash_table_new(radio_instance_key_hash,
+            radio_instance_key_equal);
+    }
+    g_hash_table_replace(radio_instance_table, key, self);
+    radio_instance_table_gen++;
+    g_object_weak_ref(G_OBJECT(self), radio_instance_gone, NULL);
+    radio_registry_instance_added(self);
+}
+
+static
+char*
+radio_instance_make_key(
+    const char* dev,
+    const char* name,
+    RADIO_INTERFACE version,
+    RADIO_AIDL_INTERFACE aidl_interface)
+{
+    return g_strdup_printf("%s:%s:%d:%d", dev, name, version, aidl_interface);
+}
+
+static
+void
+radio_instance_tx_free(
+    RadioInstanceTx* tx)
+{
+    radio_instance_unref(tx->instance);
+    gutil_slice_free(tx);
+}
+
+static
+gboolean
+radio_instance_tx_finish(
+    gpointer tx_data)
+{
+    RadioInstanceTx* tx = tx_data;
+
+    /* Deliver the completion recorded in the other context */
+    if (tx->completed && tx->complete) {
+        tx->complete(tx->instance, tx->id, tx->status, tx->user_data1,
+            tx->user_data2);
+    }
+    if (tx->destroy) {
+        tx->destroy(tx->user_data1, tx->user_data2);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+radio_instance_tx_destroy(
+    gpointer tx_data)
+{
+    RadioInstanceTx* tx = tx_data;
+
+    if (radio_instance_foreign_context(tx->instance)) {
+        radio_instance_invoke(tx->instance, radio_instance_tx_finish, tx,
+            (GDestroyNotify) radio_instance_tx_free);
+    } else {
+        if (tx->destroy) {
+            tx->destroy(tx->user_data1, tx->user_data2);
+        }
+        radio_instance_tx_free(tx);
+    }
+}
+
+static
+void
+radio_instance_tx_complete(
+    GBinderClient* client,
+    GBinderRemoteReply* reply,
+    int status,
+    void* tx_data)
+{
+    RadioInstanceTx* tx = tx_data;
+
+    if (radio_instance_foreign_context(tx->instance)) {
+        /* Completion is delivered together with destroy notification */
+        tx->completed = TRUE;
+        tx->status = status;
+    } else if (tx->complete) {
+        tx->complete(tx->instance, tx->id, status, tx->user_data1,
+            tx->user_data2);
+    }
+}
+
+static
+void
+radio_instance_new_call_free(
+    RadioInstanceNewCall* call)
+{
+    if (call->destroy) {
+        call->destroy(call->user_data);
+    }
+    gutil_slice_free(call);
+}
+
+static
+void
+radio_instance_new_op_free(
+    RadioInstanceNewOp* op)
+{
+    if (op->sm_call_id) {
+        gbinder_servicemanager_cancel(op->sm, op->sm_call_id);
+    }
+    if (op->tx_id) {
+        gbinder_client_cancel(op->instance->priv->client, op->tx_id);
+    }
+    if (op->idle_id) {
+        radio_source_remove(op->context, op->idle_id);
+    }
+    g_slist_free_full(op->calls, (GDestroyNotify)
+        radio_instance_new_call_free);
+    gbinder_servicemanager_unref(op->sm);
+    radio_instance_unref(op->instance);
+    g_main_context_unref(op->context);
+    g_free(op->key);
+    g_free(op->dev);
+    g_free(op->slot);
+    g_free(op->modem);
+    gutil_slice_free(op);
+}
+
+static
+void
+radio_instance_new_op_complete(
+    RadioInstanceNewOp* op)
+{
+    GSList* l;
+
+    /* Detach the operation so that callbacks can't cancel it under us */
+    radio_instance_new_ops = g_slist_remove(radio_instance_new_ops, op);
+    op->sm_call_id = 0;
+    op->tx_id = 0;
+    op->idle_id = 0;
+    for (l = op->calls; l; l = l->next) {
+        RadioInstanceNewCall* call = l->data;
 
-    /* IRadio::setResponseFunctions */
-    req = gbinder_client_new_request2(priv->client,
-        desc->set_response_functions_req);
-    gbinder_local_request_init_writer(req, &writer);
-    gbinder_writer_append_local_object(&writer, priv->response);
-    gbinder_writer_append_local_object(&writer, priv->indication);
-    gbinder_remote_reply_unref(gbinder_client_transact_sync_reply(priv->client,
-        desc->set_response_functions_req, req, &status));
-    GVERBOSE_("setResponseFunctions %s status %d", slot, status);
-    gbinder_local_request_unref(req);
+        call->func(op->instance, call->user_data);
+    }
+    radio_instance_new_op_free(op);
+}
 
-    GDEBUG("Instance '%s'", slot);
+static
+gboolean
+radio_instance_new_op_idle(
+    gpointer user_data)
+{
+    RadioInstanceNewOp* op = user_data;
 
-    /*
-     * Don't destroy GBinderServiceManager right away in case if we
-     * have another slot to initialize.
-     */
-    gutil_idle_pool_add(priv->idle, gbinder_servicemanager_ref(sm),
-        (GDestroyNotify) gbinder_servicemanager_unref);
-    return self;
+    op->idle_id = 0;
+    radio_instance_new_op_complete(op);
+    return G_SOURCE_REMOVE;
 }
 
 static
-RadioInstance*
-radio_instance_create(
-    const char* dev,
-    const char* slot,
-    const char* key,
-    const char* modem,
-    int slot_index,
-    RADIO_INTERFACE max_version,
-    RADIO_AIDL_INTERFACE aidl_interface)
+void
+radio_instance_new_op_tx_done(
+    GBinderClient* client,
+    GBinderRemoteReply* reply,
+    int status,
+    void* user_data)
 {
-    RadioInstance* self = NULL;
-    GBinderServiceManager* sm = gbinder_servicemanager_new(dev);
-    const RadioInterfaceDesc* interfaces = NULL;
-    gsize i, num_interfaces = 0;
-
-    if (!sm) {
-        GERR_("Failed to get ServiceManager on %s", dev);
-        return NULL;
+    RadioInstanceNewOp* op = user_data;
+    RadioInstance* self = op->instance;
+    RadioInstance* existing = radio_instance_lookup(op->dev, op->slot,
+        op->max_version, op->aidl_interface);
+
+    GVERBOSE_("setResponseFunctions %s status %d", op->slot, status);
+    op->tx_id = 0;
+    if (existing) {
+        /*
+         * Synchronous creation got there while we were waiting. Our own
+         * setResponseFunctions may have landed after theirs and redirected
+         * the callbacks to the objects which are about to be dropped.
+         * Point the remote back to the shared ones.
+         */
+        radio_instance_reset_response_functions(existing);
+        op->instance = radio_instance_ref(existing);
+        radio_instance_unref(self);
+    } else if (status == GBINDER_STATUS_OK) {
+        /* Only now it's ready to be shared */
+        radio_instance_add(self, op->max_version, op->aidl_interface);
+    } else {
+        GWARN("setResponseFunctions failed for %s (status %d)", op->slot,
+            status);
+        op->instance = NULL;
+        radio_instance_unref(self);
     }
+    radio_instance_new_op_complete(op);
+}
 
-    if (aidl_interface == RADIO_AIDL_INTERFACE_NONE) {
-        interfaces = radio_hidl_interfaces;
-        num_interfaces = G_N_ELEMENTS(radio_hidl_interfaces);
-    } else if (aidl_interface > RADIO_AIDL_INTERFACE_NONE &&
-        aidl_interface < RADIO_AIDL_INTERFACE_COUNT) {
-        interfaces = radio_aidl_interfaces + aidl_interface;
-        num_interfaces = 1;
+static
+gboolean
+radio_instance_new_op_next(
+    RadioInstanceNewOp* op);
+
+static
+void
+radio_instance_new_op_get_service_done(
+    GBinderServiceManager* sm,
+    GBinderRemoteObject* obj,
+    int status,
+    void* user_data)
+{
+    RadioInstanceNewOp* op = user_data;
+    const RadioInterfaceDesc* desc = op->interfaces + op->next;
+    RadioInstance* existing = radio_instance_lookup(op->dev, op->slot,
+        op->max_version, op->aidl_interface);
+
+    op->sm_call_id = 0;
+    if (existing) {
+        /* Synchronous creation got there first */
+        op->instance = radio_instance_ref(existing);
+        radio_instance_new_op_complete(op);
+    } else if (obj) {
+        RadioInstance* self;
+        GBinderLocalRequest* req;
+
+        GINFO("Connected to %s/%s", desc->radio_iface, op->slot);
+        self = op->instance = radio_instance_new_desc(sm, obj, op->dev,
+            op->slot, op->key, op->modem, op->slot_index, desc);
+
+        /*
+         * The instance isn't published until setResponseFunctions
+         * completes. Until then the operation holds the only reference,
+         * which is what allows cancelling the transaction.
+         */
+        req = radio_instance_set_response_functions_req(self);
+        op->tx_id = gbinder_client_transact(self->priv->client,
+            desc->set_response_functions_req, 0, req,
+            radio_instance_new_op_tx_done, NULL, op);
+        gbinder_local_request_unref(req);
+        if (!op->tx_id) {
+            GWARN("Failed to submit setResponseFunctions for %s", op->slot);
+            op->instance = NULL;
+            radio_instance_unref(self);
+            radio_instance_new_op_complete(op);
+        }
+    } else {
+        op->next++;
+        if (!radio_instance_new_op_next(op)) {
+            GWARN("No radio service for %s", op->slot);
+            radio_instance_new_op_complete(op);
+        }
     }
+}
 
-    for (i = 0; i < num_interfaces && !self; i++) {
-        const RadioInterfaceDesc* desc = interfaces + i;
+static
+gboolean
+radio_instance_new_op_next(
+    RadioInstanceNewOp* op)
+{
+    while (op->next < op->num_interfaces) {
+        const RadioInterfaceDesc* desc = op->interfaces + op->next;
 
-        if (desc->version <= max_version) {
-            char* fqname = g_strconcat(desc->radio_iface, "/", slot, NULL);
-            GBinderRemoteObject* obj = /* autoreleased */
-                gbinder_servicemanager_get_service_sync(sm, fqname, NULL);
-
-            if (obj) {
-                GINFO("Connected to %s", fqname);
-                self = radio_instance_create_desc(sm, obj, dev, slot,
-                    key, modem, slot_index, desc);
-            }
+        if (desc->version <= op->max_version) {
+            char* fqname = g_strconcat(desc->radio_iface, "/", op->slot, NULL);
+
+            op->sm_call_id = gbinder_servicemanager_get_service(op->sm,
+                fqname, radio_instance_new_op_get_service_done, op);
             g_free(fqname);
+            if (op->sm_call_id) {
+                return TRUE;
+            }
         }
+        op->next++;
     }
+    return FALSE;
+}
 
-    gbinder_servicemanager_unref(sm);
+static
+RadioInstanceNewOp*
+radio_instance_new_op_find(
+    const char* key)
+{
+    GSList* l;
 
-    return self;
+    for (l = radio_instance_new_ops; l; l = l->next) {
+        RadioInstanceNewOp* op = l->data;
+
+        if (!g_strcmp0(op->key, key)) {
+            return op;
+        }
+    }
+    return NULL;
 }
 
 static
-char*
-radio_instance_make_key(
-    const char* dev,
-    const char* name,
-    RADIO_INTERFACE version,
-    RADIO_AIDL_INTERFACE aidl_interface)
+gulong
+radio_instance_new_id(
+    void)
 {
-    return g_strdup_printf("%s:%s:%d:%d", dev, name, version, aidl_interface);
+    /* Single id space for individual calls and batches */
+    if (!++radio_instance_new_last_id) {
+        radio_instance_new_last_id = 1;
+    }
+    return radio_instance_new_last_id;
+}
+
+static
+gulong
+radio_instance_new_op_add_call(
+    RadioInstanceNewOp* op,
+    RadioInstanceFunc func,
+    GDestroyNotify destroy,
+    gpointer user_data)
+{
+    RadioInstanceNewCall* call = g_slice_new(RadioInstanceNewCall);
+
+    call->id = radio_instance_new_id();
+    call->func = func;
+    call->destroy = destroy;
+    call->user_data = user_data;
+    op->calls = g_slist_append(op->calls, call);
+    return call->id;
 }
 
 static
 void
-radio_instance_tx_free(
-    RadioInstanceTx* tx)
+radio_instance_batch_unref(
+    RadioInstanceBatch* batch)
 {
-    radio_instance_unref(tx->instance);
-    gutil_slice_free(tx);
+    if (!--batch->refs) {
+        radio_instance_batches = g_slist_remove(radio_instance_batches, batch);
+        if (batch->idle_id) {
+            g_source_remove(batch->idle_id);
+        }
+        if (batch->destroy) {
+            batch->destroy(batch->user_data);
+        }
+        gbinder_servicemanager_unref(batch->sm);
+        g_free(batch->entries);
+        gutil_slice_free(batch);
+    }
 }
 
 static
 void
-radio_instance_tx_destroy(
-    gpointer tx_data)
+radio_instance_batch_cancel(
+    RadioInstanceBatch* batch)
 {
-    RadioInstanceTx* tx = tx_data;
+    guint i;
 
-    if (tx->destroy) {
-        tx->destroy(tx->user_data1, tx->user_data2);
+    radio_instance_batches = g_slist_remove(radio_instance_batches, batch);
+    batch->refs++;
+    if (batch->idle_id) {
+        g_source_remove(batch->idle_id);
+        batch->idle_id = 0;
+    }
+    for (i = 0; i < batch->count; i++) {
+        RadioInstanceBatchEntry* entry = batch->entries + i;
+
+        if (entry->failed) {
+            entry->failed = FALSE;
+            batch->refs--;
+        } else if (entry->id) {
+            /* This ends up in radio_instance_batch_entry_destroy */
+            radio_instance_cancel_new(entry->id);
+        }
     }
-    radio_instance_tx_free(tx);
+    radio_instance_batch_unref(batch);
 }
 
 static
 void
-radio_instance_tx_complete(
-    GBinderClient* client,
-    GBinderRemoteReply* reply,
-    int status,
-    void* tx_data)
+radio_instance_batch_entry_done(
+    RadioInstance* radio,
+    gpointer user_data)
 {
-    RadioInstanceTx* tx = tx_data;
+    RadioInstanceBatchEntry* entry = user_data;
+    RadioInstanceBatch* batch = entry->batch;
 
-    if (tx->complete) {
-        tx->complete(tx->instance, tx->id, status, tx->user_data1,
-            tx->user_data2);
+    entry->id = 0;
+    batch->func(radio, entry->index, batch->user_data);
+}
+
+static
+void
+radio_instance_batch_entry_destroy(
+    gpointer user_data)
+{
+    RadioInstanceBatchEntry* entry = user_data;
+
+    entry->id = 0;
+    radio_instance_batch_unref(entry->batch);
+}
+
+static
+gboolean
+radio_instance_batch_idle(
+    gpointer user_data)
+{
+    RadioInstanceBatch* batch = user_data;
+    guint i;
+
+    /* Report the entries which couldn't even be started */
+    batch->idle_id = 0;
+    batch->refs++;
+    for (i = 0; i < batch->count; i++) {
+        RadioInstanceBatchEntry* entry = batch->entries + i;
+
+        if (entry->failed) {
+            entry->failed = FALSE;
+            batch->refs--;
+            batch->func(NULL, i, batch->user_data);
+        }
     }
+    radio_instance_batch_unref(batch);
+    return G_SOURCE_REMOVE;
 }
 
-/*==========================================================================*
- * Internal API
- *==========================================================================*/
+static
+RadioInstanceBatch*
+radio_instance_batch_find(
+    gulong id)
+{
+    GSList* l;
+
+    for (l = radio_instance_batches; l; l = l->next) {
+        RadioInstanceBatch* batch = l->data;
+
+        if (batch->id == id) {
+            return batch;
+        }
+    }
+    return NULL;
+}
 
+static
 gulong
-radio_instance_send_request(
+radio_instance_connect_indication_observer(
+    RadioInstance* self,
+    RADIO_OBSERVER_PRIORITY priority,
+    RADIO_IND code,
+    gboolean ind_interest,
+    RadioIndicationObserverFunc func,
+    gpointer user_data)
+{
+    const guint index = radio_observer_priority_index(priority);
+    const RADIO_INSTANCE_SIGNAL sig = SIGNAL_OBSERVE_INDICATION_0 + index;
+
+    /* Register signal on demand */
+    if (!radio_instance_signals[sig]) {
+        radio_instance_signals[sig] =
+            g_signal_new(radio_instance_signal_observe_indication_name
+                [index], RADIO_TYPE_INSTANCE,
+                G_SIGNAL_RUN_FIRST | G_SIGNAL_DETAILED,
+                0, NULL, NULL, NULL, G_TYPE_NONE,
+                3, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_POINTER);
+    }
+
+    return radio_instance_connect_handler_full(self,
+        radio_instance_signals[sig],
+        radio_instance_ind_quark(self, code),
+        RADIO_HANDLER_INDICATION_OBSERVER, code, ind_interest,
+        G_CALLBACK(func), user_data);
+}
+
+static
+gulong
+radio_instance_send_request_serial(
     RadioInstance* self,
     RADIO_REQ code,
+    guint32 resend_serial,
     GBinderLocalRequest* args,
     RadioInstanceTxCompleteFunc complete,
     RadioInstanceTxDestroyFunc destroy,
@@ -764,14 +2254,15 @@ radio_instance_send_request(
         RadioInstancePriv* priv = self->priv;
 
         if (complete || destroy) {
-            RadioInstanceTx* tx = g_slice_new(RadioInstanceTx);
+            RadioInstanceTx* tx = g_slice_new0(RadioInstanceTx);
 
             tx->instance = radio_instance_ref(self);
             tx->complete = complete;
             tx->destroy = destroy;
             tx->user_data1 = user_data1;
             tx->user_data2 = user_data2;
-            radio_instance_notify_request_observers(self, code, args);
+            radio_instance_notify_request_observers(self, code, resend_serial,
+                args);
             tx->id = gbinder_client_transact(priv->client, code,
                 GBINDER_TX_FLAG_ONEWAY, args, radio_instance_tx_complete,
                 radio_instance_tx_destroy, tx);
@@ -782,7 +2273,8 @@ radio_instance_send_request(
             }
         } else {
             /* No need to allocate the context */
-            radio_instance_notify_request_observers(self, code, args);
+            radio_instance_notify_request_observers(self, code, resend_serial,
+                args);
             return gbinder_client_transact(priv->client, code,
                 GBINDER_TX_FLAG_ONEWAY, args, NULL, NULL, NULL);
         }
@@ -790,6 +2282,39 @@ radio_instance_send_request(
     return 0;
 }
 
+/*==========================================================================*
+ * Internal API
+ *==========================================================================*/
+
+gulong
+radio_instance_send_request(
+    RadioInstance* self,
+    RADIO_REQ code,
+    GBinderLocalRequest* args,
+    RadioInstanceTxCompleteFunc complete,
+    RadioInstanceTxDestroyFunc destroy,
+    void* user_data1,
+    void* user_data2)
+{
+    return radio_instance_send_request_serial(self, code, 0, args,
+        complete, destroy, user_data1, user_data2);
+}
+
+gulong
+radio_instance_resend_request(
+    RadioInstance* self,
+    RADIO_REQ code,
+    guint32 serial,
+    GBinderLocalRequest* args,
+    RadioInstanceTxCompleteFunc complete,
+    RadioInstanceTxDestroyFunc destroy,
+    void* user_data1,
+    void* user_data2)
+{
+    return radio_instance_send_request_serial(self, code, serial, args,
+        complete, destroy, user_data1, user_data2);
+}
+
 void
 radio_instance_cancel_request(
     RadioInstance* self,
@@ -800,30 +2325,137 @@ radio_instance_cancel_request(
     }
 }
 
+GMainContext*
+radio_instance_context(
+    RadioInstance* self)
+{
+    return G_LIKELY(self) ? self->priv->context : NULL;
+}
+
+GBinderRemoteRequest*
+radio_instance_resp_message(
+    RadioInstance* self)
+{
+    return G_LIKELY(self) ? self->priv->resp_msg : NULL;
+}
+
 GQuark
 radio_instance_ind_quark(
     RadioInstance* self,
     RADIO_IND ind)
 {
-    GQuark q = 0;
+    GQuark q = 0;
+
+    if (ind != RADIO_IND_ANY) {
+        RadioInstancePriv* priv = self->priv;
+        gpointer key = GUINT_TO_POINTER(ind);
+
+        q = GPOINTER_TO_UINT(g_hash_table_lookup(priv->ind_quarks, key));
+        if (!q) {
+            const char* known = radio_ind_name2(self, ind);
+
+            if (known) {
+                q = g_quark_from_static_string(known);
+            } else {
+                q = g_quark_from_string(radio_instance_ind_name(self, ind));
+            }
+            g_hash_table_insert(priv->ind_quarks, key, GUINT_TO_POINTER(q));
+        }
+    }
+    return q;
+}
+
+gulong
+radio_instance_add_indication_relay(
+    RadioInstance* self,
+    RadioIndicationObserverFunc func,
+    gpointer user_data)
+{
+    /* Caller makes sure that both arguments are not NULL */
+    return radio_instance_connect_indication_observer(self,
+        RADIO_OBSERVER_PRIORITY_DEFAULT, RADIO_IND_ANY, FALSE,
+        func, user_data);
+}
+
+void
+radio_instance_ind_interest_ref(
+    RadioInstance* self,
+    RADIO_IND ind)
+{
+    RadioInstancePriv* priv = self->priv;
+
+    if (ind == RADIO_IND_ANY) {
+        if (!priv->ind_interest_any++) {
+            radio_instance_ind_filter_changed(self);
+        }
+    } else {
+        gpointer key = GUINT_TO_POINTER(ind);
+        guint n;
+
+        if (!priv->ind_interest) {
+            priv->ind_interest = g_hash_table_new(g_direct_hash,
+                g_direct_equal);
+        }
+        n = GPOINTER_TO_UINT(g_hash_table_lookup(priv->ind_interest, key));
+        g_hash_table_insert(priv->ind_interest, key, GUINT_TO_POINTER(n + 1));
+        if (!n) {
+            radio_instance_ind_filter_changed(self);
+        }
+    }
+}
+
+void
+radio_instance_ind_interest_unref(
+    RadioInstance* self,
+    RADIO_IND ind)
+{
+    RadioInstancePriv* priv = self->priv;
+
+    if (ind == RADIO_IND_ANY) {
+        GASSERT(priv->ind_interest_any);
+        if (!--priv->ind_interest_any) {
+            radio_instance_ind_filter_changed(self);
+        }
+    } else {
+        gpointer key = GUINT_TO_POINTER(ind);
+        const guint n = GPOINTER_TO_UINT(g_hash_table_lookup
+            (priv->ind_interest, key));
+
+        GASSERT(n);
+        if (n > 1) {
+            g_hash_table_insert(priv->ind_interest, key,
+                GUINT_TO_POINTER(n - 1));
+        } else {
+            g_hash_table_remove(priv->ind_interest, key);
+            radio_instance_ind_filter_changed(self);
+        }
+    }
+}
+
+void
+radio_instance_power_save_ref(
+    RadioInstance* self)
+{
+    RadioInstancePriv* priv = self->priv;
 
-    if (ind != RADIO_IND_ANY) {
-        RadioInstancePriv* priv = self->priv;
-        gpointer key = GUINT_TO_POINTER(ind);
+    /* The transition is sent right away */
+    if (!priv->power_save++ && priv->client) {
+        radio_instance_device_state_update(self);
+        radio_instance_ind_filter_update(self);
+    }
+}
 
-        q = GPOINTER_TO_UINT(g_hash_table_lookup(priv->ind_quarks, key));
-        if (!q) {
-            const char* known = radio_ind_name2(self, ind);
+void
+radio_instance_power_save_unref(
+    RadioInstance* self)
+{
+    RadioInstancePriv* priv = self->priv;
 
-            if (known) {
-                q = g_quark_from_static_string(known);
-            } else {
-                q = g_quark_from_string(radio_instance_ind_name(self, ind));
-            }
-            g_hash_table_insert(priv->ind_quarks, key, GUINT_TO_POINTER(q));
-        }
+    GASSERT(priv->power_save);
+    if (!--priv->power_save && priv->client) {
+        radio_instance_device_state_update(self);
+        radio_instance_ind_filter_update(self);
     }
-    return q;
 }
 
 /*==========================================================================*
@@ -899,34 +2531,174 @@ radio_instance_new_with_modem_slot_version_and_interface(
 {
     if (dev && dev[0] && name && name[0]) {
         /* HIDL and AIDL would use different binder devices */
-        char* key = radio_instance_make_key(dev, name, version, aidl_interface);
-        RadioInstance* self = NULL;
+        RadioInstance* self = radio_instance_lookup(dev, name, version,
+            aidl_interface);
 
-        if (radio_instance_table) {
-            self = g_hash_table_lookup(radio_instance_table, key);
-        }
         if (self) {
-            g_free(key);
-            return radio_instance_ref(self);
+            radio_instance_ref(self);
         } else {
+            char* key = radio_instance_make_key(dev, name, version,
+                aidl_interface);
+
             self = radio_instance_create(dev, name, key, modem, slot, version,
                                          aidl_interface);
             if (self) {
-                if (!radio_instance_table) {
-                    radio_instance_table = g_hash_table_new_full
-                        (g_str_hash, g_str_equal, g_free, NULL);
-                }
-                g_hash_table_replace(radio_instance_table, g_strdup(key), self);
-                g_object_weak_ref(G_OBJECT(self), radio_instance_gone, key);
-                radio_registry_instance_added(self);
-                return self;
+                radio_instance_add(self, version, aidl_interface);
             }
+            g_free(key);
         }
-        g_free(key);
+        return self;
     }
     return NULL;
 }
 
+gulong
+radio_instance_new_async(
+    const char* dev,
+    const char* name,
+    const char* modem,
+    int slot,
+    RADIO_INTERFACE version,
+    RADIO_AIDL_INTERFACE aidl_interface,
+    RadioInstanceFunc func,
+    GDestroyNotify destroy,
+    gpointer user_data) /* Since 1.6.7 */
+{
+    if (dev && dev[0] && name && name[0] && func) {
+        char* key = radio_instance_make_key(dev, name, version, aidl_interface);
+        RadioInstanceNewOp* op = radio_instance_new_op_find(key);
+
+        if (op) {
+            /* Piggyback on the operation which is already in progress */
+            g_free(key);
+        } else {
+            RadioInstance* self = radio_instance_lookup(dev, name, version,
+                aidl_interface);
+
+            op = g_slice_new0(RadioInstanceNewOp);
+            op->key = key;
+            op->context = g_main_context_ref_thread_default();
+            if (self) {
+                /* Complete on the next main loop iteration */
+                op->instance = radio_instance_ref(self);
+                op->idle_id = radio_timeout_add(op->context, 0,
+                    radio_instance_new_op_idle, op);
+            } else {
+                op->sm = gbinder_servicemanager_new(dev);
+                if (!op->sm) {
+                    GERR_("Failed to get ServiceManager on %s", dev);
+                    radio_instance_new_op_free(op);
+                    return 0;
+                }
+                op->dev = g_strdup(dev);
+                op->slot = g_strdup(name);
+                op->modem = g_strdup(modem);
+                op->slot_index = slot;
+                op->max_version = version;
+                op->aidl_interface = aidl_interface;
+                op->interfaces = radio_instance_interfaces(aidl_interface,
+                    &op->num_interfaces);
+                if (!radio_instance_new_op_next(op)) {
+                    op->idle_id = radio_timeout_add(op->context, 0,
+                        radio_instance_new_op_idle, op);
+                }
+            }
+            radio_instance_new_ops = g_slist_append(radio_instance_new_ops, op);
+        }
+        return radio_instance_new_op_add_call(op, func, destroy, user_data);
+    }
+    return 0;
+}
+
+gulong
+radio_instance_new_all_async(
+    const char* dev,
+    const RadioInstanceSpec* specs,
+    guint count,
+    RadioInstanceSpecFunc func,
+    GDestroyNotify destroy,
+    gpointer user_data) /* Since 1.6.7 */
+{
+    if (dev && dev[0] && specs && count && func) {
+        /* Keep the service manager alive until everything is done */
+        GBinderServiceManager* sm = gbinder_servicemanager_new(dev);
+
+        if (sm) {
+            RadioInstanceBatch* batch = g_slice_new0(RadioInstanceBatch);
+            guint i;
+
+            batch->id = radio_instance_new_id();
+            batch->sm = sm;
+            batch->count = count;
+            batch->entries = g_new0(RadioInstanceBatchEntry, count);
+            batch->func = func;
+            batch->destroy = destroy;
+            batch->user_data = user_data;
+            batch->refs = count;
+            radio_instance_batches = g_slist_append(radio_instance_batches,
+                batch);
+
+            /* Start all of them at once */
+            for (i = 0; i < count; i++) {
+                const RadioInstanceSpec* spec = specs + i;
+                RadioInstanceBatchEntry* entry = batch->entries + i;
+
+                entry->batch = batch;
+                entry->index = i;
+                entry->id = radio_instance_new_async(dev, spec->name,
+                    spec->modem, spec->slot, spec->version,
+                    spec->aidl_interface, radio_instance_batch_entry_done,
+                    radio_instance_batch_entry_destroy, entry);
+                if (!entry->id) {
+                    entry->failed = TRUE;
+                    if (!batch->idle_id) {
+                        batch->idle_id = g_idle_add(radio_instance_batch_idle,
+                            batch);
+                    }
+                }
+            }
+            return batch->id;
+        } else {
+            GERR_("Failed to get ServiceManager on %s", dev);
+        }
+    }
+    return 0;
+}
+
+void
+radio_instance_cancel_new(
+    gulong id) /* Since 1.6.7 */
+{
+    RadioInstanceBatch* batch = id ? radio_instance_batch_find(id) : NULL;
+    GSList* l;
+
+    if (batch) {
+        radio_instance_batch_cancel(batch);
+        return;
+    }
+
+    for (l = id ? radio_instance_new_ops : NULL; l; l = l->next) {
+        RadioInstanceNewOp* op = l->data;
+        GSList* c;
+
+        for (c = op->calls; c; c = c->next) {
+            RadioInstanceNewCall* call = c->data;
+
+            if (call->id == id) {
+                op->calls = g_slist_delete_link(op->calls, c);
+                radio_instance_new_call_free(call);
+                if (!op->calls) {
+                    /* Nobody is interested in the result anymore */
+                    radio_instance_new_ops = g_slist_remove
+                        (radio_instance_new_ops, op);
+                    radio_instance_new_op_free(op);
+                }
+                return;
+            }
+        }
+    }
+}
+
 RadioInstance*
 radio_instance_get(
     const char* dev,
@@ -950,15 +2722,8 @@ radio_instance_get_with_version(
     const char* name,
     RADIO_INTERFACE version) /* Since 1.2.2 */
 {
-    RadioInstance* self = NULL;
-
-    if (dev && dev[0] && name && name[0] && radio_instance_table) {
-        char* key = radio_instance_make_key(dev, name, version, RADIO_AIDL_INTERFACE_NONE);
-
-        self = g_hash_table_lookup(radio_instance_table, key);
-        g_free(key);
-    }
-    return self;
+    return (dev && dev[0] && name && name[0]) ? radio_instance_lookup(dev,
+        name, version, RADIO_AIDL_INTERFACE_NONE) : NULL;
 }
 
 RadioInstance* const*
@@ -966,22 +2731,69 @@ radio_instance_get_all(
     void)
 {
     if (radio_instance_table) {
-        /* If the table exists, it must be non-empty */
-        const guint n = g_hash_table_size(radio_instance_table);
-        RadioInstance** all = g_new0(RadioInstance*, n + 1);
-        RadioInstance* last = NULL;
-        GHashTableIter it;
-        gpointer value;
-        guint i = 0;
+        /* The snapshot is only rebuilt when the table changes */
+        if (!radio_instance_all ||
+            radio_instance_all_gen != radio_instance_table_gen) {
+            /* If the table exists, it must be non-empty */
+            const guint n = g_hash_table_size(radio_instance_table);
+            RadioInstance** all = g_new0(RadioInstance*, n + 1);
+            RadioInstance* last = NULL;
+            GHashTableIter it;
+            gpointer value;
+            guint i = 0;
+
+            g_hash_table_iter_init(&it, radio_instance_table);
+            while (g_hash_table_iter_next(&it, NULL, &value)) {
+                last = all[i++] = value;
+            }
+
+            /* Old snapshot may still be in use, release it when idle */
+            if (radio_instance_all) {
+                gutil_idle_pool_add(last->priv->idle, radio_instance_all,
+                    g_free);
+            }
+            radio_instance_all = all;
+            radio_instance_all_gen = radio_instance_table_gen;
+        }
+        return radio_instance_all;
+    }
+    return NULL;
+}
+
+guint
+radio_instance_generation(
+    void) /* Since 1.6.7 */
+{
+    return radio_instance_table_gen;
+}
 
-        g_hash_table_iter_init(&it, radio_instance_table);
-        while (g_hash_table_iter_next(&it, NULL, &value)) {
-            last = all[i++] = value;
+void
+radio_instance_iter_init(
+    RadioInstanceIter* iter) /* Since 1.6.7 */
+{
+    if (G_LIKELY(iter)) {
+        memset(iter, 0, sizeof(*iter));
+        iter->gen = radio_instance_table_gen;
+        if (radio_instance_table) {
+            g_hash_table_iter_init(&iter->it, radio_instance_table);
+            iter->valid = TRUE;
         }
+    }
+}
+
+RadioInstance*
+radio_instance_iter_next(
+    RadioInstanceIter* iter) /* Since 1.6.7 */
+{
+    /* Iteration stops if the set of instances has changed */
+    if (G_LIKELY(iter) && iter->valid) {
+        gpointer value;
 
-        /* Add the array itself to the idle pool of the last instance */
-        gutil_idle_pool_add(last->priv->idle, all, g_free);
-        return all;
+        if (iter->gen == radio_instance_table_gen &&
+            g_hash_table_iter_next(&iter->it, NULL, &value)) {
+            return value;
+        }
+        iter->valid = FALSE;
     }
     return NULL;
 }
@@ -1030,16 +2842,7 @@ radio_instance_req_name(
 {
     const char* known = radio_req_name2(self, req);
 
-    if (known) {
-        return known;
-    } else if (G_LIKELY(self)) {
-        char* str = g_strdup_printf("%u", (guint)req);
-
-        gutil_idle_pool_add(self->priv->idle, str, g_free);
-        return str;
-    } else {
-        return NULL;
-    }
+    return known ? known : radio_instance_unknown_name(self, req);
 }
 
 const char*
@@ -1049,16 +2852,7 @@ radio_instance_resp_name(
 {
     const char* known = radio_resp_name2(self, resp);
 
-    if (known) {
-        return known;
-    } else if (G_LIKELY(self)) {
-        char* str = g_strdup_printf("%u", (guint)resp);
-
-        gutil_idle_pool_add(self->priv->idle, str, g_free);
-        return str;
-    } else {
-        return NULL;
-    }
+    return known ? known : radio_instance_unknown_name(self, resp);
 }
 
 const char*
@@ -1068,16 +2862,7 @@ radio_instance_ind_name(
 {
     const char* known = radio_ind_name2(self, ind);
 
-    if (known) {
-        return known;
-    } else if (G_LIKELY(self)) {
-        char* str = g_strdup_printf("%u", (guint)ind);
-
-        gutil_idle_pool_add(self->priv->idle, str, g_free);
-        return str;
-    } else {
-        return NULL;
-    }
+    return known ? known : radio_instance_unknown_name(self, ind);
 }
 
 gboolean
@@ -1098,7 +2883,7 @@ radio_instance_ack(
         if (code != RADIO_REQ_NONE) {
             GBinderClient* client = priv->client;
 
-            radio_instance_notify_request_observers(self, code, NULL);
+            radio_instance_notify_request_observers(self, code, 0, NULL);
             if (gbinder_client_transact_sync_oneway(client, code, NULL) >= 0) {
                 return TRUE;
             }
@@ -1107,6 +2892,262 @@ radio_instance_ack(
     return FALSE;
 }
 
+void
+radio_instance_set_context(
+    RadioInstance* self,
+    GMainContext* context) /* Since 1.6.7 */
+{
+    if (G_LIKELY(self)) {
+        RadioInstancePriv* priv = self->priv;
+
+        if (priv->context != context) {
+            /* Don't leave the pending ack behind in the old context */
+            radio_instance_ack_flush(self);
+            if (priv->context) {
+                g_main_context_unref(priv->context);
+            }
+            priv->context = context ? g_main_context_ref(context) : NULL;
+        }
+    }
+}
+
+void
+radio_instance_set_recorder(
+    RadioInstance* self,
+    RadioRecorder* recorder) /* Since 1.6.7 */
+{
+    if (G_LIKELY(self)) {
+        RadioInstancePriv* priv = self->priv;
+
+        if (priv->recorder != recorder) {
+            gutil_disconnect_handlers(self, priv->recorder_id,
+                G_N_ELEMENTS(priv->recorder_id));
+            radio_recorder_unref(priv->recorder);
+            priv->recorder = radio_recorder_ref(recorder);
+            if (recorder) {
+                /* Record everything before anyone else gets to see it */
+                priv->recorder_id[0] =
+                    radio_instance_add_request_observer_with_priority(self,
+                        RADIO_OBSERVER_PRIORITY_HIGHEST, RADIO_REQ_ANY,
+                        radio_instance_record_request, recorder);
+                priv->recorder_id[1] =
+                    radio_instance_add_response_observer_with_priority(self,
+                        RADIO_OBSERVER_PRIORITY_HIGHEST, RADIO_RESP_ANY,
+                        radio_instance_record_response, recorder);
+                /* Recording alone doesn't affect the indication filter */
+                priv->recorder_id[2] =
+                    radio_instance_connect_indication_observer(self,
+                        RADIO_OBSERVER_PRIORITY_HIGHEST, RADIO_IND_ANY, FALSE,
+                        radio_instance_record_indication, recorder);
+            }
+        }
+    }
+}
+
+void
+radio_instance_set_handler_timing(
+    RadioInstance* self,
+    gboolean enabled,
+    guint slow_ms) /* Since 1.6.7 */
+{
+    if (G_LIKELY(self)) {
+        RadioInstancePriv* priv = self->priv;
+
+        if (enabled) {
+            RadioInstanceTiming* timing = priv->timing;
+
+            if (!timing) {
+                GHashTableIter it;
+                gpointer key;
+                int i;
+
+                /* Start from scratch */
+                timing = priv->timing = g_new0(RadioInstanceTiming, 1);
+                for (i = 0; i < RADIO_HANDLER_TYPE_COUNT; i++) {
+                    timing->codes[i] = g_hash_table_new_full(g_direct_hash,
+                        g_direct_equal, NULL, g_free);
+                }
+                g_hash_table_iter_init(&it, priv->handlers);
+                while (g_hash_table_iter_next(&it, &key, NULL)) {
+                    RadioHandlerStats* stats =
+                        &((RadioInstanceHandler*)key)->stats;
+
+                    stats->calls = stats->slow_calls = stats->max_usec = 0;
+                    stats->total_usec = 0;
+                }
+            }
+            timing->slow_usec = slow_ms * 1000;
+        } else if (priv->timing) {
+            radio_instance_timing_free(priv->timing);
+            priv->timing = NULL;
+        }
+    }
+}
+
+RadioHandlerStats*
+radio_instance_get_handler_stats(
+    RadioInstance* self,
+    guint* count) /* Since 1.6.7 */
+{
+    RadioHandlerStats* result = NULL;
+    guint n = 0;
+
+    if (G_LIKELY(self) && self->priv->timing) {
+        RadioInstancePriv* priv = self->priv;
+        const guint size = g_hash_table_size(priv->handlers);
+
+        if (size) {
+            GHashTableIter it;
+            gpointer key;
+
+            result = g_new(RadioHandlerStats, size);
+            g_hash_table_iter_init(&it, priv->handlers);
+            while (g_hash_table_iter_next(&it, &key, NULL)) {
+                result[n++] = ((RadioInstanceHandler*)key)->stats;
+            }
+            qsort(result, n, sizeof(result[0]),
+                radio_instance_handler_stats_compare);
+        }
+    }
+    if (count) {
+        *count = n;
+    }
+    return result;
+}
+
+RadioHandlerStats*
+radio_instance_get_code_stats(
+    RadioInstance* self,
+    guint* count) /* Since 1.6.7 */
+{
+    RadioHandlerStats* result = NULL;
+    guint n = 0;
+
+    if (G_LIKELY(self) && self->priv->timing) {
+        RadioInstanceTiming* timing = self->priv->timing;
+        guint size = 0;
+        int i;
+
+        for (i = 0; i < RADIO_HANDLER_TYPE_COUNT; i++) {
+            size += g_hash_table_size(timing->codes[i]);
+        }
+        if (size) {
+            result = g_new(RadioHandlerStats, size);
+            for (i = 0; i < RADIO_HANDLER_TYPE_COUNT; i++) {
+                GHashTableIter it;
+                gpointer value;
+
+                g_hash_table_iter_init(&it, timing->codes[i]);
+                while (g_hash_table_iter_next(&it, NULL, &value)) {
+                    result[n++] = *(RadioHandlerStats*)value;
+                }
+            }
+            qsort(result, n, sizeof(result[0]),
+                radio_instance_handler_stats_compare);
+        }
+    }
+    if (count) {
+        *count = n;
+    }
+    return result;
+}
+
+void
+radio_instance_set_ind_meter(
+    RadioInstance* self,
+    guint half_life_ms) /* Since 1.6.7 */
+{
+    if (G_LIKELY(self)) {
+        RadioInstancePriv* priv = self->priv;
+
+        if (radio_ind_meter_half_life_ms(priv->ind_meter) != half_life_ms) {
+            radio_ind_meter_free(priv->ind_meter);
+            priv->ind_meter = half_life_ms ?
+                radio_ind_meter_new(half_life_ms) : NULL;
+        }
+    }
+}
+
+RadioIndRate*
+radio_instance_get_ind_rates(
+    RadioInstance* self,
+    RADIO_IND_RATE_ORDER order,
+    guint max,
+    guint* count) /* Since 1.6.7 */
+{
+    return radio_ind_meter_top(G_LIKELY(self) ? self->priv->ind_meter : NULL,
+        order, max, g_get_monotonic_time(), count);
+}
+
+gboolean
+radio_instance_set_auto_ind_filter(
+    RadioInstance* self,
+    gboolean enabled) /* Since 1.6.7 */
+{
+    if (G_LIKELY(self)) {
+        RadioInstancePriv* priv = self->priv;
+
+        if (priv->ind_filter_desc) {
+            if (priv->ind_filter_auto != enabled) {
+                if (enabled) {
+                    priv->ind_filter_auto = TRUE;
+                    radio_instance_ind_filter_changed(self);
+                } else {
+                    /* Restore the default filter right away */
+                    if (priv->ind_filter_id) {
+                        radio_source_remove(priv->context,
+                            priv->ind_filter_id);
+                        priv->ind_filter_id = 0;
+                    }
+                    priv->ind_filter_auto = FALSE;
+                    radio_instance_ind_filter_update(self);
+                }
+            }
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+RADIO_IND_FILTER
+radio_instance_get_ind_filter(
+    RadioInstance* self) /* Since 1.6.7 */
+{
+    return G_LIKELY(self) ? (RADIO_IND_FILTER) self->priv->ind_filter :
+        RADIO_IND_FILTER_NONE;
+}
+
+void
+radio_instance_set_ack_batching(
+    RadioInstance* self,
+    gboolean batching) /* Since 1.6.7 */
+{
+    if (G_LIKELY(self)) {
+        RadioInstancePriv* priv = self->priv;
+
+        if (priv->ack_batching != batching) {
+            priv->ack_batching = batching;
+            if (!batching) {
+                radio_instance_ack_flush(self);
+            }
+        }
+    }
+}
+
+void
+radio_instance_get_ack_stats(
+    RadioInstance* self,
+    RadioAckStats* stats) /* Since 1.6.7 */
+{
+    if (G_LIKELY(stats)) {
+        if (G_LIKELY(self)) {
+            *stats = self->priv->ack_stats;
+        } else {
+            memset(stats, 0, sizeof(*stats));
+        }
+    }
+}
+
 GBinderLocalRequest*
 radio_instance_new_request(
     RadioInstance* self,
@@ -1127,7 +3168,7 @@ radio_instance_send_request_sync(
     if (G_LIKELY(self)) {
         GBinderClient* client = self->priv->client;
 
-        radio_instance_notify_request_observers(self, code, args);
+        radio_instance_notify_request_observers(self, code, 0, args);
         return gbinder_client_transact_sync_oneway(client, code, args) >= 0;
     }
     return FALSE;
@@ -1178,10 +3219,10 @@ radio_instance_add_request_observer_with_priority(
                     2, G_TYPE_UINT, G_TYPE_POINTER);
         }
 
-        return g_signal_connect_closure_by_id(self,
+        return radio_instance_connect_handler(self,
             radio_instance_signals[sig],
             radio_instance_req_quark(self, code),
-            g_cclosure_new(G_CALLBACK(func), user_data, NULL), FALSE);
+            RADIO_HANDLER_REQUEST_OBSERVER, code, G_CALLBACK(func), user_data);
     }
     return 0;
 }
@@ -1219,10 +3260,10 @@ radio_instance_add_response_observer_with_priority(
                     3, G_TYPE_UINT, G_TYPE_POINTER, G_TYPE_POINTER);
         }
 
-        return g_signal_connect_closure_by_id(self,
+        return radio_instance_connect_handler(self,
             radio_instance_signals[sig],
             radio_instance_resp_quark(self, code),
-            g_cclosure_new(G_CALLBACK(func), user_data, NULL), FALSE);
+            RADIO_HANDLER_RESPONSE_OBSERVER, code, G_CALLBACK(func), user_data);
     }
     return 0;
 }
@@ -1246,26 +3287,9 @@ radio_instance_add_indication_observer_with_priority(
     RadioIndicationObserverFunc func,
     gpointer user_data) /* Since 1.4.3 */
 {
-    if (G_LIKELY(self) && G_LIKELY(func)) {
-        const guint index = radio_observer_priority_index(priority);
-        const RADIO_INSTANCE_SIGNAL sig = SIGNAL_OBSERVE_INDICATION_0 + index;
-
-        /* Register signal on demand */
-        if (!radio_instance_signals[sig]) {
-            radio_instance_signals[sig] =
-                g_signal_new(radio_instance_signal_observe_indication_name
-                    [index], RADIO_TYPE_INSTANCE,
-                    G_SIGNAL_RUN_FIRST | G_SIGNAL_DETAILED,
-                    0, NULL, NULL, NULL, G_TYPE_NONE,
-                    3, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_POINTER);
-        }
-
-        return g_signal_connect_closure_by_id(self,
-            radio_instance_signals[sig],
-            radio_instance_ind_quark(self, code),
-            g_cclosure_new(G_CALLBACK(func), user_data, NULL), FALSE);
-    }
-    return 0;
+    return (G_LIKELY(self) && G_LIKELY(func)) ?
+        radio_instance_connect_indication_observer(self, priority, code,
+            TRUE, func, user_data) : 0;
 }
 
 gulong
@@ -1276,10 +3300,10 @@ radio_instance_add_response_handler(
     gpointer user_data)
 {
     return (G_LIKELY(self) && G_LIKELY(func)) ?
-        g_signal_connect_closure_by_id(self,
+        radio_instance_connect_handler(self,
             radio_instance_signals[SIGNAL_HANDLE_RESPONSE],
             radio_instance_resp_quark(self, code),
-            g_cclosure_new(G_CALLBACK(func), user_data, NULL), FALSE) : 0;
+            RADIO_HANDLER_RESPONSE, code, G_CALLBACK(func), user_data) : 0;
 }
 
 gulong
@@ -1290,10 +3314,10 @@ radio_instance_add_indication_handler(
     gpointer user_data)
 {
     return (G_LIKELY(self) && G_LIKELY(func)) ?
-        g_signal_connect_closure_by_id(self,
+        radio_instance_connect_handler(self,
             radio_instance_signals[SIGNAL_HANDLE_INDICATION],
             radio_instance_ind_quark(self, code),
-            g_cclosure_new(G_CALLBACK(func), user_data, NULL), FALSE) : 0;
+            RADIO_HANDLER_INDICATION, code, G_CALLBACK(func), user_data) : 0;
 }
 
 gulong
@@ -1336,6 +3360,16 @@ radio_instance_add_connected_handler(
         SIGNAL_CONNECTED_NAME, G_CALLBACK(func), user_data) : 0;
 }
 
+gulong
+radio_instance_add_slow_handler_handler(
+    RadioInstance* self,
+    RadioSlowHandlerFunc func,
+    gpointer user_data) /* Since 1.6.7 */
+{
+    return (G_LIKELY(self) && G_LIKELY(func)) ? g_signal_connect(self,
+        SIGNAL_SLOW_HANDLER_NAME, G_CALLBACK(func), user_data) : 0;
+}
+
 void
 radio_instance_remove_handler(
     RadioInstance* self,
@@ -1372,6 +3406,7 @@ radio_instance_init(
     priv->req_quarks = g_hash_table_new(g_direct_hash, g_direct_equal);
     priv->resp_quarks = g_hash_table_new(g_direct_hash, g_direct_equal);
     priv->ind_quarks = g_hash_table_new(g_direct_hash, g_direct_equal);
+    priv->handlers = g_hash_table_new(g_direct_hash, g_direct_equal);
 }
 
 static
@@ -1385,6 +3420,9 @@ radio_instance_finalize(
     radio_instance_drop_binder(self);
     gbinder_client_unref(priv->client);
     gutil_idle_pool_destroy(priv->idle);
+    if (priv->unknown_names) {
+        g_hash_table_destroy(priv->unknown_names);
+    }
     g_hash_table_destroy(priv->req_quarks);
     g_hash_table_destroy(priv->resp_quarks);
     g_hash_table_destroy(priv->ind_quarks);
@@ -1392,6 +3430,18 @@ radio_instance_finalize(
     g_free(priv->dev);
     g_free(priv->key);
     g_free(priv->modem);
+    if (priv->context) {
+        g_main_context_unref(priv->context);
+    }
+    radio_recorder_unref(priv->recorder);
+    if (priv->timing) {
+        radio_instance_timing_free(priv->timing);
+    }
+    g_hash_table_destroy(priv->handlers);
+    if (priv->ind_interest) {
+        g_hash_table_destroy(priv->ind_interest);
+    }
+    radio_ind_meter_free(priv->ind_meter);
     G_OBJECT_CLASS(radio_instance_parent_class)->finalize(object);
 }
 
@@ -1433,6 +3483,10 @@ radio_instance_class_init(
         g_signal_new(SIGNAL_CONNECTED_NAME, type,
             G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL,
             G_TYPE_NONE, 0);
+    radio_instance_signals[SIGNAL_SLOW_HANDLER] =
+        g_signal_new(SIGNAL_SLOW_HANDLER_NAME, type,
+            G_SIGNAL_RUN_FIRST, 0, NULL, NULL, NULL,
+            G_TYPE_NONE, 3, G_TYPE_POINTER, G_TYPE_UINT, G_TYPE_UINT);
 }
 
 /*
@@ -66,18 +66,76 @@ radio_instance_send_request(
     void* user_data2)
     RADIO_INTERNAL;
 
+/* Tells the request observers that it's a resubmission of serial */
+gulong
+radio_instance_resend_request(
+    RadioInstance* instance,
+    RADIO_REQ code,
+    guint32 serial,
+    GBinderLocalRequest* args,
+    RadioInstanceTxCompleteFunc complete,
+    RadioInstanceTxDestroyFunc destroy,
+    void* user_data1,
+    void* user_data2)
+    RADIO_INTERNAL;
+
 void
 radio_instance_cancel_request(
     RadioInstance* instance,
     gulong id)
     RADIO_INTERNAL;
 
+GMainContext*
+radio_instance_context(
+    RadioInstance* instance)
+    RADIO_INTERNAL;
+
+GBinderRemoteRequest*
+radio_instance_resp_message(
+    RadioInstance* instance)
+    RADIO_INTERNAL;
+
 GQuark
 radio_instance_ind_quark(
     RadioInstance* instance,
     RADIO_IND ind)
     RADIO_INTERNAL;
 
+/* Unlike regular observers, doesn't keep any indications enabled */
+gulong
+radio_instance_add_indication_relay(
+    RadioInstance* instance,
+    RadioIndicationObserverFunc func,
+    gpointer user_data)
+    RADIO_INTERNAL;
+
+/* Keeps the indication enabled when the indication filter is automatic */
+void
+radio_instance_ind_interest_ref(
+    RadioInstance* instance,
+    RADIO_IND ind)
+    RADIO_INTERNAL;
+
+void
+radio_instance_ind_interest_unref(
+    RadioInstance* instance,
+    RADIO_IND ind)
+    RADIO_INTERNAL;
+
+/*
+ * While at least one client is in power save, the modem is told about
+ * it and the indication filter is limited to the essential indications.
+ */
+void
+radio_instance_power_save_ref(
+    RadioInstance* instance)
+    RADIO_INTERNAL;
+
+void
+radio_instance_power_save_unref(
+    RadioInstance* instance)
+    RADIO_INTERNAL;
+
 #endif /* RADIO_INSTANCE_PRIVATE_H */
 
 /*
@@ -0,0 +1,1068 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "radio_base.h"
+#include "radio_client_p.h"
+#include "radio_config.h"
+#include "radio_instance.h"
+#include "radio_metrics.h"
+#include "radio_log.h"
+
+#include <gutil_macros.h>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+/* This API exists since 1.6.7 */
+
+typedef enum radio_metrics_base_counter {
+    RADIO_METRICS_QUEUED,
+    RADIO_METRICS_PENDING,
+    RADIO_METRICS_SUBMITTED,
+    RADIO_METRICS_COMPLETED,
+    RADIO_METRICS_FAILED,
+    RADIO_METRICS_TIMEOUTS,
+    RADIO_METRICS_RETRIES,
+    RADIO_METRICS_BASE_COUNT
+} RADIO_METRICS_BASE_COUNTER;
+
+typedef struct radio_metrics_desc {
+    const char* name;
+    const char* type;
+    const char* help;
+} RadioMetricsDesc;
+
+static const RadioMetricsDesc radio_metrics_base_desc[] = {
+    { "radio_requests_queued", "gauge",
+      "Requests waiting in the queue" },
+    { "radio_requests_pending", "gauge",
+      "Requests waiting for a response" },
+    { "radio_requests_submitted_total", "counter",
+      "Request transactions, including retries" },
+    { "radio_requests_completed_total", "counter",
+      "Requests completed with a response" },
+    { "radio_requests_failed_total", "counter",
+      "Requests failed, including timeouts" },
+    { "radio_requests_timeouts_total", "counter",
+      "Requests which didn't get a response in time" },
+    { "radio_requests_retries_total", "counter",
+      "Requests re-queued for another attempt" }
+};
+G_STATIC_ASSERT(G_N_ELEMENTS(radio_metrics_base_desc) ==
+    RADIO_METRICS_BASE_COUNT);
+
+/* Indexed by RADIO_AIDL_INTERFACE */
+static const char* const radio_metrics_aidl_iface[] = {
+    "data", "ims", "messaging", "modem", "network", "sim", "voice"
+};
+G_STATIC_ASSERT(G_N_ELEMENTS(radio_metrics_aidl_iface) ==
+    RADIO_AIDL_INTERFACE_COUNT);
+
+enum radio_metrics_event {
+    RADIO_METRICS_EVENT_DEATH,
+    RADIO_METRICS_EVENT_CONNECTED,
+    RADIO_METRICS_EVENT_COUNT
+};
+
+/* Exactly one of client, config and instance is the primary object */
+typedef struct radio_metrics_source {
+    RadioClient* client;
+    RadioConfig* config;
+    RadioInstance* instance;    /* The client's one or a bare instance */
+    gulong event_id[RADIO_METRICS_EVENT_COUNT];
+    guint64 connects;
+    guint64 deaths;
+} RadioMetricsSource;
+
+/* Everything collected from a source before formatting */
+typedef struct radio_metrics_snapshot {
+    const RadioMetricsSource* src;
+    char* labels;               /* Identify the instance or the config */
+    char* base_labels;          /* Identify the client or the config */
+    gboolean first;             /* The first source of its object */
+    gboolean has_base;
+    guint64 base[RADIO_METRICS_BASE_COUNT];
+    RadioBaseLatency* latency;
+    guint latency_count;
+    RadioAckStats ack;
+    RadioIndRate* ind;
+    guint ind_count;
+} RadioMetricsSnapshot;
+
+typedef struct radio_metrics_conn {
+    RadioMetrics* metrics;      /* Not a reference */
+    int fd;
+    guint id;
+    char* data;
+    gsize size;
+    gsize written;
+} RadioMetricsConn;
+
+struct radio_metrics {
+    gint refcount;
+    GSList* sources;
+    char* file;
+    guint file_timer_id;
+    char* socket;
+    int socket_fd;
+    guint socket_id;
+    GSList* conns;
+};
+
+/*==========================================================================*
+ * Sources
+ *==========================================================================*/
+
+static
+void
+radio_metrics_instance_death(
+    RadioInstance* instance,
+    gpointer user_data)
+{
+    ((RadioMetricsSource*)user_data)->deaths++;
+}
+
+static
+void
+radio_metrics_instance_connected(
+    RadioInstance* instance,
+    gpointer user_data)
+{
+    ((RadioMetricsSource*)user_data)->connects++;
+}
+
+static
+void
+radio_metrics_config_death(
+    RadioConfig* config,
+    gpointer user_data)
+{
+    ((RadioMetricsSource*)user_data)->deaths++;
+}
+
+static
+GSList*
+radio_metrics_find_source(
+    RadioMetrics* self,
+    gpointer client,
+    gpointer config,
+    gpointer instance)
+{
+    GSList* l;
+
+    for (l = self->sources; l; l = l->next) {
+        RadioMetricsSource* src = l->data;
+
+        if ((client && src->client == client) ||
+            (config && src->config == config) ||
+            (instance && !client && !src->client &&
+             src->instance == instance)) {
+            return l;
+        }
+    }
+    return NULL;
+}
+
+static
+void
+radio_metrics_add_source(
+    RadioMetrics* self,
+    RadioClient* client,
+    RadioConfig* config,
+    RadioInstance* instance)
+{
+    RadioMetricsSource* src;
+
+    if (radio_metrics_find_source(self, client, config, instance)) {
+        /* Each object is only counted once */
+        return;
+    }
+
+    src = g_slice_new0(RadioMetricsSource);
+    if (config) {
+        src->config = radio_config_ref(config);
+        src->event_id[RADIO_METRICS_EVENT_DEATH] =
+            radio_config_add_death_handler(config,
+                radio_metrics_config_death, src);
+    } else {
+        src->client = radio_client_ref(client);
+        src->instance = radio_instance_ref(instance);
+        src->event_id[RADIO_METRICS_EVENT_DEATH] =
+            radio_instance_add_death_handler(instance,
+                radio_metrics_instance_death, src);
+        src->event_id[RADIO_METRICS_EVENT_CONNECTED] =
+            radio_instance_add_connected_handler(instance,
+                radio_metrics_instance_connected, src);
+    }
+    self->sources = g_slist_append(self->sources, src);
+}
+
+static
+void
+radio_metrics_source_free(
+    gpointer data)
+{
+    RadioMetricsSource* src = data;
+
+    if (src->config) {
+        radio_config_remove_all_handlers(src->config, src->event_id);
+        radio_config_unref(src->config);
+    } else {
+        radio_instance_remove_all_handlers(src->instance, src->event_id);
+        radio_instance_unref(src->instance);
+        radio_client_unref(src->client);
+    }
+    gutil_slice_free(src);
+}
+
+static
+void
+radio_metrics_remove_source(
+    RadioMetrics* self,
+    gpointer client,
+    gpointer config,
+    gpointer instance)
+{
+    GSList* l = radio_metrics_find_source(self, client, config, instance);
+
+    if (l) {
+        radio_metrics_source_free(l->data);
+        self->sources = g_slist_delete_link(self->sources, l);
+    }
+}
+
+/*==========================================================================*
+ * Formatting
+ *==========================================================================*/
+
+static
+void
+radio_metrics_append_escaped(
+    GString* buf,
+    const char* str)
+{
+    const char* ptr;
+
+    for (ptr = str; *ptr; ptr++) {
+        switch (*ptr) {
+        case '\\':
+            g_string_append(buf, "\\\\");
+            break;
+        case '"':
+            g_string_append(buf, "\\\"");
+            break;
+        case '\n':
+            g_string_append(buf, "\\n");
+            break;
+        default:
+            g_string_append_c(buf, *ptr);
+            break;
+        }
+    }
+}
+
+static
+char*
+radio_metrics_labels(
+    const RadioMetricsSource* src)
+{
+    GString* buf = g_string_new(NULL);
+
+    if (src->config) {
+        RadioConfig* config = src->config;
+        const int version = radio_config_interface(config);
+
+        /* HIDL and AIDL IRadioConfig may coexist */
+        g_string_append(buf, "iface=\"config\",version=\"");
+        if (radio_config_interface_type(config) == RADIO_INTERFACE_TYPE_AIDL) {
+            g_string_append_printf(buf, "aidl%d\"", version + 1);
+        } else {
+            g_string_append_printf(buf, "1.%d\"", version);
+        }
+    } else {
+        RadioInstance* instance = src->instance;
+
+        g_string_append(buf, "slot=\"");
+        radio_metrics_append_escaped(buf, instance->slot);
+        g_string_append(buf, "\",iface=\"");
+        if (instance->interface_type == RADIO_INTERFACE_TYPE_AIDL &&
+            instance->interface_aidl > RADIO_AIDL_INTERFACE_NONE &&
+            instance->interface_aidl < RADIO_AIDL_INTERFACE_COUNT) {
+            g_string_append(buf,
+                radio_metrics_aidl_iface[instance->interface_aidl]);
+        } else {
+            g_string_append(buf, "radio");
+        }
+        g_string_append_c(buf, '"');
+    }
+    return g_string_free(buf, FALSE);
+}
+
+/*
+ * Instance level metrics are only emitted by the first source of each
+ * instance, otherwise several clients sharing the instance would produce
+ * identical series. Request counters are per RadioBase, and the clients
+ * of the same instance are told apart by their index.
+ */
+static
+void
+radio_metrics_snapshot_init(
+    RadioMetricsSnapshot* snap,
+    const RadioMetricsSource* src,
+    GSList* prev)
+{
+    RadioBase* base = src->client ? RADIO_BASE(src->client) :
+        src->config ? RADIO_BASE(src->config) : NULL;
+    guint index = 0;
+    GSList* l;
+
+    memset(snap, 0, sizeof(*snap));
+    snap->src = src;
+    snap->first = TRUE;
+    for (l = prev; l && l->data != src; l = l->next) {
+        const RadioMetricsSource* other = l->data;
+
+        if (!src->config && other->instance == src->instance) {
+            snap->first = FALSE;
+            if (other->client) {
+                index++;
+            }
+        }
+    }
+    snap->labels = radio_metrics_labels(src);
+    snap->base_labels = src->client ?
+        g_strdup_printf("%s,client=\"%u\"", snap->labels, index) :
+        g_strdup(snap->labels);
+    if (base) {
+        RadioBaseStats stats;
+
+        radio_base_get_stats(base, &stats);
+        snap->has_base = TRUE;
+        snap->base[RADIO_METRICS_QUEUED] = stats.queued;
+        snap->base[RADIO_METRICS_PENDING] = stats.pending;
+        snap->base[RADIO_METRICS_SUBMITTED] = stats.submitted;
+        snap->base[RADIO_METRICS_COMPLETED] = stats.completed;
+        snap->base[RADIO_METRICS_FAILED] = stats.failed;
+        snap->base[RADIO_METRICS_TIMEOUTS] = stats.timeouts;
+        snap->base[RADIO_METRICS_RETRIES] = stats.retries;
+        snap->latency = radio_base_get_latency(base, &snap->latency_count);
+    }
+    if (src->config) {
+        snap->ind = radio_config_get_ind_rates(src->config,
+            RADIO_IND_RATE_BY_COUNT, 0, &snap->ind_count);
+    } else {
+        radio_instance_get_ack_stats(src->instance, &snap->ack);
+        snap->ind = radio_instance_get_ind_rates(src->instance,
+            RADIO_IND_RATE_BY_COUNT, 0, &snap->ind_count);
+    }
+}
+
+static
+void
+radio_metrics_snapshot_cleanup(
+    RadioMetricsSnapshot* snap)
+{
+    g_free(snap->labels);
+    g_free(snap->base_labels);
+    g_free(snap->latency);
+    g_free(snap->ind);
+}
+
+static
+void
+radio_metrics_append_code(
+    GString* buf,
+    const char* name,
+    guint code)
+{
+    g_string_append(buf, ",code=\"");
+    if (name) {
+        radio_metrics_append_escaped(buf, name);
+    } else {
+        g_string_append_printf(buf, "%u", code);
+    }
+    g_string_append_c(buf, '"');
+}
+
+static
+const char*
+radio_metrics_req_name(
+    const RadioMetricsSource* src,
+    guint code)
+{
+    return src->config ? radio_config_req_name(src->config, code) :
+        radio_instance_req_name(src->instance, code);
+}
+
+static
+const char*
+radio_metrics_ind_name(
+    const RadioMetricsSource* src,
+    guint code)
+{
+    return src->config ? radio_config_ind_name(src->config, code) :
+        radio_instance_ind_name(src->instance, code);
+}
+
+static
+void
+radio_metrics_append_header(
+    GString* buf,
+    const char* name,
+    const char* type,
+    const char* help)
+{
+    g_string_append_printf(buf, "# HELP %s %s\n# TYPE %s %s\n",
+        name, help, name, type);
+}
+
+static
+void
+radio_metrics_append_uint(
+    GString* buf,
+    const char* name,
+    const char* labels,
+    const char* code_name,
+    guint code,
+    guint64 value)
+{
+    g_string_append_printf(buf, "%s{%s", name, labels);
+    if (code_name || code) {
+        radio_metrics_append_code(buf, code_name, code);
+    }
+    g_string_append_printf(buf, "} %" G_GUINT64_FORMAT "\n", value);
+}
+
+static
+void
+radio_metrics_append_double(
+    GString* buf,
+    const char* name,
+    const char* labels,
+    const char* code_name,
+    guint code,
+    gdouble value)
+{
+    char str[G_ASCII_DTOSTR_BUF_SIZE];
+
+    /* Not affected by the locale */
+    g_ascii_dtostr(str, sizeof(str), value);
+    g_string_append_printf(buf, "%s{%s", name, labels);
+    radio_metrics_append_code(buf, code_name, code);
+    g_string_append_printf(buf, "} %s\n", str);
+}
+
+static
+void
+radio_metrics_format_base(
+    GString* buf,
+    const RadioMetricsSnapshot* snaps,
+    guint n)
+{
+    guint i, k, j;
+
+    for (k = 0; k < RADIO_METRICS_BASE_COUNT; k++) {
+        const RadioMetricsDesc* desc = radio_metrics_base_desc + k;
+
+        radio_metrics_append_header(buf, desc->name, desc->type, desc->help);
+        for (i = 0; i < n; i++) {
+            const RadioMetricsSnapshot* snap = snaps + i;
+
+            if (snap->has_base) {
+                radio_metrics_append_uint(buf, desc->name, snap->base_labels,
+                    NULL, 0, snap->base[k]);
+            }
+        }
+    }
+
+    radio_metrics_append_header(buf, "radio_request_latency_seconds",
+        "summary", "Time from the first transaction to the response");
+    for (i = 0; i < n; i++) {
+        const RadioMetricsSnapshot* snap = snaps + i;
+
+        for (j = 0; j < snap->latency_count; j++) {
+            const RadioBaseLatency* lat = snap->latency + j;
+            const char* name = radio_metrics_req_name(snap->src, lat->code);
+
+            radio_metrics_append_double(buf,
+                "radio_request_latency_seconds_sum", snap->base_labels,
+                name, lat->code, lat->total_usec / 1e6);
+            g_string_append_printf(buf,
+                "radio_request_latency_seconds_count{%s", snap->base_labels);
+            radio_metrics_append_code(buf, name, lat->code);
+            g_string_append_printf(buf, "} %u\n", lat->count);
+        }
+    }
+
+    radio_metrics_append_header(buf, "radio_request_latency_max_seconds",
+        "gauge", "Longest time from the first transaction to the response");
+    for (i = 0; i < n; i++) {
+        const RadioMetricsSnapshot* snap = snaps + i;
+
+        for (j = 0; j < snap->latency_count; j++) {
+            const RadioBaseLatency* lat = snap->latency + j;
+
+            radio_metrics_append_double(buf,
+                "radio_request_latency_max_seconds", snap->base_labels,
+                radio_metrics_req_name(snap->src, lat->code), lat->code,
+                lat->max_usec / 1e6);
+        }
+    }
+}
+
+static
+void
+radio_metrics_format_instance(
+    GString* buf,
+    const RadioMetricsSnapshot* snaps,
+    guint n)
+{
+    static const RadioMetricsDesc desc[] = {
+        { "radio_instance_connected", "gauge",
+          "Whether rilConnected has been received" },
+        { "radio_instance_dead", "gauge",
+          "Whether the remote object has died" },
+        { "radio_instance_connects_total", "counter",
+          "rilConnected indications received" },
+        { "radio_instance_deaths_total", "counter",
+          "Remote object deaths" },
+        { "radio_acks_requested_total", "counter",
+          "Acks requested by the modem" },
+        { "radio_acks_sent_total", "counter",
+          "responseAcknowledgement transactions sent" }
+    };
+    guint i, k;
+
+    for (k = 0; k < G_N_ELEMENTS(desc); k++) {
+        const char* metric = desc[k].name;
+
+        radio_metrics_append_header(buf, metric, desc[k].type, desc[k].help);
+        for (i = 0; i < n; i++) {
+            const RadioMetricsSnapshot* snap = snaps + i;
+            const RadioMetricsSource* src = snap->src;
+            RadioInstance* instance = src->instance;
+            guint64 value;
+
+            if (!snap->first) {
+                continue;
+            }
+            switch (k) {
+            case 1:
+                value = instance ? instance->dead :
+                    radio_config_dead(src->config);
+                break;
+            case 3:
+                value = src->deaths;
+                break;
+            default:
+                /* The rest is only relevant to instances */
+                if (!instance) {
+                    continue;
+                }
+                value = (k == 0) ? instance->connected :
+                    (k == 2) ? src->connects :
+                    (k == 4) ? snap->ack.requested :
+                    snap->ack.sent;
+                break;
+            }
+            radio_metrics_append_uint(buf, metric, snap->labels, NULL, 0,
+                value);
+        }
+    }
+}
+
+static
+void
+radio_metrics_format_ind(
+    GString* buf,
+    const RadioMetricsSnapshot* snaps,
+    guint n)
+{
+    static const RadioMetricsDesc desc[] = {
+        { "radio_indications_total", "counter",
+          "Indications received" },
+        { "radio_indication_bytes_total", "counter",
+          "Indication bytes received" },
+        { "radio_indication_rate", "gauge",
+          "Decayed indication rate, per second" },
+        { "radio_indication_byte_rate", "gauge",
+          "Decayed indication byte rate, per second" }
+    };
+    guint i, j, k;
+
+    for (k = 0; k < G_N_ELEMENTS(desc); k++) {
+        const char* metric = desc[k].name;
+
+        radio_metrics_append_header(buf, metric, desc[k].type, desc[k].help);
+        for (i = 0; i < n; i++) {
+            const RadioMetricsSnapshot* snap = snaps + i;
+
+            if (!snap->first) {
+                continue;
+            }
+            for (j = 0; j < snap->ind_count; j++) {
+                const RadioIndRate* r = snap->ind + j;
+                const char* name = radio_metrics_ind_name(snap->src, r->code);
+
+                switch (k) {
+                case 0:
+                    radio_metrics_append_uint(buf, metric, snap->labels,
+                        name, r->code, r->count);
+                    break;
+                case 1:
+                    radio_metrics_append_uint(buf, metric, snap->labels,
+                        name, r->code, r->bytes);
+                    break;
+                case 2:
+                    radio_metrics_append_double(buf, metric, snap->labels,
+                        name, r->code, r->rate);
+                    break;
+                default:
+                    radio_metrics_append_double(buf, metric, snap->labels,
+                        name, r->code, r->byte_rate);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/*==========================================================================*
+ * File exporter
+ *==========================================================================*/
+
+static
+gboolean
+radio_metrics_write_file(
+    RadioMetrics* self)
+{
+    GError* error = NULL;
+    char* text = radio_metrics_format(self);
+    const gboolean ok = g_file_set_contents(self->file, text, -1, &error);
+
+    if (!ok) {
+        GWARN("%s", error->message);
+        g_error_free(error);
+    }
+    g_free(text);
+    return ok;
+}
+
+static
+gboolean
+radio_metrics_file_timer(
+    gpointer user_data)
+{
+    radio_metrics_write_file(user_data);
+    return G_SOURCE_CONTINUE;
+}
+
+static
+void
+radio_metrics_stop_file(
+    RadioMetrics* self)
+{
+    if (self->file_timer_id) {
+        g_source_remove(self->file_timer_id);
+        self->file_timer_id = 0;
+    }
+    g_free(self->file);
+    self->file = NULL;
+}
+
+/*==========================================================================*
+ * Socket exporter
+ *==========================================================================*/
+
+/* The watch holds the only channel reference, the fd is closed by us */
+static
+guint
+radio_metrics_add_watch(
+    int fd,
+    GIOCondition condition,
+    GIOFunc func,
+    gpointer user_data)
+{
+    GIOChannel* channel = g_io_channel_unix_new(fd);
+    const guint id = g_io_add_watch(channel, condition, func, user_data);
+
+    g_io_channel_unref(channel);
+    return id;
+}
+
+static
+void
+radio_metrics_conn_free(
+    RadioMetricsConn* conn)
+{
+    if (conn->id) {
+        g_source_remove(conn->id);
+    }
+    close(conn->fd);
+    g_free(conn->data);
+    gutil_slice_free(conn);
+}
+
+static
+void
+radio_metrics_conn_done(
+    RadioMetricsConn* conn)
+{
+    RadioMetrics* self = conn->metrics;
+
+    self->conns = g_slist_remove(self->conns, conn);
+    radio_metrics_conn_free(conn);
+}
+
+/* Returns TRUE if there's more to write */
+static
+gboolean
+radio_metrics_conn_write(
+    RadioMetricsConn* conn)
+{
+    while (conn->written < conn->size) {
+        /* Don't get killed by SIGPIPE if the peer has gone away */
+        const ssize_t n = send(conn->fd, conn->data + conn->written,
+            conn->size - conn->written, MSG_NOSIGNAL);
+
+        if (n > 0) {
+            conn->written += n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return TRUE;
+        } else {
+            GDEBUG("Metrics write error: %s", strerror(errno));
+            break;
+        }
+    }
+    return FALSE;
+}
+
+static
+gboolean
+radio_metrics_conn_writable(
+    GIOChannel* channel,
+    GIOCondition condition,
+    gpointer user_data)
+{
+    RadioMetricsConn* conn = user_data;
+
+    if (!(condition & (G_IO_ERR | G_IO_HUP)) &&
+        radio_metrics_conn_write(conn)) {
+        return G_SOURCE_CONTINUE;
+    } else {
+        conn->id = 0;
+        radio_metrics_conn_done(conn);
+        return G_SOURCE_REMOVE;
+    }
+}
+
+static
+gboolean
+radio_metrics_accept(
+    GIOChannel* channel,
+    GIOCondition condition,
+    gpointer user_data)
+{
+    RadioMetrics* self = user_data;
+    const int cfd = accept(g_io_channel_unix_get_fd(channel), NULL, NULL);
+
+    if (cfd >= 0) {
+        RadioMetricsConn* conn = g_slice_new0(RadioMetricsConn);
+
+        fcntl(cfd, F_SETFL, fcntl(cfd, F_GETFL) | O_NONBLOCK);
+        fcntl(cfd, F_SETFD, FD_CLOEXEC);
+        conn->metrics = self;
+        conn->fd = cfd;
+        conn->data = radio_metrics_format(self);
+        conn->size = strlen(conn->data);
+        if (radio_metrics_conn_write(conn)) {
+            /* The rest is written when the socket becomes writable */
+            conn->id = radio_metrics_add_watch(cfd, G_IO_OUT,
+                radio_metrics_conn_writable, conn);
+            self->conns = g_slist_append(self->conns, conn);
+        } else {
+            radio_metrics_conn_free(conn);
+        }
+    } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        GWARN("Metrics accept error: %s", strerror(errno));
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static
+void
+radio_metrics_stop_socket(
+    RadioMetrics* self)
+{
+    while (self->conns) {
+        RadioMetricsConn* conn = self->conns->data;
+
+        self->conns = g_slist_delete_link(self->conns, self->conns);
+        radio_metrics_conn_free(conn);
+    }
+    if (self->socket_id) {
+        g_source_remove(self->socket_id);
+        self->socket_id = 0;
+    }
+    if (self->socket) {
+        close(self->socket_fd);
+        unlink(self->socket);
+        g_free(self->socket);
+        self->socket = NULL;
+    }
+}
+
+static
+void
+radio_metrics_free(
+    RadioMetrics* self)
+{
+    radio_metrics_stop_file(self);
+    radio_metrics_stop_socket(self);
+    g_slist_free_full(self->sources, radio_metrics_source_free);
+    g_free(self);
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+RadioMetrics*
+radio_metrics_new(
+    void)
+{
+    RadioMetrics* self = g_new0(RadioMetrics, 1);
+
+    g_atomic_int_set(&self->refcount, 1);
+    self->socket_fd = -1;
+    return self;
+}
+
+RadioMetrics*
+radio_metrics_ref(
+    RadioMetrics* self)
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->refcount > 0);
+        g_atomic_int_inc(&self->refcount);
+    }
+    return self;
+}
+
+void
+radio_metrics_unref(
+    RadioMetrics* self)
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->refcount > 0);
+        if (g_atomic_int_dec_and_test(&self->refcount)) {
+            radio_metrics_free(self);
+        }
+    }
+}
+
+void
+radio_metrics_add_client(
+    RadioMetrics* self,
+    RadioClient* client)
+{
+    if (G_LIKELY(self) && G_LIKELY(client)) {
+        radio_metrics_add_source(self, client, NULL,
+            radio_client_instance(client));
+    }
+}
+
+void
+radio_metrics_remove_client(
+    RadioMetrics* self,
+    RadioClient* client)
+{
+    if (G_LIKELY(self) && G_LIKELY(client)) {
+        radio_metrics_remove_source(self, client, NULL, NULL);
+    }
+}
+
+void
+radio_metrics_add_config(
+    RadioMetrics* self,
+    RadioConfig* config)
+{
+    if (G_LIKELY(self) && G_LIKELY(config)) {
+        radio_metrics_add_source(self, NULL, config, NULL);
+    }
+}
+
+void
+radio_metrics_remove_config(
+    RadioMetrics* self,
+    RadioConfig* config)
+{
+    if (G_LIKELY(self) && G_LIKELY(config)) {
+        radio_metrics_remove_source(self, NULL, config, NULL);
+    }
+}
+
+void
+radio_metrics_add_instance(
+    RadioMetrics* self,
+    RadioInstance* instance)
+{
+    if (G_LIKELY(self) && G_LIKELY(instance)) {
+        radio_metrics_add_source(self, NULL, NULL, instance);
+    }
+}
+
+void
+radio_metrics_remove_instance(
+    RadioMetrics* self,
+    RadioInstance* instance)
+{
+    if (G_LIKELY(self) && G_LIKELY(instance)) {
+        radio_metrics_remove_source(self, NULL, NULL, instance);
+    }
+}
+
+char*
+radio_metrics_format(
+    RadioMetrics* self)
+{
+    if (G_LIKELY(self)) {
+        const guint n = g_slist_length(self->sources);
+        RadioMetricsSnapshot* snaps = g_new(RadioMetricsSnapshot, MAX(n, 1));
+        GString* buf = g_string_new(NULL);
+        GSList* l;
+        guint i;
+
+        for (l = self->sources, i = 0; l; l = l->next, i++) {
+            radio_metrics_snapshot_init(snaps + i, l->data, self->sources);
+        }
+        radio_metrics_format_base(buf, snaps, n);
+        radio_metrics_format_instance(buf, snaps, n);
+        radio_metrics_format_ind(buf, snaps, n);
+        for (i = 0; i < n; i++) {
+            radio_metrics_snapshot_cleanup(snaps + i);
+        }
+        g_free(snaps);
+        return g_string_free(buf, FALSE);
+    }
+    return NULL;
+}
+
+gboolean
+radio_metrics_export_file(
+    RadioMetrics* self,
+    const char* path,
+    guint interval_ms)
+{
+    if (G_LIKELY(self)) {
+        radio_metrics_stop_file(self);
+        if (path) {
+            self->file = g_strdup(path);
+            if (radio_metrics_write_file(self)) {
+                if (interval_ms) {
+                    self->file_timer_id = g_timeout_add(interval_ms,
+                        radio_metrics_file_timer, self);
+                }
+                return TRUE;
+            }
+            radio_metrics_stop_file(self);
+        } else {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+gboolean
+radio_metrics_export_socket(
+    RadioMetrics* self,
+    const char* path)
+{
+    if (G_LIKELY(self)) {
+        radio_metrics_stop_socket(self);
+        if (path) {
+            struct sockaddr_un addr;
+            struct stat st;
+            int fd;
+
+            memset(&addr, 0, sizeof(addr));
+            if (strlen(path) >= sizeof(addr.sun_path)) {
+                GWARN("Socket path too long: %s", path);
+                return FALSE;
+            }
+            addr.sun_family = AF_UNIX;
+            strcpy(addr.sun_path, path);
+
+            fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                0);
+            if (fd < 0) {
+                GWARN("Failed to create socket: %s", strerror(errno));
+                return FALSE;
+            }
+
+            /* Remove the stale socket but nothing else */
+            if (!lstat(path, &st) && S_ISSOCK(st.st_mode)) {
+                unlink(path);
+            }
+            if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+                listen(fd, 4) < 0) {
+                GWARN("Failed to listen on %s: %s", path, strerror(errno));
+                close(fd);
+                return FALSE;
+            }
+            self->socket = g_strdup(path);
+            self->socket_fd = fd;
+            self->socket_id = radio_metrics_add_watch(fd, G_IO_IN,
+                radio_metrics_accept, self);
+        }
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
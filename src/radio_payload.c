@@ -0,0 +1,284 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "radio_payload.h"
+
+#include <gbinder_reader.h>
+
+static
+const void*
+radio_payload_read(
+    RADIO_PAYLOAD_TYPE type,
+    gsize size,
+    GBinderReader* reader,
+    gsize* count)
+{
+    const void* ptr = NULL;
+    gsize n = 0;
+
+    if (G_LIKELY(reader)) {
+        switch (type) {
+        case RADIO_PAYLOAD_STRUCT:
+            ptr = gbinder_reader_read_hidl_struct1(reader, size);
+            if (ptr) {
+                n = 1;
+            }
+            break;
+        case RADIO_PAYLOAD_VEC:
+            ptr = gbinder_reader_read_hidl_vec1(reader, &n, size);
+            break;
+        case RADIO_PAYLOAD_NONE:
+            break;
+        }
+    }
+    if (count) {
+        *count = ptr ? n : 0;
+    }
+    return ptr;
+}
+
+static
+gboolean
+radio_vec_iter_setup(
+    RadioVecIter* iter,
+    gconstpointer ptr,
+    gsize count,
+    gsize elem_size)
+{
+    memset(iter, 0, sizeof(*iter));
+    if (ptr && count <= G_MAXUINT) {
+        iter->ptr = ptr;
+        iter->count = (guint) count;
+        iter->elem_size = elem_size;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+RADIO_PAYLOAD_TYPE
+radio_resp_payload_type(
+    RADIO_RESP resp,
+    gsize* size)
+{
+    switch (resp) {
+#define RADIO_PAYLOAD_STRUCT_(NAME,Type) case RADIO_RESP_##NAME: \
+        if (size) *size = sizeof(Type); \
+        return RADIO_PAYLOAD_STRUCT;
+#define RADIO_PAYLOAD_VEC_(NAME,Type) case RADIO_RESP_##NAME: \
+        if (size) *size = sizeof(Type); \
+        return RADIO_PAYLOAD_VEC;
+    RADIO_RESP_PAYLOAD_STRUCT(RADIO_PAYLOAD_STRUCT_)
+    RADIO_RESP_PAYLOAD_VEC(RADIO_PAYLOAD_VEC_)
+#undef RADIO_PAYLOAD_STRUCT_
+#undef RADIO_PAYLOAD_VEC_
+    default:
+        break;
+    }
+    if (size) *size = 0;
+    return RADIO_PAYLOAD_NONE;
+}
+
+RADIO_PAYLOAD_TYPE
+radio_ind_payload_type(
+    RADIO_IND ind,
+    gsize* size)
+{
+    switch (ind) {
+#define RADIO_PAYLOAD_STRUCT_(NAME,Type) case RADIO_IND_##NAME: \
+        if (size) *size = sizeof(Type); \
+        return RADIO_PAYLOAD_STRUCT;
+#define RADIO_PAYLOAD_VEC_(NAME,Type) case RADIO_IND_##NAME: \
+        if (size) *size = sizeof(Type); \
+        return RADIO_PAYLOAD_VEC;
+    RADIO_IND_PAYLOAD_STRUCT(RADIO_PAYLOAD_STRUCT_)
+    RADIO_IND_PAYLOAD_VEC(RADIO_PAYLOAD_VEC_)
+#undef RADIO_PAYLOAD_STRUCT_
+#undef RADIO_PAYLOAD_VEC_
+    default:
+        break;
+    }
+    if (size) *size = 0;
+    return RADIO_PAYLOAD_NONE;
+}
+
+const void*
+radio_resp_payload(
+    RADIO_RESP resp,
+    GBinderReader* reader,
+    gsize* count)
+{
+    gsize size;
+    const RADIO_PAYLOAD_TYPE type = radio_resp_payload_type(resp, &size);
+
+    return radio_payload_read(type, size, reader, count);
+}
+
+const void*
+radio_ind_payload(
+    RADIO_IND ind,
+    GBinderReader* reader,
+    gsize* count)
+{
+    gsize size;
+    const RADIO_PAYLOAD_TYPE type = radio_ind_payload_type(ind, &size);
+
+    return radio_payload_read(type, size, reader, count);
+}
+
+gboolean
+radio_vec_iter_init(
+    RadioVecIter* iter,
+    GBinderReader* reader,
+    gsize elem_size)
+{
+    if (G_LIKELY(iter)) {
+        gsize count = 0;
+        const void* ptr = (reader && elem_size) ?
+            gbinder_reader_read_hidl_vec1(reader, &count, elem_size) : NULL;
+
+        return radio_vec_iter_setup(iter, ptr, count, elem_size);
+    }
+    return FALSE;
+}
+
+gboolean
+radio_vec_iter_init_hidl(
+    RadioVecIter* iter,
+    const GBinderHidlVec* vec,
+    gsize elem_size)
+{
+    if (G_LIKELY(iter)) {
+        if (vec && elem_size) {
+            /* Empty vector may have NULL data pointer */
+            return radio_vec_iter_setup(iter, vec->count ? vec->data.ptr :
+                (gconstpointer) vec, vec->count, elem_size);
+        }
+        memset(iter, 0, sizeof(*iter));
+    }
+    return FALSE;
+}
+
+gboolean
+radio_vec_iter_init_aidl(
+    RadioVecIter* iter,
+    GBinderReader* reader)
+{
+    if (G_LIKELY(iter)) {
+        gint32 count;
+
+        memset(iter, 0, sizeof(*iter));
+        if (reader && gbinder_reader_read_int32(reader, &count) &&
+            count >= 0) {
+            iter->count = count;
+            iter->reader = reader;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+gboolean
+radio_resp_vec_iter_init(
+    RadioVecIter* iter,
+    RADIO_RESP resp,
+    GBinderReader* reader)
+{
+    gsize size;
+
+    if (radio_resp_payload_type(resp, &size) == RADIO_PAYLOAD_VEC) {
+        return radio_vec_iter_init(iter, reader, size);
+    } else if (G_LIKELY(iter)) {
+        memset(iter, 0, sizeof(*iter));
+    }
+    return FALSE;
+}
+
+gboolean
+radio_ind_vec_iter_init(
+    RadioVecIter* iter,
+    RADIO_IND ind,
+    GBinderReader* reader)
+{
+    gsize size;
+
+    if (radio_ind_payload_type(ind, &size) == RADIO_PAYLOAD_VEC) {
+        return radio_vec_iter_init(iter, reader, size);
+    } else if (G_LIKELY(iter)) {
+        memset(iter, 0, sizeof(*iter));
+    }
+    return FALSE;
+}
+
+const void*
+radio_vec_iter_next(
+    RadioVecIter* iter,
+    gsize* size)
+{
+    const void* elem = NULL;
+    gsize elem_size = 0;
+
+    if (G_LIKELY(iter) && iter->index < iter->count) {
+        if (iter->reader) {
+            elem = gbinder_reader_read_parcelable(iter->reader, &elem_size);
+        } else {
+            elem = iter->ptr;
+            elem_size = iter->elem_size;
+            iter->ptr = (const guint8*)elem + elem_size;
+        }
+        if (elem) {
+            iter->index++;
+        } else {
+            /* Stop right here */
+            iter->count = iter->index;
+            elem_size = 0;
+        }
+    }
+    if (size) {
+        *size = elem_size;
+    }
+    return elem;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef RADIO_PROBE_PRIVATE_H
+#define RADIO_PROBE_PRIVATE_H
+
+/*
+ * Static user-space tracepoints (USDT), provider "gbinder_radio".
+ * They are only compiled in when the library is built with USDT=1
+ * (which requires <sys/sdt.h>), otherwise the macros expand to nothing
+ * and the arguments are not evaluated. With USDT=1 each probe is a nop
+ * instruction plus an ELF note, e.g.
+ *
+ *   bpftrace -e 'usdt:libgbinder-radio.so:gbinder_radio:request_sent
+ *       { printf("%x %u\n", arg0, arg1); }'
+ *
+ * Probes and their arguments:
+ *
+ *   request_create     serial, code
+ *   request_queued     serial, code
+ *   request_deferred   serial, code
+ *   request_sent       serial (of this transaction), code
+ *   request_acked      serial
+ *   request_response   serial, code, error
+ *   request_retry      serial, code, retry count
+ *   request_timeout    serial, code
+ *   request_complete   serial, code, RADIO_TX_STATUS
+ *   instance_create    slot, RADIO_INTERFACE_TYPE, RADIO_INTERFACE
+ *   instance_death     slot
+ *   indication         slot, code, RADIO_IND_TYPE
+ *   indication_done    slot, code
+ *   response           slot, code, serial
+ *   response_done      slot, code
+ *   config_indication       code
+ *   config_indication_done  code
+ *   config_response         code, serial
+ *   config_response_done    code
+ */
+
+#ifdef RADIO_USDT
+#  include <sys/sdt.h>
+#  define RADIO_PROBE1(name,a) \
+    DTRACE_PROBE1(gbinder_radio, name, a)
+#  define RADIO_PROBE2(name,a,b) \
+    DTRACE_PROBE2(gbinder_radio, name, a, b)
+#  define RADIO_PROBE3(name,a,b,c) \
+    DTRACE_PROBE3(gbinder_radio, name, a, b, c)
+#else
+#  define RADIO_PROBE1(name,a) ((void)0)
+#  define RADIO_PROBE2(name,a,b) ((void)0)
+#  define RADIO_PROBE3(name,a,b,c) ((void)0)
+#endif
+
+#endif /* RADIO_PROBE_PRIVATE_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,455 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "radio_recorder_p.h"
+#include "radio_log.h"
+
+#include <gbinder_local_request.h>
+#include <gbinder_reader.h>
+#include <gbinder_writer.h>
+
+#include <gutil_macros.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Keep the whole thing well below 4G */
+#define RADIO_RECORDER_MAX_COUNT (0x10000)
+#define RADIO_RECORDER_MAX_DATA (0x10000)
+
+struct radio_recorder {
+    gint refcount;
+    gboolean mapped;
+    guint8* buf;
+    gsize size;
+    guint mask;
+    guint slot_size;
+    gint* busy; /* Per-slot writer flags, not part of the image */
+    dev_t dev;  /* Identifies the mapped file */
+    ino_t ino;
+};
+
+static
+RadioRecorderHeader*
+radio_recorder_header(
+    RadioRecorder* self)
+{
+    return (RadioRecorderHeader*) self->buf;
+}
+
+static
+RadioRecord*
+radio_recorder_slot(
+    RadioRecorder* self,
+    guint index)
+{
+    return (RadioRecord*) (self->buf + sizeof(RadioRecorderHeader) +
+        (gsize) (index & self->mask) * self->slot_size);
+}
+
+static
+void
+radio_recorder_init_header(
+    RadioRecorderHeader* hdr,
+    guint count,
+    guint slot_size,
+    guint32 next)
+{
+    hdr->magic = RADIO_RECORDER_MAGIC;
+    hdr->format = RADIO_RECORDER_FORMAT;
+    hdr->header_size = sizeof(RadioRecorderHeader);
+    hdr->count = count;
+    hdr->slot_size = slot_size;
+    hdr->next = next;
+    hdr->reserved = 0;
+    hdr->mono_time = g_get_monotonic_time();
+    hdr->real_time = g_get_real_time();
+}
+
+/*
+ * The records contain raw parcels (PINs, SMS, IMSI, location and such)
+ * so the files are only accessible by the owner. They are written under
+ * a temporary name and then renamed into place. An existing file is never
+ * truncated, since it may be mapped by a live recorder and truncating it
+ * would crash the writers with SIGBUS.
+ */
+static
+void*
+radio_recorder_map_file(
+    const char* path,
+    gsize size,
+    char** tmp)
+{
+    void* ptr = NULL;
+    char* name = g_strconcat(path, ".XXXXXX", NULL);
+    const int fd = g_mkstemp_full(name, O_RDWR | O_CLOEXEC, 0600);
+
+    if (fd >= 0) {
+        if (ftruncate(fd, size) == 0) {
+            ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (ptr == MAP_FAILED) {
+                GERR("Failed to map %s: %s", name, strerror(errno));
+                ptr = NULL;
+            }
+        } else {
+            GERR("Failed to resize %s: %s", name, strerror(errno));
+        }
+        close(fd);
+        if (ptr) {
+            *tmp = name;
+            return ptr;
+        }
+        unlink(name);
+    } else {
+        GERR("Failed to create %s: %s", name, strerror(errno));
+    }
+    g_free(name);
+    return NULL;
+}
+
+static
+gboolean
+radio_recorder_publish_file(
+    char* tmp,
+    const char* path)
+{
+    gboolean ok = TRUE;
+
+    if (rename(tmp, path) < 0) {
+        GERR("Failed to rename %s: %s", tmp, strerror(errno));
+        unlink(tmp);
+        ok = FALSE;
+    }
+    g_free(tmp);
+    return ok;
+}
+
+static
+void
+radio_recorder_free(
+    RadioRecorder* self)
+{
+    if (self->mapped) {
+        msync(self->buf, self->size, MS_ASYNC);
+        munmap(self->buf, self->size);
+    } else {
+        g_free(self->buf);
+    }
+    g_free(self->busy);
+    gutil_slice_free(self);
+}
+
+static
+RadioRecorder*
+radio_recorder_create(
+    const char* path,
+    guint count,
+    gsize max_data)
+{
+    RadioRecorder* self;
+    guint n = 1;
+    guint slot_size;
+    gsize size;
+    char* tmp = NULL;
+    void* buf;
+
+    /* Round the number of slots up to the next power of 2 */
+    count = MIN(count, RADIO_RECORDER_MAX_COUNT);
+    while (n < count) {
+        n <<= 1;
+    }
+
+    /* Keep 64-bit time stamps aligned */
+    max_data = MIN(max_data, RADIO_RECORDER_MAX_DATA);
+    slot_size = G_ALIGN8(sizeof(RadioRecord) + max_data);
+    size = sizeof(RadioRecorderHeader) + (gsize) n * slot_size;
+
+    if (path) {
+        buf = radio_recorder_map_file(path, size, &tmp);
+        if (!buf) {
+            return NULL;
+        }
+        /* The file has just been created, it's all zeros */
+    } else {
+        buf = g_malloc0(size);
+    }
+
+    self = g_slice_new0(RadioRecorder);
+    g_atomic_int_set(&self->refcount, 1);
+    self->mapped = (path != NULL);
+    self->buf = buf;
+    self->size = size;
+    self->mask = n - 1;
+    self->slot_size = slot_size;
+    self->busy = g_new0(gint, n);
+    radio_recorder_init_header(radio_recorder_header(self), n, slot_size, 1);
+    if (path) {
+        struct stat st;
+
+        if (!radio_recorder_publish_file(tmp, path)) {
+            radio_recorder_free(self);
+            return NULL;
+        } else if (stat(path, &st) == 0) {
+            self->dev = st.st_dev;
+            self->ino = st.st_ino;
+        }
+    }
+    GDEBUG("Recorder %u x %u bytes%s%s", n, slot_size, path ? " => " : "",
+        path ? path : "");
+    return self;
+}
+
+/*==========================================================================*
+ * Internal API
+ *==========================================================================*/
+
+void
+radio_recorder_add(
+    RadioRecorder* self,
+    RadioRecord* rec,
+    const void* data,
+    gsize size)
+{
+    RadioRecorderHeader* hdr = radio_recorder_header(self);
+    const gsize max = self->slot_size - sizeof(RadioRecord);
+    const gsize n = MIN(size, max);
+    RadioRecord* slot;
+    guint32 seq, prev;
+    gint* busy;
+
+    /* Claim the sequence number */
+    seq = (guint32) g_atomic_int_add((gint*) &hdr->next, 1);
+    if (G_UNLIKELY(!seq)) {
+        /* Zero marks an empty slot, skip it */
+        seq = (guint32) g_atomic_int_add((gint*) &hdr->next, 1);
+    }
+
+    rec->seq = 0;
+    rec->size = size;
+    rec->time = g_get_monotonic_time();
+    if (n < size) {
+        rec->flags |= RADIO_RECORD_FLAG_TRUNCATED;
+    }
+
+    /*
+     * Writers which have wrapped around onto the same slot would
+     * interleave their copies. That requires the whole ring to wrap
+     * while a record is being copied, so rather than waiting, the
+     * colliding record is dropped.
+     */
+    busy = self->busy + ((seq - 1) & self->mask);
+    if (!g_atomic_int_compare_and_exchange(busy, 0, 1)) {
+        GDEBUG("Recorder slot collision, record %u dropped", seq);
+        return;
+    }
+
+    /*
+     * If a newer record has got there first, ours would have been
+     * overwritten anyway. Otherwise, zero sequence number invalidates
+     * the slot while it's being written. The sequence number is stored
+     * last, which publishes the record. radio_recorder_dump() relies
+     * on that.
+     */
+    slot = radio_recorder_slot(self, seq - 1);
+    prev = (guint32) g_atomic_int_get((gint*) &slot->seq);
+    if (!prev || (gint32) (prev - seq) < 0) {
+        g_atomic_int_set((gint*) &slot->seq, 0);
+        memcpy(slot, rec, sizeof(*rec));
+        if (n) {
+            memcpy(slot + 1, data, n);
+        }
+        g_atomic_int_set((gint*) &slot->seq, seq);
+    }
+    g_atomic_int_set(busy, 0);
+}
+
+void
+radio_recorder_add_request(
+    RadioRecorder* self,
+    RadioRecord* rec,
+    GBinderLocalRequest* args,
+    gsize serial_offset)
+{
+    GBinderWriter writer;
+    const guint8* data;
+    gsize size = 0;
+
+    gbinder_local_request_init_writer(args, &writer);
+    data = gbinder_writer_get_data(&writer, &size);
+
+    /*
+     * The serial is the first argument of every request which gets
+     * a response. For other requests it's whatever comes first.
+     */
+    if (serial_offset && size >= serial_offset + sizeof(rec->serial)) {
+        memcpy(&rec->serial, data + serial_offset, sizeof(rec->serial));
+    }
+    radio_recorder_add(self, rec, data, size);
+}
+
+void
+radio_recorder_add_reader(
+    RadioRecorder* self,
+    RadioRecord* rec,
+    const GBinderReader* args)
+{
+    gsize size = 0;
+    const void* data = gbinder_reader_get_data(args, &size);
+
+    radio_recorder_add(self, rec, data, size);
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+RadioRecorder*
+radio_recorder_new(
+    guint count,
+    gsize max_data)
+{
+    return radio_recorder_create(NULL, count, max_data);
+}
+
+RadioRecorder*
+radio_recorder_new_mapped(
+    const char* path,
+    guint count,
+    gsize max_data)
+{
+    return G_LIKELY(path) ? radio_recorder_create(path, count, max_data) :
+        NULL;
+}
+
+RadioRecorder*
+radio_recorder_ref(
+    RadioRecorder* self)
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->refcount > 0);
+        g_atomic_int_inc(&self->refcount);
+    }
+    return self;
+}
+
+void
+radio_recorder_unref(
+    RadioRecorder* self)
+{
+    if (G_LIKELY(self)) {
+        GASSERT(self->refcount > 0);
+        if (g_atomic_int_dec_and_test(&self->refcount)) {
+            radio_recorder_free(self);
+        }
+    }
+}
+
+guint
+radio_recorder_count(
+    RadioRecorder* self)
+{
+    if (G_LIKELY(self)) {
+        const guint32 next = (guint32)
+            g_atomic_int_get((gint*) &radio_recorder_header(self)->next);
+
+        /* Number of records written so far, ignoring the wraparound */
+        return next - 1;
+    }
+    return 0;
+}
+
+gboolean
+radio_recorder_dump(
+    RadioRecorder* self,
+    const char* path)
+{
+    if (G_LIKELY(self) && G_LIKELY(path)) {
+        struct stat st;
+        char* tmp = NULL;
+        guint8* buf;
+
+        if (self->mapped && stat(path, &st) == 0 &&
+            st.st_dev == self->dev && st.st_ino == self->ino) {
+            /* That would detach the recorder from its own file */
+            GWARN("Not dumping %s onto itself", path);
+            return FALSE;
+        }
+
+        buf = radio_recorder_map_file(path, self->size, &tmp);
+        if (buf) {
+            RadioRecorderHeader* hdr = radio_recorder_header(self);
+            RadioRecorderHeader* out = (RadioRecorderHeader*) buf;
+            guint8* dest = buf + sizeof(RadioRecorderHeader);
+            const guint count = self->mask + 1;
+            guint i;
+
+            radio_recorder_init_header(out, count, self->slot_size,
+                (guint32) g_atomic_int_get((gint*) &hdr->next));
+
+            /*
+             * Records may be written while we are copying them. If the
+             * sequence number has changed (or was zero) then the slot
+             * is left empty in the snapshot.
+             */
+            for (i = 0; i < count; i++, dest += self->slot_size) {
+                RadioRecord* slot = radio_recorder_slot(self, i);
+                const guint32 seq = g_atomic_int_get((gint*) &slot->seq);
+
+                if (seq) {
+                    memcpy(dest, slot, self->slot_size);
+                    if ((guint32) g_atomic_int_get((gint*) &slot->seq) != seq) {
+                        ((RadioRecord*) dest)->seq = 0;
+                    }
+                }
+            }
+            msync(buf, self->size, MS_SYNC);
+            munmap(buf, self->size);
+            return radio_recorder_publish_file(tmp, path);
+        }
+    }
+    return FALSE;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -43,6 +43,8 @@
 #include "radio_log.h"
 
 #include <gbinder_local_request.h>
+#include <gbinder_reader.h>
+#include <gbinder_remote_request.h>
 #include <gbinder_writer.h>
 
 #include <gutil_macros.h>
@@ -59,8 +61,20 @@ typedef struct radio_request_object {
     gsize serial_offset;
     RADIO_REQUEST_FLAGS flags;
     gint refcount;
+    GMainContext* complete_context;
+    RadioRequestGenericCompleteFunc post_complete;
 } RadioRequestObject;
 
+typedef struct radio_request_complete_event {
+    RadioRequest* req;
+    GMainContext* owner;
+    GBinderRemoteRequest* msg;
+    GBinderReader args;
+    RADIO_TX_STATUS status;
+    guint32 resp;
+    RADIO_ERROR error;
+} RadioRequestCompleteEvent;
+
 static inline RadioRequestObject* radio_request_cast(RadioRequest* req)
     { return req ? G_CAST(req, RadioRequestObject, pub) : NULL; }
 
@@ -84,12 +98,34 @@ radio_request_object_cancel(
     radio_base_unregister_request(req->object, req);
 }
 
+static
+void
+radio_request_post_complete(
+    RadioRequest* req,
+    RADIO_TX_STATUS status,
+    guint32 resp,
+    RADIO_ERROR error,
+    const GBinderReader* args,
+    gpointer user_data);
+
+static
+void
+radio_request_post_event(
+    RadioRequestObject* self,
+    GMainContext* owner,
+    RADIO_TX_STATUS status,
+    guint32 resp,
+    RADIO_ERROR error,
+    const GBinderReader* args);
+
 static
 void
 radio_request_free(
     RadioRequestObject* self)
 {
     RadioRequest* req = &self->pub;
+    GMainContext* owner = req->object ? radio_base_context(req->object) :
+        NULL;
 
     GVERBOSE_("%u (%08x) %p", req->code, req->serial, req);
     radio_request_object_cancel(self);
@@ -100,6 +136,18 @@ radio_request_free(
 
         /* Request is being freed too early, before completion */
         req->complete = NULL;
+        if (complete == radio_request_post_complete) {
+            /*
+             * The poster is notified on its own context. The event
+             * brings the request back to life until then, and then
+             * releases it on the owner's context to finish the job.
+             */
+            g_atomic_int_set(&self->refcount, 1);
+            radio_request_post_event(self, owner, RADIO_TX_STATUS_FAILED,
+                RADIO_RESP_NONE, RADIO_ERROR_NONE, NULL);
+            g_atomic_int_add(&self->refcount, -1); /* The event's ref stays */
+            return;
+        }
         complete(req, RADIO_TX_STATUS_FAILED, RADIO_RESP_NONE,
             RADIO_ERROR_NONE, NULL, req->user_data);
     }
@@ -110,6 +158,9 @@ radio_request_free(
         destroy(req->user_data);
     }
     gbinder_local_request_unref(req->args);
+    if (self->complete_context) {
+        g_main_context_unref(self->complete_context);
+    }
     gutil_slice_free(self);
 }
 
@@ -149,6 +200,110 @@ radio_request_default_retry(
     }
 }
 
+static
+void
+radio_request_attach(
+    GMainContext* context,
+    GSourceFunc func,
+    gpointer data,
+    GDestroyNotify destroy)
+{
+    GSource* source = g_idle_source_new();
+
+    g_source_set_priority(source, G_PRIORITY_DEFAULT);
+    g_source_set_callback(source, func, data, destroy);
+    g_source_attach(source, context);
+    g_source_unref(source);
+}
+
+static
+gboolean
+radio_request_unref_cb(
+    gpointer req)
+{
+    radio_request_unref(req);
+    return G_SOURCE_REMOVE;
+}
+
+static
+gboolean
+radio_request_complete_event_dispatch(
+    gpointer data)
+{
+    RadioRequestCompleteEvent* event = data;
+    RadioRequest* req = event->req;
+
+    /* Runs on the submitter's context */
+    radio_request_cast(req)->post_complete(req, event->status, event->resp,
+        event->error, event->msg ? &event->args : NULL, req->user_data);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+radio_request_complete_event_free(
+    gpointer data)
+{
+    RadioRequestCompleteEvent* event = data;
+
+    /*
+     * The last reference may be the one held by the event, and only
+     * the owner of the RadioBase is allowed to free the request.
+     */
+    radio_request_attach(event->owner, radio_request_unref_cb, event->req,
+        NULL);
+    if (event->owner) {
+        g_main_context_unref(event->owner);
+    }
+    gbinder_remote_request_unref(event->msg);
+    gutil_slice_free(event);
+}
+
+static
+void
+radio_request_post_event(
+    RadioRequestObject* self,
+    GMainContext* owner,
+    RADIO_TX_STATUS status,
+    guint32 resp,
+    RADIO_ERROR error,
+    const GBinderReader* args)
+{
+    RadioRequest* req = &self->pub;
+    RadioRequestCompleteEvent* event = g_slice_new0(RadioRequestCompleteEvent);
+
+    event->req = radio_request_ref(req);
+    event->owner = owner ? g_main_context_ref(owner) : NULL;
+    event->status = status;
+    event->resp = resp;
+    event->error = error;
+    if (args && req->object) {
+        /* The copy of the reader is valid as long as the message is */
+        event->msg = gbinder_remote_request_ref
+            (radio_base_resp_message(req->object));
+        if (event->msg) {
+            gbinder_reader_copy(&event->args, args);
+        }
+    }
+    radio_request_attach(self->complete_context,
+        radio_request_complete_event_dispatch, event,
+        radio_request_complete_event_free);
+}
+
+static
+void
+radio_request_post_complete(
+    RadioRequest* req,
+    RADIO_TX_STATUS status,
+    guint32 resp,
+    RADIO_ERROR error,
+    const GBinderReader* args,
+    gpointer user_data)
+{
+    radio_request_post_event(radio_request_cast(req), req->object ?
+        radio_base_context(req->object) : NULL, status, resp, error, args);
+}
+
 static
 RadioRequest*
 radio_request_object_new(
@@ -286,6 +441,16 @@ radio_request_set_blocking(
     }
 }
 
+void
+radio_request_set_background(
+    RadioRequest* req,
+    gboolean background) /* Since 1.6.7 */
+{
+    if (G_LIKELY(req)) {
+        req->background = background;
+    }
+}
+
 void
 radio_request_set_timeout(
     RadioRequest* req,
@@ -298,7 +463,9 @@ radio_request_set_timeout(
         if (base && req->state >= RADIO_REQUEST_STATE_QUEUED) {
             const guint timeout = radio_base_timeout_ms(base, req);
 
-            req->deadline = g_get_monotonic_time() + MICROSEC(timeout);
+            /* Held requests start ticking when the batch is released */
+            req->deadline = (req->held ? req->scheduled :
+                radio_base_now(base)) + MICROSEC(timeout);
             radio_base_reset_timeout(base);
         }
     }
@@ -337,6 +504,28 @@ radio_request_submit(
     return FALSE;
 }
 
+gboolean
+radio_request_post(
+    RadioRequest* req,
+    GMainContext* context) /* Since 1.6.7 */
+{
+    RadioRequestObject* self = radio_request_cast(req);
+
+    if (G_LIKELY(self)) {
+        if (req->object) {
+            if (context && req->complete) {
+                self->complete_context = g_main_context_ref(context);
+                self->post_complete = req->complete;
+                req->complete = radio_request_post_complete;
+            }
+            radio_base_post_request(req->object, req);
+            return TRUE;
+        }
+        radio_request_unref(req);
+    }
+    return FALSE;
+}
+
 RadioRequest*
 radio_request_try_submit(
     RadioRequest* req) /* Since 1.6.2 */
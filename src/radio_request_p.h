@@ -132,12 +132,16 @@ struct radio_request {
     guint timeout_ms;           /* Timeout, in milliseconds (0 = default) */
     gint64 deadline;            /* Monotonic time, in microseconds */
     gint64 scheduled;           /* Monotonic time, in microseconds */
+    gint64 submitted;           /* When the first transaction was sent */
     gulong tx_id;               /* Id of the request transaction */
     gboolean blocking;          /* TRUE if this request blocks all others */
+    gboolean background;        /* May be deferred in power save */
+    gboolean held;              /* Deferred until the batch is released */
     gboolean acked;
     RadioBase* object;          /* Not a reference */
     RadioRequestGroup* group;   /* Not a reference */
     RadioRequest* queue_next;
+    RadioRequest* inbox_next;   /* Link in RadioBase inbox */
 };
 
 void
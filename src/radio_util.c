@@ -41,8 +41,126 @@
 
 #include <gbinder.h>
 
+#include <stdlib.h>
+#include <string.h>
+
 GLOG_MODULE_DEFINE("gbinder-radio");
 
+/*
+ * Name indices are built on demand by probing all codes below this
+ * limit, so that the switch statements remain the only place where
+ * the names are defined.
+ */
+#define RADIO_NAME_MAX_CODE (512)
+G_STATIC_ASSERT(RADIO_1_5_REQ_LAST < RADIO_NAME_MAX_CODE);
+G_STATIC_ASSERT(RADIO_1_5_RESP_LAST < RADIO_NAME_MAX_CODE);
+G_STATIC_ASSERT(RADIO_1_5_IND_LAST < RADIO_NAME_MAX_CODE);
+
+typedef struct radio_name_entry {
+    const char* name;
+    guint code;
+} RadioNameEntry;
+
+typedef struct radio_name_index {
+    guint count;
+    RadioNameEntry entries[1];
+} RadioNameIndex;
+
+/* Indexed by RADIO_AIDL_INTERFACE + 1 (zero is HIDL) */
+static gsize radio_req_names[RADIO_AIDL_INTERFACE_COUNT + 1];
+static gsize radio_resp_names[RADIO_AIDL_INTERFACE_COUNT + 1];
+static gsize radio_ind_names[RADIO_AIDL_INTERFACE_COUNT + 1];
+
+static
+RADIO_AIDL_INTERFACE
+radio_interface_aidl(
+    RADIO_INTERFACE_TYPE type,
+    RADIO_AIDL_INTERFACE aidl)
+{
+    /* Anything unknown ends up in the HIDL tables */
+    return (type != RADIO_INTERFACE_TYPE_HIDL &&
+        aidl > RADIO_AIDL_INTERFACE_NONE &&
+        aidl < RADIO_AIDL_INTERFACE_COUNT) ?
+        aidl : RADIO_AIDL_INTERFACE_NONE;
+}
+
+static
+RADIO_AIDL_INTERFACE
+radio_instance_aidl(
+    RadioInstance* instance)
+{
+    /* NULL instance means HIDL */
+    return G_LIKELY(instance) ? radio_interface_aidl(instance->interface_type,
+        instance->interface_aidl) : RADIO_AIDL_INTERFACE_NONE;
+}
+
+static
+int
+radio_name_entry_compare(
+    const void* p1,
+    const void* p2)
+{
+    const RadioNameEntry* e1 = p1;
+    const RadioNameEntry* e2 = p2;
+
+    return strcmp(e1->name, e2->name);
+}
+
+static
+const RadioNameIndex*
+radio_name_index_new(
+    RadioNameFunc fn,
+    gconstpointer data)
+{
+    RadioNameEntry entries[RADIO_NAME_MAX_CODE];
+    RadioNameIndex* index;
+    guint code, n = 0;
+
+    for (code = 1; code < RADIO_NAME_MAX_CODE; code++) {
+        const char* name = fn(data, code);
+
+        if (name) {
+            entries[n].name = name;
+            entries[n].code = code;
+            n++;
+        }
+    }
+    qsort(entries, n, sizeof(entries[0]), radio_name_entry_compare);
+    index = g_malloc(G_STRUCT_OFFSET(RadioNameIndex, entries) +
+        MAX(n, 1) * sizeof(entries[0]));
+    index->count = n;
+    memcpy(index->entries, entries, n * sizeof(entries[0]));
+    return index;
+}
+
+guint
+radio_name_to_code(
+    gsize* index,
+    RadioNameFunc fn,
+    gconstpointer data,
+    const char* name)
+{
+    if (name) {
+        const RadioNameIndex* idx;
+        const RadioNameEntry* found;
+        RadioNameEntry key;
+
+        /* The index is built once and then never freed */
+        if (g_once_init_enter(index)) {
+            g_once_init_leave(index, (gsize) radio_name_index_new(fn, data));
+        }
+        idx = (const RadioNameIndex*) *index;
+        key.name = name;
+        key.code = 0;
+        found = bsearch(&key, idx->entries, idx->count, sizeof(key),
+            radio_name_entry_compare);
+        if (found) {
+            return found->code;
+        }
+    }
+    return 0;
+}
+
 guint
 radio_observer_priority_index(
     RADIO_OBSERVER_PRIORITY priority)
@@ -75,6 +193,36 @@ radio_read_response_info_aidl(
     return (size >= sizeof(*info)) ? info : NULL;
 }
 
+guint
+radio_timeout_add(
+    GMainContext* context,
+    guint ms,
+    GSourceFunc func,
+    gpointer data)
+{
+    /* Zero timeout means idle callback, like g_idle_add() */
+    GSource* source = ms ? g_timeout_source_new(ms) : g_idle_source_new();
+    guint id;
+
+    g_source_set_callback(source, func, data, NULL);
+    id = g_source_attach(source, context);
+    g_source_unref(source);
+    return id;
+}
+
+void
+radio_source_remove(
+    GMainContext* context,
+    guint id)
+{
+    /* g_source_remove() only works with the default context */
+    GSource* source = g_main_context_find_source_by_id(context, id);
+
+    if (source) {
+        g_source_destroy(source);
+    }
+}
+
 const char*
 radio_req_name(
     RADIO_REQ req)
@@ -82,12 +230,16 @@ radio_req_name(
     return radio_req_name2(NULL, req);
 }
 
+static
 const char*
-radio_req_name2(
-    RadioInstance* instance,
-    RADIO_REQ req)
+radio_req_name_aidl(
+    gconstpointer data,
+    guint code)
 {
-    if (!G_LIKELY(instance) || instance->interface_type == RADIO_INTERFACE_TYPE_HIDL) {
+    const RADIO_AIDL_INTERFACE aidl = GPOINTER_TO_INT(data);
+    const RADIO_REQ req = code;
+
+    if (aidl == RADIO_AIDL_INTERFACE_NONE) {
         switch (req) {
         case RADIO_REQ_SET_RESPONSE_FUNCTIONS:   return "setResponseFunctions";
         case RADIO_REQ_RESPONSE_ACKNOWLEDGEMENT: return "responseAcknowledgement";
@@ -112,7 +264,7 @@ radio_req_name2(
         case RADIO_REQ_ANY:
             break;
         }
-    } else if (instance->interface_aidl == RADIO_DATA_INTERFACE) {
+    } else if (aidl == RADIO_DATA_INTERFACE) {
         switch ((RADIO_DATA_REQ)req) {
 #define RADIO_DATA_REQ_(req,resp,Name,NAME) \
         case RADIO_DATA_REQ_##NAME: return #Name;
@@ -123,7 +275,7 @@ radio_req_name2(
         case RADIO_DATA_REQ_ANY:
             break;
         }
-    } else if (instance->interface_aidl == RADIO_IMS_INTERFACE) {
+    } else if (aidl == RADIO_IMS_INTERFACE) {
         switch ((RADIO_IMS_REQ)req) {
 #define RADIO_IMS_REQ_(req,resp,Name,NAME) \
         case RADIO_IMS_REQ_##NAME: return #Name;
@@ -133,7 +285,7 @@ radio_req_name2(
         case RADIO_IMS_REQ_ANY:
             break;
         }
-    } else if (instance->interface_aidl == RADIO_MESSAGING_INTERFACE) {
+    } else if (aidl == RADIO_MESSAGING_INTERFACE) {
         switch ((RADIO_MESSAGING_REQ)req) {
 #define RADIO_MESSAGING_REQ_(req,resp,Name,NAME) \
         case RADIO_MESSAGING_REQ_##NAME: return #Name;
@@ -144,7 +296,7 @@ radio_req_name2(
         case RADIO_MESSAGING_REQ_ANY:
             break;
         }
-    } else if (instance->interface_aidl == RADIO_MODEM_INTERFACE) {
+    } else if (aidl == RADIO_MODEM_INTERFACE) {
         switch ((RADIO_MODEM_REQ)req) {
 #define RADIO_MODEM_REQ_(req,resp,Name,NAME) \
         case RADIO_MODEM_REQ_##NAME: return #Name;
@@ -155,7 +307,7 @@ radio_req_name2(
         case RADIO_MODEM_REQ_ANY:
             break;
         }
-    } else if (instance->interface_aidl == RADIO_NETWORK_INTERFACE) {
+    } else if (aidl == RADIO_NETWORK_INTERFACE) {
         switch ((RADIO_NETWORK_REQ)req) {
 #define RADIO_NETWORK_REQ_(req,resp,Name,NAME) \
         case RADIO_NETWORK_REQ_##NAME: return #Name;
@@ -166,7 +318,7 @@ radio_req_name2(
         case RADIO_NETWORK_REQ_ANY:
             break;
         }
-    } else if (instance->interface_aidl == RADIO_SIM_INTERFACE) {
+    } else if (aidl == RADIO_SIM_INTERFACE) {
         switch ((RADIO_SIM_REQ)req) {
 #define RADIO_SIM_REQ_(req,resp,Name,NAME) \
         case RADIO_SIM_REQ_##NAME: return #Name;
@@ -177,7 +329,7 @@ radio_req_name2(
         case RADIO_SIM_REQ_ANY:
             break;
         }
-    } else if (instance->interface_aidl == RADIO_VOICE_INTERFACE) {
+    } else if (aidl == RADIO_VOICE_INTERFACE) {
         switch ((RADIO_VOICE_REQ)req) {
 #define RADIO_VOICE_REQ_(req,resp,Name,NAME) \
         case RADIO_VOICE_REQ_##NAME: return #Name;
@@ -193,6 +345,36 @@ radio_req_name2(
     return NULL;
 }
 
+const char*
+radio_req_name2(
+    RadioInstance* instance,
+    RADIO_REQ req)
+{
+    return radio_req_name_aidl(GINT_TO_POINTER(radio_instance_aidl(instance)),
+        req);
+}
+
+const char*
+radio_req_name_interface(
+    RADIO_INTERFACE_TYPE type,
+    RADIO_AIDL_INTERFACE aidl,
+    RADIO_REQ req)
+{
+    return radio_req_name_aidl(GINT_TO_POINTER(radio_interface_aidl(type, aidl)),
+        req);
+}
+
+RADIO_REQ
+radio_req_from_name(
+    RadioInstance* instance,
+    const char* name) /* Since 1.6.7 */
+{
+    const RADIO_AIDL_INTERFACE aidl = radio_instance_aidl(instance);
+
+    return radio_name_to_code(radio_req_names + aidl + 1, radio_req_name_aidl,
+        GINT_TO_POINTER(aidl), name);
+}
+
 const char*
 radio_resp_name(
     RADIO_RESP resp)
@@ -200,12 +382,16 @@ radio_resp_name(
     return radio_resp_name2(NULL, resp);
 }
 
+static
 const char*
-radio_resp_name2(
-    RadioInstance* instance,
-    RADIO_RESP resp)
+radio_resp_name_aidl(
+    gconstpointer data,
+    guint code)
 {
-    if (!G_LIKELY(instance) || instance->interface_type == RADIO_INTERFACE_TYPE_HIDL) {
+    const RADIO_AIDL_INTERFACE aidl = GPOINTER_TO_INT(data);
+    const RADIO_RESP resp = code;
+
+    if (aidl == RADIO_AIDL_INTERFACE_NONE) {
         switch (resp) {
         case RADIO_RESP_ACKNOWLEDGE_REQUEST: return "acknowledgeRequest";
 #define RADIO_RESP_(req,resp,Name,NAME) \
@@ -249,7 +435,7 @@ radio_resp_name2(
         case RADIO_RESP_ANY:
             break;
         }
-    } else if (instance->interface_aidl == RADIO_DATA_INTERFACE) {
+    } else if (aidl == RADIO_DATA_INTERFACE) {
         switch ((RADIO_DATA_RESP)resp) {
         case RADIO_DATA_RESP_ACKNOWLEDGE_REQUEST: return "acknowledgeRequest";
 #define RADIO_DATA_RESP_(req,resp,Name,NAME) \
@@ -259,7 +445,7 @@ radio_resp_name2(
         case RADIO_DATA_RESP_ANY:
             break;
         }
-    } else if (instance->interface_aidl == RADIO_IMS_INTERFACE) {
+    } else if (aidl == RADIO_IMS_INTERFACE) {
         switch ((RADIO_IMS_RESP)resp) {
 #define RADIO_IMS_RESP_(req,resp,Name,NAME) \
         case RADIO_IMS_RESP_##NAME: return #Name "Response";
@@ -268,7 +454,7 @@ radio_resp_name2(
         case RADIO_IMS_RESP_ANY:
             break;
         }
-    } else if (instance->interface_aidl == RADIO_MESSAGING_INTERFACE) {
+    } else if (aidl == RADIO_MESSAGING_INTERFACE) {
         switch ((RADIO_MESSAGING_RESP)resp) {
         case RADIO_MESSAGING_RESP_ACKNOWLEDGE_REQUEST: return "acknowledgeRequest";
 #define RADIO_MESSAGING_RESP_(req,resp,Name,NAME) \
@@ -278,7 +464,7 @@ radio_resp_name2(
         case RADIO_MESSAGING_RESP_ANY:
             break;
         }
-    } else if (instance->interface_aidl == RADIO_MODEM_INTERFACE) {
+    } else if (aidl == RADIO_MODEM_INTERFACE) {
         switch ((RADIO_MODEM_RESP)resp) {
         case RADIO_MODEM_RESP_ACKNOWLEDGE_REQUEST: return "acknowledgeRequest";
 #define RADIO_MODEM_RESP_(req,resp,Name,NAME) \
@@ -288,7 +474,7 @@ radio_resp_name2(
         case RADIO_MODEM_RESP_ANY:
             break;
         }
-    } else if (instance->interface_aidl == RADIO_NETWORK_INTERFACE) {
+    } else if (aidl == RADIO_NETWORK_INTERFACE) {
         switch ((RADIO_NETWORK_RESP)resp) {
         case RADIO_NETWORK_RESP_ACKNOWLEDGE_REQUEST: return "acknowledgeRequest";
 #define RADIO_NETWORK_RESP_(req,resp,Name,NAME) \
@@ -298,7 +484,7 @@ radio_resp_name2(
         case RADIO_NETWORK_RESP_ANY:
             break;
         }
-    } else if (instance->interface_aidl == RADIO_SIM_INTERFACE) {
+    } else if (aidl == RADIO_SIM_INTERFACE) {
         switch ((RADIO_SIM_RESP)resp) {
         case RADIO_SIM_RESP_ACKNOWLEDGE_REQUEST: return "acknowledgeRequest";
 #define RADIO_SIM_RESP_(req,resp,Name,NAME) \
@@ -308,7 +494,7 @@ radio_resp_name2(
         case RADIO_SIM_RESP_ANY:
             break;
         }
-    } else if (instance->interface_aidl == RADIO_VOICE_INTERFACE) {
+    } else if (aidl == RADIO_VOICE_INTERFACE) {
         switch ((RADIO_VOICE_RESP)resp) {
         case RADIO_VOICE_RESP_ACKNOWLEDGE_REQUEST:        return "acknowledgeRequest";
         case RADIO_VOICE_RESP_HANGUP_CONNECTION_RESPONSE: return "hangupConnectionResponse";
@@ -323,6 +509,36 @@ radio_resp_name2(
     return NULL;
 }
 
+const char*
+radio_resp_name2(
+    RadioInstance* instance,
+    RADIO_RESP resp)
+{
+    return radio_resp_name_aidl(GINT_TO_POINTER(radio_instance_aidl(instance)),
+        resp);
+}
+
+const char*
+radio_resp_name_interface(
+    RADIO_INTERFACE_TYPE type,
+    RADIO_AIDL_INTERFACE aidl,
+    RADIO_RESP resp)
+{
+    return radio_resp_name_aidl(GINT_TO_POINTER(radio_interface_aidl(type, aidl)),
+        resp);
+}
+
+RADIO_RESP
+radio_resp_from_name(
+    RadioInstance* instance,
+    const char* name) /* Since 1.6.7 */
+{
+    const RADIO_AIDL_INTERFACE aidl = radio_instance_aidl(instance);
+
+    return radio_name_to_code(radio_resp_names + aidl + 1, radio_resp_name_aidl,
+        GINT_TO_POINTER(aidl), name);
+}
+
 const char*
 radio_ind_name(
     RADIO_IND ind)
@@ -330,12 +546,16 @@ radio_ind_name(
     return radio_ind_name2(NULL, ind);
 }
 
+static
 const char*
-radio_ind_name2(
-    RadioInstance* instance,
-    RADIO_IND ind)
+radio_ind_name_aidl(
+    gconstpointer data,
+    guint code)
 {
-    if (!G_LIKELY(instance) || instance->interface_type == RADIO_INTERFACE_TYPE_HIDL) {
+    const RADIO_AIDL_INTERFACE aidl = GPOINTER_TO_INT(data);
+    const RADIO_IND ind = code;
+
+    if (aidl == RADIO_AIDL_INTERFACE_NONE) {
         switch (ind) {
 #define RADIO_IND_(code,Name,NAME) \
         case RADIO_IND_##NAME: return #Name;
@@ -348,7 +568,7 @@ radio_ind_name2(
         case RADIO_IND_ANY:
             break;
         }
-    } else if (instance->interface_aidl == RADIO_DATA_INTERFACE) {
+    } else if (aidl == RADIO_DATA_INTERFACE) {
         switch ((RADIO_DATA_IND)ind) {
 #define RADIO_DATA_IND_(code,Name,NAME) \
         case RADIO_DATA_IND_##NAME: return #Name;
@@ -357,7 +577,7 @@ radio_ind_name2(
         case RADIO_DATA_IND_ANY:
             break;
         }
-    } else if (instance->interface_aidl == RADIO_IMS_INTERFACE) {
+    } else if (aidl == RADIO_IMS_INTERFACE) {
         switch ((RADIO_IMS_IND)ind) {
 #define RADIO_IMS_IND_(code,Name,NAME) \
         case RADIO_IMS_IND_##NAME: return #Name;
@@ -366,7 +586,7 @@ radio_ind_name2(
         case RADIO_IMS_IND_ANY:
             break;
         }
-    } else if (instance->interface_aidl == RADIO_MESSAGING_INTERFACE) {
+    } else if (aidl == RADIO_MESSAGING_INTERFACE) {
         switch ((RADIO_MESSAGING_IND)ind) {
 #define RADIO_MESSAGING_IND_(code,Name,NAME) \
         case RADIO_MESSAGING_IND_##NAME: return #Name;
@@ -375,7 +595,7 @@ radio_ind_name2(
         case RADIO_MESSAGING_IND_ANY:
             break;
         }
-    } else if (instance->interface_aidl == RADIO_MODEM_INTERFACE) {
+    } else if (aidl == RADIO_MODEM_INTERFACE) {
         switch ((RADIO_MODEM_IND)ind) {
 #define RADIO_MODEM_IND_(code,Name,NAME) \
         case RADIO_MODEM_IND_##NAME: return #Name;
@@ -384,7 +604,7 @@ radio_ind_name2(
         case RADIO_MODEM_IND_ANY:
             break;
         }
-    } else if (instance->interface_aidl == RADIO_NETWORK_INTERFACE) {
+    } else if (aidl == RADIO_NETWORK_INTERFACE) {
         switch ((RADIO_NETWORK_IND)ind) {
 #define RADIO_NETWORK_IND_(code,Name,NAME) \
         case RADIO_NETWORK_IND_##NAME: return #Name;
@@ -393,7 +613,7 @@ radio_ind_name2(
         case RADIO_NETWORK_IND_ANY:
             break;
         }
-    } else if (instance->interface_aidl == RADIO_SIM_INTERFACE) {
+    } else if (aidl == RADIO_SIM_INTERFACE) {
         switch ((RADIO_SIM_IND)ind) {
 #define RADIO_SIM_IND_(code,Name,NAME) \
         case RADIO_SIM_IND_##NAME: return #Name;
@@ -402,7 +622,7 @@ radio_ind_name2(
         case RADIO_SIM_IND_ANY:
             break;
         }
-    } else if (instance->interface_aidl == RADIO_VOICE_INTERFACE) {
+    } else if (aidl == RADIO_VOICE_INTERFACE) {
         switch ((RADIO_VOICE_IND)ind) {
 #define RADIO_VOICE_IND_(code,Name,NAME) \
         case RADIO_VOICE_IND_##NAME: return #Name;
@@ -415,6 +635,36 @@ radio_ind_name2(
     return NULL;
 }
 
+const char*
+radio_ind_name2(
+    RadioInstance* instance,
+    RADIO_IND ind)
+{
+    return radio_ind_name_aidl(GINT_TO_POINTER(radio_instance_aidl(instance)),
+        ind);
+}
+
+const char*
+radio_ind_name_interface(
+    RADIO_INTERFACE_TYPE type,
+    RADIO_AIDL_INTERFACE aidl,
+    RADIO_IND ind)
+{
+    return radio_ind_name_aidl(GINT_TO_POINTER(radio_interface_aidl(type, aidl)),
+        ind);
+}
+
+RADIO_IND
+radio_ind_from_name(
+    RadioInstance* instance,
+    const char* name) /* Since 1.6.7 */
+{
+    const RADIO_AIDL_INTERFACE aidl = radio_instance_aidl(instance);
+
+    return radio_name_to_code(radio_ind_names + aidl + 1, radio_ind_name_aidl,
+        GINT_TO_POINTER(aidl), name);
+}
+
 /**
  * This function no longer makes as much sense as it did in IRadio 1.0 times.
  * Later it turned out that that same call may produce different responses
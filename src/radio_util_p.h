@@ -41,6 +41,12 @@
 #include "radio_types_p.h"
 #include "radio_util.h"
 
+typedef
+const char*
+(*RadioNameFunc)(
+    gconstpointer data,
+    guint code);
+
 guint
 radio_observer_priority_index(
     RADIO_OBSERVER_PRIORITY priority)
@@ -56,6 +62,54 @@ radio_read_response_info_aidl(
     GBinderReader* reader)
     RADIO_INTERNAL;
 
+guint
+radio_timeout_add(
+    GMainContext* context,
+    guint ms,
+    GSourceFunc func,
+    gpointer data)
+    RADIO_INTERNAL;
+
+void
+radio_source_remove(
+    GMainContext* context,
+    guint id)
+    RADIO_INTERNAL;
+
+guint
+radio_name_to_code(
+    gsize* index, /* Static storage, built on the first call */
+    RadioNameFunc fn,
+    gconstpointer data,
+    const char* name)
+    RADIO_INTERNAL;
+
+/*
+ * Same as radio_*_name2() but without a RadioInstance, e.g. for looking
+ * up the names of recorded transactions. The AIDL interface is ignored
+ * unless the interface type is AIDL.
+ */
+const char*
+radio_req_name_interface(
+    RADIO_INTERFACE_TYPE type,
+    RADIO_AIDL_INTERFACE aidl,
+    RADIO_REQ req)
+    RADIO_INTERNAL;
+
+const char*
+radio_resp_name_interface(
+    RADIO_INTERFACE_TYPE type,
+    RADIO_AIDL_INTERFACE aidl,
+    RADIO_RESP resp)
+    RADIO_INTERNAL;
+
+const char*
+radio_ind_name_interface(
+    RADIO_INTERFACE_TYPE type,
+    RADIO_AIDL_INTERFACE aidl,
+    RADIO_IND ind)
+    RADIO_INTERNAL;
+
 #endif /* RADIO_UTIL_PRIVATE_H */
 
 /*
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "radio_version_cache_p.h"
+#include "radio_log.h"
+
+#include <gbinder_servicemanager.h>
+
+#include <gutil_strv.h>
+
+#include <string.h>
+
+static char* radio_version_cache_file = NULL;
+static GKeyFile* radio_version_cache_data = NULL;
+
+static
+GKeyFile*
+radio_version_cache(
+    void)
+{
+    if (!radio_version_cache_data && radio_version_cache_file) {
+        GError* error = NULL;
+
+        radio_version_cache_data = g_key_file_new();
+        if (!g_key_file_load_from_file(radio_version_cache_data,
+            radio_version_cache_file, G_KEY_FILE_NONE, &error)) {
+            /* Missing file is perfectly normal */
+            GDEBUG("%s: %s", radio_version_cache_file, error->message);
+            g_error_free(error);
+        }
+    }
+    return radio_version_cache_data;
+}
+
+static
+gboolean
+radio_version_cache_listed(
+    const GStrV* list,
+    const char* name)
+{
+    /* No list => assume that everything is there */
+    return !list || gutil_strv_contains(list, name);
+}
+
+/*==========================================================================*
+ * Internal API
+ *==========================================================================*/
+
+guint
+radio_version_cache_order(
+    GBinderServiceManager* sm,
+    const char* dev,
+    const char* key,
+    const char* const* names,
+    guint count,
+    guint* order)
+{
+    GKeyFile* cache = radio_version_cache();
+    guint i, n = 0;
+
+    if (cache) {
+        char* cached = g_key_file_get_string(cache, dev, key, NULL);
+        char** list = gbinder_servicemanager_list_sync(sm);
+
+        /*
+         * The names are sorted newest first. A HIDL service registers
+         * every version it inherits, so the cached name is only trusted
+         * if nothing newer is registered. Otherwise the service has been
+         * upgraded and the cache gets updated by whatever works now.
+         * Either way, the names which aren't registered are skipped.
+         */
+        for (i = 0; i < count; i++) {
+            if (radio_version_cache_listed(list, names[i])) {
+                if (!n && cached) {
+                    if (!strcmp(names[i], cached)) {
+                        GDEBUG("Trying cached %s", cached);
+                    } else {
+                        GDEBUG("Cached %s is outdated", cached);
+                    }
+                }
+                order[n++] = i;
+            }
+        }
+        g_strfreev(list);
+        g_free(cached);
+    } else {
+        for (i = 0; i < count; i++) {
+            order[n++] = i;
+        }
+    }
+    return n;
+}
+
+void
+radio_version_cache_update(
+    const char* dev,
+    const char* key,
+    const char* name)
+{
+    GKeyFile* cache = radio_version_cache();
+
+    if (cache) {
+        char* cached = g_key_file_get_string(cache, dev, key, NULL);
+
+        if (g_strcmp0(cached, name)) {
+            GError* error = NULL;
+            gsize len = 0;
+            char* data;
+
+            g_key_file_set_string(cache, dev, key, name);
+            data = g_key_file_to_data(cache, &len, NULL);
+            if (!g_file_set_contents(radio_version_cache_file, data, len,
+                &error)) {
+                GWARN("%s: %s", radio_version_cache_file, error->message);
+                g_error_free(error);
+            }
+            g_free(data);
+        }
+        g_free(cached);
+    }
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+void
+radio_version_cache_set_file(
+    const char* path)
+{
+    if (g_strcmp0(path, radio_version_cache_file)) {
+        if (radio_version_cache_data) {
+            g_key_file_free(radio_version_cache_data);
+            radio_version_cache_data = NULL;
+        }
+        g_free(radio_version_cache_file);
+        radio_version_cache_file = g_strdup(path);
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
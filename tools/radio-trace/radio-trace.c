@@ -0,0 +1,634 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include <radio_recorder.h>
+#include <radio_util.h>
+
+#include "radio_util_p.h"
+
+#include <gutil_log.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RET_OK (0)
+#define RET_CMDLINE (1)
+#define RET_ERR (2)
+
+#define DEFAULT_TIMEOUT_MS (30000)
+#define DEFAULT_TOP (10)
+
+/* Identifies the object which has produced the record */
+#define TRACE_SOURCE(r) (((guint64)((r)->flags & RADIO_RECORD_FLAG_CONFIG) \
+    << 16) | ((guint64)(r)->interface_type << 8) | (guint8)(r)->interface)
+#define TRACE_KEY(r,n) ((TRACE_SOURCE(r) << 32) | (guint32)(n))
+
+typedef struct trace_opt {
+    gboolean verbose;
+    int timeout_ms;
+    int top;
+} TraceOpt;
+
+typedef struct trace_code_stats {
+    const RadioRecord* first;   /* For the name */
+    GArray* latency;            /* gint64 microseconds */
+    guint count;
+    guint errors;
+    guint retries;
+    guint timeouts;
+    guint pending;              /* Unanswered at the moment */
+} TraceCodeStats;
+
+typedef struct trace_tx {
+    const RadioRecord* req;
+    const RadioRecord* resp;
+} TraceTx;
+
+typedef struct trace {
+    const TraceOpt* opt;
+    GPtrArray* records;
+    GHashTable* pending;        /* TRACE_KEY(req, serial) => TraceTx */
+    GHashTable* req_stats;      /* TRACE_KEY(req, code) => TraceCodeStats */
+    GHashTable* ind_stats;      /* TRACE_KEY(ind, code) => TraceCodeStats */
+    GArray* done;               /* TraceTx */
+    guint unmatched;
+    guint mismatched;
+} Trace;
+
+static const char* const trace_aidl_names[] = {
+    "data", "ims", "messaging", "modem", "network", "sim", "voice"
+};
+G_STATIC_ASSERT(G_N_ELEMENTS(trace_aidl_names) == RADIO_AIDL_INTERFACE_COUNT);
+
+static
+const char*
+trace_interface(
+    const RadioRecord* rec,
+    char* buf,
+    gsize size)
+{
+    if (rec->flags & RADIO_RECORD_FLAG_CONFIG) {
+        snprintf(buf, size, "config/%d", rec->interface);
+    } else if (rec->interface_type == RADIO_INTERFACE_TYPE_AIDL) {
+        if (rec->interface >= 0 &&
+            rec->interface < (int) G_N_ELEMENTS(trace_aidl_names)) {
+            return trace_aidl_names[rec->interface];
+        }
+        snprintf(buf, size, "aidl/%d", rec->interface);
+    } else {
+        snprintf(buf, size, "1.%d", rec->interface);
+    }
+    return buf;
+}
+
+static
+const char*
+trace_name(
+    const RadioRecord* rec,
+    char* buf,
+    gsize size)
+{
+    const char* name = NULL;
+
+    if (!(rec->flags & RADIO_RECORD_FLAG_CONFIG)) {
+        const RADIO_INTERFACE_TYPE type = rec->interface_type;
+        const RADIO_AIDL_INTERFACE aidl = rec->interface;
+
+        switch (rec->type) {
+        case RADIO_RECORD_REQUEST:
+            name = radio_req_name_interface(type, aidl, rec->code);
+            break;
+        case RADIO_RECORD_RESPONSE:
+            name = radio_resp_name_interface(type, aidl, rec->code);
+            break;
+        case RADIO_RECORD_INDICATION:
+            name = radio_ind_name_interface(type, aidl, rec->code);
+            break;
+        }
+    }
+    if (!name) {
+        snprintf(buf, size, "%u", rec->code);
+        name = buf;
+    }
+    return name;
+}
+
+static
+gboolean
+trace_response_matches(
+    const RadioRecord* req,
+    const RadioRecord* resp)
+{
+    if (TRACE_SOURCE(req) != TRACE_SOURCE(resp)) {
+        return FALSE;
+    } else if (!(req->flags & RADIO_RECORD_FLAG_CONFIG) &&
+        req->interface_type == RADIO_INTERFACE_TYPE_HIDL) {
+        const RADIO_RESP expected = radio_req_resp2(req->code, req->interface);
+
+        /* Unknown mapping is not a reason to reject the pair */
+        return expected == RADIO_RESP_NONE || expected == resp->code;
+    }
+    return TRUE;
+}
+
+static
+gboolean
+trace_expects_response(
+    const RadioRecord* req)
+{
+    /* Serials start with 1, zero means that there's no serial */
+    if (!req->serial) {
+        return FALSE;
+    } else if (!(req->flags & RADIO_RECORD_FLAG_CONFIG) &&
+        req->interface_type == RADIO_INTERFACE_TYPE_HIDL) {
+        return radio_req_resp2(req->code, req->interface) != RADIO_RESP_NONE;
+    }
+    return TRUE;
+}
+
+static
+void
+trace_code_stats_free(
+    gpointer data)
+{
+    TraceCodeStats* stats = data;
+
+    g_array_free(stats->latency, TRUE);
+    g_free(stats);
+}
+
+static
+TraceCodeStats*
+trace_code_stats(
+    GHashTable* table,
+    const RadioRecord* rec)
+{
+    const guint64 key = TRACE_KEY(rec, rec->code);
+    TraceCodeStats* stats = g_hash_table_lookup(table, &key);
+
+    if (!stats) {
+        guint64* k = g_new(guint64, 1);
+
+        *k = key;
+        stats = g_new0(TraceCodeStats, 1);
+        stats->first = rec;
+        stats->latency = g_array_new(FALSE, FALSE, sizeof(gint64));
+        g_hash_table_insert(table, k, stats);
+    }
+    return stats;
+}
+
+static
+int
+trace_compare_records(
+    gconstpointer a,
+    gconstpointer b)
+{
+    const RadioRecord* r1 = *(const RadioRecord**)a;
+    const RadioRecord* r2 = *(const RadioRecord**)b;
+
+    return (r1->seq < r2->seq) ? (-1) : (r1->seq > r2->seq) ? 1 : 0;
+}
+
+static
+int
+trace_compare_latency(
+    gconstpointer a,
+    gconstpointer b)
+{
+    const gint64 t1 = *(const gint64*)a;
+    const gint64 t2 = *(const gint64*)b;
+
+    return (t1 < t2) ? (-1) : (t1 > t2) ? 1 : 0;
+}
+
+static
+int
+trace_compare_tx(
+    gconstpointer a,
+    gconstpointer b)
+{
+    const TraceTx* tx1 = a;
+    const TraceTx* tx2 = b;
+    const gint64 t1 = tx1->resp->time - tx1->req->time;
+    const gint64 t2 = tx2->resp->time - tx2->req->time;
+
+    /* Slowest first */
+    return (t1 > t2) ? (-1) : (t1 < t2) ? 1 : 0;
+}
+
+static
+int
+trace_compare_stats(
+    gconstpointer a,
+    gconstpointer b)
+{
+    const TraceCodeStats* s1 = *(const TraceCodeStats**)a;
+    const TraceCodeStats* s2 = *(const TraceCodeStats**)b;
+
+    /* Most frequent first */
+    return (s1->count > s2->count) ? (-1) : (s1->count < s2->count) ? 1 : 0;
+}
+
+static
+double
+trace_percentile_ms(
+    GArray* sorted,
+    guint percent)
+{
+    if (sorted->len) {
+        /* Nearest rank */
+        guint rank = (sorted->len * percent + 99) / 100;
+
+        return g_array_index(sorted, gint64, rank ? (rank - 1) : 0) / 1000.0;
+    }
+    return 0;
+}
+
+static
+gboolean
+trace_load(
+    Trace* trace,
+    const char* file,
+    const guint8* image,
+    gsize size)
+{
+    const RadioRecorderHeader* hdr = (const RadioRecorderHeader*) image;
+    guint i;
+
+    if (size < sizeof(*hdr) || hdr->magic != RADIO_RECORDER_MAGIC) {
+        fprintf(stderr, "%s: not a radio trace\n", file);
+        return FALSE;
+    } else if (hdr->format != RADIO_RECORDER_FORMAT ||
+        hdr->header_size < sizeof(*hdr) ||
+        hdr->slot_size < sizeof(RadioRecord) ||
+        (hdr->count & (hdr->count - 1)) ||
+        size < hdr->header_size + (gsize) hdr->count * hdr->slot_size) {
+        fprintf(stderr, "%s: unsupported or corrupt trace\n", file);
+        return FALSE;
+    }
+
+    for (i = 0; i < hdr->count; i++) {
+        const RadioRecord* rec = (const RadioRecord*) (image +
+            hdr->header_size + (gsize) i * hdr->slot_size);
+
+        if (rec->seq) {
+            g_ptr_array_add(trace->records, (gpointer) rec);
+        }
+    }
+    g_ptr_array_sort(trace->records, trace_compare_records);
+    return TRUE;
+}
+
+static
+void
+trace_request(
+    Trace* trace,
+    const RadioRecord* req)
+{
+    TraceCodeStats* stats = trace_code_stats(trace->req_stats, req);
+    const guint64 key = TRACE_KEY(req, req->serial);
+    TraceTx* tx;
+
+    if (!trace_expects_response(req)) {
+        stats->count++;
+        return;
+    }
+
+    if (req->extra) {
+        /* Resubmission, the original serial will never complete */
+        const guint64 orig = TRACE_KEY(req, (guint32) req->extra);
+
+        tx = g_hash_table_lookup(trace->pending, &orig);
+        if (tx) {
+            trace_code_stats(trace->req_stats, tx->req)->pending--;
+            g_hash_table_remove(trace->pending, &orig);
+        }
+        stats->retries++;
+    }
+
+    tx = g_hash_table_lookup(trace->pending, &key);
+    stats->count++;
+    stats->pending++;
+    if (tx) {
+        /* The serial has been reused, the old one will never complete */
+        trace_code_stats(trace->req_stats, tx->req)->pending--;
+    } else {
+        guint64* k = g_new(guint64, 1);
+
+        *k = key;
+        tx = g_new0(TraceTx, 1);
+        g_hash_table_insert(trace->pending, k, tx);
+    }
+    tx->req = req;
+}
+
+static
+void
+trace_response(
+    Trace* trace,
+    const RadioRecord* resp)
+{
+    const guint64 key = TRACE_KEY(resp, resp->serial);
+    TraceTx* tx = g_hash_table_lookup(trace->pending, &key);
+
+    if (tx && trace_response_matches(tx->req, resp)) {
+        TraceCodeStats* stats = trace_code_stats(trace->req_stats, tx->req);
+        const gint64 latency = resp->time - tx->req->time;
+        TraceTx done;
+
+        g_array_append_val(stats->latency, latency);
+        if (resp->extra) {
+            stats->errors++;
+        }
+        stats->pending--;
+        done.req = tx->req;
+        done.resp = resp;
+        g_array_append_val(trace->done, done);
+        g_hash_table_remove(trace->pending, &key);
+    } else if (tx) {
+        trace->mismatched++;
+    } else {
+        /* The request has been overwritten or was never recorded */
+        trace->unmatched++;
+    }
+}
+
+static
+void
+trace_print_record(
+    const RadioRecord* rec,
+    gint64 t0)
+{
+    static const char* type[] = { "?", "req", "resp", "ind" };
+    char buf1[16], buf2[16];
+
+    printf("%10u %10.3f %-4s %-9s %-40s serial=%u extra=%d size=%u%s\n",
+        rec->seq, (rec->time - t0) / 1000000.0,
+        type[rec->type < G_N_ELEMENTS(type) ? rec->type : 0],
+        trace_interface(rec, buf1, sizeof(buf1)),
+        trace_name(rec, buf2, sizeof(buf2)), rec->serial, rec->extra,
+        rec->size, (rec->flags & RADIO_RECORD_FLAG_TRUNCATED) ? "+" : "");
+}
+
+static
+GPtrArray*
+trace_sorted_stats(
+    GHashTable* table)
+{
+    GPtrArray* list = g_ptr_array_new();
+    GHashTableIter it;
+    gpointer value;
+
+    g_hash_table_iter_init(&it, table);
+    while (g_hash_table_iter_next(&it, NULL, &value)) {
+        g_ptr_array_add(list, value);
+    }
+    g_ptr_array_sort(list, trace_compare_stats);
+    return list;
+}
+
+static
+void
+trace_report(
+    Trace* trace)
+{
+    const TraceOpt* opt = trace->opt;
+    GPtrArray* records = trace->records;
+    const RadioRecord* first = records->pdata[0];
+    const RadioRecord* last = records->pdata[records->len - 1];
+    const gint64 span = last->time - first->time;
+    const double sec = span / 1000000.0;
+    GHashTableIter it;
+    GPtrArray* list;
+    gpointer value;
+    guint i;
+
+    /* Whatever is still pending for too long has timed out */
+    g_hash_table_iter_init(&it, trace->pending);
+    while (g_hash_table_iter_next(&it, NULL, &value)) {
+        const TraceTx* tx = value;
+
+        if ((last->time - tx->req->time) / 1000 >= opt->timeout_ms) {
+            trace_code_stats(trace->req_stats, tx->req)->timeouts++;
+        }
+    }
+
+    printf("Records: %u (seq %u..%u, %u lost), %.3f sec\n", records->len,
+        first->seq, last->seq, (last->seq - first->seq + 1) - records->len,
+        sec);
+    if (trace->unmatched || trace->mismatched) {
+        printf("Responses without request: %u, mismatched: %u\n",
+            trace->unmatched, trace->mismatched);
+    }
+
+    list = trace_sorted_stats(trace->req_stats);
+    if (list->len) {
+        printf("\n%-9s %-40s %6s %9s %9s %9s %9s %5s %5s %5s\n", "IFACE",
+            "REQUEST", "COUNT", "P50,ms", "P90,ms", "P99,ms", "MAX,ms",
+            "ERR", "RETRY", "TMOUT");
+        for (i = 0; i < list->len; i++) {
+            TraceCodeStats* stats = list->pdata[i];
+            GArray* lat = stats->latency;
+            char buf1[16], buf2[16];
+
+            g_array_sort(lat, trace_compare_latency);
+            printf("%-9s %-40s %6u %9.1f %9.1f %9.1f %9.1f %5u %5u %5u\n",
+                trace_interface(stats->first, buf1, sizeof(buf1)),
+                trace_name(stats->first, buf2, sizeof(buf2)), stats->count,
+                trace_percentile_ms(lat, 50), trace_percentile_ms(lat, 90),
+                trace_percentile_ms(lat, 99), trace_percentile_ms(lat, 100),
+                stats->errors, stats->retries, stats->timeouts);
+        }
+    }
+    g_ptr_array_free(list, TRUE);
+
+    list = trace_sorted_stats(trace->ind_stats);
+    if (list->len) {
+        printf("\n%-9s %-40s %6s %9s\n", "IFACE", "INDICATION", "COUNT",
+            "PER SEC");
+        for (i = 0; i < list->len; i++) {
+            TraceCodeStats* stats = list->pdata[i];
+            char buf1[16], buf2[16];
+
+            printf("%-9s %-40s %6u %9.2f\n",
+                trace_interface(stats->first, buf1, sizeof(buf1)),
+                trace_name(stats->first, buf2, sizeof(buf2)), stats->count,
+                span ? (stats->count / sec) : 0.0);
+        }
+    }
+    g_ptr_array_free(list, TRUE);
+
+    if (trace->done->len && opt->top > 0) {
+        const guint n = MIN(trace->done->len, (guint) opt->top);
+
+        g_array_sort(trace->done, trace_compare_tx);
+        printf("\nSlowest transactions:\n");
+        for (i = 0; i < n; i++) {
+            const TraceTx* tx = &g_array_index(trace->done, TraceTx, i);
+            char buf1[16], buf2[16];
+
+            printf("%10.3f %-9s %-40s serial=%u %.1f ms\n",
+                (tx->req->time - first->time) / 1000000.0,
+                trace_interface(tx->req, buf1, sizeof(buf1)),
+                trace_name(tx->req, buf2, sizeof(buf2)), tx->req->serial,
+                (tx->resp->time - tx->req->time) / 1000.0);
+        }
+    }
+}
+
+static
+int
+trace_run(
+    const TraceOpt* opt,
+    const char* file)
+{
+    GError* error = NULL;
+    gchar* image = NULL;
+    gsize size = 0;
+    int ret = RET_ERR;
+
+    if (g_file_get_contents(file, &image, &size, &error)) {
+        Trace trace;
+
+        memset(&trace, 0, sizeof(trace));
+        trace.opt = opt;
+        trace.records = g_ptr_array_new();
+        trace.pending = g_hash_table_new_full(g_int64_hash, g_int64_equal,
+            g_free, g_free);
+        trace.req_stats = g_hash_table_new_full(g_int64_hash, g_int64_equal,
+            g_free, trace_code_stats_free);
+        trace.ind_stats = g_hash_table_new_full(g_int64_hash, g_int64_equal,
+            g_free, trace_code_stats_free);
+        trace.done = g_array_new(FALSE, FALSE, sizeof(TraceTx));
+
+        if (trace_load(&trace, file, (guint8*) image, size)) {
+            GPtrArray* records = trace.records;
+            guint i;
+
+            for (i = 0; i < records->len; i++) {
+                const RadioRecord* rec = records->pdata[i];
+
+                if (opt->verbose) {
+                    trace_print_record(rec,
+                        ((RadioRecord*)records->pdata[0])->time);
+                }
+                switch (rec->type) {
+                case RADIO_RECORD_REQUEST:
+                    trace_request(&trace, rec);
+                    break;
+                case RADIO_RECORD_RESPONSE:
+                    trace_response(&trace, rec);
+                    break;
+                case RADIO_RECORD_INDICATION:
+                    trace_code_stats(trace.ind_stats, rec)->count++;
+                    break;
+                }
+            }
+            if (records->len) {
+                if (opt->verbose) {
+                    printf("\n");
+                }
+                trace_report(&trace);
+            } else {
+                printf("No records\n");
+            }
+            ret = RET_OK;
+        }
+
+        g_ptr_array_free(trace.records, TRUE);
+        g_hash_table_destroy(trace.pending);
+        g_hash_table_destroy(trace.req_stats);
+        g_hash_table_destroy(trace.ind_stats);
+        g_array_free(trace.done, TRUE);
+        g_free(image);
+    } else {
+        fprintf(stderr, "%s\n", error->message);
+        g_error_free(error);
+    }
+    return ret;
+}
+
+int main(int argc, char* argv[])
+{
+    int ret = RET_CMDLINE;
+    TraceOpt opt;
+    GError* error = NULL;
+    GOptionContext* options;
+    GOptionEntry entries[] = {
+        { "verbose", 'v', 0, G_OPTION_ARG_NONE, &opt.verbose,
+          "Print every record", NULL },
+        { "timeout", 't', 0, G_OPTION_ARG_INT, &opt.timeout_ms,
+          "Request timeout [30000]", "MS" },
+        { "top", 'n', 0, G_OPTION_ARG_INT, &opt.top,
+          "Number of slowest transactions to show [10]", "N" },
+        { NULL }
+    };
+
+    memset(&opt, 0, sizeof(opt));
+    opt.timeout_ms = DEFAULT_TIMEOUT_MS;
+    opt.top = DEFAULT_TOP;
+    gutil_log_timestamp = FALSE;
+    gutil_log_default.level = GLOG_LEVEL_NONE;
+
+    options = g_option_context_new("FILE");
+    g_option_context_set_summary(options, "Analyzes the file written "
+        "by radio_recorder_dump() or radio_recorder_new_mapped().");
+    g_option_context_add_main_entries(options, entries, NULL);
+    if (g_option_context_parse(options, &argc, &argv, &error)) {
+        if (argc == 2) {
+            ret = trace_run(&opt, argv[1]);
+        } else {
+            char* help = g_option_context_get_help(options, TRUE, NULL);
+
+            fprintf(stderr, "%s", help);
+            g_free(help);
+        }
+    } else {
+        fprintf(stderr, "%s\n", error->message);
+        g_error_free(error);
+    }
+    g_option_context_free(options);
+    return ret;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
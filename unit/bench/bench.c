@@ -0,0 +1,978 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "bench_alloc.h"
+#include "test_common.h"
+#include "test_gbinder.h"
+
+#include "radio_client.h"
+#include "radio_config.h"
+#include "radio_instance.h"
+#include "radio_request.h"
+
+#include <gutil_log.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Prints one tab separated line per measurement:
+ *
+ *   name  param  count  usec  ops_per_sec  ns_per_op
+ *
+ * Everything runs on top of the fake binder from unit/common, which
+ * delivers each transaction from an idle callback. The absolute numbers
+ * are therefore only comparable between runs of this program.
+ *
+ * With --alloc, heap allocations are counted instead:
+ *
+ *   name  phase  count  allocs  frees  bytes  allocs_per_op  bytes_per_op
+ *
+ * Those include whatever the fake binder allocates, which is constant
+ * per transaction.
+ */
+
+#define DEV GBINDER_DEFAULT_HWBINDER
+#define SLOT "slot1"
+#define BENCH_COUNT (100000)
+#define BENCH_MAX_DEPTH (100000)
+#define BENCH_MAX_OBSERVERS (8)
+#define BENCH_ALLOC_WARMUP (10)
+
+#define RET_OK (0)
+#define RET_CMDLINE (1)
+#define RET_ERR (2)
+
+typedef struct bench_opt {
+    guint count;
+    guint max_depth;
+} BenchOpt;
+
+static BenchOpt bench_opt;
+
+static const GBinderClientIfaceInfo bench_radio_ind_iface_info[] = {
+    {RADIO_INDICATION_1_0, RADIO_1_0_IND_LAST }
+};
+
+static const GBinderClientIfaceInfo bench_radio_resp_iface_info[] = {
+    {RADIO_RESPONSE_1_0, RADIO_1_0_RESP_LAST }
+};
+
+static const GBinderClientIfaceInfo bench_config_ind_iface_info[] = {
+    {RADIO_CONFIG_INDICATION_1_0, RADIO_CONFIG_1_0_IND_LAST }
+};
+
+static const GBinderClientIfaceInfo bench_config_resp_iface_info[] = {
+    {RADIO_CONFIG_RESPONSE_1_1, RADIO_CONFIG_1_1_RESP_LAST },
+    {RADIO_CONFIG_RESPONSE_1_0, RADIO_CONFIG_1_0_RESP_LAST }
+};
+
+static
+void
+bench_result(
+    const char* name,
+    const char* param,
+    guint count,
+    gint64 usec)
+{
+    const double sec = MAX(usec, 1) / 1000000.0;
+
+    printf("%s\t%s\t%u\t%" G_GINT64_FORMAT "\t%.0f\t%.1f\n", name, param,
+        count, usec, count / sec, count ? (sec * 1e9 / count) : 0.0);
+    fflush(stdout);
+}
+
+static
+gboolean
+bench_quit(
+    gpointer loop)
+{
+    g_main_loop_quit(loop);
+    return G_SOURCE_REMOVE;
+}
+
+/* Runs the loop until everything pending has been handled */
+static
+void
+bench_drain(
+    GMainLoop* loop)
+{
+    g_idle_add_full(G_PRIORITY_LOW, bench_quit, loop, NULL);
+    g_main_loop_run(loop);
+}
+
+/*==========================================================================*
+ * Fake service
+ *==========================================================================*/
+
+typedef struct bench_service {
+    GBinderLocalObject* obj;
+    GBinderClient* resp_client;
+    GBinderClient* ind_client;
+    const GBinderClientIfaceInfo* resp_info;
+    gsize resp_count;
+    const GBinderClientIfaceInfo* ind_info;
+    gsize ind_count;
+    guint set_response_functions;
+    guint resp_code;            /* Zero to ignore requests */
+} BenchService;
+
+static
+GBinderLocalReply*
+bench_service_txproc(
+    GBinderLocalObject* obj,
+    GBinderRemoteRequest* req,
+    guint code,
+    guint flags,
+    int* status,
+    void* user_data)
+{
+    BenchService* service = user_data;
+    GBinderReader reader;
+
+    gbinder_remote_request_init_reader(req, &reader);
+    if (code == service->set_response_functions) {
+        GBinderRemoteObject* resp = gbinder_reader_read_object(&reader);
+        GBinderRemoteObject* ind = gbinder_reader_read_object(&reader);
+
+        gbinder_client_unref(service->resp_client);
+        gbinder_client_unref(service->ind_client);
+        service->resp_client = gbinder_client_new2(resp,
+            service->resp_info, service->resp_count);
+        service->ind_client = gbinder_client_new2(ind,
+            service->ind_info, service->ind_count);
+        gbinder_remote_object_unref(resp);
+        gbinder_remote_object_unref(ind);
+    } else if (service->resp_code) {
+        GBinderLocalRequest* resp = gbinder_client_new_request2
+            (service->resp_client, service->resp_code);
+        RadioResponseInfo info;
+        GBinderWriter writer;
+
+        memset(&info, 0, sizeof(info));
+        info.type = RADIO_RESP_SOLICITED;
+        if (gbinder_reader_read_uint32(&reader, &info.serial)) {
+            gbinder_local_request_init_writer(resp, &writer);
+            gbinder_writer_append_buffer_object(&writer, &info, sizeof(info));
+            gbinder_client_transact(service->resp_client, service->resp_code,
+                GBINDER_TX_FLAG_ONEWAY, resp, NULL, NULL, NULL);
+        }
+        gbinder_local_request_unref(resp);
+    }
+    *status = GBINDER_STATUS_OK;
+    return NULL;
+}
+
+static
+void
+bench_service_init(
+    BenchService* service,
+    guint set_response_functions)
+{
+    memset(service, 0, sizeof(*service));
+    service->set_response_functions = set_response_functions;
+    service->obj = test_gbinder_local_object_new(NULL,
+        bench_service_txproc, service);
+}
+
+static
+void
+bench_service_cleanup(
+    BenchService* service)
+{
+    gbinder_client_unref(service->resp_client);
+    gbinder_client_unref(service->ind_client);
+    gbinder_local_object_unref(service->obj);
+}
+
+/*==========================================================================*
+ * IRadio setup
+ *==========================================================================*/
+
+typedef struct bench_radio {
+    GMainLoop* loop;
+    GBinderServiceManager* sm;
+    GBinderRemoteObject* remote;
+    BenchService service;
+    RadioInstance* instance;
+    RadioClient* client;
+} BenchRadio;
+
+static
+void
+bench_radio_init(
+    BenchRadio* radio,
+    guint resp_code)
+{
+    const RADIO_IND code = RADIO_IND_RIL_CONNECTED;
+    BenchService* service = &radio->service;
+    GBinderLocalRequest* ind;
+
+    memset(radio, 0, sizeof(*radio));
+    radio->loop = g_main_loop_new(NULL, FALSE);
+    radio->sm = gbinder_servicemanager_new(DEV);
+    bench_service_init(service, RADIO_REQ_SET_RESPONSE_FUNCTIONS);
+    service->resp_info = bench_radio_resp_iface_info;
+    service->resp_count = G_N_ELEMENTS(bench_radio_resp_iface_info);
+    service->ind_info = bench_radio_ind_iface_info;
+    service->ind_count = G_N_ELEMENTS(bench_radio_ind_iface_info);
+    service->resp_code = resp_code;
+    radio->remote = test_gbinder_servicemanager_new_service(radio->sm,
+        RADIO_1_0 "/" SLOT, service->obj);
+    radio->instance = radio_instance_new_with_version(DEV, SLOT,
+        RADIO_INTERFACE_1_0);
+    radio->client = radio_client_new(radio->instance);
+
+    /* Requests can't be submitted until the modem is connected */
+    ind = gbinder_client_new_request2(service->ind_client, code);
+    gbinder_local_request_append_int32(ind, RADIO_IND_UNSOLICITED);
+    gbinder_client_transact_sync_oneway(service->ind_client, code, ind);
+    gbinder_local_request_unref(ind);
+    g_assert(radio_client_connected(radio->client));
+}
+
+static
+void
+bench_radio_cleanup(
+    BenchRadio* radio)
+{
+    bench_drain(radio->loop);
+    radio_client_unref(radio->client);
+    radio_instance_unref(radio->instance);
+    bench_service_cleanup(&radio->service);
+    gbinder_remote_object_unref(radio->remote);
+    gbinder_servicemanager_unref(radio->sm);
+    g_main_loop_unref(radio->loop);
+}
+
+/*==========================================================================*
+ * Round trips
+ *==========================================================================*/
+
+typedef struct bench_roundtrip BenchRoundTrip;
+
+struct bench_roundtrip {
+    GMainLoop* loop;
+    guint count;
+    guint submitted;
+    guint completed;
+    guint failed;
+    RadioRequest* (*new_request)(BenchRoundTrip* rt);
+    gpointer owner;
+};
+
+static
+void
+bench_roundtrip_submit(
+    BenchRoundTrip* rt)
+{
+    RadioRequest* req = rt->new_request(rt);
+
+    rt->submitted++;
+    if (!radio_request_submit(req)) {
+        rt->failed++;
+    }
+    radio_request_unref(req);
+}
+
+static
+void
+bench_roundtrip_done(
+    BenchRoundTrip* rt,
+    RADIO_TX_STATUS status)
+{
+    rt->completed++;
+    if (status != RADIO_TX_STATUS_OK) {
+        rt->failed++;
+    }
+    if (rt->submitted < rt->count) {
+        bench_roundtrip_submit(rt);
+    } else if (rt->completed == rt->count) {
+        g_main_loop_quit(rt->loop);
+    }
+}
+
+static
+void
+bench_roundtrip_complete(
+    RadioRequest* req,
+    RADIO_TX_STATUS status,
+    RADIO_RESP resp,
+    RADIO_ERROR error,
+    const GBinderReader* args,
+    gpointer user_data)
+{
+    bench_roundtrip_done(user_data, status);
+}
+
+static
+void
+bench_roundtrip_config_complete(
+    RadioRequest* req,
+    RADIO_TX_STATUS status,
+    RADIO_CONFIG_RESP resp,
+    RADIO_ERROR error,
+    const GBinderReader* args,
+    gpointer user_data)
+{
+    bench_roundtrip_done(user_data, status);
+}
+
+static
+void
+bench_roundtrip_run(
+    BenchRoundTrip* rt,
+    const char* name,
+    guint depth)
+{
+    char* param = g_strdup_printf("depth=%u", depth);
+    gint64 start;
+    guint i;
+
+    rt->submitted = rt->completed = rt->failed = 0;
+    start = g_get_monotonic_time();
+    for (i = 0; i < depth && i < rt->count; i++) {
+        bench_roundtrip_submit(rt);
+    }
+    g_main_loop_run(rt->loop);
+    bench_result(name, param, rt->count, g_get_monotonic_time() - start);
+    if (rt->failed) {
+        GWARN("%s %s: %u failed", name, param, rt->failed);
+    }
+    g_free(param);
+}
+
+static
+RadioRequest*
+bench_client_new_request(
+    BenchRoundTrip* rt)
+{
+    return radio_request_new(rt->owner, RADIO_REQ_GET_MUTE, NULL,
+        bench_roundtrip_complete, NULL, rt);
+}
+
+static
+void
+bench_client_roundtrip(
+    void)
+{
+    static const guint depths[] = { 1, 10, 100 };
+    BenchRoundTrip rt;
+    BenchRadio radio;
+    guint i;
+
+    bench_radio_init(&radio, RADIO_RESP_GET_MUTE);
+    memset(&rt, 0, sizeof(rt));
+    rt.loop = radio.loop;
+    rt.count = bench_opt.count;
+    rt.owner = radio.client;
+    rt.new_request = bench_client_new_request;
+    for (i = 0; i < G_N_ELEMENTS(depths); i++) {
+        bench_roundtrip_run(&rt, "client_roundtrip", depths[i]);
+    }
+    bench_radio_cleanup(&radio);
+}
+
+/*==========================================================================*
+ * IRadioConfig
+ *==========================================================================*/
+
+static
+RadioRequest*
+bench_config_new_request(
+    BenchRoundTrip* rt)
+{
+    return radio_config_request_new(rt->owner,
+        RADIO_CONFIG_REQ_SET_PREFERRED_DATA_MODEM, NULL,
+        bench_roundtrip_config_complete, NULL, rt);
+}
+
+typedef struct bench_config {
+    GMainLoop* loop;
+    GBinderServiceManager* sm;
+    GBinderRemoteObject* remote[2];
+    BenchService service;
+    RadioConfig* config;
+} BenchConfig;
+
+static
+void
+bench_config_init(
+    BenchConfig* bc)
+{
+    static const char* fqnames[] = {
+        RADIO_CONFIG_1_0_FQNAME,
+        RADIO_CONFIG_1_1_FQNAME
+    };
+    BenchService* service = &bc->service;
+    guint i;
+
+    G_STATIC_ASSERT(G_N_ELEMENTS(fqnames) == G_N_ELEMENTS(bc->remote));
+    memset(bc, 0, sizeof(*bc));
+    bc->loop = g_main_loop_new(NULL, FALSE);
+    bc->sm = gbinder_servicemanager_new(DEV);
+    bench_service_init(service, RADIO_CONFIG_REQ_SET_RESPONSE_FUNCTIONS);
+    service->resp_info = bench_config_resp_iface_info;
+    service->resp_count = G_N_ELEMENTS(bench_config_resp_iface_info);
+    service->ind_info = bench_config_ind_iface_info;
+    service->ind_count = G_N_ELEMENTS(bench_config_ind_iface_info);
+    service->resp_code = RADIO_CONFIG_RESP_SET_PREFERRED_DATA_MODEM;
+    for (i = 0; i < G_N_ELEMENTS(fqnames); i++) {
+        bc->remote[i] = test_gbinder_servicemanager_new_service(bc->sm,
+            fqnames[i], service->obj);
+    }
+    bc->config = radio_config_new_with_version(RADIO_CONFIG_INTERFACE_1_1);
+}
+
+static
+void
+bench_config_cleanup(
+    BenchConfig* bc)
+{
+    guint i;
+
+    bench_drain(bc->loop);
+    radio_config_unref(bc->config);
+    bench_service_cleanup(&bc->service);
+    for (i = 0; i < G_N_ELEMENTS(bc->remote); i++) {
+        gbinder_remote_object_unref(bc->remote[i]);
+    }
+    gbinder_servicemanager_unref(bc->sm);
+    g_main_loop_unref(bc->loop);
+}
+
+static
+void
+bench_config_roundtrip(
+    void)
+{
+    static const guint depths[] = { 1, 10, 100 };
+    BenchRoundTrip rt;
+    BenchConfig bc;
+    guint i;
+
+    bench_config_init(&bc);
+    memset(&rt, 0, sizeof(rt));
+    rt.loop = bc.loop;
+    rt.count = bench_opt.count;
+    rt.owner = bc.config;
+    rt.new_request = bench_config_new_request;
+    for (i = 0; i < G_N_ELEMENTS(depths); i++) {
+        bench_roundtrip_run(&rt, "config_roundtrip", depths[i]);
+    }
+    bench_config_cleanup(&bc);
+}
+
+/*==========================================================================*
+ * Indications
+ *==========================================================================*/
+
+static
+void
+bench_indication_observer(
+    RadioInstance* radio,
+    RADIO_IND code,
+    RADIO_IND_TYPE type,
+    const GBinderReader* reader,
+    gpointer user_data)
+{
+    (*(guint*)user_data)++;
+}
+
+static
+void
+bench_indication_run(
+    BenchRadio* radio,
+    guint observers)
+{
+    const RADIO_IND code = RADIO_IND_CALL_STATE_CHANGED;
+    const guint count = bench_opt.count;
+    GBinderClient* ind_client = radio->service.ind_client;
+    GBinderLocalRequest* ind = gbinder_client_new_request2(ind_client, code);
+    gulong ids[BENCH_MAX_OBSERVERS];
+    char* param = g_strdup_printf("observers=%u", observers);
+    guint calls = 0;
+    gint64 start;
+    guint i;
+
+    /* Spread the observers across the priorities */
+    for (i = 0; i < observers; i++) {
+        ids[i] = radio_instance_add_indication_observer_with_priority
+            (radio->instance, RADIO_OBSERVER_PRIORITY_LOWEST +
+                i % (RADIO_OBSERVER_PRIORITY_HIGHEST -
+                    RADIO_OBSERVER_PRIORITY_LOWEST + 1), code,
+                bench_indication_observer, &calls);
+    }
+
+    gbinder_local_request_append_int32(ind, RADIO_IND_UNSOLICITED);
+    start = g_get_monotonic_time();
+    for (i = 0; i < count; i++) {
+        gbinder_client_transact_sync_oneway(ind_client, code, ind);
+    }
+    bench_result("indication", param, count, g_get_monotonic_time() - start);
+    if (calls != count * observers) {
+        GWARN("%u observer calls instead of %u", calls, count * observers);
+    }
+
+    radio_instance_remove_handlers(radio->instance, ids, observers);
+    gbinder_local_request_unref(ind);
+    g_free(param);
+}
+
+static
+void
+bench_indication(
+    void)
+{
+    BenchRadio radio;
+
+    bench_radio_init(&radio, 0);
+    bench_indication_run(&radio, 0);
+    bench_indication_run(&radio, 1);
+    bench_indication_run(&radio, BENCH_MAX_OBSERVERS);
+    bench_radio_cleanup(&radio);
+}
+
+/*==========================================================================*
+ * Cancellation and timeouts
+ *==========================================================================*/
+
+typedef struct bench_timeout {
+    GMainLoop* loop;
+    guint pending;
+    guint timeouts;
+} BenchTimeout;
+
+static
+void
+bench_timeout_complete(
+    RadioRequest* req,
+    RADIO_TX_STATUS status,
+    RADIO_RESP resp,
+    RADIO_ERROR error,
+    const GBinderReader* args,
+    gpointer user_data)
+{
+    BenchTimeout* bt = user_data;
+
+    if (status == RADIO_TX_STATUS_TIMEOUT) {
+        bt->timeouts++;
+    }
+    if (!--bt->pending) {
+        g_main_loop_quit(bt->loop);
+    }
+}
+
+static
+void
+bench_cancel_run(
+    BenchRadio* radio,
+    guint depth)
+{
+    RadioRequest** reqs = g_new(RadioRequest*, depth);
+    char* param = g_strdup_printf("depth=%u", depth);
+    gint64 start;
+    guint i;
+
+    start = g_get_monotonic_time();
+    for (i = 0; i < depth; i++) {
+        reqs[i] = radio_request_new(radio->client, RADIO_REQ_GET_MUTE, NULL,
+            NULL, NULL, NULL);
+        radio_request_submit(reqs[i]);
+    }
+    bench_result("submit", param, depth, g_get_monotonic_time() - start);
+
+    /* Cancel in the submission order */
+    start = g_get_monotonic_time();
+    for (i = 0; i < depth; i++) {
+        radio_request_drop(reqs[i]);
+    }
+    bench_result("cancel", param, depth, g_get_monotonic_time() - start);
+
+    bench_drain(radio->loop);
+    g_free(reqs);
+    g_free(param);
+}
+
+static
+void
+bench_timeout_run(
+    BenchRadio* radio,
+    guint depth)
+{
+    char* param = g_strdup_printf("depth=%u", depth);
+    BenchTimeout bt;
+    gint64 start;
+    guint i;
+
+    memset(&bt, 0, sizeof(bt));
+    bt.loop = radio->loop;
+    for (i = 0; i < depth; i++) {
+        RadioRequest* req = radio_request_new(radio->client,
+            RADIO_REQ_GET_MUTE, NULL, bench_timeout_complete, NULL, &bt);
+
+        radio_request_set_timeout(req, 1);
+        if (radio_request_submit(req)) {
+            bt.pending++;
+        }
+        radio_request_unref(req);
+    }
+
+    /* Includes the time spent delivering the requests */
+    start = g_get_monotonic_time();
+    if (bt.pending) {
+        g_main_loop_run(radio->loop);
+    }
+    bench_result("timeout", param, depth, g_get_monotonic_time() - start);
+    if (bt.timeouts != depth) {
+        GWARN("%u timeouts instead of %u", bt.timeouts, depth);
+    }
+    bench_drain(radio->loop);
+    g_free(param);
+}
+
+static
+void
+bench_cancel_timeout(
+    void)
+{
+    BenchRadio radio;
+    guint depth;
+
+    bench_radio_init(&radio, 0);
+    for (depth = 10; depth <= bench_opt.max_depth; depth *= 10) {
+        bench_cancel_run(&radio, depth);
+        bench_timeout_run(&radio, depth);
+    }
+    bench_radio_cleanup(&radio);
+}
+
+/*==========================================================================*
+ * Allocation accounting
+ *==========================================================================*/
+
+typedef enum bench_alloc_phase {
+    BENCH_ALLOC_NEW,            /* radio_request_new() */
+    BENCH_ALLOC_SUBMIT,         /* radio_request_submit() */
+    BENCH_ALLOC_COMPLETE,       /* Transport, response and completion */
+    BENCH_ALLOC_FREE,           /* The last radio_request_unref() */
+    BENCH_ALLOC_PHASE_COUNT
+} BENCH_ALLOC_PHASE;
+
+static const char* const bench_alloc_phase_names[] = {
+    "new", "submit", "complete", "free"
+};
+G_STATIC_ASSERT(G_N_ELEMENTS(bench_alloc_phase_names) ==
+    BENCH_ALLOC_PHASE_COUNT);
+
+static
+void
+bench_alloc_result(
+    const char* name,
+    const char* phase,
+    guint count,
+    const BenchAlloc* alloc)
+{
+    const double n = MAX(count, 1);
+
+    printf("%s\t%s\t%u\t%" G_GUINT64_FORMAT "\t%" G_GUINT64_FORMAT
+        "\t%" G_GUINT64_FORMAT "\t%.2f\t%.1f\n", name, phase, count,
+        alloc->allocs, alloc->frees, alloc->bytes, alloc->allocs / n,
+        alloc->bytes / n);
+    fflush(stdout);
+}
+
+/*
+ * One request at a time, so that every phase can be attributed. The
+ * first few round trips are not counted, they fill the caches (quarks,
+ * hashtables growing to their working size and such).
+ */
+static
+void
+bench_alloc_lifecycle(
+    BenchRoundTrip* rt,
+    const char* name)
+{
+    BenchAlloc phase[BENCH_ALLOC_PHASE_COUNT];
+    BenchAlloc total, before, after;
+    guint i, n = 0;
+
+    memset(phase, 0, sizeof(phase));
+    rt->count = 1;
+    for (i = 0; i < BENCH_ALLOC_WARMUP + bench_opt.count; i++) {
+        const gboolean counting = (i >= BENCH_ALLOC_WARMUP);
+        RadioRequest* req;
+
+        rt->submitted = rt->completed = rt->failed = 0;
+        bench_alloc_get(&before);
+        req = rt->new_request(rt);
+        bench_alloc_get(&after);
+        if (counting) {
+            bench_alloc_add(phase + BENCH_ALLOC_NEW, &before, &after);
+        }
+
+        before = after;
+        rt->submitted++;
+        if (!radio_request_submit(req)) {
+            GWARN("%s: failed to submit request", name);
+            radio_request_unref(req);
+            break;
+        }
+        bench_alloc_get(&after);
+        if (counting) {
+            bench_alloc_add(phase + BENCH_ALLOC_SUBMIT, &before, &after);
+        }
+
+        before = after;
+        g_main_loop_run(rt->loop);
+        bench_alloc_get(&after);
+        if (counting) {
+            bench_alloc_add(phase + BENCH_ALLOC_COMPLETE, &before, &after);
+        }
+
+        /* The library has dropped its references by now */
+        before = after;
+        radio_request_unref(req);
+        bench_alloc_get(&after);
+        if (counting) {
+            bench_alloc_add(phase + BENCH_ALLOC_FREE, &before, &after);
+            n++;
+        }
+    }
+
+    memset(&total, 0, sizeof(total));
+    for (i = 0; i < BENCH_ALLOC_PHASE_COUNT; i++) {
+        memset(&before, 0, sizeof(before));
+        bench_alloc_add(&total, &before, phase + i);
+        bench_alloc_result(name, bench_alloc_phase_names[i], n, phase + i);
+    }
+    bench_alloc_result(name, "total", n, &total);
+}
+
+static
+void
+bench_alloc_client(
+    void)
+{
+    BenchRoundTrip rt;
+    BenchRadio radio;
+
+    bench_radio_init(&radio, RADIO_RESP_GET_MUTE);
+    memset(&rt, 0, sizeof(rt));
+    rt.loop = radio.loop;
+    rt.owner = radio.client;
+    rt.new_request = bench_client_new_request;
+    bench_alloc_lifecycle(&rt, "client");
+    bench_radio_cleanup(&radio);
+}
+
+static
+void
+bench_alloc_config(
+    void)
+{
+    BenchRoundTrip rt;
+    BenchConfig bc;
+
+    bench_config_init(&bc);
+    memset(&rt, 0, sizeof(rt));
+    rt.loop = bc.loop;
+    rt.owner = bc.config;
+    rt.new_request = bench_config_new_request;
+    bench_alloc_lifecycle(&rt, "config");
+    bench_config_cleanup(&bc);
+}
+
+/* Requests which never reach the service */
+static
+void
+bench_alloc_cancel(
+    void)
+{
+    BenchAlloc alloc, before, after;
+    BenchRadio radio;
+    guint i, n = 0;
+
+    bench_radio_init(&radio, 0);
+    memset(&alloc, 0, sizeof(alloc));
+    for (i = 0; i < BENCH_ALLOC_WARMUP + bench_opt.count; i++) {
+        RadioRequest* req;
+
+        bench_alloc_get(&before);
+        req = radio_request_new(radio.client, RADIO_REQ_GET_MUTE, NULL,
+            NULL, NULL, NULL);
+        radio_request_submit(req);
+        radio_request_drop(req);
+        bench_drain(radio.loop);
+        bench_alloc_get(&after);
+        if (i >= BENCH_ALLOC_WARMUP) {
+            bench_alloc_add(&alloc, &before, &after);
+            n++;
+        }
+    }
+    bench_alloc_result("cancel", "total", n, &alloc);
+    bench_radio_cleanup(&radio);
+}
+
+static
+void
+bench_alloc_indication(
+    void)
+{
+    const RADIO_IND code = RADIO_IND_CALL_STATE_CHANGED;
+    BenchAlloc alloc, before, after;
+    BenchRadio radio;
+    GBinderClient* ind_client;
+    GBinderLocalRequest* ind;
+    guint i, n = 0, calls = 0;
+    gulong id;
+
+    bench_radio_init(&radio, 0);
+    ind_client = radio.service.ind_client;
+    ind = gbinder_client_new_request2(ind_client, code);
+    gbinder_local_request_append_int32(ind, RADIO_IND_UNSOLICITED);
+    id = radio_instance_add_indication_observer(radio.instance, code,
+        bench_indication_observer, &calls);
+
+    memset(&alloc, 0, sizeof(alloc));
+    for (i = 0; i < BENCH_ALLOC_WARMUP + bench_opt.count; i++) {
+        bench_alloc_get(&before);
+        gbinder_client_transact_sync_oneway(ind_client, code, ind);
+        bench_alloc_get(&after);
+        if (i >= BENCH_ALLOC_WARMUP) {
+            bench_alloc_add(&alloc, &before, &after);
+            n++;
+        }
+    }
+    bench_alloc_result("indication", "observers=1", n, &alloc);
+
+    radio_instance_remove_handler(radio.instance, id);
+    gbinder_local_request_unref(ind);
+    bench_radio_cleanup(&radio);
+}
+
+static
+int
+bench_alloc(
+    void)
+{
+    if (!bench_alloc_supported()) {
+        fprintf(stderr, "Allocation counting is not supported\n");
+        return RET_ERR;
+    }
+
+    printf("# name\tphase\tcount\tallocs\tfrees\tbytes\t"
+        "allocs_per_op\tbytes_per_op\n");
+    bench_alloc_enable(TRUE);
+    bench_alloc_client();
+    bench_alloc_config();
+    bench_alloc_cancel();
+    bench_alloc_indication();
+    bench_alloc_enable(FALSE);
+    return RET_OK;
+}
+
+/*==========================================================================*
+ * Common
+ *==========================================================================*/
+
+int main(int argc, char* argv[])
+{
+    gboolean verbose = FALSE;
+    gboolean quick = FALSE;
+    gboolean alloc = FALSE;
+    GOptionEntry entries[] = {
+        { "verbose", 'v', 0, G_OPTION_ARG_NONE, &verbose,
+          "Enable verbose output", NULL },
+        { "count", 'c', 0, G_OPTION_ARG_INT, &bench_opt.count,
+          "Iterations per measurement [100000]", "N" },
+        { "depth", 'd', 0, G_OPTION_ARG_INT, &bench_opt.max_depth,
+          "Maximum queue depth [100000]", "N" },
+        { "quick", 'q', 0, G_OPTION_ARG_NONE, &quick,
+          "Small counts, for a quick sanity check", NULL },
+        { "alloc", 'a', 0, G_OPTION_ARG_NONE, &alloc,
+          "Count heap allocations instead of measuring time", NULL },
+        { NULL }
+    };
+    GOptionContext* options = g_option_context_new(NULL);
+    GError* error = NULL;
+    gboolean ok;
+
+    bench_opt.count = BENCH_COUNT;
+    bench_opt.max_depth = BENCH_MAX_DEPTH;
+    g_option_context_add_main_entries(options, entries, NULL);
+    g_option_context_set_summary(options,
+        "Measures libgbinder-radio on top of the fake binder.");
+    ok = g_option_context_parse(options, &argc, &argv, &error);
+    g_option_context_free(options);
+    if (!ok) {
+        fprintf(stderr, "%s\n", error->message);
+        g_error_free(error);
+        return RET_CMDLINE;
+    }
+
+    if (quick) {
+        bench_opt.count = MIN(bench_opt.count, 1000);
+        bench_opt.max_depth = MIN(bench_opt.max_depth, 1000);
+    }
+    bench_opt.count = MAX(bench_opt.count, 1);
+    gutil_log_timestamp = FALSE;
+    gutil_log_default.name = "bench";
+    gutil_log_default.level = verbose ? GLOG_LEVEL_VERBOSE : GLOG_LEVEL_ERR;
+
+    if (alloc) {
+        /*
+         * Make g_slice_alloc() go through malloc() on older GLib which
+         * has its own slab allocator. Newer GLib does it anyway.
+         */
+        g_setenv("G_SLICE", "always-malloc", TRUE);
+        return bench_alloc();
+    }
+
+    printf("# name\tparam\tcount\tusec\tops_per_sec\tns_per_op\n");
+    bench_client_roundtrip();
+    bench_config_roundtrip();
+    bench_indication();
+    bench_cancel_timeout();
+    return RET_OK;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+#include "bench_alloc.h"
+
+#include <stdlib.h>
+
+static gboolean bench_alloc_enabled = FALSE;
+static BenchAlloc bench_alloc_total;
+
+#ifdef __GLIBC__
+
+/*
+ * glibc exports its allocator under these names, which allows to
+ * wrap it without dlsym() and the recursion that comes with it.
+ * The bench is single-threaded, plain counters are good enough.
+ */
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t nmemb, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void __libc_free(void* ptr);
+
+void*
+malloc(
+    size_t size)
+{
+    if (bench_alloc_enabled) {
+        bench_alloc_total.allocs++;
+        bench_alloc_total.bytes += size;
+    }
+    return __libc_malloc(size);
+}
+
+void*
+calloc(
+    size_t nmemb,
+    size_t size)
+{
+    if (bench_alloc_enabled) {
+        bench_alloc_total.allocs++;
+        bench_alloc_total.bytes += nmemb * size;
+    }
+    return __libc_calloc(nmemb, size);
+}
+
+void*
+realloc(
+    void* ptr,
+    size_t size)
+{
+    if (bench_alloc_enabled) {
+        /* Counted as free + malloc */
+        if (ptr) {
+            bench_alloc_total.frees++;
+        }
+        if (size) {
+            bench_alloc_total.allocs++;
+            bench_alloc_total.bytes += size;
+        }
+    }
+    return __libc_realloc(ptr, size);
+}
+
+void
+free(
+    void* ptr)
+{
+    if (ptr && bench_alloc_enabled) {
+        bench_alloc_total.frees++;
+    }
+    __libc_free(ptr);
+}
+
+gboolean
+bench_alloc_supported(
+    void)
+{
+    return TRUE;
+}
+
+#else /* !__GLIBC__ */
+
+gboolean
+bench_alloc_supported(
+    void)
+{
+    return FALSE;
+}
+
+#endif /* !__GLIBC__ */
+
+void
+bench_alloc_enable(
+    gboolean enable)
+{
+    bench_alloc_enabled = enable;
+}
+
+void
+bench_alloc_get(
+    BenchAlloc* alloc)
+{
+    *alloc = bench_alloc_total;
+}
+
+void
+bench_alloc_add(
+    BenchAlloc* acc,
+    const BenchAlloc* before,
+    const BenchAlloc* after)
+{
+    acc->allocs += after->allocs - before->allocs;
+    acc->frees += after->frees - before->frees;
+    acc->bytes += after->bytes - before->bytes;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,281 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "test_clock.h"
+
+/* Doesn't start at zero, zero deadlines have special meaning */
+#define TEST_CLOCK_START (1000000)
+
+typedef struct test_clock_timer {
+    guint id;
+    guint interval_ms;
+    gint64 due;
+    GSourceFunc func;
+    gpointer data;
+    GDestroyNotify destroy;
+    GSequenceIter* iter;
+} TestClockTimer;
+
+struct test_clock {
+    RadioBaseClock radio_base_clock;
+    GSequence* timers;
+    GHashTable* ids;
+    gint64 now;
+    guint last_id;
+};
+
+static
+void
+test_clock_timer_free(
+    gpointer data)
+{
+    TestClockTimer* timer = data;
+
+    if (timer->destroy) {
+        timer->destroy(timer->data);
+    }
+    g_free(timer);
+}
+
+static
+int
+test_clock_timer_compare(
+    gconstpointer a,
+    gconstpointer b,
+    gpointer user_data)
+{
+    const TestClockTimer* t1 = a;
+    const TestClockTimer* t2 = b;
+
+    /* Timers which expire at the same time fire in the order of creation */
+    return (t1->due < t2->due) ? (-1) : (t1->due > t2->due) ? 1 :
+        (t1->id < t2->id) ? (-1) : (t1->id > t2->id) ? 1 : 0;
+}
+
+static
+void
+test_clock_schedule(
+    TestClock* self,
+    TestClockTimer* timer)
+{
+    timer->due = self->now + (gint64) timer->interval_ms * 1000;
+    timer->iter = g_sequence_insert_sorted(self->timers, timer,
+        test_clock_timer_compare, NULL);
+}
+
+static
+void
+test_clock_fire(
+    TestClock* self,
+    TestClockTimer* timer)
+{
+    const gpointer key = GUINT_TO_POINTER(timer->id);
+    gboolean again;
+
+    self->now = MAX(self->now, timer->due);
+    g_sequence_remove(timer->iter);
+    timer->iter = NULL;
+    again = timer->func(timer->data);
+
+    /* The callback may have removed the timer */
+    if (g_hash_table_lookup(self->ids, key) == timer) {
+        if (again) {
+            test_clock_schedule(self, timer);
+        } else {
+            g_hash_table_remove(self->ids, key);
+        }
+    }
+}
+
+static
+gint64
+test_clock_radio_base_now(
+    gpointer user_data)
+{
+    return test_clock_now(user_data);
+}
+
+static
+guint
+test_clock_radio_base_timeout_add(
+    GMainContext* context,
+    guint ms,
+    GSourceFunc func,
+    gpointer data,
+    gpointer user_data)
+{
+    return test_clock_add(user_data, ms, func, data, NULL);
+}
+
+static
+void
+test_clock_radio_base_source_remove(
+    GMainContext* context,
+    guint id,
+    gpointer user_data)
+{
+    test_clock_remove(user_data, id);
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+TestClock*
+test_clock_new(
+    void)
+{
+    TestClock* self = g_new0(TestClock, 1);
+
+    self->radio_base_clock.now = test_clock_radio_base_now;
+    self->radio_base_clock.timeout_add = test_clock_radio_base_timeout_add;
+    self->radio_base_clock.source_remove =
+        test_clock_radio_base_source_remove;
+    self->radio_base_clock.user_data = self;
+    /* The hashtable owns the timers, the sequence only sorts them */
+    self->timers = g_sequence_new(NULL);
+    self->ids = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+        NULL, test_clock_timer_free);
+    self->now = TEST_CLOCK_START;
+    return self;
+}
+
+void
+test_clock_free(
+    TestClock* self)
+{
+    g_sequence_free(self->timers);
+    g_hash_table_destroy(self->ids);
+    g_free(self);
+}
+
+const RadioBaseClock*
+test_clock_radio_base_clock(
+    TestClock* self)
+{
+    return &self->radio_base_clock;
+}
+
+gint64
+test_clock_now(
+    TestClock* self)
+{
+    return self->now;
+}
+
+guint
+test_clock_add(
+    TestClock* self,
+    guint ms,
+    GSourceFunc func,
+    gpointer data,
+    GDestroyNotify destroy)
+{
+    TestClockTimer* timer = g_new0(TestClockTimer, 1);
+
+    do { timer->id = ++self->last_id; } while (!timer->id);
+    timer->interval_ms = ms;
+    timer->func = func;
+    timer->data = data;
+    timer->destroy = destroy;
+    g_hash_table_insert(self->ids, GUINT_TO_POINTER(timer->id), timer);
+    test_clock_schedule(self, timer);
+    return timer->id;
+}
+
+void
+test_clock_remove(
+    TestClock* self,
+    guint id)
+{
+    TestClockTimer* timer = g_hash_table_lookup(self->ids,
+        GUINT_TO_POINTER(id));
+
+    if (timer) {
+        if (timer->iter) {
+            g_sequence_remove(timer->iter);
+            timer->iter = NULL;
+        }
+        g_hash_table_remove(self->ids, GUINT_TO_POINTER(id));
+    }
+}
+
+guint
+test_clock_count(
+    TestClock* self)
+{
+    return g_hash_table_size(self->ids);
+}
+
+gboolean
+test_clock_next(
+    TestClock* self)
+{
+    GSequenceIter* first = g_sequence_get_begin_iter(self->timers);
+
+    if (!g_sequence_iter_is_end(first)) {
+        test_clock_fire(self, g_sequence_get(first));
+        return TRUE;
+    }
+    return FALSE;
+}
+
+void
+test_clock_advance(
+    TestClock* self,
+    gint64 usec)
+{
+    const gint64 end = self->now + usec;
+    GSequenceIter* first;
+
+    while (!g_sequence_iter_is_end(first =
+        g_sequence_get_begin_iter(self->timers))) {
+        TestClockTimer* timer = g_sequence_get(first);
+
+        if (timer->due > end) {
+            break;
+        }
+        test_clock_fire(self, timer);
+    }
+    self->now = end;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
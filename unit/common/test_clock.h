@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef TEST_CLOCK_H
+#define TEST_CLOCK_H
+
+#include "radio_base.h"
+
+/*
+ * Virtual clock. Time only moves when test_clock_next() or
+ * test_clock_advance() is called, the due timers are invoked from
+ * there in the order of their expiration.
+ */
+
+typedef struct test_clock TestClock;
+
+TestClock*
+test_clock_new(
+    void);
+
+void
+test_clock_free(
+    TestClock* clock);
+
+/* To be passed to radio_base_set_clock() */
+const RadioBaseClock*
+test_clock_radio_base_clock(
+    TestClock* clock);
+
+gint64
+test_clock_now(
+    TestClock* clock);
+
+guint
+test_clock_add(
+    TestClock* clock,
+    guint ms,
+    GSourceFunc func,
+    gpointer data,
+    GDestroyNotify destroy);
+
+void
+test_clock_remove(
+    TestClock* clock,
+    guint id);
+
+guint
+test_clock_count(
+    TestClock* clock);
+
+/* Moves to the next timer and fires it. FALSE if there are no timers */
+gboolean
+test_clock_next(
+    TestClock* clock);
+
+/* Fires everything that expires within the specified interval */
+void
+test_clock_advance(
+    TestClock* clock,
+    gint64 usec);
+
+#endif /* TEST_CLOCK_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
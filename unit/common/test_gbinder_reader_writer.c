@@ -71,6 +71,7 @@ struct test_gbinder_data {
 
 typedef struct test_gbinder_reader {
     TestGBinderDataItem* item;
+    TestGBinderData* data;
 } TestGBinderReader;
 
 typedef struct test_gbinder_writer {
@@ -310,7 +311,10 @@ test_gbinder_data_init_reader(
 {
     memset(reader, 0, sizeof(*reader));
     if (data) {
-        test_gbinder_reader_cast(reader)->item = data->items;
+        TestGBinderReader* self = test_gbinder_reader_cast(reader);
+
+        self->item = data->items;
+        self->data = data;
     }
 }
 
@@ -357,6 +361,24 @@ gbinder_reader_read_int32(
     return gbinder_reader_read_uint32(reader, (guint32*)value);
 }
 
+gboolean
+gbinder_reader_read_bool(
+    GBinderReader* reader,
+    gboolean* value)
+{
+    TestGBinderReader* self = test_gbinder_reader_cast(reader);
+    TestGBinderDataItem* item = self->item;
+
+    if (item && item->type == DATA_TYPE_BOOLEAN) {
+        if (value) {
+            *value = item->data.b;
+        }
+        self->item = item->next;
+        return TRUE;
+    }
+    return FALSE;
+}
+
 const void*
 gbinder_reader_read_hidl_struct1(
     GBinderReader* reader,
@@ -373,6 +395,31 @@ gbinder_reader_read_hidl_struct1(
     return NULL;
 }
 
+const void*
+gbinder_reader_read_hidl_vec1(
+    GBinderReader* reader,
+    gsize* count,
+    guint expected_elem_size)
+{
+    TestGBinderReader* self = test_gbinder_reader_cast(reader);
+    TestGBinderDataItem* item = self->item;
+
+    /* The whole vector is stored as a single buffer */
+    if (item && item->type == DATA_TYPE_BUFFER && expected_elem_size &&
+        !(item->data.blob.size % expected_elem_size)) {
+        self->item = item->next;
+        if (count) {
+            *count = item->data.blob.size / expected_elem_size;
+        }
+        /* Non-NULL pointer is returned for an empty vector too */
+        return item->data.blob.buf ? item->data.blob.buf : (void*)item;
+    }
+    if (count) {
+        *count = 0;
+    }
+    return NULL;
+}
+
 const void*
 gbinder_reader_read_parcelable(
     GBinderReader* reader,
@@ -405,6 +452,44 @@ gbinder_reader_read_object(
     return NULL;
 }
 
+void
+gbinder_reader_copy(
+    GBinderReader* dest,
+    const GBinderReader* src)
+{
+    *test_gbinder_reader_cast(dest) =
+        *test_gbinder_reader_cast((GBinderReader*)src);
+}
+
+const void*
+gbinder_reader_get_data(
+    const GBinderReader* reader,
+    gsize* size)
+{
+    TestGBinderReader* self = test_gbinder_reader_cast((GBinderReader*)reader);
+    TestGBinderData* data = self->data;
+    TestGBinderDataItem* item;
+    GByteArray* buf = g_byte_array_new();
+
+    /* Only the unread part, which is good enough for the tests */
+    for (item = self->item; item; item = item->next) {
+        g_byte_array_append(buf, (void*)&item->data,
+            test_gbinder_data_item_size(item));
+    }
+    if (size) *size = buf->len;
+    if (data) {
+        void* ptr = g_byte_array_free(buf, FALSE);
+
+        if (!data->pool) {
+            data->pool = gutil_idle_pool_new();
+        }
+        gutil_idle_pool_add(data->pool, ptr, g_free);
+        return ptr;
+    }
+    g_byte_array_free(buf, TRUE);
+    return NULL;
+}
+
 const void*
 gbinder_writer_get_data(
     GBinderWriter* writer,
@@ -484,6 +569,54 @@ gbinder_writer_append_buffer_object(
     return index;
 }
 
+guint
+gbinder_writer_append_buffer_object_with_parent(
+    GBinderWriter* writer,
+    const void* buf,
+    gsize size,
+    const GBinderParent* parent)
+{
+    /* The parent isn't needed, buffers are read back one by one */
+    return gbinder_writer_append_buffer_object(writer, buf, size);
+}
+
+void
+gbinder_writer_append_hidl_vec(
+    GBinderWriter* writer,
+    const void* base,
+    guint count,
+    guint elemsize)
+{
+    /* The whole vector is stored as a single buffer */
+    gbinder_writer_append_buffer_object(writer, base, count * elemsize);
+}
+
+void*
+gbinder_writer_malloc0(
+    GBinderWriter* writer,
+    gsize size)
+{
+    TestGBinderWriter* self = test_gbinder_writer_cast(writer);
+    TestGBinderData* data = self->data;
+    void* ptr = g_malloc0(size);
+
+    if (!data->pool) {
+        data->pool = gutil_idle_pool_new();
+    }
+    gutil_idle_pool_add(data->pool, ptr, g_free);
+    return ptr;
+}
+
+void*
+gbinder_writer_memdup(
+    GBinderWriter* writer,
+    const void* buf,
+    gsize size)
+{
+    return (buf && size) ? memcpy(gbinder_writer_malloc0(writer, size),
+        buf, size) : NULL;
+}
+
 void
 gbinder_writer_append_local_object(
     GBinderWriter* writer,
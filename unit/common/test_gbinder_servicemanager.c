@@ -46,6 +46,13 @@ struct gbinder_servicemanager {
     char* dev;
 };
 
+typedef struct test_gbinder_servicemanager_call {
+    GBinderServiceManager* sm;
+    char* name;
+    GBinderServiceManagerGetServiceFunc func;
+    void* user_data;
+} TestGBinderServiceManagerCall;
+
 static GHashTable* test_servermanagers = NULL;
 
 static
@@ -67,6 +74,35 @@ test_gbinder_servicemanager_free(
     g_free(self);
 }
 
+static
+gboolean
+test_gbinder_servicemanager_get_service_handle(
+    gpointer data)
+{
+    TestGBinderServiceManagerCall* call = data;
+    GBinderRemoteObject* obj = g_hash_table_lookup(call->sm->services,
+        call->name);
+
+    if (!obj) {
+        GDEBUG("Name %s not found", call->name);
+    }
+    call->func(call->sm, obj, obj ? GBINDER_STATUS_OK : GBINDER_STATUS_FAILED,
+        call->user_data);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+test_gbinder_servicemanager_get_service_free(
+    gpointer data)
+{
+    TestGBinderServiceManagerCall* call = data;
+
+    gbinder_servicemanager_unref(call->sm);
+    g_free(call->name);
+    g_free(call);
+}
+
 /*==========================================================================*
  * Internal API
  *==========================================================================*/
@@ -161,6 +197,57 @@ gbinder_servicemanager_get_service_sync(
     return NULL;
 }
 
+gulong
+gbinder_servicemanager_get_service(
+    GBinderServiceManager* self,
+    const char* name,
+    GBinderServiceManagerGetServiceFunc func,
+    void* user_data)
+{
+    if (self && name && func) {
+        TestGBinderServiceManagerCall* call =
+            g_new0(TestGBinderServiceManagerCall, 1);
+
+        call->sm = gbinder_servicemanager_ref(self);
+        call->name = g_strdup(name);
+        call->func = func;
+        call->user_data = user_data;
+        return g_idle_add_full(G_PRIORITY_DEFAULT_IDLE,
+            test_gbinder_servicemanager_get_service_handle, call,
+            test_gbinder_servicemanager_get_service_free);
+    }
+    return 0;
+}
+
+void
+gbinder_servicemanager_cancel(
+    GBinderServiceManager* self,
+    gulong id)
+{
+    if (self && id) {
+        g_source_remove((guint)id);
+    }
+}
+
+char**
+gbinder_servicemanager_list_sync(
+    GBinderServiceManager* self)
+{
+    if (self) {
+        GHashTableIter it;
+        gpointer key;
+        GPtrArray* list = g_ptr_array_new();
+
+        g_hash_table_iter_init(&it, self->services);
+        while (g_hash_table_iter_next(&it, &key, NULL)) {
+            g_ptr_array_add(list, g_strdup(key));
+        }
+        g_ptr_array_add(list, NULL);
+        return (char**) g_ptr_array_free(list, FALSE);
+    }
+    return NULL;
+}
+
 GBinderLocalObject*
 gbinder_servicemanager_new_local_object2(
     GBinderServiceManager* self,
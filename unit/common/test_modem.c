@@ -0,0 +1,714 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+#include "test_modem.h"
+#include "test_common.h"
+#include "test_gbinder.h"
+
+#include "radio_config.h"
+#include "radio_instance.h"
+#include "radio_util.h"
+
+#include <gutil_log.h>
+
+typedef struct test_modem_timer {
+    TestModem* modem;
+    guint id;                   /* Key in the timers table */
+    guint source;               /* Clock or GLib source */
+    TestClock* clock;           /* Clock the source belongs to */
+    guint code;
+    GBinderLocalRequest* tx;    /* Response, NULL for indication streams */
+    gboolean error;
+    RADIO_IND_TYPE type;
+    guint interval_ms;
+    guint remaining;            /* Zero for endless streams */
+} TestModemTimer;
+
+typedef struct test_modem_aidl_desc {
+    const char* iface;
+    GBinderClientIfaceInfo resp_info;
+    GBinderClientIfaceInfo ind_info;
+    guint set_response_functions;
+    guint resp_ack;
+    guint ack_req;
+    guint ril_connected;
+} TestModemAidlDesc;
+
+struct test_modem {
+    TEST_MODEM_TYPE type;
+    int version;
+    const char* dev;
+    GBinderServiceManager* sm;
+    GBinderLocalObject* obj;
+    GPtrArray* services;
+    GBinderClient* resp_client;
+    GBinderClient* ind_client;
+    const GBinderClientIfaceInfo* resp_info;
+    gsize resp_count;
+    const GBinderClientIfaceInfo* ind_info;
+    gsize ind_count;
+    guint set_response_functions;
+    guint resp_ack;
+    guint ack_req;
+    guint ril_connected;
+    TestModemParams params;
+    GRand* rand;
+    TestClock* clock;
+    TestModemPayloadFunc payload_func;
+    gpointer payload_data;
+    GHashTable* timers;
+    guint last_id;
+    guint connect_id;
+    TestModemStats stats;
+};
+
+static const GBinderClientIfaceInfo test_modem_radio_resp_info[] = {
+    { RADIO_RESPONSE_1_5, RADIO_1_5_RESP_LAST },
+    { RADIO_RESPONSE_1_4, RADIO_1_4_RESP_LAST },
+    { RADIO_RESPONSE_1_3, RADIO_1_3_RESP_LAST },
+    { RADIO_RESPONSE_1_2, RADIO_1_2_RESP_LAST },
+    { RADIO_RESPONSE_1_1, RADIO_1_1_RESP_LAST },
+    { RADIO_RESPONSE_1_0, RADIO_1_0_RESP_LAST }
+};
+G_STATIC_ASSERT(G_N_ELEMENTS(test_modem_radio_resp_info) ==
+    RADIO_INTERFACE_COUNT);
+
+static const GBinderClientIfaceInfo test_modem_radio_ind_info[] = {
+    { RADIO_INDICATION_1_5, RADIO_1_5_IND_LAST },
+    { RADIO_INDICATION_1_4, RADIO_1_4_IND_LAST },
+    { RADIO_INDICATION_1_3, RADIO_1_3_IND_LAST },
+    { RADIO_INDICATION_1_2, RADIO_1_2_IND_LAST },
+    { RADIO_INDICATION_1_1, RADIO_1_1_IND_LAST },
+    { RADIO_INDICATION_1_0, RADIO_1_0_IND_LAST }
+};
+G_STATIC_ASSERT(G_N_ELEMENTS(test_modem_radio_ind_info) ==
+    RADIO_INTERFACE_COUNT);
+
+static const char* const test_modem_radio_ifaces[] = {
+    RADIO_1_0, RADIO_1_1, RADIO_1_2, RADIO_1_3, RADIO_1_4, RADIO_1_5
+};
+G_STATIC_ASSERT(G_N_ELEMENTS(test_modem_radio_ifaces) ==
+    RADIO_INTERFACE_COUNT);
+
+static const GBinderClientIfaceInfo test_modem_config_resp_info[] = {
+    { RADIO_CONFIG_RESPONSE_1_2, RADIO_CONFIG_1_2_RESP_LAST },
+    { RADIO_CONFIG_RESPONSE_1_1, RADIO_CONFIG_1_1_RESP_LAST },
+    { RADIO_CONFIG_RESPONSE_1_0, RADIO_CONFIG_1_0_RESP_LAST }
+};
+G_STATIC_ASSERT(G_N_ELEMENTS(test_modem_config_resp_info) ==
+    RADIO_CONFIG_INTERFACE_COUNT);
+
+static const GBinderClientIfaceInfo test_modem_config_ind_info[] = {
+    { RADIO_CONFIG_INDICATION_1_2, RADIO_CONFIG_1_2_IND_LAST },
+    { RADIO_CONFIG_INDICATION_1_1, RADIO_CONFIG_1_0_IND_LAST },
+    { RADIO_CONFIG_INDICATION_1_0, RADIO_CONFIG_1_0_IND_LAST }
+};
+G_STATIC_ASSERT(G_N_ELEMENTS(test_modem_config_ind_info) ==
+    RADIO_CONFIG_INTERFACE_COUNT);
+
+static const char* const test_modem_config_fqnames[] = {
+    RADIO_CONFIG_1_0_FQNAME, RADIO_CONFIG_1_1_FQNAME, RADIO_CONFIG_1_2_FQNAME
+};
+G_STATIC_ASSERT(G_N_ELEMENTS(test_modem_config_fqnames) ==
+    RADIO_CONFIG_INTERFACE_COUNT);
+
+static const GBinderClientIfaceInfo test_modem_config_aidl_resp_info[] = {
+    { RADIO_CONFIG_AIDL_RESPONSE, RADIO_CONFIG_AIDL_1_RESP_LAST }
+};
+
+static const GBinderClientIfaceInfo test_modem_config_aidl_ind_info[] = {
+    { RADIO_CONFIG_AIDL_INDICATION, RADIO_CONFIG_AIDL_1_IND_LAST }
+};
+
+#define TEST_MODEM_AIDL_DESC_(X,resp_ack,ack_req,ril_connected) { \
+    RADIO_##X, \
+    { RADIO_##X##_RESPONSE, RADIO_##X##_1_RESP_LAST }, \
+    { RADIO_##X##_INDICATION, RADIO_##X##_1_IND_LAST }, \
+    RADIO_##X##_REQ_SET_RESPONSE_FUNCTIONS, \
+    resp_ack, ack_req, ril_connected }
+#define TEST_MODEM_AIDL_DESC(X) TEST_MODEM_AIDL_DESC_(X, \
+    RADIO_##X##_REQ_RESPONSE_ACKNOWLEDGEMENT, \
+    RADIO_##X##_RESP_ACKNOWLEDGE_REQUEST, 0)
+
+/* The order of these must match the RADIO_AIDL_INTERFACE enum */
+static const TestModemAidlDesc test_modem_aidl[] = {
+    TEST_MODEM_AIDL_DESC(DATA),
+    TEST_MODEM_AIDL_DESC_(IMS, 0, 0, 0),
+    TEST_MODEM_AIDL_DESC(MESSAGING),
+    TEST_MODEM_AIDL_DESC_(MODEM,
+        RADIO_MODEM_REQ_RESPONSE_ACKNOWLEDGEMENT,
+        RADIO_MODEM_RESP_ACKNOWLEDGE_REQUEST,
+        RADIO_MODEM_IND_RIL_CONNECTED),
+    TEST_MODEM_AIDL_DESC(NETWORK),
+    TEST_MODEM_AIDL_DESC(SIM),
+    TEST_MODEM_AIDL_DESC(VOICE)
+};
+G_STATIC_ASSERT(G_N_ELEMENTS(test_modem_aidl) == RADIO_AIDL_INTERFACE_COUNT);
+
+#define TEST_MODEM_RESP_(req,resp,Name,NAME) case req: return resp;
+
+static
+guint
+test_modem_aidl_resp(
+    RADIO_AIDL_INTERFACE iface,
+    guint code)
+{
+    switch (iface) {
+    case RADIO_DATA_INTERFACE:
+        switch (code) { RADIO_DATA_CALL_1(TEST_MODEM_RESP_) }
+        break;
+    case RADIO_IMS_INTERFACE:
+        switch (code) { RADIO_IMS_CALL_1(TEST_MODEM_RESP_) }
+        break;
+    case RADIO_MESSAGING_INTERFACE:
+        switch (code) { RADIO_MESSAGING_CALL_1(TEST_MODEM_RESP_) }
+        break;
+    case RADIO_MODEM_INTERFACE:
+        switch (code) { RADIO_MODEM_CALL_1(TEST_MODEM_RESP_) }
+        break;
+    case RADIO_NETWORK_INTERFACE:
+        switch (code) { RADIO_NETWORK_CALL_1(TEST_MODEM_RESP_) }
+        break;
+    case RADIO_SIM_INTERFACE:
+        switch (code) { RADIO_SIM_CALL_1(TEST_MODEM_RESP_) }
+        break;
+    case RADIO_VOICE_INTERFACE:
+        switch (code) { RADIO_VOICE_CALL_1(TEST_MODEM_RESP_) }
+        break;
+    case RADIO_AIDL_INTERFACE_NONE:
+    case RADIO_AIDL_INTERFACE_COUNT:
+        break;
+    }
+    return 0;
+}
+
+static
+guint
+test_modem_resp_code(
+    TestModem* self,
+    guint code)
+{
+    switch (self->type) {
+    case TEST_MODEM_RADIO:
+        return radio_req_resp2(code, self->version);
+    case TEST_MODEM_RADIO_AIDL:
+        return test_modem_aidl_resp(self->version, code);
+    case TEST_MODEM_CONFIG:
+        if (code == RADIO_CONFIG_REQ_GET_SIM_SLOTS_STATUS &&
+            self->version >= RADIO_CONFIG_INTERFACE_1_2) {
+            return RADIO_CONFIG_RESP_GET_SIM_SLOTS_STATUS_1_2;
+        }
+        switch (code) {
+        RADIO_CONFIG_CALL_1_0(TEST_MODEM_RESP_)
+        RADIO_CONFIG_CALL_1_1(TEST_MODEM_RESP_)
+        }
+        break;
+    case TEST_MODEM_CONFIG_AIDL:
+        switch (code) { RADIO_CONFIG_AIDL_CALL_1(TEST_MODEM_RESP_) }
+        break;
+    }
+    return 0;
+}
+
+#undef TEST_MODEM_RESP_
+
+static
+gboolean
+test_modem_roll(
+    TestModem* self,
+    guint percent)
+{
+    return percent && g_rand_int_range(self->rand, 0, 100) < (gint32) percent;
+}
+
+static
+void
+test_modem_timer_stop(
+    TestModemTimer* timer)
+{
+    if (timer->source) {
+        if (timer->clock) {
+            test_clock_remove(timer->clock, timer->source);
+        } else {
+            g_source_remove(timer->source);
+        }
+        timer->source = 0;
+    }
+}
+
+static
+void
+test_modem_timer_free(
+    gpointer data)
+{
+    TestModemTimer* timer = data;
+
+    test_modem_timer_stop(timer);
+    gbinder_local_request_unref(timer->tx);
+    g_free(timer);
+}
+
+static
+gboolean
+test_modem_timer_fire(
+    gpointer data);
+
+static
+void
+test_modem_timer_start(
+    TestModemTimer* timer,
+    guint ms)
+{
+    TestModem* self = timer->modem;
+
+    timer->clock = self->clock;
+    if (timer->clock) {
+        timer->source = test_clock_add(timer->clock, ms,
+            test_modem_timer_fire, timer, NULL);
+    } else {
+        timer->source = g_timeout_add(ms, test_modem_timer_fire, timer);
+    }
+}
+
+static
+TestModemTimer*
+test_modem_timer_new(
+    TestModem* self,
+    guint code)
+{
+    TestModemTimer* timer = g_new0(TestModemTimer, 1);
+
+    timer->modem = self;
+    timer->id = ++self->last_id;
+    timer->code = code;
+    g_hash_table_insert(self->timers, GUINT_TO_POINTER(timer->id), timer);
+    return timer;
+}
+
+static
+gboolean
+test_modem_timer_fire(
+    gpointer data)
+{
+    TestModemTimer* timer = data;
+    TestModem* self = timer->modem;
+
+    timer->source = 0;
+    if (timer->tx) {
+        gbinder_client_transact(self->resp_client, timer->code,
+            GBINDER_TX_FLAG_ONEWAY, timer->tx, NULL, NULL, NULL);
+        self->stats.responses++;
+        if (timer->error) {
+            self->stats.errors++;
+        }
+        g_hash_table_remove(self->timers, GUINT_TO_POINTER(timer->id));
+    } else {
+        const gpointer key = GUINT_TO_POINTER(timer->id);
+
+        test_modem_indication(self, timer->code, timer->type, NULL, 0);
+        /* The handler may have removed the stream */
+        if (g_hash_table_lookup(self->timers, key) == timer) {
+            if (timer->remaining && !--timer->remaining) {
+                g_hash_table_remove(self->timers, key);
+            } else {
+                test_modem_timer_start(timer, timer->interval_ms);
+            }
+        }
+    }
+    return G_SOURCE_REMOVE;
+}
+
+static
+gboolean
+test_modem_connect(
+    gpointer user_data)
+{
+    TestModem* self = user_data;
+
+    self->connect_id = 0;
+    test_modem_indication(self, self->ril_connected, RADIO_IND_UNSOLICITED,
+        NULL, 0);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+test_modem_set_response_functions(
+    TestModem* self,
+    GBinderReader* reader)
+{
+    GBinderRemoteObject* resp = gbinder_reader_read_object(reader);
+    GBinderRemoteObject* ind = gbinder_reader_read_object(reader);
+
+    gbinder_client_unref(self->resp_client);
+    gbinder_client_unref(self->ind_client);
+    self->resp_client = gbinder_client_new2(resp, self->resp_info,
+        self->resp_count);
+    self->ind_client = gbinder_client_new2(ind, self->ind_info,
+        self->ind_count);
+    gbinder_remote_object_unref(resp);
+    gbinder_remote_object_unref(ind);
+
+    /* Don't call back from inside the transaction */
+    if (self->ril_connected && !self->connect_id) {
+        self->connect_id = g_idle_add(test_modem_connect, self);
+    }
+}
+
+static
+void
+test_modem_request(
+    TestModem* self,
+    guint code,
+    GBinderReader* reader)
+{
+    const guint resp = test_modem_resp_code(self, code);
+    guint32 serial = 0;
+
+    self->stats.requests++;
+    gbinder_reader_read_uint32(reader, &serial);
+    if (!resp || !self->resp_client) {
+        GDEBUG("No response to request %u", code);
+        self->stats.unknown++;
+    } else if (test_modem_roll(self, self->params.drop_percent)) {
+        GDEBUG("Dropping request %u serial %u", code, serial);
+        self->stats.dropped++;
+    } else {
+        const TestModemParams* params = &self->params;
+        GBinderLocalRequest* tx;
+        GBinderWriter writer;
+        RadioResponseInfo info;
+        TestModemTimer* timer;
+        guint latency = params->min_latency_ms;
+
+        memset(&info, 0, sizeof(info));
+        info.type = RADIO_RESP_SOLICITED;
+        info.serial = serial;
+        if (self->ack_req && test_modem_roll(self, params->ack_percent)) {
+            tx = gbinder_client_new_request2(self->resp_client,
+                self->ack_req);
+            gbinder_local_request_init_writer(tx, &writer);
+            gbinder_writer_append_int32(&writer, serial);
+            gbinder_client_transact(self->resp_client, self->ack_req,
+                GBINDER_TX_FLAG_ONEWAY, tx, NULL, NULL, NULL);
+            gbinder_local_request_unref(tx);
+            self->stats.ack_requests++;
+            info.type = RADIO_RESP_SOLICITED_ACK;
+        } else if (self->resp_ack &&
+            test_modem_roll(self, params->ack_exp_percent)) {
+            info.type = RADIO_RESP_SOLICITED_ACK_EXP;
+        }
+        if (test_modem_roll(self, params->error_percent)) {
+            info.error = params->error ? params->error :
+                RADIO_ERROR_GENERIC_FAILURE;
+        }
+
+        /* The response is built right away, from the request arguments */
+        tx = gbinder_client_new_request2(self->resp_client, resp);
+        gbinder_local_request_init_writer(tx, &writer);
+        gbinder_writer_append_buffer_object(&writer, &info, sizeof(info));
+        if (self->payload_func) {
+            self->payload_func(self, code, resp, reader, &writer,
+                self->payload_data);
+        }
+
+        if (params->max_latency_ms > params->min_latency_ms) {
+            latency += g_rand_int_range(self->rand, 0,
+                params->max_latency_ms - params->min_latency_ms + 1);
+        }
+
+        timer = test_modem_timer_new(self, resp);
+        timer->tx = tx;
+        timer->error = (info.error != RADIO_ERROR_NONE);
+        test_modem_timer_start(timer, latency);
+    }
+}
+
+static
+GBinderLocalReply*
+test_modem_txproc(
+    GBinderLocalObject* obj,
+    GBinderRemoteRequest* req,
+    guint code,
+    guint flags,
+    int* status,
+    void* user_data)
+{
+    TestModem* self = user_data;
+    GBinderReader reader;
+
+    gbinder_remote_request_init_reader(req, &reader);
+    if (code == self->set_response_functions) {
+        test_modem_set_response_functions(self, &reader);
+    } else if (self->resp_ack && code == self->resp_ack) {
+        self->stats.acks++;
+    } else {
+        test_modem_request(self, code, &reader);
+    }
+    *status = GBINDER_STATUS_OK;
+    return NULL;
+}
+
+static
+void
+test_modem_add_service(
+    TestModem* self,
+    const char* fqname)
+{
+    g_ptr_array_add(self->services, test_gbinder_servicemanager_new_service
+        (self->sm, fqname, self->obj));
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+TestModem*
+test_modem_new(
+    TEST_MODEM_TYPE type,
+    int version,
+    const char* slot)
+{
+    TestModem* self = g_new0(TestModem, 1);
+    const TestModemAidlDesc* aidl;
+    char* fqname;
+    int i;
+
+    self->type = type;
+    self->version = version;
+    self->rand = g_rand_new_with_seed(0);
+    self->timers = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+        NULL, test_modem_timer_free);
+    self->services = g_ptr_array_new_with_free_func((GDestroyNotify)
+        gbinder_remote_object_unref);
+    self->dev = (type == TEST_MODEM_RADIO || type == TEST_MODEM_CONFIG) ?
+        GBINDER_DEFAULT_HWBINDER : GBINDER_DEFAULT_BINDER;
+    self->sm = gbinder_servicemanager_new(self->dev);
+    self->obj = test_gbinder_local_object_new(NULL, test_modem_txproc, self);
+
+    switch (type) {
+    case TEST_MODEM_RADIO:
+        g_assert_cmpint(version, >= ,RADIO_INTERFACE_1_0);
+        g_assert_cmpint(version, < ,RADIO_INTERFACE_COUNT);
+        i = RADIO_INTERFACE_COUNT - version - 1;
+        self->resp_info = test_modem_radio_resp_info + i;
+        self->ind_info = test_modem_radio_ind_info + i;
+        self->resp_count = self->ind_count = RADIO_INTERFACE_COUNT - i;
+        self->set_response_functions = RADIO_REQ_SET_RESPONSE_FUNCTIONS;
+        self->resp_ack = RADIO_REQ_RESPONSE_ACKNOWLEDGEMENT;
+        self->ack_req = RADIO_RESP_ACKNOWLEDGE_REQUEST;
+        self->ril_connected = RADIO_IND_RIL_CONNECTED;
+        fqname = g_strconcat(test_modem_radio_ifaces[version], "/",
+            slot, NULL);
+        test_modem_add_service(self, fqname);
+        g_free(fqname);
+        break;
+    case TEST_MODEM_RADIO_AIDL:
+        g_assert_cmpint(version, >= ,RADIO_AIDL_INTERFACE_NONE + 1);
+        g_assert_cmpint(version, < ,RADIO_AIDL_INTERFACE_COUNT);
+        aidl = test_modem_aidl + version;
+        self->resp_info = &aidl->resp_info;
+        self->ind_info = &aidl->ind_info;
+        self->resp_count = self->ind_count = 1;
+        self->set_response_functions = aidl->set_response_functions;
+        self->resp_ack = aidl->resp_ack;
+        self->ack_req = aidl->ack_req;
+        self->ril_connected = aidl->ril_connected;
+        fqname = g_strconcat(aidl->iface, "/", slot, NULL);
+        test_modem_add_service(self, fqname);
+        g_free(fqname);
+        break;
+    case TEST_MODEM_CONFIG:
+        g_assert_cmpint(version, >= ,RADIO_CONFIG_INTERFACE_1_0);
+        g_assert_cmpint(version, <= ,RADIO_CONFIG_INTERFACE_MAX);
+        i = RADIO_CONFIG_INTERFACE_MAX - version;
+        self->resp_info = test_modem_config_resp_info + i;
+        self->ind_info = test_modem_config_ind_info + i;
+        self->resp_count = self->ind_count = RADIO_CONFIG_INTERFACE_COUNT - i;
+        self->set_response_functions = RADIO_CONFIG_REQ_SET_RESPONSE_FUNCTIONS;
+        for (i = RADIO_CONFIG_INTERFACE_1_0; i <= version; i++) {
+            test_modem_add_service(self, test_modem_config_fqnames[i]);
+        }
+        break;
+    case TEST_MODEM_CONFIG_AIDL:
+        self->resp_info = test_modem_config_aidl_resp_info;
+        self->ind_info = test_modem_config_aidl_ind_info;
+        self->resp_count = self->ind_count = 1;
+        self->set_response_functions =
+            RADIO_CONFIG_AIDL_REQ_SET_RESPONSE_FUNCTIONS;
+        test_modem_add_service(self, RADIO_CONFIG_AIDL_FQNAME);
+        break;
+    default:
+        g_assert_not_reached();
+    }
+    return self;
+}
+
+void
+test_modem_free(
+    TestModem* self)
+{
+    if (self) {
+        if (self->connect_id) {
+            g_source_remove(self->connect_id);
+        }
+        g_hash_table_destroy(self->timers);
+        g_ptr_array_free(self->services, TRUE);
+        gbinder_client_unref(self->resp_client);
+        gbinder_client_unref(self->ind_client);
+        gbinder_local_object_unref(self->obj);
+        gbinder_servicemanager_unref(self->sm);
+        g_rand_free(self->rand);
+        g_free(self);
+    }
+}
+
+const char*
+test_modem_dev(
+    TestModem* self)
+{
+    return self->dev;
+}
+
+gboolean
+test_modem_connected(
+    TestModem* self)
+{
+    return self->resp_client && self->ind_client;
+}
+
+void
+test_modem_set_params(
+    TestModem* self,
+    const TestModemParams* params)
+{
+    if (params) {
+        self->params = *params;
+    } else {
+        memset(&self->params, 0, sizeof(self->params));
+    }
+    g_rand_set_seed(self->rand, self->params.seed);
+}
+
+void
+test_modem_set_clock(
+    TestModem* self,
+    TestClock* clock)
+{
+    /* Pending timers stay with the clock they have been started on */
+    self->clock = clock;
+}
+
+void
+test_modem_set_payload_func(
+    TestModem* self,
+    TestModemPayloadFunc func,
+    gpointer user_data)
+{
+    self->payload_func = func;
+    self->payload_data = user_data;
+}
+
+void
+test_modem_get_stats(
+    TestModem* self,
+    TestModemStats* stats)
+{
+    *stats = self->stats;
+}
+
+gboolean
+test_modem_indication(
+    TestModem* self,
+    guint code,
+    RADIO_IND_TYPE type,
+    const void* data,
+    gsize size)
+{
+    GBinderLocalRequest* req = self->ind_client ?
+        gbinder_client_new_request2(self->ind_client, code) : NULL;
+
+    if (req) {
+        GBinderWriter writer;
+
+        gbinder_local_request_init_writer(req, &writer);
+        gbinder_writer_append_int32(&writer, type);
+        if (size) {
+            gbinder_writer_append_buffer_object(&writer, data, size);
+        }
+        gbinder_client_transact_sync_oneway(self->ind_client, code, req);
+        gbinder_local_request_unref(req);
+        self->stats.indications++;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+guint
+test_modem_add_indication_stream(
+    TestModem* self,
+    guint code,
+    RADIO_IND_TYPE type,
+    guint interval_ms,
+    guint count)
+{
+    TestModemTimer* timer = test_modem_timer_new(self, code);
+
+    timer->type = type;
+    timer->interval_ms = interval_ms;
+    timer->remaining = count;
+    test_modem_timer_start(timer, interval_ms);
+    return timer->id;
+}
+
+void
+test_modem_remove_indication_stream(
+    TestModem* self,
+    guint id)
+{
+    TestModemTimer* timer = g_hash_table_lookup(self->timers,
+        GUINT_TO_POINTER(id));
+
+    if (timer && !timer->tx) {
+        g_hash_table_remove(self->timers, GUINT_TO_POINTER(id));
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef TEST_MODEM_H
+#define TEST_MODEM_H
+
+#include "test_clock.h"
+
+#include <radio_config_types.h>
+#include <radio_types.h>
+
+#include <gbinder_types.h>
+
+/*
+ * Simulated IRadio/IRadioConfig service on top of the fake binder.
+ *
+ * Answers every request code it knows a response for, with configurable
+ * latency, error rate, dropped responses and acks. The response carries
+ * RadioResponseInfo and whatever the payload callback writes after it.
+ * Latency is measured by the TestClock if one is set, otherwise real
+ * GLib timeouts are used.
+ */
+
+typedef enum test_modem_type {
+    TEST_MODEM_RADIO,           /* HIDL IRadio 1.0..1.5 */
+    TEST_MODEM_RADIO_AIDL,      /* One of the AIDL IRadio* services */
+    TEST_MODEM_CONFIG,          /* HIDL IRadioConfig 1.0..1.2 */
+    TEST_MODEM_CONFIG_AIDL      /* AIDL IRadioConfig */
+} TEST_MODEM_TYPE;
+
+typedef struct test_modem TestModem;
+
+typedef struct test_modem_params {
+    guint min_latency_ms;       /* Latency is uniformly distributed */
+    guint max_latency_ms;       /* between min and max */
+    guint error_percent;        /* Responses carrying an error */
+    RADIO_ERROR error;          /* RADIO_ERROR_GENERIC_FAILURE if NONE */
+    guint drop_percent;         /* Requests which never get a response */
+    guint ack_percent;          /* acknowledgeRequest before the response */
+    guint ack_exp_percent;      /* Responses asking for an ack */
+    guint32 seed;
+} TestModemParams;
+
+typedef struct test_modem_stats {
+    guint requests;             /* Requests received */
+    guint responses;            /* Responses sent */
+    guint errors;               /* ... of which carried an error */
+    guint dropped;              /* Requests left without a response */
+    guint unknown;              /* Requests without a known response */
+    guint ack_requests;         /* acknowledgeRequest sent */
+    guint acks;                 /* responseAcknowledgement received */
+    guint indications;          /* Indications sent */
+} TestModemStats;
+
+/* Writes the response payload after RadioResponseInfo */
+typedef
+void
+(*TestModemPayloadFunc)(
+    TestModem* modem,
+    guint req,
+    guint resp,
+    GBinderReader* args,
+    GBinderWriter* payload,
+    gpointer user_data);
+
+/*
+ * The meaning of the version depends on the type, it's RADIO_INTERFACE,
+ * RADIO_AIDL_INTERFACE, RADIO_CONFIG_INTERFACE or ignored for AIDL
+ * IRadioConfig. The slot is ignored for IRadioConfig.
+ */
+TestModem*
+test_modem_new(
+    TEST_MODEM_TYPE type,
+    int version,
+    const char* slot);
+
+void
+test_modem_free(
+    TestModem* modem);
+
+const char*
+test_modem_dev(
+    TestModem* modem);
+
+/* The modem has got the response and indication objects */
+gboolean
+test_modem_connected(
+    TestModem* modem);
+
+void
+test_modem_set_params(
+    TestModem* modem,
+    const TestModemParams* params); /* NULL to answer without delay */
+
+void
+test_modem_set_clock(
+    TestModem* modem,
+    TestClock* clock); /* NULL for GLib timeouts */
+
+void
+test_modem_set_payload_func(
+    TestModem* modem,
+    TestModemPayloadFunc func,
+    gpointer user_data);
+
+void
+test_modem_get_stats(
+    TestModem* modem,
+    TestModemStats* stats);
+
+/* Sends the indication right away */
+gboolean
+test_modem_indication(
+    TestModem* modem,
+    guint code,
+    RADIO_IND_TYPE type,
+    const void* data,
+    gsize size);
+
+/* Sends the indication every interval_ms, count times (zero - forever) */
+guint
+test_modem_add_indication_stream(
+    TestModem* modem,
+    guint code,
+    RADIO_IND_TYPE type,
+    guint interval_ms,
+    guint count);
+
+void
+test_modem_remove_indication_stream(
+    TestModem* modem,
+    guint id);
+
+#endif /* TEST_MODEM_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,595 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "test_replay.h"
+#include "test_common.h"
+#include "test_gbinder.h"
+
+#include "radio_client.h"
+#include "radio_instance.h"
+#include "radio_recorder.h"
+#include "radio_request_p.h"
+
+#include <gutil_log.h>
+
+#define TEST_REPLAY_DEV GBINDER_DEFAULT_HWBINDER
+#define TEST_REPLAY_SLOT "slot1"
+
+struct test_replay {
+    void* image;
+    GPtrArray* records;
+    gsize max_data;
+    RADIO_INTERFACE version;
+    double speed;
+    gint64 t0;
+    gint64 start;
+    guint next;
+    GMainLoop* loop;
+    GBinderServiceManager* sm;
+    GBinderLocalObject* service;
+    GBinderRemoteObject* remote;
+    GBinderClient* resp_client;
+    GBinderClient* ind_client;
+    RadioInstance* radio;
+    RadioClient* client;
+    GHashTable* reqs;       /* Recorded serial => RadioRequest */
+    GHashTable* seen;       /* Serials seen by the service */
+    GHashTable* waiting;    /* RadioRequest => GSList of RadioRecord */
+    TestReplayStats stats;
+};
+
+typedef struct test_replay_req {
+    TestReplay* replay;
+    guint32 serial;
+} TestReplayReq;
+
+static const GBinderClientIfaceInfo test_replay_ind_iface_info[] = {
+    {RADIO_INDICATION_1_5, RADIO_1_5_IND_LAST },
+    {RADIO_INDICATION_1_4, RADIO_1_4_IND_LAST },
+    {RADIO_INDICATION_1_3, RADIO_1_3_IND_LAST },
+    {RADIO_INDICATION_1_2, RADIO_1_2_IND_LAST },
+    {RADIO_INDICATION_1_1, RADIO_1_1_IND_LAST },
+    {RADIO_INDICATION_1_0, RADIO_1_0_IND_LAST }
+};
+
+static const GBinderClientIfaceInfo test_replay_resp_iface_info[] = {
+    {RADIO_RESPONSE_1_5, RADIO_1_5_RESP_LAST },
+    {RADIO_RESPONSE_1_4, RADIO_1_4_RESP_LAST },
+    {RADIO_RESPONSE_1_3, RADIO_1_3_RESP_LAST },
+    {RADIO_RESPONSE_1_2, RADIO_1_2_RESP_LAST },
+    {RADIO_RESPONSE_1_1, RADIO_1_1_RESP_LAST },
+    {RADIO_RESPONSE_1_0, RADIO_1_0_RESP_LAST }
+};
+
+static const char* const test_replay_fqnames[] = {
+    RADIO_1_0 "/" TEST_REPLAY_SLOT,
+    RADIO_1_1 "/" TEST_REPLAY_SLOT,
+    RADIO_1_2 "/" TEST_REPLAY_SLOT,
+    RADIO_1_3 "/" TEST_REPLAY_SLOT,
+    RADIO_1_4 "/" TEST_REPLAY_SLOT,
+    RADIO_1_5 "/" TEST_REPLAY_SLOT
+};
+G_STATIC_ASSERT(G_N_ELEMENTS(test_replay_fqnames) == RADIO_INTERFACE_COUNT);
+
+static
+int
+test_replay_compare_records(
+    gconstpointer a,
+    gconstpointer b)
+{
+    const RadioRecord* r1 = *(const RadioRecord**)a;
+    const RadioRecord* r2 = *(const RadioRecord**)b;
+
+    return (r1->seq < r2->seq) ? (-1) : (r1->seq > r2->seq) ? 1 : 0;
+}
+
+static
+void
+test_replay_append_payload(
+    TestReplay* self,
+    GBinderWriter* writer,
+    const RadioRecord* rec)
+{
+    if (rec->size) {
+        /* Pad the truncated part with zeros */
+        guint8* buf = g_malloc0(rec->size);
+
+        memcpy(buf, rec + 1, MIN(rec->size, self->max_data));
+        gbinder_writer_append_buffer_object(writer, buf, rec->size);
+        g_free(buf);
+    }
+}
+
+static
+guint32
+test_replay_live_serial(
+    RadioRequest* req)
+{
+    return req->serial2 ? req->serial2 : req->serial;
+}
+
+static
+void
+test_replay_send_response(
+    TestReplay* self,
+    const RadioRecord* rec,
+    guint32 serial)
+{
+    GBinderLocalRequest* resp = gbinder_client_new_request2(self->resp_client,
+        rec->code);
+
+    if (resp) {
+        RadioResponseInfo info;
+        GBinderWriter writer;
+
+        memset(&info, 0, sizeof(info));
+        info.type = RADIO_RESP_SOLICITED;
+        info.serial = serial;
+        info.error = rec->extra;
+        gbinder_local_request_init_writer(resp, &writer);
+        gbinder_writer_append_buffer_object(&writer, &info, sizeof(info));
+        test_replay_append_payload(self, &writer, rec);
+        gbinder_client_transact(self->resp_client, rec->code,
+            GBINDER_TX_FLAG_ONEWAY, resp, NULL, NULL, NULL);
+        gbinder_local_request_unref(resp);
+        self->stats.responses++;
+    } else {
+        self->stats.skipped++;
+    }
+}
+
+static
+void
+test_replay_request_seen(
+    TestReplay* self,
+    guint32 serial)
+{
+    GHashTableIter it;
+    gpointer key, value;
+
+    g_hash_table_add(self->seen, GUINT_TO_POINTER(serial));
+    g_hash_table_iter_init(&it, self->waiting);
+    while (g_hash_table_iter_next(&it, &key, &value)) {
+        if (test_replay_live_serial(key) == serial) {
+            GSList* l;
+
+            /* Responses which were due before the request arrived */
+            value = g_slist_reverse(value);
+            for (l = value; l; l = l->next) {
+                test_replay_send_response(self, l->data, serial);
+            }
+            g_slist_free(value);
+            g_hash_table_iter_remove(&it);
+            break;
+        }
+    }
+}
+
+static
+GBinderLocalReply*
+test_replay_txproc(
+    GBinderLocalObject* obj,
+    GBinderRemoteRequest* req,
+    guint code,
+    guint flags,
+    int* status,
+    void* user_data)
+{
+    TestReplay* self = user_data;
+    GBinderReader reader;
+    guint32 serial;
+
+    gbinder_remote_request_init_reader(req, &reader);
+    switch (code) {
+    case RADIO_REQ_SET_RESPONSE_FUNCTIONS:
+        {
+            GBinderRemoteObject* resp = gbinder_reader_read_object(&reader);
+            GBinderRemoteObject* ind = gbinder_reader_read_object(&reader);
+
+            gbinder_client_unref(self->resp_client);
+            gbinder_client_unref(self->ind_client);
+            self->resp_client = gbinder_client_new2(resp,
+                TEST_ARRAY_AND_COUNT(test_replay_resp_iface_info));
+            self->ind_client = gbinder_client_new2(ind,
+                TEST_ARRAY_AND_COUNT(test_replay_ind_iface_info));
+            gbinder_remote_object_unref(resp);
+            gbinder_remote_object_unref(ind);
+        }
+        break;
+    case RADIO_REQ_RESPONSE_ACKNOWLEDGEMENT:
+        self->stats.acks++;
+        break;
+    default:
+        if (gbinder_reader_read_uint32(&reader, &serial)) {
+            test_replay_request_seen(self, serial);
+        }
+        break;
+    }
+    *status = GBINDER_STATUS_OK;
+    return NULL;
+}
+
+static
+void
+test_replay_complete(
+    RadioRequest* req,
+    RADIO_TX_STATUS status,
+    RADIO_RESP resp,
+    RADIO_ERROR error,
+    const GBinderReader* args,
+    gpointer user_data)
+{
+    TestReplayReq* data = user_data;
+    TestReplay* self = data->replay;
+    const gpointer key = GUINT_TO_POINTER(data->serial);
+
+    if (status == RADIO_TX_STATUS_OK) {
+        self->stats.completed++;
+    } else {
+        self->stats.failed++;
+    }
+    g_hash_table_remove(self->waiting, req);
+    if (g_hash_table_lookup(self->reqs, key) == req) {
+        g_hash_table_remove(self->reqs, key);
+    }
+}
+
+static
+void
+test_replay_request(
+    TestReplay* self,
+    const RadioRecord* rec)
+{
+    TestReplayReq* data;
+    GBinderWriter writer;
+    RadioRequest* req;
+
+    switch ((RADIO_REQ) rec->code) {
+    case RADIO_REQ_SET_RESPONSE_FUNCTIONS:
+    case RADIO_REQ_RESPONSE_ACKNOWLEDGEMENT:
+        /* RadioInstance issues these by itself */
+        self->stats.skipped++;
+        return;
+    default:
+        break;
+    }
+
+    data = g_new(TestReplayReq, 1);
+    data->replay = self;
+    data->serial = rec->serial;
+    req = radio_request_new(self->client, rec->code, &writer,
+        test_replay_complete, g_free, data);
+    test_replay_append_payload(self, &writer, rec);
+    if (radio_request_submit(req)) {
+        g_hash_table_insert(self->reqs, GUINT_TO_POINTER(rec->serial), req);
+        self->stats.requests++;
+    } else {
+        radio_request_unref(req);
+        self->stats.skipped++;
+    }
+}
+
+static
+void
+test_replay_response(
+    TestReplay* self,
+    const RadioRecord* rec)
+{
+    RadioRequest* req = g_hash_table_lookup(self->reqs,
+        GUINT_TO_POINTER(rec->serial));
+
+    if (req) {
+        const guint32 serial = test_replay_live_serial(req);
+
+        if (g_hash_table_contains(self->seen, GUINT_TO_POINTER(serial))) {
+            test_replay_send_response(self, rec, serial);
+        } else {
+            /* Hold it until the service receives the request */
+            g_hash_table_insert(self->waiting, req, g_slist_prepend
+                (g_hash_table_lookup(self->waiting, req), (gpointer) rec));
+        }
+    } else {
+        /* The request is not in the capture */
+        self->stats.skipped++;
+    }
+}
+
+static
+void
+test_replay_indication(
+    TestReplay* self,
+    const RadioRecord* rec)
+{
+    GBinderLocalRequest* ind = gbinder_client_new_request2(self->ind_client,
+        rec->code);
+
+    if (ind) {
+        GBinderWriter writer;
+
+        gbinder_local_request_init_writer(ind, &writer);
+        gbinder_writer_append_int32(&writer, rec->extra);
+        test_replay_append_payload(self, &writer, rec);
+        gbinder_client_transact(self->ind_client, rec->code,
+            GBINDER_TX_FLAG_ONEWAY, ind, NULL, NULL, NULL);
+        gbinder_local_request_unref(ind);
+        self->stats.indications++;
+    } else {
+        self->stats.skipped++;
+    }
+}
+
+static
+gboolean
+test_replay_done(
+    gpointer user_data)
+{
+    TestReplay* self = user_data;
+
+    /* Everything at higher priority has been handled by now */
+    g_main_loop_quit(self->loop);
+    return G_SOURCE_REMOVE;
+}
+
+static
+gboolean
+test_replay_step(
+    gpointer user_data)
+{
+    TestReplay* self = user_data;
+    GPtrArray* records = self->records;
+
+    while (self->next < records->len) {
+        const RadioRecord* rec = records->pdata[self->next];
+
+        if (self->speed > 0) {
+            const gint64 due = self->start +
+                (gint64) ((rec->time - self->t0) / self->speed);
+            const gint64 now = g_get_monotonic_time();
+
+            if (due > now) {
+                g_timeout_add((guint) ((due - now + 999) / 1000),
+                    test_replay_step, self);
+                return G_SOURCE_REMOVE;
+            }
+        }
+
+        self->next++;
+        switch (rec->type) {
+        case RADIO_RECORD_REQUEST:
+            test_replay_request(self, rec);
+            break;
+        case RADIO_RECORD_RESPONSE:
+            test_replay_response(self, rec);
+            break;
+        case RADIO_RECORD_INDICATION:
+            test_replay_indication(self, rec);
+            break;
+        default:
+            self->stats.skipped++;
+            break;
+        }
+
+        if (self->speed <= 0) {
+            /* Let the transactions flow between the records */
+            g_idle_add(test_replay_step, self);
+            return G_SOURCE_REMOVE;
+        }
+    }
+
+    g_idle_add_full(G_PRIORITY_LOW, test_replay_done, self, NULL);
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+test_replay_connect(
+    TestReplay* self)
+{
+    const RADIO_IND code = RADIO_IND_RIL_CONNECTED;
+    GBinderLocalRequest* ind = gbinder_client_new_request2(self->ind_client,
+        code);
+
+    gbinder_local_request_append_int32(ind, RADIO_IND_UNSOLICITED);
+    g_assert_cmpint(gbinder_client_transact_sync_oneway(self->ind_client,
+        code, ind), == ,GBINDER_STATUS_OK);
+    gbinder_local_request_unref(ind);
+    g_assert(radio_client_connected(self->client));
+}
+
+static
+void
+test_replay_free_waiting(
+    gpointer list)
+{
+    g_slist_free(list);
+}
+
+/*==========================================================================*
+ * API
+ *==========================================================================*/
+
+TestReplay*
+test_replay_new(
+    const void* image,
+    gsize size)
+{
+    const RadioRecorderHeader* hdr = image;
+
+    if (image && size >= sizeof(*hdr) &&
+        hdr->magic == RADIO_RECORDER_MAGIC &&
+        hdr->format == RADIO_RECORDER_FORMAT &&
+        hdr->header_size >= sizeof(*hdr) &&
+        hdr->slot_size >= sizeof(RadioRecord) &&
+        size >= hdr->header_size + (gsize) hdr->count * hdr->slot_size) {
+        TestReplay* self = g_new0(TestReplay, 1);
+        const guint8* ptr;
+        guint i;
+
+        self->image = gutil_memdup(image, size);
+        self->records = g_ptr_array_new();
+        self->max_data = hdr->slot_size - sizeof(RadioRecord);
+        self->version = RADIO_INTERFACE_NONE;
+        ptr = (guint8*) self->image + hdr->header_size;
+        for (i = 0; i < hdr->count; i++, ptr += hdr->slot_size) {
+            const RadioRecord* rec = (const RadioRecord*) ptr;
+
+            if (rec->seq && !(rec->flags & RADIO_RECORD_FLAG_CONFIG) &&
+                rec->interface_type == RADIO_INTERFACE_TYPE_HIDL &&
+                rec->interface >= RADIO_INTERFACE_1_0 &&
+                rec->interface < RADIO_INTERFACE_COUNT) {
+                g_ptr_array_add(self->records, (gpointer) rec);
+                self->version = MAX(self->version, rec->interface);
+            }
+        }
+        g_ptr_array_sort(self->records, test_replay_compare_records);
+        if (self->records->len) {
+            self->t0 = ((RadioRecord*)self->records->pdata[0])->time;
+        } else {
+            self->version = RADIO_INTERFACE_1_0;
+        }
+        GDEBUG("%u records to replay", self->records->len);
+        return self;
+    }
+    return NULL;
+}
+
+TestReplay*
+test_replay_new_from_file(
+    const char* file)
+{
+    TestReplay* self = NULL;
+    gchar* image = NULL;
+    gsize size = 0;
+
+    if (g_file_get_contents(file, &image, &size, NULL)) {
+        self = test_replay_new(image, size);
+        g_free(image);
+    }
+    return self;
+}
+
+void
+test_replay_free(
+    TestReplay* self)
+{
+    if (self) {
+        g_ptr_array_free(self->records, TRUE);
+        g_free(self->image);
+        g_free(self);
+    }
+}
+
+guint
+test_replay_count(
+    TestReplay* self)
+{
+    return self ? self->records->len : 0;
+}
+
+void
+test_replay_run(
+    TestReplay* self,
+    double speed,
+    TestReplayStats* stats)
+{
+    GHashTableIter it;
+    gpointer value;
+
+    memset(&self->stats, 0, sizeof(self->stats));
+    self->speed = speed;
+    self->next = 0;
+    self->loop = g_main_loop_new(NULL, FALSE);
+    self->sm = gbinder_servicemanager_new(TEST_REPLAY_DEV);
+    self->service = test_gbinder_local_object_new(NULL,
+        test_replay_txproc, self);
+    self->remote = test_gbinder_servicemanager_new_service(self->sm,
+        test_replay_fqnames[self->version], self->service);
+    self->radio = radio_instance_new_with_version(TEST_REPLAY_DEV,
+        TEST_REPLAY_SLOT, self->version);
+    g_assert(self->radio);
+    self->client = radio_client_new(self->radio);
+    self->reqs = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+        NULL, (GDestroyNotify) radio_request_unref);
+    self->seen = g_hash_table_new(g_direct_hash, g_direct_equal);
+    self->waiting = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+        NULL, test_replay_free_waiting);
+    test_replay_connect(self);
+
+    self->start = g_get_monotonic_time();
+    g_idle_add(test_replay_step, self);
+    g_main_loop_run(self->loop);
+    self->stats.elapsed = g_get_monotonic_time() - self->start;
+
+    /* Whatever is still there has never been answered */
+    g_hash_table_iter_init(&it, self->waiting);
+    while (g_hash_table_iter_next(&it, NULL, &value)) {
+        self->stats.skipped += g_slist_length(value);
+    }
+    g_hash_table_iter_init(&it, self->reqs);
+    while (g_hash_table_iter_next(&it, NULL, &value)) {
+        radio_request_cancel(value);
+        self->stats.unanswered++;
+    }
+    g_hash_table_destroy(self->waiting);
+    g_hash_table_destroy(self->reqs);
+    g_hash_table_destroy(self->seen);
+
+    radio_client_unref(self->client);
+    radio_instance_unref(self->radio);
+    gbinder_client_unref(self->resp_client);
+    gbinder_client_unref(self->ind_client);
+    gbinder_remote_object_unref(self->remote);
+    gbinder_local_object_unref(self->service);
+    gbinder_servicemanager_unref(self->sm);
+    g_main_loop_unref(self->loop);
+    self->client = NULL;
+    self->radio = NULL;
+    self->resp_client = self->ind_client = NULL;
+    self->remote = NULL;
+    self->service = NULL;
+    self->sm = NULL;
+    self->loop = NULL;
+    if (stats) {
+        *stats = self->stats;
+    }
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef TEST_REPLAY_H
+#define TEST_REPLAY_H
+
+#include <radio_types.h>
+
+/*
+ * Replays a file written by RadioRecorder against the fake binder.
+ *
+ * Recorded requests are submitted through RadioClient, recorded
+ * responses and indications are sent to RadioInstance by a fake IRadio
+ * service. Each response goes out with the serial of the live request
+ * it corresponds to and only after the fake service has seen that
+ * request. Parcel contents are replaced by an opaque buffer of the
+ * recorded size. Only the HIDL IRadio records are replayed.
+ *
+ * Speed 1.0 reproduces the original timing, larger values compress
+ * it and zero replays everything back to back.
+ */
+
+typedef struct test_replay TestReplay;
+
+typedef struct test_replay_stats {
+    guint requests;     /* Submitted through RadioClient */
+    guint completed;    /* Completed with RADIO_TX_STATUS_OK */
+    guint failed;       /* Completed with any other status */
+    guint unanswered;   /* Cancelled at the end of replay */
+    guint responses;    /* Response transactions sent */
+    guint indications;  /* Indication transactions sent */
+    guint acks;         /* responseAcknowledgement requests received */
+    guint skipped;      /* Records which couldn't be replayed */
+    gint64 elapsed;     /* Microseconds */
+} TestReplayStats;
+
+TestReplay*
+test_replay_new(
+    const void* image,
+    gsize size);
+
+TestReplay*
+test_replay_new_from_file(
+    const char* file);
+
+void
+test_replay_free(
+    TestReplay* replay);
+
+guint
+test_replay_count(
+    TestReplay* replay);
+
+void
+test_replay_run(
+    TestReplay* replay,
+    double speed,
+    TestReplayStats* stats);
+
+#endif /* TEST_REPLAY_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
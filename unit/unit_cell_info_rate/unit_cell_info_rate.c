@@ -0,0 +1,318 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+#include "test_common.h"
+#include "test_gbinder.h"
+#include "test_modem.h"
+
+#include "radio_cell_info_rate.h"
+#include "radio_client.h"
+#include "radio_instance.h"
+#include "radio_network_types.h"
+
+#include <gutil_log.h>
+
+#include <limits.h>
+
+#define SLOT "slot1"
+
+static TestOpt test_opt;
+
+typedef struct test_cell_info_rate {
+    guint code;
+    GArray* rates;
+    GMainLoop* loop;
+} TestCellInfoRate;
+
+static
+void
+test_drain(
+    void)
+{
+    while (g_main_context_iteration(NULL, FALSE));
+}
+
+static
+void
+test_payload(
+    TestModem* modem,
+    guint code,
+    guint resp,
+    GBinderReader* args,
+    GBinderWriter* payload,
+    gpointer user_data)
+{
+    TestCellInfoRate* test = user_data;
+    gint32 rate;
+
+    g_assert_cmpuint(code, == ,test->code);
+    g_assert(gbinder_reader_read_int32(args, &rate));
+    GDEBUG("Rate %d", rate);
+    g_array_append_val(test->rates, rate);
+    if (test->loop) {
+        g_main_loop_quit(test->loop);
+    }
+}
+
+static
+void
+test_init_rates(
+    TestCellInfoRate* test,
+    guint code)
+{
+    memset(test, 0, sizeof(*test));
+    test->code = code;
+    test->rates = g_array_new(FALSE, FALSE, sizeof(gint32));
+}
+
+static
+void
+test_check_rates(
+    TestCellInfoRate* test,
+    guint count,
+    gint32 last)
+{
+    g_assert_cmpuint(test->rates->len, == ,count);
+    if (count) {
+        g_assert_cmpint(g_array_index(test->rates, gint32, count - 1), == ,
+            last);
+    }
+}
+
+/*==========================================================================*
+ * null
+ *==========================================================================*/
+
+static
+void
+test_null(
+    void)
+{
+    g_assert(!radio_cell_info_rate_new(NULL));
+    g_assert(!radio_cell_info_rate_ref(NULL));
+    radio_cell_info_rate_unref(NULL);
+    radio_cell_info_rate_set_idle_timeout(NULL, 0);
+    g_assert(!radio_cell_info_rate_add(NULL, 1000));
+    radio_cell_info_rate_remove(NULL, 1);
+}
+
+/*==========================================================================*
+ * unsupported
+ *==========================================================================*/
+
+static
+void
+test_unsupported(
+    void)
+{
+    TestModem* modem = test_modem_new(TEST_MODEM_RADIO_AIDL,
+        RADIO_MODEM_INTERFACE, SLOT);
+    RadioInstance* instance =
+        radio_instance_new_with_modem_slot_version_and_interface
+            (test_modem_dev(modem), SLOT, NULL, 0, RADIO_INTERFACE_NONE,
+                RADIO_MODEM_INTERFACE);
+    RadioClient* client = radio_client_new(instance);
+    RadioCellInfoRate* rate = radio_cell_info_rate_new(client);
+    TestModemStats stats;
+
+    /* IRadioModem has no cell info */
+    g_assert(rate);
+    g_assert(radio_cell_info_rate_ref(rate) == rate);
+    radio_cell_info_rate_unref(rate);
+    radio_cell_info_rate_set_idle_timeout(rate, 0);
+    g_assert(!radio_cell_info_rate_add(rate, 1000));
+    radio_cell_info_rate_remove(rate, 1);
+    test_drain();
+
+    test_modem_get_stats(modem, &stats);
+    g_assert_cmpuint(stats.requests, == ,0);
+
+    radio_cell_info_rate_unref(rate);
+    radio_client_unref(client);
+    radio_instance_unref(instance);
+    test_modem_free(modem);
+}
+
+/*==========================================================================*
+ * basic
+ *==========================================================================*/
+
+static
+void
+test_basic(
+    void)
+{
+    TestModem* modem = test_modem_new(TEST_MODEM_RADIO, RADIO_INTERFACE_1_4,
+        SLOT);
+    RadioInstance* instance = radio_instance_new_with_version
+        (test_modem_dev(modem), SLOT, RADIO_INTERFACE_1_4);
+    RadioClient* client = radio_client_new(instance);
+    RadioCellInfoRate* rate = radio_cell_info_rate_new(client);
+    TestCellInfoRate test;
+    guint id[3];
+
+    test_init_rates(&test, RADIO_REQ_SET_CELL_INFO_LIST_RATE);
+    test_modem_set_payload_func(modem, test_payload, &test);
+    radio_cell_info_rate_set_idle_timeout(rate, 0);
+
+    /* Subscribed before the client gets connected */
+    g_assert(!radio_client_connected(client));
+    g_assert((id[0] = radio_cell_info_rate_add(rate, 5000)) != 0);
+    g_assert((id[1] = radio_cell_info_rate_add(rate, 2000)) != 0);
+    g_assert_cmpuint(id[0], != ,id[1]);
+    test_drain();
+    g_assert(radio_client_connected(client));
+    test_check_rates(&test, 1, 2000);
+
+    /* The most demanding one is gone */
+    radio_cell_info_rate_remove(rate, id[1]);
+    radio_cell_info_rate_remove(rate, id[1]);
+    test_drain();
+    test_check_rates(&test, 2, 5000);
+
+    /* Nothing changes */
+    g_assert((id[2] = radio_cell_info_rate_add(rate, 5000)) != 0);
+    radio_cell_info_rate_remove(rate, 0);
+    test_drain();
+    test_check_rates(&test, 2, 5000);
+
+    /* Every change, then nobody */
+    g_assert((id[1] = radio_cell_info_rate_add(rate, 0)) != 0);
+    test_drain();
+    test_check_rates(&test, 3, 0);
+    radio_cell_info_rate_remove(rate, id[0]);
+    radio_cell_info_rate_remove(rate, id[1]);
+    radio_cell_info_rate_remove(rate, id[2]);
+    test_drain();
+    test_check_rates(&test, 4, INT_MAX);
+
+    /* Pending update is cancelled */
+    radio_cell_info_rate_add(rate, 1000);
+    radio_cell_info_rate_unref(rate);
+    test_drain();
+    test_check_rates(&test, 4, INT_MAX);
+
+    g_array_free(test.rates, TRUE);
+    radio_client_unref(client);
+    radio_instance_unref(instance);
+    test_modem_free(modem);
+}
+
+/*==========================================================================*
+ * idle
+ *==========================================================================*/
+
+static
+void
+test_idle(
+    void)
+{
+    TestModem* modem = test_modem_new(TEST_MODEM_RADIO_AIDL,
+        RADIO_NETWORK_INTERFACE, SLOT);
+    RadioInstance* instance =
+        radio_instance_new_with_modem_slot_version_and_interface
+            (test_modem_dev(modem), SLOT, NULL, 0, RADIO_INTERFACE_NONE,
+                RADIO_NETWORK_INTERFACE);
+    RadioClient* client = radio_client_new(instance);
+    RadioCellInfoRate* rate;
+    TestCellInfoRate test;
+    guint id;
+
+    test_init_rates(&test, RADIO_NETWORK_REQ_SET_CELL_INFO_LIST_RATE);
+    test_modem_set_payload_func(modem, test_payload, &test);
+    test.loop = g_main_loop_new(NULL, FALSE);
+
+    /* Nobody is subscribed, cell info gets disabled after a while */
+    g_assert(radio_client_connected(client));
+    rate = radio_cell_info_rate_new(client);
+    test_drain();
+    test_check_rates(&test, 0, 0);
+    radio_cell_info_rate_set_idle_timeout(rate, 10);
+    test_run(&test_opt, test.loop);
+    test_check_rates(&test, 1, INT_MAX);
+
+    /* Subscribers are served right away */
+    g_assert((id = radio_cell_info_rate_add(rate, 1000)) != 0);
+    test_drain();
+    test_check_rates(&test, 2, 1000);
+
+    /* Coming back before the timeout expires changes nothing */
+    radio_cell_info_rate_set_idle_timeout(rate, TEST_TIMEOUT_MS);
+    radio_cell_info_rate_remove(rate, id);
+    test_drain();
+    g_assert((id = radio_cell_info_rate_add(rate, 1000)) != 0);
+    test_drain();
+    test_check_rates(&test, 2, 1000);
+
+    /* Now let it expire (changing the timeout restarts it) */
+    radio_cell_info_rate_remove(rate, id);
+    test_drain();
+    test_check_rates(&test, 2, 1000);
+    radio_cell_info_rate_set_idle_timeout(rate, 10);
+    test_run(&test_opt, test.loop);
+    test_check_rates(&test, 3, INT_MAX);
+
+    g_main_loop_unref(test.loop);
+    g_array_free(test.rates, TRUE);
+    radio_cell_info_rate_unref(rate);
+    radio_client_unref(client);
+    radio_instance_unref(instance);
+    test_modem_free(modem);
+}
+
+/*==========================================================================*
+ * Common
+ *==========================================================================*/
+
+#define TEST_PREFIX "/cell_info_rate/"
+#define TEST_(t) TEST_PREFIX t
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_null);
+    g_test_add_func(TEST_("unsupported"), test_unsupported);
+    g_test_add_func(TEST_("basic"), test_basic);
+    g_test_add_func(TEST_("idle"), test_idle);
+    test_init(&test_opt, argc, argv);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
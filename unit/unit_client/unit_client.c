@@ -43,6 +43,7 @@
 
 #include "radio_client.h"
 #include "radio_instance.h"
+#include "radio_recorder.h"
 #include "radio_request_p.h"
 #include "radio_request_group_p.h"
 #include "radio_util.h"
@@ -50,6 +51,8 @@
 #include <gutil_strv.h>
 #include <gutil_log.h>
 
+#include <glib/gstdio.h>
+
 #define DEFAULT_INTERFACE RADIO_INTERFACE_1_0
 #define DEV GBINDER_DEFAULT_HWBINDER
 
@@ -861,6 +864,160 @@ test_resp(
     test_simple_cleanup(&test);
 }
 
+/*==========================================================================*
+ * post
+ *==========================================================================*/
+
+typedef struct test_post_data {
+    TestSimple simple;
+    GMainContext* context;
+    GThread* thread;
+} TestPost;
+
+static
+void
+test_post_complete_cb(
+    RadioRequest* req,
+    RADIO_TX_STATUS status,
+    RADIO_RESP resp,
+    RADIO_ERROR error,
+    const GBinderReader* reader,
+    gpointer user_data)
+{
+    TestPost* test = user_data;
+
+    /* Invoked on the submitter's context */
+    g_assert(g_main_context_is_owner(test->context));
+    g_assert_cmpint(status, == ,RADIO_TX_STATUS_OK);
+    g_assert_cmpint(resp, == ,RADIO_RESP_GET_MUTE);
+    g_assert_cmpint(error, == ,RADIO_ERROR_NONE);
+    g_assert(reader);
+    test->simple.completed++;
+}
+
+static
+void
+test_post_fail_cb(
+    RadioRequest* req,
+    RADIO_TX_STATUS status,
+    RADIO_RESP resp,
+    RADIO_ERROR error,
+    const GBinderReader* reader,
+    gpointer user_data)
+{
+    TestPost* test = user_data;
+
+    g_assert(!g_main_context_is_owner(test->context));
+    g_assert_cmpint(status, == ,RADIO_TX_STATUS_FAILED);
+    test->simple.completed++;
+}
+
+static
+void
+test_post_dropped_cb(
+    RadioRequest* req,
+    RADIO_TX_STATUS status,
+    RADIO_RESP resp,
+    RADIO_ERROR error,
+    const GBinderReader* reader,
+    gpointer user_data)
+{
+    TestPost* test = user_data;
+
+    /* Still invoked on the submitter's context */
+    g_assert(g_main_context_is_owner(test->context));
+    g_assert_cmpint(status, == ,RADIO_TX_STATUS_FAILED);
+    g_assert(!reader);
+    test->simple.completed++;
+}
+
+static
+void
+test_post_destroy_cb(
+    gpointer user_data)
+{
+    TestPost* test = user_data;
+
+    /* Always invoked on the owner's context */
+    g_assert(!g_main_context_is_owner(test->context));
+    test->simple.destroyed++;
+}
+
+static
+gpointer
+test_post_thread(
+    gpointer req)
+{
+    TestPost* test = radio_request_user_data(req);
+
+    g_assert(radio_request_post(req, test->context));
+    return NULL;
+}
+
+static
+void
+test_post(
+    void)
+{
+    TestPost test;
+    RadioClient* client = test_simple_init(&test.simple);
+    RadioClient* client2;
+    RadioRequest* req;
+
+    test.context = g_main_context_new();
+    g_assert(!radio_request_post(NULL, NULL));
+
+    /* Posted request dropped before completion still gets completed */
+    client2 = radio_client_new(test.simple.common.radio);
+    req = radio_request_new(client2, RADIO_REQ_GET_MUTE, NULL,
+        test_post_dropped_cb, test_post_destroy_cb, &test);
+    g_assert(radio_request_post(req, test.context));
+    while (g_main_context_iteration(NULL, FALSE)); /* Not connected yet */
+    radio_client_unref(client2);
+    g_assert_cmpint(test.simple.completed, == ,0);
+    while (g_main_context_iteration(test.context, FALSE));
+    g_assert_cmpint(test.simple.completed, == ,1);
+    while (!test.simple.destroyed) {
+        g_main_context_iteration(NULL, TRUE);
+    }
+    test.simple.completed = test.simple.destroyed = 0;
+
+    test_common_connected(&test.simple.common);
+
+    /* Post the request from another thread */
+    req = radio_request_new(client, RADIO_REQ_GET_MUTE, NULL,
+        test_post_complete_cb, test_post_destroy_cb, &test);
+    test.thread = g_thread_new("post", test_post_thread, req);
+    g_thread_join(test.thread);
+
+    /* Completion doesn't happen until the submitter context is iterated */
+    while (!g_main_context_pending(test.context)) {
+        g_main_context_iteration(NULL, TRUE);
+    }
+    g_assert_cmpint(test.simple.completed, == ,0);
+    while (g_main_context_iteration(test.context, FALSE));
+    g_assert_cmpint(test.simple.completed, == ,1);
+
+    /* And the request gets freed by the owner */
+    while (!test.simple.destroyed) {
+        g_main_context_iteration(NULL, TRUE);
+    }
+
+    /* Dead client fails the posted request */
+    req = radio_request_new(client, RADIO_REQ_GET_MUTE, NULL,
+        test_post_fail_cb, test_post_destroy_cb, &test);
+    test_gbinder_remote_object_kill(test.simple.common.remote);
+    g_assert(radio_client_dead(client));
+    g_assert(radio_request_post(req, NULL));
+    while (test.simple.destroyed < 2) {
+        g_main_context_iteration(NULL, TRUE);
+    }
+    g_assert_cmpint(test.simple.completed, == ,2);
+
+    g_main_context_unref(test.context);
+    test_simple_cleanup(&test.simple);
+}
+
 /*==========================================================================*
  * group
  *==========================================================================*/
@@ -1732,6 +1889,63 @@ test_retry3(
     test_simple_cleanup(&test);
 }
 
+static
+void
+test_retry_recorder(
+    void)
+{
+    int i;
+    TestSimple test;
+    RadioClient* client = test_simple_init(&test);
+    RadioRequest* req = radio_request_new(client, ERROR_REQ, NULL,
+        test_retry_complete_cb, test_simple_destroy_cb, &test);
+    RadioRecorder* recorder = radio_recorder_new(8, 16);
+    char* dir = g_dir_make_tmp("unit_client_XXXXXX", NULL);
+    char* file = g_build_filename(dir, "dump", NULL);
+    guint32 serial[TEST_RETRY_COUNT + 1];
+    gchar* image;
+
+    test_common_connected(&test.common);
+    radio_instance_set_recorder(test.common.radio, recorder);
+
+    radio_request_set_timeout(req, TEST_TIMEOUT_MS * 2);
+    radio_request_set_retry(req, 10, TEST_RETRY_COUNT);
+    g_assert(radio_request_submit(req));
+    serial[0] = req->serial2;
+    for (i = 0; i < TEST_RETRY_COUNT; i++) {
+        g_assert(radio_request_retry(req));
+        serial[i + 1] = req->serial2;
+    }
+
+    /* Each resubmission refers to the original serial */
+    g_assert(radio_recorder_dump(recorder, file));
+    g_assert(g_file_get_contents(file, &image, NULL, NULL));
+    for (i = 0; i <= TEST_RETRY_COUNT; i++) {
+        const RadioRecord* rec = (RadioRecord*)(image +
+            sizeof(RadioRecorderHeader) + i * (sizeof(RadioRecord) + 16));
+
+        g_assert_cmpuint(rec->seq, == ,i + 1);
+        g_assert_cmpuint(rec->type, == ,RADIO_RECORD_REQUEST);
+        g_assert_cmpuint(rec->serial, == ,serial[i]);
+        g_assert_cmpuint(rec->extra, == ,i ? req->serial : 0);
+    }
+    g_free(image);
+    radio_request_unref(req);
+
+    test_run(&test_opt, test.loop);
+
+    g_assert(test.completed);
+    g_assert(test.destroyed);
+
+    /* Cleanup */
+    radio_recorder_unref(recorder);
+    g_unlink(file);
+    g_rmdir(dir);
+    g_free(file);
+    g_free(dir);
+    test_simple_cleanup(&test);
+}
+
 /*==========================================================================*
  * fail
  *==========================================================================*/
@@ -2225,6 +2439,7 @@ int main(int argc, char* argv[])
     g_test_add_func(TEST_("cancel_queue"), test_cancel_queue);
     g_test_add_func(TEST_("ind"), test_ind);
     g_test_add_func(TEST_("resp"), test_resp);
+    g_test_add_func(TEST_("post"), test_post);
     g_test_add_func(TEST_("group"), test_group);
     g_test_add_func(TEST_("group2"), test_group2);
     g_test_add_func(TEST_("group3"), test_group3);
@@ -2235,6 +2450,7 @@ int main(int argc, char* argv[])
     g_test_add_func(TEST_("retry/1"), test_retry1);
     g_test_add_func(TEST_("retry/2"), test_retry2);
     g_test_add_func(TEST_("retry/3"), test_retry3);
+    g_test_add_func(TEST_("retry/recorder"), test_retry_recorder);
     g_test_add_func(TEST_("fail"), test_fail);
     g_test_add_func(TEST_("fail_tx"), test_fail_tx);
     g_test_add_func(TEST_("err"), test_err);
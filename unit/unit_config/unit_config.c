@@ -380,6 +380,12 @@ test_null(
     g_assert(!radio_config_req_name(NULL, RADIO_CONFIG_REQ_NONE));
     g_assert(!radio_config_resp_name(NULL, RADIO_CONFIG_RESP_NONE));
     g_assert(!radio_config_ind_name(NULL, RADIO_CONFIG_IND_NONE));
+    g_assert_cmpint(radio_config_req_from_name(NULL, "getModemsConfig"), == ,
+        RADIO_CONFIG_REQ_NONE);
+    g_assert_cmpint(radio_config_resp_from_name(NULL, NULL), == ,
+        RADIO_CONFIG_RESP_NONE);
+    g_assert_cmpint(radio_config_ind_from_name(NULL, NULL), == ,
+        RADIO_CONFIG_IND_NONE);
     g_assert(!radio_config_add_death_handler(NULL, NULL, NULL));
     g_assert(!radio_config_add_request_observer(NULL,
         RADIO_CONFIG_REQ_ANY, NULL, NULL));
@@ -398,6 +404,9 @@ test_null(
     g_assert_cmpint(radio_config_interface_type(NULL), ==,
         RADIO_INTERFACE_TYPE_NONE);
 
+    g_assert(!radio_config_get_ind_rates(NULL, RADIO_IND_RATE_BY_COUNT, 0,
+        NULL));
+    radio_config_set_ind_meter(NULL, 1000);
     radio_config_unref(NULL);
     radio_config_remove_handler(NULL, 0);
     radio_config_remove_handlers(NULL, NULL, 0);
@@ -439,6 +448,17 @@ test_name(
         "simSlotsStatusChanged");
     g_assert_null(radio_config_ind_name(client, (RADIO_CONFIG_IND)12345));
 
+    g_assert_cmpint(radio_config_req_from_name(client,
+        "getPhoneCapability"), == ,RADIO_CONFIG_REQ_GET_PHONE_CAPABILITY);
+    g_assert_cmpint(radio_config_resp_from_name(client,
+        "getSimSlotsStatusResponse"), == ,
+        RADIO_CONFIG_RESP_GET_SIM_SLOTS_STATUS);
+    g_assert_cmpint(radio_config_ind_from_name(client,
+        "simSlotsStatusChanged"), == ,
+        RADIO_CONFIG_IND_SIM_SLOTS_STATUS_CHANGED);
+    g_assert_cmpint(radio_config_req_from_name(client, "foo"), == ,
+        RADIO_CONFIG_REQ_NONE);
+
     test_common_cleanup(&test);
 }
 
@@ -565,13 +585,17 @@ test_ind(
     GBinderLocalRequest* req;
     GBinderClient* ind_client;
     RadioConfig* client;
+    RadioIndRate* rates;
     TestInd test;
+    guint count;
     gulong id[2];
 
     memset(&test, 0, sizeof(test));
     test.loop = g_main_loop_new(NULL, FALSE);
     client = test_common_init(&test.common, RADIO_CONFIG_INTERFACE_1_1);
     ind_client = test.common.service.ind_client;
+    radio_config_set_ind_meter(client, 60000);
+    radio_config_set_ind_meter(client, 60000); /* No effect */
 
     /* Register and unregister one listener */
     id[0] = radio_config_add_indication_observer(client, RADIO_CONFIG_IND_ANY,
@@ -622,6 +646,23 @@ test_ind(
     test_run(&test_opt, test.loop);
     g_assert_cmpint(test.ind, == ,RADIO_CONFIG_IND_SIM_SLOTS_STATUS_CHANGED);
 
+    /* Only the valid indication is metered */
+    rates = radio_config_get_ind_rates(client, RADIO_IND_RATE_BY_BYTES, 0,
+        &count);
+    g_assert(rates);
+    g_assert_cmpuint(count, == ,1);
+    g_assert_cmpuint(rates[0].code, == ,
+        RADIO_CONFIG_IND_SIM_SLOTS_STATUS_CHANGED);
+    g_assert_cmpuint(rates[0].count, == ,1);
+    g_assert(rates[0].rate > 0);
+    g_free(rates);
+
+    /* Turning the meter off drops the data */
+    radio_config_set_ind_meter(client, 0);
+    g_assert(!radio_config_get_ind_rates(client, RADIO_IND_RATE_BY_COUNT, 0,
+        &count));
+    g_assert_cmpuint(count, == ,0);
+
     /* Cleanup */
     radio_config_remove_all_handlers(client, id);
     g_main_loop_unref(test.loop);
@@ -888,6 +929,161 @@ test_death(
     test_simple_cleanup(&test);
 }
 
+/*==========================================================================*
+ * async
+ *==========================================================================*/
+
+typedef struct test_async_data {
+    GMainLoop* loop;
+    RadioConfig* config;
+    int completed;
+    int destroyed;
+} TestAsync;
+
+static
+void
+test_async_cb(
+    RadioConfig* config,
+    gpointer user_data)
+{
+    TestAsync* test = user_data;
+
+    GDEBUG("config %p", config);
+    g_assert(!test->config);
+    test->config = radio_config_ref(config);
+    test->completed++;
+}
+
+static
+void
+test_async_not_reached(
+    RadioConfig* config,
+    gpointer user_data)
+{
+    g_assert_not_reached();
+}
+
+static
+void
+test_async_destroy_cb(
+    gpointer user_data)
+{
+    TestAsync* test = user_data;
+
+    test->destroyed++;
+    test_quit_later(test->loop);
+}
+
+static
+void
+test_async(
+    void)
+{
+    GBinderServiceManager* sm = gbinder_servicemanager_new(DEV);
+    GBinderRemoteObject* remote;
+    TestConfigService service;
+    TestAsync test;
+    RadioConfig* config;
+    gboolean destroyed = FALSE;
+    gulong id;
+
+    memset(&test, 0, sizeof(test));
+    test.loop = g_main_loop_new(NULL, FALSE);
+
+    /* Invalid parameters */
+    g_assert(!radio_config_new_async(RADIO_CONFIG_INTERFACE_MAX,
+        RADIO_INTERFACE_TYPE_HIDL, NULL, NULL, NULL));
+    g_assert(!radio_config_new_async(RADIO_CONFIG_INTERFACE_MAX,
+        RADIO_INTERFACE_TYPE_NONE, test_async_cb, NULL, NULL));
+    radio_config_cancel_new(0);
+
+    /* No service => NULL */
+    g_assert(radio_config_new_async(RADIO_CONFIG_INTERFACE_MAX,
+        RADIO_INTERFACE_TYPE_HIDL, test_async_cb, test_async_destroy_cb,
+        &test));
+    test_run(&test_opt, test.loop);
+    g_assert_cmpint(test.completed, == ,1);
+    g_assert_cmpint(test.destroyed, == ,1);
+    g_assert(!test.config);
+
+    /* Register the service */
+    test_config_service_init(&service);
+    remote = test_gbinder_servicemanager_new_service(sm,
+        RADIO_CONFIG_1_1_FQNAME, service.obj);
+
+    /* Cancelled call never completes */
+    id = radio_config_new_async(RADIO_CONFIG_INTERFACE_MAX,
+        RADIO_INTERFACE_TYPE_HIDL, test_async_not_reached,
+        test_destroy_once, &destroyed);
+    g_assert(id);
+    radio_config_cancel_new(id);
+    g_assert(destroyed);
+    radio_config_cancel_new(id); /* Second time has no effect */
+
+    /* Successful lookup and setResponseFunctions */
+    test.completed = test.destroyed = 0;
+    g_assert(radio_config_new_async(RADIO_CONFIG_INTERFACE_MAX,
+        RADIO_INTERFACE_TYPE_HIDL, test_async_cb, test_async_destroy_cb,
+        &test));
+    test_run(&test_opt, test.loop);
+    g_assert_cmpint(test.completed, == ,1);
+    g_assert_cmpint(test.destroyed, == ,1);
+    g_assert(test.config);
+    g_assert_cmpint(radio_config_interface(test.config), == ,
+        RADIO_CONFIG_INTERFACE_1_1);
+    g_assert_cmpint(test_config_service_req_count(&service,
+        RADIO_CONFIG_REQ_SET_RESPONSE_FUNCTIONS), == ,1);
+
+    /* The instance is shared with the synchronous API */
+    config = radio_config_new();
+    g_assert(config == test.config);
+    radio_config_unref(config);
+
+    /* Existing instance is delivered asynchronously too */
+    config = test.config;
+    test.config = NULL;
+    test.completed = test.destroyed = 0;
+    g_assert(radio_config_new_async(RADIO_CONFIG_INTERFACE_1_1,
+        RADIO_INTERFACE_TYPE_HIDL, test_async_cb, test_async_destroy_cb,
+        &test));
+    g_assert(!test.completed);
+    test_run(&test_opt, test.loop);
+    g_assert_cmpint(test.completed, == ,1);
+    g_assert(test.config == config);
+    g_assert_cmpint(test_config_service_req_count(&service,
+        RADIO_CONFIG_REQ_SET_RESPONSE_FUNCTIONS), == ,1);
+
+    radio_config_unref(test.config);
+    radio_config_unref(config);
+
+    /* Synchronous creation wins the race */
+    while (g_main_context_iteration(NULL, FALSE));
+    test.config = NULL;
+    test.completed = test.destroyed = 0;
+    g_assert(radio_config_new_async(RADIO_CONFIG_INTERFACE_1_1,
+        RADIO_INTERFACE_TYPE_HIDL, test_async_cb, test_async_destroy_cb,
+        &test));
+    g_assert(g_main_context_iteration(NULL, FALSE)); /* getService */
+    config = radio_config_new_with_version(RADIO_CONFIG_INTERFACE_1_1);
+    g_assert(config);
+    g_assert_cmpint(test_config_service_req_count(&service,
+        RADIO_CONFIG_REQ_SET_RESPONSE_FUNCTIONS), == ,2);
+    test_run(&test_opt, test.loop);
+    g_assert_cmpint(test.completed, == ,1);
+    g_assert(test.config == config);
+
+    /* The survivor has re-issued its setResponseFunctions after ours */
+    while (g_main_context_iteration(NULL, FALSE));
+    g_assert_cmpint(test_config_service_req_count(&service,
+        RADIO_CONFIG_REQ_SET_RESPONSE_FUNCTIONS), == ,4);
+    radio_config_unref(test.config);
+    radio_config_unref(config);
+    test_config_service_cleanup(&service);
+    gbinder_remote_object_unref(remote);
+    gbinder_servicemanager_unref(sm);
+    g_main_loop_unref(test.loop);
+}
+
 /*==========================================================================*
  * Common
  *==========================================================================*/
@@ -907,6 +1103,7 @@ int main(int argc, char* argv[])
     g_test_add_func(TEST_("cancel"), test_cancel);
     g_test_add_func(TEST_("fail_tx"), test_fail_tx);
     g_test_add_func(TEST_("death"), test_death);
+    g_test_add_func(TEST_("async"), test_async);
     test_init(&test_opt, argc, argv);
     return g_test_run();
 }
@@ -0,0 +1,575 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+#include "test_common.h"
+#include "test_gbinder.h"
+#include "test_modem.h"
+
+#include "radio_client.h"
+#include "radio_criteria.h"
+#include "radio_instance.h"
+#include "radio_network_types.h"
+
+#include <gutil_log.h>
+
+#define SLOT "slot1"
+
+static TestOpt test_opt;
+
+typedef struct test_criteria_req {
+    guint code;
+    gint ran;
+    gint measurement;       /* Zero for IRadio 1.2 and link capacity */
+    gint hysteresis_ms;
+    gint hysteresis[2];     /* dB or DL/UL kbps */
+    gboolean enabled;
+    guint count;            /* Number of thresholds */
+    gint32 first;
+    gint32 last;
+} TestCriteriaReq;
+
+typedef struct test_criteria {
+    gboolean aidl;
+    GSList* reqs;
+} TestCriteria;
+
+static
+void
+test_drain(
+    void)
+{
+    while (g_main_context_iteration(NULL, FALSE));
+}
+
+static
+void
+test_read_hidl_thresholds(
+    GBinderReader* args,
+    TestCriteriaReq* req)
+{
+    gsize count = 0;
+    const gint32* values = gbinder_reader_read_hidl_vec1(args, &count,
+        sizeof(gint32));
+
+    g_assert(values);
+    req->count = count;
+    if (count) {
+        req->first = values[0];
+        req->last = values[count - 1];
+    }
+}
+
+static
+void
+test_read_aidl_thresholds(
+    GBinderReader* args,
+    TestCriteriaReq* req)
+{
+    gint32 count = -1;
+    gint i;
+
+    g_assert(gbinder_reader_read_int32(args, &count));
+    g_assert_cmpint(count, >= ,0);
+    req->count = count;
+    for (i = 0; i < count; i++) {
+        gint32 value;
+
+        g_assert(gbinder_reader_read_int32(args, &value));
+        if (!i) req->first = value;
+        req->last = value;
+    }
+}
+
+static
+void
+test_read_link_capacity(
+    GBinderReader* args,
+    gboolean aidl,
+    TestCriteriaReq* req)
+{
+    TestCriteriaReq ul;
+
+    memset(&ul, 0, sizeof(ul));
+    g_assert(gbinder_reader_read_int32(args, &req->hysteresis_ms));
+    g_assert(gbinder_reader_read_int32(args, req->hysteresis));
+    g_assert(gbinder_reader_read_int32(args, req->hysteresis + 1));
+    if (aidl) {
+        test_read_aidl_thresholds(args, req);
+        test_read_aidl_thresholds(args, &ul);
+    } else {
+        test_read_hidl_thresholds(args, req);
+        test_read_hidl_thresholds(args, &ul);
+    }
+
+    /* Link capacity never has thresholds */
+    g_assert_cmpuint(req->count, == ,0);
+    g_assert_cmpuint(ul.count, == ,0);
+    req->enabled = (req->hysteresis[0] || req->hysteresis[1]);
+}
+
+static
+void
+test_payload(
+    TestModem* modem,
+    guint code,
+    guint resp,
+    GBinderReader* args,
+    GBinderWriter* payload,
+    gpointer user_data)
+{
+    TestCriteria* test = user_data;
+    TestCriteriaReq* req = g_new0(TestCriteriaReq, 1);
+
+    req->code = code;
+    if (test->aidl) {
+        gint32 n = 0, nonnull = 0, size = 0;
+
+        switch (code) {
+        case RADIO_NETWORK_REQ_SET_SIGNAL_STRENGTH_REPORTING_CRITERIA:
+            g_assert(gbinder_reader_read_int32(args, &n));
+            g_assert(gbinder_reader_read_int32(args, &nonnull));
+            g_assert(gbinder_reader_read_int32(args, &size));
+            g_assert_cmpint(n, == ,1);
+            g_assert_cmpint(nonnull, == ,1);
+            g_assert(gbinder_reader_read_int32(args, &req->measurement));
+            g_assert(gbinder_reader_read_int32(args, &req->hysteresis_ms));
+            g_assert(gbinder_reader_read_int32(args, req->hysteresis));
+            test_read_aidl_thresholds(args, req);
+            g_assert(gbinder_reader_read_bool(args, &req->enabled));
+            g_assert(gbinder_reader_read_int32(args, &req->ran));
+            /* Fields, thresholds and the size itself */
+            g_assert_cmpint(size, == ,(7 + req->count) * 4);
+            test->reqs = g_slist_append(test->reqs, req);
+            return;
+        case RADIO_NETWORK_REQ_SET_LINK_CAPACITY_REPORTING_CRITERIA:
+            test_read_link_capacity(args, TRUE, req);
+            break;
+        default:
+            g_assert_not_reached();
+        }
+    } else {
+        const RadioSignalThresholdInfo* info;
+
+        switch (code) {
+        case RADIO_REQ_SET_SIGNAL_STRENGTH_REPORTING_CRITERIA:
+            g_assert(gbinder_reader_read_int32(args, &req->hysteresis_ms));
+            g_assert(gbinder_reader_read_int32(args, req->hysteresis));
+            test_read_hidl_thresholds(args, req);
+            req->enabled = (req->count > 0);
+            break;
+        case RADIO_REQ_SET_SIGNAL_STRENGTH_REPORTING_CRITERIA_1_5:
+            info = gbinder_reader_read_hidl_struct1(args,
+                sizeof(RadioSignalThresholdInfo));
+            g_assert(info);
+            req->measurement = info->signalMeasurement;
+            req->hysteresis_ms = info->hysteresisMs;
+            req->hysteresis[0] = info->hysteresisDb;
+            req->enabled = info->isEnabled;
+            test_read_hidl_thresholds(args, req);
+            g_assert_cmpuint(req->count, == ,info->thresholds.count);
+            break;
+        case RADIO_REQ_SET_LINK_CAPACITY_REPORTING_CRITERIA:
+        case RADIO_REQ_SET_LINK_CAPACITY_REPORTING_CRITERIA_1_5:
+            test_read_link_capacity(args, FALSE, req);
+            break;
+        default:
+            g_assert_not_reached();
+        }
+    }
+    g_assert(gbinder_reader_read_int32(args, &req->ran));
+    test->reqs = g_slist_append(test->reqs, req);
+}
+
+static
+void
+test_check_req(
+    TestCriteria* test,
+    guint code,
+    gint ran,
+    gint measurement,
+    gint hysteresis_ms,
+    gint hysteresis1,
+    gint hysteresis2,
+    guint count,
+    gint32 first,
+    gint32 last)
+{
+    TestCriteriaReq* req;
+
+    g_assert(test->reqs);
+    req = test->reqs->data;
+    test->reqs = g_slist_delete_link(test->reqs, test->reqs);
+    GDEBUG("Request %u ran %d measurement %d hysteresis %d ms %d/%d, "
+        "%u thresholds", req->code, req->ran, req->measurement,
+        req->hysteresis_ms, req->hysteresis[0], req->hysteresis[1],
+        req->count);
+    g_assert_cmpuint(req->code, == ,code);
+    g_assert_cmpint(req->ran, == ,ran);
+    g_assert_cmpint(req->measurement, == ,measurement);
+    g_assert_cmpint(req->hysteresis_ms, == ,hysteresis_ms);
+    g_assert_cmpint(req->hysteresis[0], == ,hysteresis1);
+    g_assert_cmpint(req->hysteresis[1], == ,hysteresis2);
+    g_assert_cmpuint(req->count, == ,count);
+    if (count) {
+        g_assert_cmpint(req->first, == ,first);
+        g_assert_cmpint(req->last, == ,last);
+    }
+    g_free(req);
+}
+
+/*==========================================================================*
+ * null
+ *==========================================================================*/
+
+static
+void
+test_null(
+    void)
+{
+    g_assert(!radio_criteria_new(NULL));
+    g_assert(!radio_criteria_ref(NULL));
+    radio_criteria_unref(NULL);
+    g_assert(!radio_criteria_add_signal(NULL, RADIO_ACCESS_NETWORK_EUTRAN,
+        RADIO_SIGNAL_MEASUREMENT_RSRP, 2, 0));
+    g_assert(!radio_criteria_add_link_capacity(NULL,
+        RADIO_ACCESS_NETWORK_EUTRAN, 100, 100, 0));
+    radio_criteria_remove(NULL, 1);
+}
+
+/*==========================================================================*
+ * unsupported
+ *==========================================================================*/
+
+static
+void
+test_unsupported(
+    void)
+{
+    TestModem* modem = test_modem_new(TEST_MODEM_RADIO, RADIO_INTERFACE_1_1,
+        SLOT);
+    RadioInstance* instance = radio_instance_new_with_version
+        (test_modem_dev(modem), SLOT, RADIO_INTERFACE_1_1);
+    RadioClient* client = radio_client_new(instance);
+    RadioCriteria* criteria = radio_criteria_new(client);
+    TestModem* aidl_modem = test_modem_new(TEST_MODEM_RADIO_AIDL,
+        RADIO_MODEM_INTERFACE, SLOT);
+    RadioInstance* aidl_instance =
+        radio_instance_new_with_modem_slot_version_and_interface
+            (test_modem_dev(aidl_modem), SLOT, NULL, 0,
+                RADIO_INTERFACE_NONE, RADIO_MODEM_INTERFACE);
+    RadioClient* aidl_client = radio_client_new(aidl_instance);
+    RadioCriteria* aidl_criteria = radio_criteria_new(aidl_client);
+    TestModemStats stats;
+
+    /* IRadio 1.1 doesn't have any of that */
+    g_assert(criteria);
+    g_assert(radio_criteria_ref(criteria) == criteria);
+    radio_criteria_unref(criteria);
+    g_assert(!radio_criteria_add_signal(criteria,
+        RADIO_ACCESS_NETWORK_EUTRAN, RADIO_SIGNAL_MEASUREMENT_RSRP, 2, 0));
+    g_assert(!radio_criteria_add_link_capacity(criteria,
+        RADIO_ACCESS_NETWORK_EUTRAN, 100, 100, 0));
+
+    /* Neither does IRadioModem */
+    g_assert(!radio_criteria_add_signal(aidl_criteria,
+        RADIO_ACCESS_NETWORK_EUTRAN, RADIO_SIGNAL_MEASUREMENT_RSRP, 2, 0));
+    g_assert(!radio_criteria_add_link_capacity(aidl_criteria,
+        RADIO_ACCESS_NETWORK_EUTRAN, 100, 100, 0));
+
+    /* Removing unknown ids is fine */
+    radio_criteria_remove(criteria, 0);
+    radio_criteria_remove(criteria, 1);
+    test_drain();
+
+    /* Nothing has been sent */
+    test_modem_get_stats(modem, &stats);
+    g_assert_cmpuint(stats.requests, == ,0);
+    test_modem_get_stats(aidl_modem, &stats);
+    g_assert_cmpuint(stats.requests, == ,0);
+
+    radio_criteria_unref(criteria);
+    radio_criteria_unref(aidl_criteria);
+    radio_client_unref(client);
+    radio_client_unref(aidl_client);
+    radio_instance_unref(instance);
+    radio_instance_unref(aidl_instance);
+    test_modem_free(modem);
+    test_modem_free(aidl_modem);
+}
+
+/*==========================================================================*
+ * hidl_1_2
+ *==========================================================================*/
+
+static
+void
+test_hidl_1_2(
+    void)
+{
+    TestModem* modem = test_modem_new(TEST_MODEM_RADIO, RADIO_INTERFACE_1_2,
+        SLOT);
+    RadioInstance* instance = radio_instance_new_with_version
+        (test_modem_dev(modem), SLOT, RADIO_INTERFACE_1_2);
+    RadioClient* client = radio_client_new(instance);
+    RadioCriteria* criteria = radio_criteria_new(client);
+    const guint code = RADIO_REQ_SET_SIGNAL_STRENGTH_REPORTING_CRITERIA;
+    const guint code2 = RADIO_REQ_SET_LINK_CAPACITY_REPORTING_CRITERIA;
+    TestCriteria test;
+    guint id[4];
+
+    memset(&test, 0, sizeof(test));
+    test_modem_set_payload_func(modem, test_payload, &test);
+
+    /* These require IRadio 1.5 */
+    g_assert(!radio_criteria_add_signal(criteria,
+        RADIO_ACCESS_NETWORK_EUTRAN, RADIO_SIGNAL_MEASUREMENT_RSRQ, 2, 0));
+    g_assert(!radio_criteria_add_signal(criteria,
+        RADIO_ACCESS_NETWORK_NGRAN, RADIO_SIGNAL_MEASUREMENT_SSRSRP, 2, 0));
+    g_assert(!radio_criteria_add_link_capacity(criteria,
+        RADIO_ACCESS_NETWORK_NGRAN, 100, 100, 0));
+
+    /* And these don't make sense at all */
+    g_assert(!radio_criteria_add_signal(criteria,
+        RADIO_ACCESS_NETWORK_EUTRAN, RADIO_SIGNAL_MEASUREMENT_RSRP, 0, 0));
+    g_assert(!radio_criteria_add_signal(criteria,
+        RADIO_ACCESS_NETWORK_UTRAN, RADIO_SIGNAL_MEASUREMENT_RSSI, 2, 0));
+    g_assert(!radio_criteria_add_signal(criteria,
+        RADIO_ACCESS_NETWORK_IWLAN, RADIO_SIGNAL_MEASUREMENT_RSSI, 2, 0));
+    g_assert(!radio_criteria_add_link_capacity(criteria,
+        RADIO_ACCESS_NETWORK_UNKNOWN, 100, 100, 0));
+    g_assert(!radio_criteria_add_link_capacity(criteria,
+        RADIO_ACCESS_NETWORK_EUTRAN, 0, 100, 0));
+
+    /* The finest criteria win. Added before the client gets connected */
+    g_assert(!radio_client_connected(client));
+    g_assert((id[0] = radio_criteria_add_signal(criteria,
+        RADIO_ACCESS_NETWORK_EUTRAN, RADIO_SIGNAL_MEASUREMENT_RSRP, 5,
+        3000)) != 0);
+    g_assert((id[1] = radio_criteria_add_signal(criteria,
+        RADIO_ACCESS_NETWORK_EUTRAN, RADIO_SIGNAL_MEASUREMENT_RSRP, 2,
+        5000)) != 0);
+    g_assert((id[2] = radio_criteria_add_signal(criteria,
+        RADIO_ACCESS_NETWORK_GERAN, RADIO_SIGNAL_MEASUREMENT_RSSI, 4,
+        1000)) != 0);
+    g_assert((id[3] = radio_criteria_add_link_capacity(criteria,
+        RADIO_ACCESS_NETWORK_EUTRAN, 100, 50, 2000)) != 0);
+    g_assert(radio_criteria_add_link_capacity(criteria,
+        RADIO_ACCESS_NETWORK_EUTRAN, 50, 100, 0));
+    test_drain();
+    g_assert(radio_client_connected(client));
+
+    /* Every access network is programmed */
+    test_check_req(&test, code, RADIO_ACCESS_NETWORK_GERAN, 0, 1000, 2, 0,
+        16, -112, -52);
+    test_check_req(&test, code, RADIO_ACCESS_NETWORK_EUTRAN, 0, 3000, 1, 0,
+        49, -140, -44);
+    test_check_req(&test, code2, RADIO_ACCESS_NETWORK_EUTRAN, 0, 0, 50, 50,
+        0, 0, 0);
+    g_assert(!test.reqs);
+
+    /* Coarser criteria after the finer ones are gone */
+    radio_criteria_remove(criteria, id[1]);
+    test_drain();
+    test_check_req(&test, code, RADIO_ACCESS_NETWORK_EUTRAN, 0, 3000, 2, 0,
+        20, -140, -45);
+    g_assert(!test.reqs);
+
+    /* Default criteria after the last one is gone */
+    radio_criteria_remove(criteria, id[0]);
+    radio_criteria_remove(criteria, id[0]);
+    test_drain();
+    test_check_req(&test, code, RADIO_ACCESS_NETWORK_EUTRAN, 0, 0, 0, 0,
+        0, 0, 0);
+    g_assert(!test.reqs);
+
+    /* And so does GERAN, whichever access network is current */
+    radio_criteria_remove(criteria, id[2]);
+    test_drain();
+    test_check_req(&test, code, RADIO_ACCESS_NETWORK_GERAN, 0, 0, 0, 0,
+        0, 0, 0);
+    g_assert(!test.reqs);
+
+    /* Pending update is cancelled */
+    radio_criteria_remove(criteria, id[3]);
+    radio_criteria_unref(criteria);
+    test_drain();
+    g_assert(!test.reqs);
+
+    radio_client_unref(client);
+    radio_instance_unref(instance);
+    test_modem_free(modem);
+}
+
+/*==========================================================================*
+ * hidl_1_5
+ *==========================================================================*/
+
+static
+void
+test_hidl_1_5(
+    void)
+{
+    TestModem* modem = test_modem_new(TEST_MODEM_RADIO, RADIO_INTERFACE_1_5,
+        SLOT);
+    RadioInstance* instance = radio_instance_new_with_version
+        (test_modem_dev(modem), SLOT, RADIO_INTERFACE_1_5);
+    RadioClient* client = radio_client_new(instance);
+    RadioCriteria* criteria = radio_criteria_new(client);
+    const guint code = RADIO_REQ_SET_SIGNAL_STRENGTH_REPORTING_CRITERIA_1_5;
+    const guint code2 = RADIO_REQ_SET_LINK_CAPACITY_REPORTING_CRITERIA_1_5;
+    TestCriteria test;
+    guint id;
+
+    memset(&test, 0, sizeof(test));
+    test_modem_set_payload_func(modem, test_payload, &test);
+    test_drain();
+    g_assert(radio_client_connected(client));
+
+    g_assert((id = radio_criteria_add_signal(criteria,
+        RADIO_ACCESS_NETWORK_EUTRAN, RADIO_SIGNAL_MEASUREMENT_RSRQ, 3,
+        0)) != 0);
+    g_assert(radio_criteria_add_signal(criteria,
+        RADIO_ACCESS_NETWORK_NGRAN, RADIO_SIGNAL_MEASUREMENT_SSSINR, 100,
+        500));
+    g_assert(radio_criteria_add_link_capacity(criteria,
+        RADIO_ACCESS_NETWORK_NGRAN, 1000, 500, 100));
+    test_drain();
+    test_check_req(&test, code, RADIO_ACCESS_NETWORK_EUTRAN,
+        RADIO_SIGNAL_MEASUREMENT_RSRQ, 0, 1, 0, 13, -33, 3);
+    test_check_req(&test, code, RADIO_ACCESS_NETWORK_NGRAN,
+        RADIO_SIGNAL_MEASUREMENT_SSSINR, 500, 50, 0, 1, 0, 0);
+    test_check_req(&test, code2, RADIO_ACCESS_NETWORK_NGRAN, 0, 100, 1000,
+        500, 0, 0, 0);
+    g_assert(!test.reqs);
+
+    /* Disabled */
+    radio_criteria_remove(criteria, id);
+    test_drain();
+    g_assert(test.reqs);
+    g_assert(!((TestCriteriaReq*)test.reqs->data)->enabled);
+    test_check_req(&test, code, RADIO_ACCESS_NETWORK_EUTRAN,
+        RADIO_SIGNAL_MEASUREMENT_RSRQ, 0, 0, 0, 0, 0, 0);
+    g_assert(!test.reqs);
+
+    radio_criteria_unref(criteria);
+    radio_client_unref(client);
+    radio_instance_unref(instance);
+    test_modem_free(modem);
+}
+
+/*==========================================================================*
+ * aidl
+ *==========================================================================*/
+
+static
+void
+test_aidl(
+    void)
+{
+    TestModem* modem = test_modem_new(TEST_MODEM_RADIO_AIDL,
+        RADIO_NETWORK_INTERFACE, SLOT);
+    RadioInstance* instance =
+        radio_instance_new_with_modem_slot_version_and_interface
+            (test_modem_dev(modem), SLOT, NULL, 0, RADIO_INTERFACE_NONE,
+                RADIO_NETWORK_INTERFACE);
+    RadioClient* client = radio_client_new(instance);
+    RadioCriteria* criteria = radio_criteria_new(client);
+    const guint code =
+        RADIO_NETWORK_REQ_SET_SIGNAL_STRENGTH_REPORTING_CRITERIA;
+    const guint code2 =
+        RADIO_NETWORK_REQ_SET_LINK_CAPACITY_REPORTING_CRITERIA;
+    TestCriteria test;
+    guint id[2];
+
+    memset(&test, 0, sizeof(test));
+    test.aidl = TRUE;
+    test_modem_set_payload_func(modem, test_payload, &test);
+    g_assert(radio_client_connected(client));
+
+    g_assert((id[0] = radio_criteria_add_signal(criteria,
+        RADIO_ACCESS_NETWORK_NGRAN, RADIO_SIGNAL_MEASUREMENT_SSRSRP, 10,
+        500)) != 0);
+    g_assert((id[1] = radio_criteria_add_link_capacity(criteria,
+        RADIO_ACCESS_NETWORK_UTRAN, 64, 32, 0)) != 0);
+    test_drain();
+    test_check_req(&test, code, RADIO_ACCESS_NETWORK_NGRAN,
+        RADIO_SIGNAL_MEASUREMENT_SSRSRP, 500, 5, 0, 10, -140, -50);
+    test_check_req(&test, code2, RADIO_ACCESS_NETWORK_UTRAN, 0, 0, 64, 32,
+        0, 0, 0);
+    g_assert(!test.reqs);
+
+    /* Both get disabled at once */
+    radio_criteria_remove(criteria, id[0]);
+    radio_criteria_remove(criteria, id[1]);
+    test_drain();
+    g_assert(test.reqs);
+    g_assert(!((TestCriteriaReq*)test.reqs->data)->enabled);
+    test_check_req(&test, code, RADIO_ACCESS_NETWORK_NGRAN,
+        RADIO_SIGNAL_MEASUREMENT_SSRSRP, 0, 0, 0, 0, 0, 0);
+    test_check_req(&test, code2, RADIO_ACCESS_NETWORK_UTRAN, 0, 0, 0, 0,
+        0, 0, 0);
+    g_assert(!test.reqs);
+
+    radio_criteria_unref(criteria);
+    radio_client_unref(client);
+    radio_instance_unref(instance);
+    test_modem_free(modem);
+}
+
+/*==========================================================================*
+ * Common
+ *==========================================================================*/
+
+#define TEST_PREFIX "/criteria/"
+#define TEST_(t) TEST_PREFIX t
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_null);
+    g_test_add_func(TEST_("unsupported"), test_unsupported);
+    g_test_add_func(TEST_("hidl_1_2"), test_hidl_1_2);
+    g_test_add_func(TEST_("hidl_1_5"), test_hidl_1_5);
+    g_test_add_func(TEST_("aidl"), test_aidl);
+    test_init(&test_opt, argc, argv);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
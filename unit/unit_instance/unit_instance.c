@@ -37,12 +37,18 @@
 #include "test_common.h"
 #include "test_gbinder.h"
 
+#include "radio_client.h"
+#include "radio_ind_meter_p.h"
 #include "radio_instance_p.h"
+#include "radio_recorder.h"
 #include "radio_util.h"
+#include "radio_version_cache.h"
 
 #include <gutil_strv.h>
 #include <gutil_log.h>
 
+#include <glib/gstdio.h>
+
 #define DEFAULT_INTERFACE RADIO_INTERFACE_1_0
 #define DEV GBINDER_DEFAULT_BINDER
 
@@ -71,6 +77,7 @@ typedef struct test_radio_service {
     GBinderRemoteObject* resp_obj;
     GBinderRemoteObject* ind_obj;
     GHashTable* req_count;
+    gint32 ind_filter;
 } TestRadioService;
 
 static TestOpt test_opt;
@@ -170,6 +177,12 @@ test_service_txproc(
             g_assert(service->resp_obj);
             g_assert(service->ind_obj);
             break;
+        case RADIO_REQ_SET_INDICATION_FILTER:
+        case RADIO_REQ_SET_INDICATION_FILTER_1_2:
+        case RADIO_REQ_SET_INDICATION_FILTER_1_5:
+            g_assert(gbinder_reader_read_int32(&reader, NULL)); /* serial */
+            g_assert(gbinder_reader_read_int32(&reader, &service->ind_filter));
+            break;
         }
         *status = GBINDER_STATUS_OK;
         return NULL;
@@ -334,6 +347,95 @@ test_basic(
     gbinder_servicemanager_unref(sm);
 }
 
+/*==========================================================================*
+ * iter
+ *==========================================================================*/
+
+static
+void
+test_iter(
+    void)
+{
+    GBinderServiceManager* sm = gbinder_servicemanager_new(DEV);
+    GBinderRemoteObject* remote[2];
+    RadioInstance* radio[2];
+    RadioInstance* found[2];
+    RadioInstance* const* all;
+    TestRadioService service[2];
+    RadioInstanceIter iter;
+    RadioInstance* r;
+    guint gen;
+    int n;
+
+    /* NULL tolerance */
+    radio_instance_iter_init(NULL);
+    g_assert(!radio_instance_iter_next(NULL));
+
+    /* Nothing to iterate */
+    radio_instance_iter_init(&iter);
+    g_assert(!radio_instance_iter_next(&iter));
+    g_assert(!radio_instance_iter_next(&iter));
+
+    gen = radio_instance_generation();
+    test_service_init(service + 0);
+    test_service_init(service + 1);
+    remote[0] = test_gbinder_servicemanager_new_service(sm,
+        RADIO_1_0 "/slot1", service[0].obj);
+    remote[1] = test_gbinder_servicemanager_new_service(sm,
+        RADIO_1_0 "/slot2", service[1].obj);
+    radio[0] = radio_instance_new_with_version(DEV, "slot1",
+        RADIO_INTERFACE_1_0);
+    g_assert(radio[0]);
+    g_assert_cmpuint(radio_instance_generation(), != ,gen);
+    radio[1] = radio_instance_new_with_version(DEV, "slot2",
+        RADIO_INTERFACE_1_0);
+    g_assert(radio[1]);
+
+    /* Lookup doesn't match a different version */
+    g_assert(radio_instance_get_with_version(DEV, "slot2",
+        RADIO_INTERFACE_1_0) == radio[1]);
+    g_assert(!radio_instance_get_with_version(DEV, "slot2",
+        RADIO_INTERFACE_1_1));
+    g_assert(!radio_instance_get_with_version(DEV, "slot3",
+        RADIO_INTERFACE_1_0));
+
+    /* Snapshot stays the same while nothing changes */
+    all = radio_instance_get_all();
+    g_assert(all);
+    g_assert(all == radio_instance_get_all());
+
+    /* Both instances are enumerated */
+    memset(found, 0, sizeof(found));
+    radio_instance_iter_init(&iter);
+    for (n = 0; (r = radio_instance_iter_next(&iter)) != NULL; n++) {
+        found[r == radio[0] ? 0 : 1] = r;
+    }
+    g_assert_cmpint(n, == ,2);
+    g_assert(found[0] == radio[0]);
+    g_assert(found[1] == radio[1]);
+    g_assert(!radio_instance_iter_next(&iter));
+
+    /* Removal terminates the iteration and updates the snapshot */
+    gen = radio_instance_generation();
+    radio_instance_iter_init(&iter);
+    g_assert(radio_instance_iter_next(&iter));
+    radio_instance_unref(radio[1]);
+    g_assert_cmpuint(radio_instance_generation(), != ,gen);
+    g_assert(!radio_instance_iter_next(&iter));
+    all = radio_instance_get_all();
+    g_assert(all);
+    g_assert(all[0] == radio[0]);
+    g_assert(!all[1]);
+
+    radio_instance_unref(radio[0]);
+    g_assert(!radio_instance_get_all());
+    test_service_cleanup(service + 0);
+    test_service_cleanup(service + 1);
+    gbinder_remote_object_unref(remote[0]);
+    gbinder_remote_object_unref(remote[1]);
+    gbinder_servicemanager_unref(sm);
+}
+
 /*==========================================================================*
  * connected
  *==========================================================================*/
@@ -613,178 +715,925 @@ test_ind(
 }
 
 /*==========================================================================*
- * req
+ * ack_batch
  *==========================================================================*/
 
-#define TEST_REQ RADIO_REQ_DIAL
+static
+void
+test_ack_batch(
+    void)
+{
+    GBinderServiceManager* sm = gbinder_servicemanager_new(DEV);
+    GMainLoop* loop = g_main_loop_new(NULL, FALSE);
+    GBinderRemoteObject* remote;
+    RadioInstance* radio;
+    TestRadioService service;
+    GBinderClient* ind;
+    GBinderLocalRequest* req;
+    RadioAckStats stats;
+    const char* fqname = RADIO_1_0 "/slot1";
+    int i;
+
+    /* NULL tolerance */
+    radio_instance_set_ack_batching(NULL, TRUE);
+    radio_instance_get_ack_stats(NULL, NULL);
+    memset(&stats, 0xff, sizeof(stats));
+    radio_instance_get_ack_stats(NULL, &stats);
+    g_assert_cmpuint(stats.requested, == ,0);
+    g_assert_cmpuint(stats.sent, == ,0);
+
+    test_service_init(&service);
+    remote = test_gbinder_servicemanager_new_service(sm, fqname, service.obj);
+    radio = radio_instance_new_with_version(DEV, "slot1", RADIO_INTERFACE_1_4);
+    g_assert(radio);
+    radio_instance_set_ack_batching(radio, TRUE);
+    radio_instance_set_ack_batching(radio, TRUE); /* No effect */
+
+    ind = gbinder_client_new2(service.ind_obj,
+        TEST_ARRAY_AND_COUNT(radio_ind_iface_info));
+    req = gbinder_client_new_request2(ind, RADIO_IND_CALL_STATE_CHANGED);
+    gbinder_local_request_append_int32(req, RADIO_IND_ACK_EXP);
+
+    /* A burst of unhandled indications produces a single ack */
+    for (i = 0; i < 3; i++) {
+        g_assert_cmpint(gbinder_client_transact_sync_oneway(ind,
+            RADIO_IND_CALL_STATE_CHANGED, req), == ,GBINDER_STATUS_OK);
+    }
+    g_assert_cmpint(test_service_req_count(&service,
+        RADIO_REQ_RESPONSE_ACKNOWLEDGEMENT), == ,0);
+    test_quit_later_n(loop, 3);
+    test_run(&test_opt, loop);
+    g_assert_cmpint(test_service_req_count(&service,
+        RADIO_REQ_RESPONSE_ACKNOWLEDGEMENT), == ,1);
+    radio_instance_get_ack_stats(radio, &stats);
+    g_assert_cmpuint(stats.requested, == ,3);
+    g_assert_cmpuint(stats.sent, == ,1);
+
+    /* Turning batching off flushes the pending ack */
+    g_assert_cmpint(gbinder_client_transact_sync_oneway(ind,
+        RADIO_IND_CALL_STATE_CHANGED, req), == ,GBINDER_STATUS_OK);
+    radio_instance_set_ack_batching(radio, FALSE);
+    test_quit_later_n(loop, 3);
+    test_run(&test_opt, loop);
+    g_assert_cmpint(test_service_req_count(&service,
+        RADIO_REQ_RESPONSE_ACKNOWLEDGEMENT), == ,2);
+
+    /* And then each one is acked individually */
+    g_assert_cmpint(gbinder_client_transact_sync_oneway(ind,
+        RADIO_IND_CALL_STATE_CHANGED, req), == ,GBINDER_STATUS_OK);
+    g_assert_cmpint(test_service_req_count(&service,
+        RADIO_REQ_RESPONSE_ACKNOWLEDGEMENT), == ,3);
+    radio_instance_get_ack_stats(radio, &stats);
+    g_assert_cmpuint(stats.requested, == ,5);
+    g_assert_cmpuint(stats.sent, == ,3);
+
+    /* Pending ack is dropped when the instance goes away */
+    radio_instance_set_ack_batching(radio, TRUE);
+    g_assert_cmpint(gbinder_client_transact_sync_oneway(ind,
+        RADIO_IND_CALL_STATE_CHANGED, req), == ,GBINDER_STATUS_OK);
+    gbinder_local_request_unref(req);
+    gbinder_client_unref(ind);
+    radio_instance_unref(radio);
+    test_quit_later_n(loop, 3);
+    test_run(&test_opt, loop);
+    g_assert_cmpint(test_service_req_count(&service,
+        RADIO_REQ_RESPONSE_ACKNOWLEDGEMENT), == ,3);
+
+    test_service_cleanup(&service);
+    gbinder_remote_object_unref(remote);
+    gbinder_servicemanager_unref(sm);
+    g_main_loop_unref(loop);
+}
+
+/*==========================================================================*
+ * handler_timing
+ *==========================================================================*/
+
+#define TEST_HANDLER_SLOW_MS (10)
+
+static
+gboolean
+test_handler_timing_slow(
+    RadioInstance* radio,
+    RADIO_IND code,
+    RADIO_IND_TYPE type,
+    const GBinderReader* reader,
+    gpointer user_data)
+{
+    g_usleep(2 * TEST_HANDLER_SLOW_MS * 1000);
+    return TRUE;
+}
 
 static
 void
-test_req_observe(
+test_handler_timing_slow_handler(
     RadioInstance* radio,
-    RADIO_REQ code,
-    GBinderLocalRequest* args,
+    const RadioHandlerStats* handler,
+    guint code,
+    guint usec,
     gpointer user_data)
 {
     int* count = user_data;
 
+    g_assert_cmpint(handler->type, == ,RADIO_HANDLER_INDICATION);
+    g_assert_cmpuint(handler->code, == ,RADIO_IND_CALL_STATE_CHANGED);
+    g_assert_cmpuint(code, == ,RADIO_IND_CALL_STATE_CHANGED);
+    g_assert_cmpuint(usec, >= ,TEST_HANDLER_SLOW_MS * 1000);
     (*count)++;
-    GDEBUG_("%d", *count);
 }
 
 static
 void
-test_req(
+test_handler_timing(
     void)
 {
-    const char* slot = "slot1";
-    const char* fqname = RADIO_1_0 "/slot1";
-    TestRadioService service;
     GBinderServiceManager* sm = gbinder_servicemanager_new(DEV);
     GBinderRemoteObject* remote;
-    GBinderLocalRequest* req;
     RadioInstance* radio;
-    int count[3];
+    TestRadioService service;
+    GBinderClient* ind;
+    GBinderLocalRequest* req;
+    RadioHandlerStats* stats;
+    const char* fqname = RADIO_1_0 "/slot1";
+    int code = RADIO_IND_CALL_STATE_CHANGED;
+    int slow = 0;
+    guint count;
     gulong id[3];
 
+    /* NULL tolerance */
+    radio_instance_set_handler_timing(NULL, TRUE, 0);
+    g_assert(!radio_instance_get_handler_stats(NULL, NULL));
+    count = 1;
+    g_assert(!radio_instance_get_code_stats(NULL, &count));
+    g_assert_cmpuint(count, == ,0);
+    g_assert(!radio_instance_add_slow_handler_handler(NULL, NULL, NULL));
+
     test_service_init(&service);
     remote = test_gbinder_servicemanager_new_service(sm, fqname, service.obj);
-    radio = radio_instance_new_with_version(DEV, slot, RADIO_INTERFACE_1_4);
+    radio = radio_instance_new_with_version(DEV, "slot1", RADIO_INTERFACE_1_4);
+    g_assert(radio);
+    g_assert(!radio_instance_add_slow_handler_handler(radio, NULL, NULL));
+    id[0] = radio_instance_add_indication_handler(radio,
+        RADIO_IND_CALL_STATE_CHANGED, test_handler_timing_slow, NULL);
+    id[1] = radio_instance_add_indication_observer(radio, RADIO_IND_ANY,
+        test_ind_observe, &code);
+    id[2] = radio_instance_add_slow_handler_handler(radio,
+        test_handler_timing_slow_handler, &slow);
 
-    memset(count, 0, sizeof(count));
-    id[0] = radio_instance_add_request_observer(radio, RADIO_REQ_ANY,
-        test_req_observe, count + 0);
-    id[1] = radio_instance_add_request_observer(radio, TEST_REQ,
-        test_req_observe, count + 1);
-    id[2] = radio_instance_add_request_observer(radio, TEST_REQ + 1,
-        test_req_observe, count + 2); /* Won't be called */
-    g_assert(id[0]);
-    g_assert(id[1]);
-    g_assert(id[2]);
+    ind = gbinder_client_new2(service.ind_obj,
+        TEST_ARRAY_AND_COUNT(radio_ind_iface_info));
+    req = gbinder_client_new_request2(ind, RADIO_IND_CALL_STATE_CHANGED);
+    gbinder_local_request_append_int32(req, RADIO_IND_UNSOLICITED);
 
-    req = radio_instance_new_request(radio, TEST_REQ);
-    gbinder_local_request_append_int32(req, 123);
-    g_assert(radio_instance_send_request_sync(radio, TEST_REQ, req));
-    g_assert_cmpint(test_service_req_count(&service, TEST_REQ), == ,1);
-    g_assert_cmpint(count[0], == ,1);
-    g_assert_cmpint(count[1], == ,1);
-    g_assert_cmpint(count[2], == ,0);
-    radio_instance_remove_all_handlers(radio, id);
+    /* Nothing is collected while timing is disabled */
+    g_assert_cmpint(gbinder_client_transact_sync_oneway(ind,
+        RADIO_IND_CALL_STATE_CHANGED, req), == ,GBINDER_STATUS_OK);
+    g_assert_cmpint(code, == ,RADIO_IND_NONE);
+    g_assert(!radio_instance_get_handler_stats(radio, &count));
+    g_assert_cmpuint(count, == ,0);
+    g_assert_cmpint(slow, == ,0);
+
+    /* Enable it and repeat */
+    radio_instance_set_handler_timing(radio, TRUE, TEST_HANDLER_SLOW_MS);
+    radio_instance_set_handler_timing(radio, TRUE, TEST_HANDLER_SLOW_MS);
+    code = RADIO_IND_CALL_STATE_CHANGED;
+    g_assert_cmpint(gbinder_client_transact_sync_oneway(ind,
+        RADIO_IND_CALL_STATE_CHANGED, req), == ,GBINDER_STATUS_OK);
+    g_assert_cmpint(code, == ,RADIO_IND_NONE);
+    g_assert_cmpint(slow, == ,1);
+
+    /* The slow handler comes first */
+    stats = radio_instance_get_handler_stats(radio, &count);
+    g_assert(stats);
+    g_assert_cmpuint(count, == ,2);
+    g_assert_cmpuint(stats[0].id, == ,id[0]);
+    g_assert_cmpint(stats[0].type, == ,RADIO_HANDLER_INDICATION);
+    g_assert_cmpuint(stats[0].code, == ,RADIO_IND_CALL_STATE_CHANGED);
+    g_assert_cmpuint(stats[0].calls, == ,1);
+    g_assert_cmpuint(stats[0].slow_calls, == ,1);
+    g_assert_cmpuint(stats[0].max_usec, >= ,TEST_HANDLER_SLOW_MS * 1000);
+    g_assert_cmpuint(stats[0].total_usec, == ,stats[0].max_usec);
+    g_assert_cmpuint(stats[1].id, == ,id[1]);
+    g_assert_cmpint(stats[1].type, == ,RADIO_HANDLER_INDICATION_OBSERVER);
+    g_assert_cmpuint(stats[1].code, == ,RADIO_IND_ANY);
+    g_assert_cmpuint(stats[1].calls, == ,1);
+    g_free(stats);
+
+    /* Observer time is accounted to the actual code */
+    stats = radio_instance_get_code_stats(radio, &count);
+    g_assert(stats);
+    g_assert_cmpuint(count, == ,2);
+    g_assert_cmpint(stats[0].type, == ,RADIO_HANDLER_INDICATION);
+    g_assert_cmpuint(stats[0].code, == ,RADIO_IND_CALL_STATE_CHANGED);
+    g_assert_cmpuint(stats[0].slow_calls, == ,1);
+    g_assert_cmpint(stats[1].type, == ,RADIO_HANDLER_INDICATION_OBSERVER);
+    g_assert_cmpuint(stats[1].code, == ,RADIO_IND_CALL_STATE_CHANGED);
+    g_assert_cmpuint(stats[1].calls, == ,1);
+    g_free(stats);
+
+    /* Removed handlers disappear from the statistics */
+    radio_instance_remove_handlers(radio, id, 1);
+    stats = radio_instance_get_handler_stats(radio, &count);
+    g_assert_cmpuint(count, == ,1);
+    g_assert_cmpuint(stats[0].id, == ,id[1]);
+    g_free(stats);
+
+    /* Disabling drops everything */
+    radio_instance_set_handler_timing(radio, FALSE, 0);
+    g_assert(!radio_instance_get_code_stats(radio, &count));
+    g_assert_cmpuint(count, == ,0);
 
+    gbinder_local_request_unref(req);
+    gbinder_client_unref(ind);
+    radio_instance_remove_all_handlers(radio, id);
     radio_instance_unref(radio);
     test_service_cleanup(&service);
-    gbinder_local_request_unref(req);
     gbinder_remote_object_unref(remote);
     gbinder_servicemanager_unref(sm);
 }
 
 /*==========================================================================*
- * resp
+ * ind_meter
  *==========================================================================*/
 
-#define TEST_RESP RADIO_RESP_DIAL
-
 static
 void
-test_resp_ack_observe(
-    RadioInstance* radio,
-    RADIO_REQ code,
-    GBinderLocalRequest* args,
-    gpointer user_data)
+test_ind_meter_assert_close(
+    gdouble value,
+    gdouble expected)
 {
-    int* count = user_data;
-
-    (*count)++;
-    GDEBUG_("%d", *count);
-    g_assert_cmpint(code, == ,RADIO_REQ_RESPONSE_ACKNOWLEDGEMENT);
+    g_assert_cmpfloat(value, >= ,expected * 0.998);
+    g_assert_cmpfloat(value, <= ,expected * 1.002);
 }
 
 static
 void
-test_resp_observe1(
-    RadioInstance* radio,
-    RADIO_RESP code,
-    const RadioResponseInfo* info,
-    const GBinderReader* reader,
-    gpointer user_data)
+test_ind_meter(
+    void)
 {
-    guint* expected = user_data;
+    const gint64 sec = G_USEC_PER_SEC;
+    RadioIndMeter* meter = radio_ind_meter_new(1000);
+    GBinderServiceManager* sm = gbinder_servicemanager_new(DEV);
+    GBinderRemoteObject* remote;
+    RadioInstance* radio;
+    TestRadioService service;
+    GBinderClient* ind;
+    GBinderLocalRequest* req;
+    RadioIndRate* rates;
+    const char* fqname = RADIO_1_0 "/slot1";
+    guint count;
+    gint64 t;
+    int i;
+
+    /* NULL tolerance */
+    radio_instance_set_ind_meter(NULL, 1000);
+    g_assert(!radio_instance_get_ind_rates(NULL, RADIO_IND_RATE_BY_COUNT, 0,
+        NULL));
+    count = 1;
+    g_assert(!radio_ind_meter_top(NULL, RADIO_IND_RATE_BY_COUNT, 0, 0,
+        &count));
+    g_assert_cmpuint(count, == ,0);
+    g_assert(!radio_ind_meter_top(meter, RADIO_IND_RATE_BY_COUNT, 0, 0,
+        NULL));
+    g_assert_cmpuint(radio_ind_meter_half_life_ms(NULL), == ,0);
+    g_assert_cmpuint(radio_ind_meter_half_life_ms(meter), == ,1000);
+    radio_ind_meter_free(NULL);
+
+    /* Many small ones vs a single big one */
+    for (i = 0; i < 3; i++) {
+        radio_ind_meter_add(meter, RADIO_IND_CALL_STATE_CHANGED, 100, 0);
+    }
+    radio_ind_meter_add(meter, RADIO_IND_CELL_INFO_LIST, 1000, 0);
+
+    rates = radio_ind_meter_top(meter, RADIO_IND_RATE_BY_COUNT, 0, 0, &count);
+    g_assert_cmpuint(count, == ,2);
+    g_assert_cmpuint(rates[0].code, == ,RADIO_IND_CALL_STATE_CHANGED);
+    g_assert_cmpuint(rates[0].count, == ,3);
+    g_assert_cmpuint(rates[0].bytes, == ,300);
+    test_ind_meter_assert_close(rates[0].rate, 3 * G_LN2);
+    test_ind_meter_assert_close(rates[0].byte_rate, 300 * G_LN2);
+    g_assert_cmpuint(rates[1].code, == ,RADIO_IND_CELL_INFO_LIST);
+    g_free(rates);
+
+    rates = radio_ind_meter_top(meter, RADIO_IND_RATE_BY_BYTES, 1, 0, &count);
+    g_assert_cmpuint(count, == ,1);
+    g_assert_cmpuint(rates[0].code, == ,RADIO_IND_CELL_INFO_LIST);
+    test_ind_meter_assert_close(rates[0].byte_rate, 1000 * G_LN2);
+    g_free(rates);
+
+    /* Rates decay but the counters don't */
+    rates = radio_ind_meter_top(meter, RADIO_IND_RATE_BY_COUNT, 1, sec,
+        &count);
+    g_assert_cmpuint(rates[0].count, == ,3);
+    test_ind_meter_assert_close(rates[0].rate, 3 * G_LN2 / 2);
+    g_free(rates);
+    rates = radio_ind_meter_top(meter, RADIO_IND_RATE_BY_COUNT, 1, 3 * sec / 2,
+        &count);
+    test_ind_meter_assert_close(rates[0].rate, 3 * G_LN2 * 0.35355339);
+    g_free(rates);
+    rates = radio_ind_meter_top(meter, RADIO_IND_RATE_BY_COUNT, 1, 100 * sec,
+        &count);
+    g_assert_cmpuint(rates[0].count, == ,3);
+    g_assert_cmpfloat(rates[0].rate, == ,0);
+    g_free(rates);
+
+    /* Steady 100 per second (discrete events run ~0.35% above that) */
+    for (i = 0, t = 100 * sec; i < 2000; i++, t += sec / 100) {
+        radio_ind_meter_add(meter, RADIO_IND_CURRENT_SIGNAL_STRENGTH, 10, t);
+    }
+    rates = radio_ind_meter_top(meter, RADIO_IND_RATE_BY_COUNT, 0, t, &count);
+    g_assert_cmpuint(count, == ,3);
+    g_assert_cmpuint(rates[0].code, == ,RADIO_IND_CURRENT_SIGNAL_STRENGTH);
+    g_assert_cmpfloat(rates[0].rate, > ,99);
+    g_assert_cmpfloat(rates[0].rate, < ,101);
+    g_free(rates);
+    radio_ind_meter_free(meter);
+
+    /* Now the real thing */
+    test_service_init(&service);
+    remote = test_gbinder_servicemanager_new_service(sm, fqname, service.obj);
+    radio = radio_instance_new_with_version(DEV, "slot1", RADIO_INTERFACE_1_4);
+    g_assert(radio);
+    radio_instance_set_ind_meter(radio, 60000);
+    radio_instance_set_ind_meter(radio, 60000); /* No effect */
 
-    GDEBUG("Observing resp %u (high prio)", code);
-    g_assert_cmpuint(info->serial, == ,*expected);
-    *expected = 0;
+    ind = gbinder_client_new2(service.ind_obj,
+        TEST_ARRAY_AND_COUNT(radio_ind_iface_info));
+    req = gbinder_client_new_request2(ind, RADIO_IND_CALL_STATE_CHANGED);
+    gbinder_local_request_append_int32(req, RADIO_IND_UNSOLICITED);
+    for (i = 0; i < 2; i++) {
+        g_assert_cmpint(gbinder_client_transact_sync_oneway(ind,
+            RADIO_IND_CALL_STATE_CHANGED, req), == ,GBINDER_STATUS_OK);
+    }
+    g_assert_cmpint(gbinder_client_transact_sync_oneway(ind,
+        RADIO_IND_RIL_CONNECTED, req), == ,GBINDER_STATUS_OK);
+    gbinder_local_request_unref(req);
+
+    rates = radio_instance_get_ind_rates(radio, RADIO_IND_RATE_BY_COUNT, 0,
+        &count);
+    g_assert_cmpuint(count, == ,2);
+    g_assert_cmpuint(rates[0].code, == ,RADIO_IND_CALL_STATE_CHANGED);
+    g_assert_cmpuint(rates[0].count, == ,2);
+    g_assert_cmpuint(rates[1].code, == ,RADIO_IND_RIL_CONNECTED);
+    g_assert_cmpuint(rates[1].count, == ,1);
+    g_free(rates);
+
+    /* Changing the half-life starts from scratch */
+    radio_instance_set_ind_meter(radio, 1000);
+    g_assert(!radio_instance_get_ind_rates(radio, RADIO_IND_RATE_BY_COUNT, 0,
+        &count));
+    g_assert_cmpuint(count, == ,0);
+    radio_instance_set_ind_meter(radio, 0);
+
+    gbinder_client_unref(ind);
+    radio_instance_unref(radio);
+    test_service_cleanup(&service);
+    gbinder_remote_object_unref(remote);
+    gbinder_servicemanager_unref(sm);
 }
 
+/*==========================================================================*
+ * ind_filter
+ *==========================================================================*/
+
 static
 void
-test_resp_observe2(
+test_ind_filter_observe(
     RadioInstance* radio,
-    RADIO_RESP code,
-    const RadioResponseInfo* info,
-    const GBinderReader* reader,
+    RADIO_IND code,
+    RADIO_IND_TYPE type,
+    const GBinderReader* args,
     gpointer user_data)
 {
-    guint* expected = user_data;
-
-    /* Serial must be already cleared by test_resp_observe1 */
-    GDEBUG("Observing resp %u (default prio)", code);
-    g_assert_cmpuint(*expected, == ,0);
+    g_assert_not_reached();
 }
 
 static
 gboolean
-test_resp_handle(
+test_ind_filter_handle(
     RadioInstance* radio,
-    RADIO_RESP code,
-    const RadioResponseInfo* info,
-    const GBinderReader* reader,
+    RADIO_IND code,
+    RADIO_IND_TYPE type,
+    const GBinderReader* args,
     gpointer user_data)
 {
-    guint* expected = user_data;
+    g_assert_not_reached();
+    return FALSE;
+}
 
-    GDEBUG("Handling resp %u", code);
-    g_assert_cmpuint(info->serial, == ,*expected);
-    *expected = 0;
-    if (info->type == RADIO_RESP_SOLICITED_ACK_EXP) {
-        radio_instance_ack(radio);
-    }
-    return TRUE;
+static
+void
+test_ind_filter_client_handle(
+    RadioClient* client,
+    RADIO_IND code,
+    const GBinderReader* args,
+    gpointer user_data)
+{
+    g_assert_not_reached();
 }
 
 static
 void
-test_resp(
+test_ind_filter(
     void)
 {
-    const char* slot = "slot2";
-    const char* fqname = RADIO_1_0 "/slot2";
-    TestRadioService service;
+    const RADIO_REQ code = RADIO_REQ_SET_INDICATION_FILTER_1_2;
     GBinderServiceManager* sm = gbinder_servicemanager_new(DEV);
+    GMainLoop* loop = g_main_loop_new(NULL, FALSE);
     GBinderRemoteObject* remote;
-    GBinderLocalRequest* req;
-    GBinderClient* resp;
     RadioInstance* radio;
-    RadioResponseInfo info;
-    GBinderWriter writer;
-    guint handle_serial, observe_serial;
-    int ack_count = 0;
-    gulong id[4];
-
-    test_service_init(&service);
+    RadioClient* client;
+    TestRadioService service;
+    GBinderClient* ind;
+    GBinderLocalRequest* req;
+    const char* fqname = RADIO_1_0 "/slot1";
+    gulong id[3];
 
-    memset(&info, 0, sizeof(info));
-    info.type = RADIO_RESP_SOLICITED_ACK_EXP;
-    handle_serial = observe_serial = info.serial = 123;
+    /* NULL tolerance */
+    g_assert(!radio_instance_set_auto_ind_filter(NULL, TRUE));
+    g_assert_cmpint(radio_instance_get_ind_filter(NULL), == ,
+        RADIO_IND_FILTER_NONE);
 
+    test_service_init(&service);
     remote = test_gbinder_servicemanager_new_service(sm, fqname, service.obj);
-    radio = radio_instance_new_with_version(DEV, slot, RADIO_INTERFACE_1_4);
-    id[0] = radio_instance_add_response_handler(radio, TEST_RESP,
-        test_resp_handle, &handle_serial);
-    id[1] = radio_instance_add_response_observer_with_priority(radio,
-        RADIO_INSTANCE_PRIORITY_HIGHEST, TEST_RESP,
-        test_resp_observe1, &observe_serial);
-    id[2] = radio_instance_add_response_observer(radio, TEST_RESP,
-        test_resp_observe2, &observe_serial);
+    radio = radio_instance_new_with_version(DEV, "slot1", RADIO_INTERFACE_1_4);
+    g_assert(radio);
+    g_assert_cmpint(radio_instance_get_ind_filter(radio), == ,
+        RADIO_IND_FILTER_ALL_1_2);
+
+    /* callStateChanged isn't controlled by the filter */
+    id[0] = radio_instance_add_indication_handler(radio,
+        RADIO_IND_CURRENT_SIGNAL_STRENGTH_1_2, test_ind_filter_handle, NULL);
+    id[1] = radio_instance_add_indication_observer(radio,
+        RADIO_IND_CALL_STATE_CHANGED, test_ind_filter_observe, NULL);
+    g_assert(radio_instance_set_auto_ind_filter(radio, TRUE));
+    g_assert(radio_instance_set_auto_ind_filter(radio, TRUE)); /* No effect */
+
+    /* Nothing is sent until rilConnected */
+    test_quit_later_n(loop, 3);
+    test_run(&test_opt, loop);
+    g_assert_cmpint(test_service_req_count(&service, code), == ,0);
+
+    ind = gbinder_client_new2(service.ind_obj,
+        TEST_ARRAY_AND_COUNT(radio_ind_iface_info));
+    req = gbinder_client_new_request2(ind, RADIO_IND_RIL_CONNECTED);
+    gbinder_local_request_append_int32(req, RADIO_IND_UNSOLICITED);
+    g_assert_cmpint(gbinder_client_transact_sync_oneway(ind,
+        RADIO_IND_RIL_CONNECTED, req), == ,GBINDER_STATUS_OK);
+    gbinder_local_request_unref(req);
+    gbinder_client_unref(ind);
+    g_assert(radio->connected);
+
+    test_quit_later_n(loop, 3);
+    test_run(&test_opt, loop);
+    g_assert_cmpint(test_service_req_count(&service, code), == ,1);
+    g_assert_cmpint(service.ind_filter, == ,RADIO_IND_FILTER_SIGNAL_STRENGTH);
+    g_assert_cmpint(radio_instance_get_ind_filter(radio), == ,
+        RADIO_IND_FILTER_SIGNAL_STRENGTH);
+
+    /* RadioClient handlers count too, but the client itself doesn't */
+    client = radio_client_new(radio);
+    id[2] = radio_client_add_indication_handler(client,
+        RADIO_IND_NETWORK_STATE_CHANGED, test_ind_filter_client_handle, NULL);
+    test_quit_later_n(loop, 3);
+    test_run(&test_opt, loop);
+    g_assert_cmpint(test_service_req_count(&service, code), == ,2);
+    g_assert_cmpint(service.ind_filter, == ,
+        RADIO_IND_FILTER_SIGNAL_STRENGTH |
+        RADIO_IND_FILTER_FULL_NETWORK_STATE);
+
+    /* Removing several handlers at once produces a single update */
+    radio_instance_remove_handler(radio, id[0]);
+    radio_client_remove_handler(client, id[2]);
+    test_quit_later_n(loop, 3);
+    test_run(&test_opt, loop);
+    g_assert_cmpint(test_service_req_count(&service, code), == ,3);
+    g_assert_cmpint(service.ind_filter, == ,RADIO_IND_FILTER_NONE);
+
+    /* Observing everything enables everything */
+    id[0] = radio_instance_add_indication_observer(radio, RADIO_IND_ANY,
+        test_ind_filter_observe, NULL);
+    test_quit_later_n(loop, 3);
+    test_run(&test_opt, loop);
+    g_assert_cmpint(test_service_req_count(&service, code), == ,4);
+    g_assert_cmpint(service.ind_filter, == ,RADIO_IND_FILTER_ALL_1_2);
+
+    /* Handler goes away together with the client */
+    id[2] = radio_client_add_indication_handler(client,
+        RADIO_IND_CURRENT_LINK_CAPACITY_ESTIMATE,
+        test_ind_filter_client_handle, NULL);
+    radio_instance_remove_handler(radio, id[0]);
+    test_quit_later_n(loop, 3);
+    test_run(&test_opt, loop);
+    g_assert_cmpint(test_service_req_count(&service, code), == ,5);
+    g_assert_cmpint(service.ind_filter, == ,
+        RADIO_IND_FILTER_LINK_CAPACITY_ESTIMATE);
+    radio_client_unref(client);
+    test_quit_later_n(loop, 3);
+    test_run(&test_opt, loop);
+    g_assert_cmpint(test_service_req_count(&service, code), == ,6);
+    g_assert_cmpint(service.ind_filter, == ,RADIO_IND_FILTER_NONE);
+
+    /* Turning the automatic mode off restores the default right away */
+    g_assert(radio_instance_set_auto_ind_filter(radio, FALSE));
+    g_assert_cmpint(radio_instance_get_ind_filter(radio), == ,
+        RADIO_IND_FILTER_ALL_1_2);
+    test_quit_later_n(loop, 3);
+    test_run(&test_opt, loop);
+    g_assert_cmpint(test_service_req_count(&service, code), == ,7);
+    g_assert_cmpint(service.ind_filter, == ,RADIO_IND_FILTER_ALL_1_2);
+
+    radio_instance_remove_handler(radio, id[1]);
+    test_quit_later_n(loop, 3);
+    test_run(&test_opt, loop);
+    g_assert_cmpint(test_service_req_count(&service, code), == ,7);
+
+    radio_instance_unref(radio);
+    test_service_cleanup(&service);
+    gbinder_remote_object_unref(remote);
+    gbinder_servicemanager_unref(sm);
+    g_main_loop_unref(loop);
+}
+
+/*==========================================================================*
+ * context
+ *==========================================================================*/
+
+static
+void
+test_context(
+    void)
+{
+    GBinderServiceManager* sm = gbinder_servicemanager_new(DEV);
+    GMainContext* context = g_main_context_new();
+    GBinderRemoteObject* remote;
+    RadioInstance* radio;
+    TestRadioService service;
+    GBinderClient* ind;
+    GBinderLocalRequest* req;
+    const char* fqname = RADIO_1_0 "/slot1";
+    int code = RADIO_IND_CALL_STATE_CHANGED;
+
+    /* NULL tolerance */
+    radio_instance_set_context(NULL, context);
+
+    test_service_init(&service);
+    remote = test_gbinder_servicemanager_new_service(sm, fqname, service.obj);
+    radio = radio_instance_new_with_version(DEV, "slot1", RADIO_INTERFACE_1_4);
+    g_assert(radio);
+    radio_instance_set_context(radio, context);
+    radio_instance_set_context(radio, context); /* No effect */
+    radio_instance_add_indication_observer(radio, RADIO_IND_ANY,
+        test_ind_observe, &code);
+
+    ind = gbinder_client_new2(service.ind_obj,
+        TEST_ARRAY_AND_COUNT(radio_ind_iface_info));
+    req = gbinder_client_new_request2(ind, RADIO_IND_CALL_STATE_CHANGED);
+    gbinder_local_request_append_int32(req, RADIO_IND_UNSOLICITED);
+
+    /* Nothing is delivered until the context gets iterated */
+    g_assert_cmpint(gbinder_client_transact_sync_oneway(ind,
+        RADIO_IND_CALL_STATE_CHANGED, req), == ,GBINDER_STATUS_OK);
+    g_assert_cmpint(code, == ,RADIO_IND_CALL_STATE_CHANGED);
+    while (g_main_context_iteration(context, FALSE));
+    g_assert_cmpint(code, == ,RADIO_IND_NONE);
+
+    /* Back to the default context, dispatched synchronously */
+    radio_instance_set_context(radio, NULL);
+    code = RADIO_IND_CALL_STATE_CHANGED;
+    g_assert_cmpint(gbinder_client_transact_sync_oneway(ind,
+        RADIO_IND_CALL_STATE_CHANGED, req), == ,GBINDER_STATUS_OK);
+    g_assert_cmpint(code, == ,RADIO_IND_NONE);
+
+    /* Pending event keeps the instance alive */
+    radio_instance_set_context(radio, context);
+    code = RADIO_IND_CALL_STATE_CHANGED;
+    g_assert_cmpint(gbinder_client_transact_sync_oneway(ind,
+        RADIO_IND_CALL_STATE_CHANGED, req), == ,GBINDER_STATUS_OK);
+    gbinder_local_request_unref(req);
+    gbinder_client_unref(ind);
+    radio_instance_unref(radio);
+    g_assert_cmpint(code, == ,RADIO_IND_CALL_STATE_CHANGED);
+    while (g_main_context_iteration(context, FALSE));
+    g_assert_cmpint(code, == ,RADIO_IND_NONE);
+    g_main_context_unref(context);
+
+    test_service_cleanup(&service);
+    gbinder_remote_object_unref(remote);
+    gbinder_servicemanager_unref(sm);
+}
+
+/*==========================================================================*
+ * req
+ *==========================================================================*/
+
+#define TEST_REQ RADIO_REQ_DIAL
+
+static
+void
+test_req_observe(
+    RadioInstance* radio,
+    RADIO_REQ code,
+    GBinderLocalRequest* args,
+    gpointer user_data)
+{
+    int* count = user_data;
+
+    (*count)++;
+    GDEBUG_("%d", *count);
+}
+
+static
+void
+test_req(
+    void)
+{
+    const char* slot = "slot1";
+    const char* fqname = RADIO_1_0 "/slot1";
+    TestRadioService service;
+    GBinderServiceManager* sm = gbinder_servicemanager_new(DEV);
+    GBinderRemoteObject* remote;
+    GBinderLocalRequest* req;
+    RadioInstance* radio;
+    int count[3];
+    gulong id[3];
+
+    test_service_init(&service);
+    remote = test_gbinder_servicemanager_new_service(sm, fqname, service.obj);
+    radio = radio_instance_new_with_version(DEV, slot, RADIO_INTERFACE_1_4);
+
+    memset(count, 0, sizeof(count));
+    id[0] = radio_instance_add_request_observer(radio, RADIO_REQ_ANY,
+        test_req_observe, count + 0);
+    id[1] = radio_instance_add_request_observer(radio, TEST_REQ,
+        test_req_observe, count + 1);
+    id[2] = radio_instance_add_request_observer(radio, TEST_REQ + 1,
+        test_req_observe, count + 2); /* Won't be called */
+    g_assert(id[0]);
+    g_assert(id[1]);
+    g_assert(id[2]);
+
+    req = radio_instance_new_request(radio, TEST_REQ);
+    gbinder_local_request_append_int32(req, 123);
+    g_assert(radio_instance_send_request_sync(radio, TEST_REQ, req));
+    g_assert_cmpint(test_service_req_count(&service, TEST_REQ), == ,1);
+    g_assert_cmpint(count[0], == ,1);
+    g_assert_cmpint(count[1], == ,1);
+    g_assert_cmpint(count[2], == ,0);
+    radio_instance_remove_all_handlers(radio, id);
+
+    radio_instance_unref(radio);
+    test_service_cleanup(&service);
+    gbinder_local_request_unref(req);
+    gbinder_remote_object_unref(remote);
+    gbinder_servicemanager_unref(sm);
+}
+
+/*==========================================================================*
+ * recorder
+ *==========================================================================*/
+
+static
+void
+test_recorder(
+    void)
+{
+    const char* slot = "slot1";
+    const char* fqname = RADIO_1_0 "/slot1";
+    TestRadioService service;
+    GBinderServiceManager* sm = gbinder_servicemanager_new(DEV);
+    RadioRecorder* recorder = radio_recorder_new(4, 16);
+    char* dir = g_dir_make_tmp("unit_instance_XXXXXX", NULL);
+    char* file = g_build_filename(dir, "dump", NULL);
+    const RadioRecord* rec;
+    GBinderRemoteObject* remote;
+    GBinderLocalRequest* req;
+    GBinderClient* ind;
+    RadioInstance* radio;
+    gchar* image;
+
+    test_service_init(&service);
+    remote = test_gbinder_servicemanager_new_service(sm, fqname, service.obj);
+    radio = radio_instance_new_with_version(DEV, slot, RADIO_INTERFACE_1_4);
+    radio_instance_set_recorder(NULL, recorder);
+    radio_instance_set_recorder(radio, recorder);
+    radio_instance_set_recorder(radio, recorder); /* Second time is a nop */
+
+    /* Outgoing request */
+    req = radio_instance_new_request(radio, TEST_REQ);
+    gbinder_local_request_append_int32(req, 123);
+    g_assert(radio_instance_send_request_sync(radio, TEST_REQ, req));
+    gbinder_local_request_unref(req);
+    g_assert_cmpuint(radio_recorder_count(recorder), == ,1);
+    g_assert(radio_recorder_dump(recorder, file));
+    g_assert(g_file_get_contents(file, &image, NULL, NULL));
+    rec = (RadioRecord*)(image + sizeof(RadioRecorderHeader));
+    g_assert_cmpuint(rec->seq, == ,1);
+    g_assert_cmpuint(rec->type, == ,RADIO_RECORD_REQUEST);
+    g_assert_cmpuint(rec->code, == ,TEST_REQ);
+    g_assert_cmpuint(rec->serial, == ,123);
+    g_free(image);
+
+    /* Incoming indication */
+    ind = gbinder_client_new2(service.ind_obj,
+        TEST_ARRAY_AND_COUNT(radio_ind_iface_info));
+    req = gbinder_client_new_request2(ind, RADIO_IND_CALL_STATE_CHANGED);
+    gbinder_local_request_append_int32(req, RADIO_IND_UNSOLICITED);
+    g_assert_cmpint(gbinder_client_transact_sync_oneway(ind,
+        RADIO_IND_CALL_STATE_CHANGED, req), == ,GBINDER_STATUS_OK);
+    g_assert_cmpuint(radio_recorder_count(recorder), == ,2);
+
+    /* Nothing is recorded after the recorder is detached */
+    radio_instance_set_recorder(radio, NULL);
+    g_assert_cmpint(gbinder_client_transact_sync_oneway(ind,
+        RADIO_IND_CALL_STATE_CHANGED, req), == ,GBINDER_STATUS_OK);
+    g_assert_cmpuint(radio_recorder_count(recorder), == ,2);
+
+    /* The instance holds its own reference */
+    radio_instance_set_recorder(radio, recorder);
+    radio_recorder_unref(recorder);
+    gbinder_local_request_unref(req);
+    gbinder_client_unref(ind);
+    g_unlink(file);
+    g_rmdir(dir);
+    g_free(file);
+    g_free(dir);
+    radio_instance_unref(radio);
+    test_service_cleanup(&service);
+    gbinder_remote_object_unref(remote);
+    gbinder_servicemanager_unref(sm);
+}
+
+/*==========================================================================*
+ * recorder_ind_filter
+ *==========================================================================*/
+
+static
+void
+test_recorder_ind_filter(
+    void)
+{
+    const RADIO_REQ code = RADIO_REQ_SET_INDICATION_FILTER_1_2;
+    const char* fqname = RADIO_1_0 "/slot1";
+    TestRadioService service;
+    GBinderServiceManager* sm = gbinder_servicemanager_new(DEV);
+    GMainLoop* loop = g_main_loop_new(NULL, FALSE);
+    RadioRecorder* recorder = radio_recorder_new(4, 16);
+    GBinderRemoteObject* remote;
+    GBinderLocalRequest* req;
+    GBinderClient* ind;
+    RadioInstance* radio;
+    gulong id;
+
+    test_service_init(&service);
+    remote = test_gbinder_servicemanager_new_service(sm, fqname, service.obj);
+    radio = radio_instance_new_with_version(DEV, "slot1", RADIO_INTERFACE_1_4);
+    g_assert(radio);
+
+    /* The recorder sees everything but doesn't ask for anything */
+    radio_instance_set_recorder(radio, recorder);
+    id = radio_instance_add_indication_handler(radio,
+        RADIO_IND_CURRENT_SIGNAL_STRENGTH_1_2, test_ind_filter_handle, NULL);
+    g_assert(radio_instance_set_auto_ind_filter(radio, TRUE));
+
+    ind = gbinder_client_new2(service.ind_obj,
+        TEST_ARRAY_AND_COUNT(radio_ind_iface_info));
+    req = gbinder_client_new_request2(ind, RADIO_IND_RIL_CONNECTED);
+    gbinder_local_request_append_int32(req, RADIO_IND_UNSOLICITED);
+    g_assert_cmpint(gbinder_client_transact_sync_oneway(ind,
+        RADIO_IND_RIL_CONNECTED, req), == ,GBINDER_STATUS_OK);
+    gbinder_local_request_unref(req);
+    gbinder_client_unref(ind);
+    g_assert(radio->connected);
+    g_assert_cmpuint(radio_recorder_count(recorder), == ,1);
+
+    test_quit_later_n(loop, 3);
+    test_run(&test_opt, loop);
+    g_assert_cmpint(test_service_req_count(&service, code), == ,1);
+    g_assert_cmpint(service.ind_filter, == ,RADIO_IND_FILTER_SIGNAL_STRENGTH);
+
+    /* Detaching the recorder doesn't change anything either */
+    radio_instance_set_recorder(radio, NULL);
+    radio_recorder_unref(recorder);
+    test_quit_later_n(loop, 3);
+    test_run(&test_opt, loop);
+    g_assert_cmpint(test_service_req_count(&service, code), == ,1);
+
+    radio_instance_remove_handler(radio, id);
+    radio_instance_unref(radio);
+    test_service_cleanup(&service);
+    gbinder_remote_object_unref(remote);
+    gbinder_servicemanager_unref(sm);
+    g_main_loop_unref(loop);
+}
+
+/*==========================================================================*
+ * resp
+ *==========================================================================*/
+
+#define TEST_RESP RADIO_RESP_DIAL
+
+static
+void
+test_resp_ack_observe(
+    RadioInstance* radio,
+    RADIO_REQ code,
+    GBinderLocalRequest* args,
+    gpointer user_data)
+{
+    int* count = user_data;
+
+    (*count)++;
+    GDEBUG_("%d", *count);
+    g_assert_cmpint(code, == ,RADIO_REQ_RESPONSE_ACKNOWLEDGEMENT);
+}
+
+static
+void
+test_resp_observe1(
+    RadioInstance* radio,
+    RADIO_RESP code,
+    const RadioResponseInfo* info,
+    const GBinderReader* reader,
+    gpointer user_data)
+{
+    guint* expected = user_data;
+
+    GDEBUG("Observing resp %u (high prio)", code);
+    g_assert_cmpuint(info->serial, == ,*expected);
+    *expected = 0;
+}
+
+static
+void
+test_resp_observe2(
+    RadioInstance* radio,
+    RADIO_RESP code,
+    const RadioResponseInfo* info,
+    const GBinderReader* reader,
+    gpointer user_data)
+{
+    guint* expected = user_data;
+
+    /* Serial must be already cleared by test_resp_observe1 */
+    GDEBUG("Observing resp %u (default prio)", code);
+    g_assert_cmpuint(*expected, == ,0);
+}
+
+static
+gboolean
+test_resp_handle(
+    RadioInstance* radio,
+    RADIO_RESP code,
+    const RadioResponseInfo* info,
+    const GBinderReader* reader,
+    gpointer user_data)
+{
+    guint* expected = user_data;
+
+    GDEBUG("Handling resp %u", code);
+    g_assert_cmpuint(info->serial, == ,*expected);
+    *expected = 0;
+    if (info->type == RADIO_RESP_SOLICITED_ACK_EXP) {
+        radio_instance_ack(radio);
+    }
+    return TRUE;
+}
+
+static
+void
+test_resp(
+    void)
+{
+    const char* slot = "slot2";
+    const char* fqname = RADIO_1_0 "/slot2";
+    TestRadioService service;
+    GBinderServiceManager* sm = gbinder_servicemanager_new(DEV);
+    GBinderRemoteObject* remote;
+    GBinderLocalRequest* req;
+    GBinderClient* resp;
+    RadioInstance* radio;
+    RadioResponseInfo info;
+    GBinderWriter writer;
+    guint handle_serial, observe_serial;
+    int ack_count = 0;
+    gulong id[4];
+
+    test_service_init(&service);
+
+    memset(&info, 0, sizeof(info));
+    info.type = RADIO_RESP_SOLICITED_ACK_EXP;
+    handle_serial = observe_serial = info.serial = 123;
+
+    remote = test_gbinder_servicemanager_new_service(sm, fqname, service.obj);
+    radio = radio_instance_new_with_version(DEV, slot, RADIO_INTERFACE_1_4);
+    id[0] = radio_instance_add_response_handler(radio, TEST_RESP,
+        test_resp_handle, &handle_serial);
+    id[1] = radio_instance_add_response_observer_with_priority(radio,
+        RADIO_INSTANCE_PRIORITY_HIGHEST, TEST_RESP,
+        test_resp_observe1, &observe_serial);
+    id[2] = radio_instance_add_response_observer(radio, TEST_RESP,
+        test_resp_observe2, &observe_serial);
     id[3] = radio_instance_add_request_observer(radio,
         RADIO_REQ_RESPONSE_ACKNOWLEDGEMENT, test_resp_ack_observe, &ack_count);
 
@@ -1174,6 +2023,443 @@ test_death(
     gbinder_servicemanager_unref(sm);
 }
 
+/*==========================================================================*
+ * async
+ *==========================================================================*/
+
+typedef struct test_async_data {
+    GMainLoop* loop;
+    RadioInstance* radio;
+    int completed;
+    int destroyed;
+} TestAsync;
+
+static
+void
+test_async_cb(
+    RadioInstance* radio,
+    gpointer user_data)
+{
+    TestAsync* test = user_data;
+
+    GDEBUG("instance %p", radio);
+    if (radio) {
+        g_assert(!test->radio || test->radio == radio);
+        radio_instance_ref(radio);
+        radio_instance_unref(test->radio);
+        test->radio = radio;
+    }
+    test->completed++;
+}
+
+static
+void
+test_async_not_reached(
+    RadioInstance* radio,
+    gpointer user_data)
+{
+    g_assert_not_reached();
+}
+
+static
+void
+test_async_destroy_cb(
+    gpointer user_data)
+{
+    TestAsync* test = user_data;
+
+    test->destroyed++;
+    if (test->destroyed == test->completed) {
+        test_quit_later(test->loop);
+    }
+}
+
+static
+void
+test_async_inc_cb(
+    gpointer user_data)
+{
+    (*((int*)user_data))++;
+}
+
+static
+void
+test_async(
+    void)
+{
+    GBinderServiceManager* sm = gbinder_servicemanager_new(DEV);
+    GBinderRemoteObject* remote;
+    RadioInstance* radio;
+    TestRadioService service;
+    TestAsync test;
+    const RADIO_INTERFACE version = RADIO_INTERFACE_1_4;
+    const char* slot = "slot1";
+    const char* fqname = RADIO_1_2 "/slot1";
+    int destroyed = 0;
+    gulong id;
+
+    memset(&test, 0, sizeof(test));
+    test.loop = g_main_loop_new(NULL, FALSE);
+
+    /* Invalid parameters */
+    g_assert(!radio_instance_new_async(NULL, slot, NULL, 0, version,
+        RADIO_AIDL_INTERFACE_NONE, test_async_cb, NULL, &test));
+    g_assert(!radio_instance_new_async(DEV, "", NULL, 0, version,
+        RADIO_AIDL_INTERFACE_NONE, test_async_cb, NULL, &test));
+    g_assert(!radio_instance_new_async(DEV, slot, NULL, 0, version,
+        RADIO_AIDL_INTERFACE_NONE, NULL, NULL, &test));
+    radio_instance_cancel_new(0);
+
+    /* No service => NULL */
+    g_assert(radio_instance_new_async(DEV, slot, NULL, 0, version,
+        RADIO_AIDL_INTERFACE_NONE, test_async_cb, test_async_destroy_cb,
+        &test));
+    test_run(&test_opt, test.loop);
+    g_assert_cmpint(test.completed, == ,1);
+    g_assert_cmpint(test.destroyed, == ,1);
+    g_assert(!test.radio);
+
+    /* Register the service */
+    test_service_init(&service);
+    remote = test_gbinder_servicemanager_new_service(sm, fqname, service.obj);
+
+    /* Cancelling the only caller cancels the whole thing */
+    id = radio_instance_new_async(DEV, slot, NULL, 0, version,
+        RADIO_AIDL_INTERFACE_NONE, test_async_not_reached,
+        test_async_inc_cb, &destroyed);
+    g_assert(id);
+    radio_instance_cancel_new(id);
+    g_assert_cmpint(destroyed, == ,1);
+    radio_instance_cancel_new(id); /* Second time has no effect */
+    g_assert(!radio_instance_get_with_version(DEV, slot, version));
+
+    /* Two callers share the same operation, one of them gets cancelled */
+    test.completed = test.destroyed = 0;
+    g_assert(radio_instance_new_async(DEV, slot, "/ril_0", 0, version,
+        RADIO_AIDL_INTERFACE_NONE, test_async_cb, test_async_destroy_cb,
+        &test));
+    id = radio_instance_new_async(DEV, slot, "/ril_0", 0, version,
+        RADIO_AIDL_INTERFACE_NONE, test_async_not_reached,
+        test_async_inc_cb, &destroyed);
+    g_assert(id);
+    g_assert(radio_instance_new_async(DEV, slot, "/ril_0", 0, version,
+        RADIO_AIDL_INTERFACE_NONE, test_async_cb, test_async_destroy_cb,
+        &test));
+    radio_instance_cancel_new(id);
+    g_assert_cmpint(destroyed, == ,2);
+    test_run(&test_opt, test.loop);
+    g_assert_cmpint(test.completed, == ,2);
+    g_assert_cmpint(test.destroyed, == ,2);
+    g_assert(test.radio);
+    g_assert_cmpint(test.radio->version, == ,RADIO_INTERFACE_1_2);
+    g_assert_cmpstr(test.radio->modem, == ,"/ril_0");
+    g_assert_cmpint(test_service_req_count(&service,
+        RADIO_REQ_SET_RESPONSE_FUNCTIONS), == ,1);
+    g_assert(service.resp_obj);
+    g_assert(service.ind_obj);
+
+    /* The instance is shared with the synchronous API */
+    radio = radio_instance_new_with_version(DEV, slot, version);
+    g_assert(radio == test.radio);
+    radio_instance_unref(radio);
+
+    /* Existing instance is delivered on the next loop iteration */
+    test.completed = test.destroyed = 0;
+    g_assert(radio_instance_new_async(DEV, slot, "/ril_0", 0, version,
+        RADIO_AIDL_INTERFACE_NONE, test_async_cb, test_async_destroy_cb,
+        &test));
+    g_assert(!test.completed);
+    test_run(&test_opt, test.loop);
+    g_assert_cmpint(test.completed, == ,1);
+    g_assert(test.radio == radio);
+    g_assert_cmpint(test_service_req_count(&service,
+        RADIO_REQ_SET_RESPONSE_FUNCTIONS), == ,1);
+
+    radio_instance_unref(test.radio);
+    g_assert(!radio_instance_get_all());
+
+    /* Nothing is published until setResponseFunctions completes */
+    while (g_main_context_iteration(NULL, FALSE));
+    test.radio = NULL;
+    test.completed = test.destroyed = 0;
+    g_assert(radio_instance_new_async(DEV, slot, NULL, 0, RADIO_INTERFACE_1_2,
+        RADIO_AIDL_INTERFACE_NONE, test_async_cb, test_async_destroy_cb,
+        &test));
+    g_assert(g_main_context_iteration(NULL, FALSE)); /* getService */
+    g_assert_cmpint(test_service_req_count(&service,
+        RADIO_REQ_SET_RESPONSE_FUNCTIONS), == ,1);
+    g_assert(!radio_instance_get_with_version(DEV, slot, RADIO_INTERFACE_1_2));
+
+    /* Synchronous creation in the meantime wins */
+    radio = radio_instance_new_with_version(DEV, slot, RADIO_INTERFACE_1_2);
+    g_assert(radio);
+    g_assert_cmpint(test_service_req_count(&service,
+        RADIO_REQ_SET_RESPONSE_FUNCTIONS), == ,2);
+    test_run(&test_opt, test.loop);
+    g_assert_cmpint(test.completed, == ,1);
+    g_assert(test.radio == radio);
+
+    /* The survivor has re-issued its setResponseFunctions after ours */
+    while (g_main_context_iteration(NULL, FALSE));
+    g_assert_cmpint(test_service_req_count(&service,
+        RADIO_REQ_SET_RESPONSE_FUNCTIONS), == ,4);
+    radio_instance_unref(test.radio);
+    radio_instance_unref(radio);
+    g_assert(!radio_instance_get_all());
+
+    test_service_cleanup(&service);
+    gbinder_remote_object_unref(remote);
+    gbinder_servicemanager_unref(sm);
+    g_main_loop_unref(test.loop);
+}
+
+/*==========================================================================*
+ * async_all
+ *==========================================================================*/
+
+typedef struct test_async_all_data {
+    GMainLoop* loop;
+    RadioInstance* radio[4];
+    int completed;
+    int destroyed;
+} TestAsyncAll;
+
+static
+void
+test_async_all_cb(
+    RadioInstance* radio,
+    guint index,
+    gpointer user_data)
+{
+    TestAsyncAll* test = user_data;
+
+    GDEBUG("%u: %p", index, radio);
+    g_assert_cmpuint(index, < ,G_N_ELEMENTS(test->radio));
+    g_assert(!test->radio[index]);
+    test->radio[index] = radio_instance_ref(radio);
+    test->completed++;
+}
+
+static
+void
+test_async_all_not_reached(
+    RadioInstance* radio,
+    guint index,
+    gpointer user_data)
+{
+    g_assert_not_reached();
+}
+
+static
+void
+test_async_all_destroy_cb(
+    gpointer user_data)
+{
+    TestAsyncAll* test = user_data;
+
+    g_assert(!test->destroyed);
+    test->destroyed++;
+    test_quit_later(test->loop);
+}
+
+static
+void
+test_async_all(
+    void)
+{
+    static const RadioInstanceSpec specs[] = {
+        { "slot1", "/ril_0", 0, RADIO_INTERFACE_1_4, RADIO_AIDL_INTERFACE_NONE },
+        { "slot2", "/ril_1", 1, RADIO_INTERFACE_1_4, RADIO_AIDL_INTERFACE_NONE },
+        { "slot3", "/ril_2", 2, RADIO_INTERFACE_1_4, RADIO_AIDL_INTERFACE_NONE },
+        { "", NULL, 0, RADIO_INTERFACE_1_4, RADIO_AIDL_INTERFACE_NONE }
+    };
+    GBinderServiceManager* sm = gbinder_servicemanager_new(DEV);
+    GBinderRemoteObject* remote1;
+    GBinderRemoteObject* remote2;
+    TestRadioService service1, service2;
+    TestAsyncAll test;
+    int destroyed = 0;
+    guint i;
+    gulong id;
+
+    memset(&test, 0, sizeof(test));
+    test.loop = g_main_loop_new(NULL, FALSE);
+    test_service_init(&service1);
+    test_service_init(&service2);
+    remote1 = test_gbinder_servicemanager_new_service(sm,
+        RADIO_1_4 "/slot1", service1.obj);
+    remote2 = test_gbinder_servicemanager_new_service(sm,
+        RADIO_1_2 "/slot2", service2.obj);
+
+    /* Invalid parameters */
+    g_assert(!radio_instance_new_all_async(NULL, specs, 1,
+        test_async_all_cb, NULL, &test));
+    g_assert(!radio_instance_new_all_async(DEV, NULL, 1,
+        test_async_all_cb, NULL, &test));
+    g_assert(!radio_instance_new_all_async(DEV, specs, 0,
+        test_async_all_cb, NULL, &test));
+    g_assert(!radio_instance_new_all_async(DEV, specs, 1,
+        NULL, NULL, &test));
+
+    /* Cancel the whole thing */
+    id = radio_instance_new_all_async(DEV, TEST_ARRAY_AND_COUNT(specs),
+        test_async_all_not_reached, test_async_inc_cb, &destroyed);
+    g_assert(id);
+    radio_instance_cancel_new(id);
+    g_assert_cmpint(destroyed, == ,1);
+    radio_instance_cancel_new(id); /* Second time has no effect */
+    g_assert(!radio_instance_get_all());
+
+    /* And now let it run */
+    g_assert(radio_instance_new_all_async(DEV, TEST_ARRAY_AND_COUNT(specs),
+        test_async_all_cb, test_async_all_destroy_cb, &test));
+    test_run(&test_opt, test.loop);
+    g_assert_cmpint(test.completed, == ,G_N_ELEMENTS(specs));
+    g_assert_cmpint(test.destroyed, == ,1);
+    g_assert(test.radio[0]);
+    g_assert(test.radio[1]);
+    g_assert(!test.radio[2]);
+    g_assert(!test.radio[3]);
+    g_assert_cmpint(test.radio[0]->version, == ,RADIO_INTERFACE_1_4);
+    g_assert_cmpint(test.radio[1]->version, == ,RADIO_INTERFACE_1_2);
+    g_assert_cmpint(test.radio[1]->slot_index, == ,1);
+    g_assert_cmpint(test_service_req_count(&service1,
+        RADIO_REQ_SET_RESPONSE_FUNCTIONS), == ,1);
+    g_assert_cmpint(test_service_req_count(&service2,
+        RADIO_REQ_SET_RESPONSE_FUNCTIONS), == ,1);
+
+    for (i = 0; i < G_N_ELEMENTS(test.radio); i++) {
+        radio_instance_unref(test.radio[i]);
+    }
+    g_assert(!radio_instance_get_all());
+    test_service_cleanup(&service1);
+    test_service_cleanup(&service2);
+    gbinder_remote_object_unref(remote1);
+    gbinder_remote_object_unref(remote2);
+    gbinder_servicemanager_unref(sm);
+    g_main_loop_unref(test.loop);
+}
+
+/*==========================================================================*
+ * version_cache
+ *==========================================================================*/
+
+static
+char*
+test_version_cache_get(
+    const char* file)
+{
+    GKeyFile* k = g_key_file_new();
+    char* value = NULL;
+
+    if (g_key_file_load_from_file(k, file, G_KEY_FILE_NONE, NULL)) {
+        value = g_key_file_get_string(k, DEV, "IRadio/slot1", NULL);
+    }
+    g_key_file_free(k);
+    return value;
+}
+
+static
+void
+test_version_cache_reload(
+    const char* file)
+{
+    radio_version_cache_set_file(NULL);
+    radio_version_cache_set_file(file);
+}
+
+static
+void
+test_version_cache(
+    void)
+{
+    GBinderServiceManager* sm = gbinder_servicemanager_new(DEV);
+    GBinderRemoteObject* remote12;
+    GBinderRemoteObject* remote14;
+    TestRadioService service;
+    RadioInstance* radio;
+    const char* slot = "slot1";
+    char* dir = g_dir_make_tmp("unit_instance_XXXXXX", NULL);
+    char* file = g_build_filename(dir, "cache", NULL);
+    char* bad_file = g_build_filename(dir, "no", "such", "file", NULL);
+    char* value;
+
+    test_service_init(&service);
+    remote12 = test_gbinder_servicemanager_new_service(sm,
+        RADIO_1_2 "/slot1", service.obj);
+    radio_version_cache_set_file(file);
+    radio_version_cache_set_file(file); /* Second time is a nop */
+
+    /* The cache gets populated */
+    radio = radio_instance_new_with_version(DEV, slot, RADIO_INTERFACE_1_4);
+    g_assert(radio);
+    g_assert_cmpint(radio->version, == ,RADIO_INTERFACE_1_2);
+    radio_instance_unref(radio);
+    value = test_version_cache_get(file);
+    g_assert_cmpstr(value, == ,RADIO_1_2 "/slot1");
+    g_free(value);
+
+    /* The cached version is used */
+    test_version_cache_reload(file);
+    radio = radio_instance_new_with_version(DEV, slot, RADIO_INTERFACE_1_4);
+    g_assert(radio);
+    g_assert_cmpint(radio->version, == ,RADIO_INTERFACE_1_2);
+    radio_instance_unref(radio);
+
+    /* Newer version has been registered, the cache gets updated */
+    remote14 = test_gbinder_servicemanager_new_service(sm,
+        RADIO_1_4 "/slot1", service.obj);
+    radio = radio_instance_new_with_version(DEV, slot, RADIO_INTERFACE_1_4);
+    g_assert(radio);
+    g_assert_cmpint(radio->version, == ,RADIO_INTERFACE_1_4);
+    radio_instance_unref(radio);
+    value = test_version_cache_get(file);
+    g_assert_cmpstr(value, == ,RADIO_1_4 "/slot1");
+    g_free(value);
+
+    /* And the updated cache is used after reload */
+    test_version_cache_reload(file);
+    radio = radio_instance_new_with_version(DEV, slot, RADIO_INTERFACE_1_4);
+    g_assert(radio);
+    g_assert_cmpint(radio->version, == ,RADIO_INTERFACE_1_4);
+    radio_instance_unref(radio);
+
+    /* Without the cache the newest one wins */
+    g_assert_cmpint(g_remove(file), == ,0);
+    test_version_cache_reload(file);
+    radio = radio_instance_new_with_version(DEV, slot, RADIO_INTERFACE_1_4);
+    g_assert(radio);
+    g_assert_cmpint(radio->version, == ,RADIO_INTERFACE_1_4);
+    radio_instance_unref(radio);
+    value = test_version_cache_get(file);
+    g_assert_cmpstr(value, == ,RADIO_1_4 "/slot1");
+    g_free(value);
+
+    /* Cached version newer than requested is ignored too */
+    radio = radio_instance_new_with_version(DEV, slot, RADIO_INTERFACE_1_3);
+    g_assert(radio);
+    g_assert_cmpint(radio->version, == ,RADIO_INTERFACE_1_2);
+    radio_instance_unref(radio);
+
+    /* Failure to write the cache is not fatal */
+    radio_version_cache_set_file(bad_file);
+    radio = radio_instance_new_with_version(DEV, slot, RADIO_INTERFACE_1_4);
+    g_assert(radio);
+    g_assert_cmpint(radio->version, == ,RADIO_INTERFACE_1_4);
+    radio_instance_unref(radio);
+
+    radio_version_cache_set_file(NULL);
+    test_service_cleanup(&service);
+    gbinder_remote_object_unref(remote12);
+    gbinder_remote_object_unref(remote14);
+    gbinder_servicemanager_unref(sm);
+    g_assert_cmpint(g_remove(file), == ,0);
+    g_assert_cmpint(g_rmdir(dir), == ,0);
+    g_free(bad_file);
+    g_free(file);
+    g_free(dir);
+}
+
 /*==========================================================================*
  * Common
  *==========================================================================*/
@@ -1186,14 +2472,25 @@ int main(int argc, char* argv[])
     g_test_init(&argc, &argv, NULL);
     g_test_add_func(TEST_("null"), test_null);
     g_test_add_func(TEST_("basic"), test_basic);
+    g_test_add_func(TEST_("iter"), test_iter);
     g_test_add_func(TEST_("connected"), test_connected);
     g_test_add_func(TEST_("ind"), test_ind);
+    g_test_add_func(TEST_("ack_batch"), test_ack_batch);
+    g_test_add_func(TEST_("handler_timing"), test_handler_timing);
+    g_test_add_func(TEST_("ind_meter"), test_ind_meter);
+    g_test_add_func(TEST_("ind_filter"), test_ind_filter);
+    g_test_add_func(TEST_("context"), test_context);
     g_test_add_func(TEST_("req"), test_req);
+    g_test_add_func(TEST_("recorder"), test_recorder);
+    g_test_add_func(TEST_("recorder_ind_filter"), test_recorder_ind_filter);
     g_test_add_func(TEST_("resp"), test_resp);
     g_test_add_func(TEST_("ack"), test_ack);
     g_test_add_func(TEST_("send_req"), test_send_req);
     g_test_add_func(TEST_("enabled"), test_enabled);
     g_test_add_func(TEST_("death"), test_death);
+    g_test_add_func(TEST_("async"), test_async);
+    g_test_add_func(TEST_("async_all"), test_async_all);
+    g_test_add_func(TEST_("version_cache"), test_version_cache);
     test_init(&test_opt, argc, argv);
     return g_test_run();
 }
@@ -0,0 +1,511 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "test_common.h"
+#include "test_gbinder.h"
+#include "test_modem.h"
+
+#include "radio_base.h"
+#include "radio_client.h"
+#include "radio_config.h"
+#include "radio_instance.h"
+#include "radio_metrics.h"
+#include "radio_request.h"
+
+#include <gutil_log.h>
+
+#include <glib/gstdio.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define SLOT "slot1"
+#define LABELS "{slot=\"" SLOT "\",iface=\"radio\"}"
+#define CODE_LABELS(code) "{slot=\"" SLOT "\",iface=\"radio\",code=\"" \
+    code "\"}"
+#define CLIENT_LABELS(n) "{slot=\"" SLOT "\",iface=\"radio\",client=\"" \
+    n "\"}"
+#define CLIENT_CODE_LABELS(n,code) "{slot=\"" SLOT "\",iface=\"radio\"," \
+    "client=\"" n "\",code=\"" code "\"}"
+#define CONFIG_LABELS "{iface=\"config\",version=\"1.1\"}"
+
+static TestOpt test_opt;
+
+static
+void
+test_drain(
+    void)
+{
+    while (g_main_context_iteration(NULL, FALSE));
+}
+
+static
+void
+test_complete(
+    RadioRequest* req,
+    RADIO_TX_STATUS status,
+    RADIO_RESP resp,
+    RADIO_ERROR error,
+    const GBinderReader* args,
+    gpointer user_data)
+{
+    (*(int*)user_data)++;
+}
+
+static
+void
+test_config_complete(
+    RadioRequest* req,
+    RADIO_TX_STATUS status,
+    RADIO_CONFIG_RESP resp,
+    RADIO_ERROR error,
+    const GBinderReader* args,
+    gpointer user_data)
+{
+    (*(int*)user_data)++;
+}
+
+static
+void
+test_submit(
+    RadioClient* client,
+    RADIO_REQ code,
+    guint timeout_ms,
+    int* count)
+{
+    RadioRequest* req = radio_request_new(client, code, NULL,
+        test_complete, NULL, count);
+
+    if (timeout_ms) {
+        radio_request_set_timeout(req, timeout_ms);
+    }
+    g_assert(radio_request_submit(req));
+    radio_request_unref(req);
+}
+
+static
+void
+test_assert_line(
+    const char* text,
+    const char* line)
+{
+    char* str = g_strconcat("\n", line, "\n", NULL);
+
+    if (!strstr(text, str)) {
+        GERR("Missing '%s' in:\n%s", line, text);
+        g_assert_not_reached();
+    }
+    g_free(str);
+}
+
+static
+guint
+test_count_samples(
+    const char* text,
+    const char* sample)
+{
+    char* str = g_strconcat("\n", sample, " ", NULL);
+    const char* ptr = text;
+    guint n = 0;
+
+    while ((ptr = strstr(ptr, str)) != NULL) {
+        ptr++;
+        n++;
+    }
+    g_free(str);
+    return n;
+}
+
+/*==========================================================================*
+ * null
+ *==========================================================================*/
+
+static
+void
+test_null(
+    void)
+{
+    RadioMetrics* metrics = radio_metrics_new();
+    char* text;
+
+    g_assert(!radio_metrics_ref(NULL));
+    radio_metrics_unref(NULL);
+    radio_metrics_add_client(NULL, NULL);
+    radio_metrics_add_config(NULL, NULL);
+    radio_metrics_add_instance(NULL, NULL);
+    radio_metrics_remove_client(NULL, NULL);
+    radio_metrics_remove_config(NULL, NULL);
+    radio_metrics_remove_instance(NULL, NULL);
+    g_assert(!radio_metrics_format(NULL));
+    g_assert(!radio_metrics_export_file(NULL, NULL, 0));
+    g_assert(!radio_metrics_export_socket(NULL, NULL));
+
+    radio_metrics_add_client(metrics, NULL);
+    radio_metrics_add_config(metrics, NULL);
+    radio_metrics_add_instance(metrics, NULL);
+    radio_metrics_remove_client(metrics, NULL);
+    radio_metrics_remove_config(metrics, NULL);
+    radio_metrics_remove_instance(metrics, NULL);
+    g_assert(radio_metrics_export_file(metrics, NULL, 0));
+    g_assert(radio_metrics_export_socket(metrics, NULL));
+
+    /* Nothing but headers */
+    text = radio_metrics_format(metrics);
+    g_assert(text);
+    test_assert_line(text, "# TYPE radio_requests_queued gauge");
+    g_assert(!strstr(text, "{"));
+    g_free(text);
+
+    g_assert(radio_metrics_ref(metrics) == metrics);
+    radio_metrics_unref(metrics);
+    radio_metrics_unref(metrics);
+}
+
+/*==========================================================================*
+ * basic
+ *==========================================================================*/
+
+static
+void
+test_basic(
+    void)
+{
+    TestModem* modem = test_modem_new(TEST_MODEM_RADIO, RADIO_INTERFACE_1_4,
+        SLOT);
+    TestModem* config_modem = test_modem_new(TEST_MODEM_CONFIG,
+        RADIO_CONFIG_INTERFACE_1_1, NULL);
+    RadioInstance* instance = radio_instance_new_with_version
+        (test_modem_dev(modem), SLOT, RADIO_INTERFACE_1_4);
+    RadioClient* client = radio_client_new(instance);
+    RadioConfig* config = radio_config_new_with_version
+        (RADIO_CONFIG_INTERFACE_1_1);
+    RadioMetrics* metrics = radio_metrics_new();
+    TestClock* clock = test_clock_new();
+    RadioClient* client2;
+    RadioRequest* req;
+    TestModemParams params;
+    char* text;
+    int count = 0;
+
+    radio_metrics_add_client(metrics, client);
+    radio_metrics_add_config(metrics, config);
+    radio_instance_set_ind_meter(instance, 60000);
+
+    /* rilConnected is counted */
+    test_drain();
+    g_assert(radio_client_connected(client));
+    test_modem_set_clock(modem, clock);
+    radio_base_set_clock(RADIO_BASE(client),
+        test_clock_radio_base_clock(clock));
+
+    /* One request takes half a second */
+    memset(&params, 0, sizeof(params));
+    params.min_latency_ms = params.max_latency_ms = 500;
+    test_modem_set_params(modem, &params);
+    test_submit(client, RADIO_REQ_GET_MUTE, 0, &count);
+    test_drain();
+    test_clock_advance(clock, 500000);
+    test_drain();
+    g_assert_cmpint(count, == ,1);
+
+    /* Another one never gets a response */
+    params.drop_percent = 100;
+    test_modem_set_params(modem, &params);
+    test_submit(client, RADIO_REQ_GET_MUTE, 1000, &count);
+    test_drain();
+    test_clock_advance(clock, 1000000);
+    test_drain();
+    g_assert_cmpint(count, == ,2);
+
+    /* And one is still pending */
+    test_submit(client, RADIO_REQ_GET_MUTE, 0, &count);
+    test_drain();
+
+    /* Config request and indication */
+    req = radio_config_request_new(config, RADIO_CONFIG_REQ_GET_MODEMS_CONFIG,
+        NULL, test_config_complete, NULL, &count);
+    g_assert(radio_request_submit(req));
+    radio_request_unref(req);
+    test_drain();
+    g_assert_cmpint(count, == ,3);
+    g_assert(test_modem_indication(modem, RADIO_IND_CALL_STATE_CHANGED,
+        RADIO_IND_UNSOLICITED, NULL, 0));
+
+    text = radio_metrics_format(metrics);
+    GDEBUG("\n%s", text);
+    test_assert_line(text, "# TYPE radio_requests_submitted_total counter");
+    test_assert_line(text, "radio_requests_queued" CLIENT_LABELS("0") " 0");
+    test_assert_line(text, "radio_requests_pending" CLIENT_LABELS("0") " 1");
+    test_assert_line(text, "radio_requests_submitted_total"
+        CLIENT_LABELS("0") " 3");
+    test_assert_line(text, "radio_requests_completed_total"
+        CLIENT_LABELS("0") " 1");
+    test_assert_line(text, "radio_requests_failed_total"
+        CLIENT_LABELS("0") " 1");
+    test_assert_line(text, "radio_requests_timeouts_total"
+        CLIENT_LABELS("0") " 1");
+    test_assert_line(text, "radio_requests_retries_total"
+        CLIENT_LABELS("0") " 0");
+    test_assert_line(text, "radio_request_latency_seconds_sum"
+        CLIENT_CODE_LABELS("0", "getMute") " 0.5");
+    test_assert_line(text, "radio_request_latency_seconds_count"
+        CLIENT_CODE_LABELS("0", "getMute") " 1");
+    test_assert_line(text, "radio_request_latency_max_seconds"
+        CLIENT_CODE_LABELS("0", "getMute") " 0.5");
+    test_assert_line(text, "radio_instance_connected" LABELS " 1");
+    test_assert_line(text, "radio_instance_dead" LABELS " 0");
+    test_assert_line(text, "radio_instance_connects_total" LABELS " 1");
+    test_assert_line(text, "radio_instance_deaths_total" LABELS " 0");
+    test_assert_line(text, "radio_indications_total"
+        CODE_LABELS("callStateChanged") " 1");
+    test_assert_line(text, "radio_requests_completed_total"
+        CONFIG_LABELS " 1");
+    test_assert_line(text, "radio_instance_dead" CONFIG_LABELS " 0");
+    g_assert(!strstr(text, "radio_instance_connected" CONFIG_LABELS));
+    g_free(text);
+
+    /* Second client on the same instance and duplicate additions */
+    client2 = radio_client_new(instance);
+    radio_metrics_add_client(metrics, client2);
+    radio_metrics_add_client(metrics, client);
+    radio_metrics_add_config(metrics, config);
+    radio_metrics_add_instance(metrics, instance);
+    text = radio_metrics_format(metrics);
+    GDEBUG("\n%s", text);
+    test_assert_line(text, "radio_requests_submitted_total"
+        CLIENT_LABELS("0") " 3");
+    test_assert_line(text, "radio_requests_submitted_total"
+        CLIENT_LABELS("1") " 0");
+    g_assert(!strstr(text, "client=\"2\""));
+    g_assert_cmpuint(test_count_samples(text, "radio_requests_submitted_total"
+        CLIENT_LABELS("0")), == ,1);
+    g_assert_cmpuint(test_count_samples(text, "radio_instance_connected"
+        LABELS), == ,1);
+    g_assert_cmpuint(test_count_samples(text, "radio_instance_connects_total"
+        LABELS), == ,1);
+    g_assert_cmpuint(test_count_samples(text, "radio_indications_total"
+        CODE_LABELS("callStateChanged")), == ,1);
+    g_assert_cmpuint(test_count_samples(text, "radio_requests_completed_total"
+        CONFIG_LABELS), == ,1);
+    g_free(text);
+    radio_metrics_remove_instance(metrics, instance);
+    radio_metrics_remove_client(metrics, client2);
+    radio_client_unref(client2);
+
+    /* Removed objects disappear */
+    radio_metrics_remove_instance(metrics, instance); /* Not a bare one */
+    radio_metrics_remove_client(metrics, client);
+    radio_metrics_remove_config(metrics, config);
+    text = radio_metrics_format(metrics);
+    g_assert(!strstr(text, "{"));
+    g_free(text);
+
+    radio_metrics_add_client(metrics, client);
+    radio_metrics_add_config(metrics, config);
+    radio_metrics_unref(metrics);
+    radio_client_unref(client);
+    radio_instance_unref(instance);
+    radio_config_unref(config);
+    test_modem_free(modem);
+    test_modem_free(config_modem);
+    test_clock_free(clock);
+}
+
+/*==========================================================================*
+ * file
+ *==========================================================================*/
+
+static
+void
+test_file(
+    void)
+{
+    TestModem* modem = test_modem_new(TEST_MODEM_RADIO, RADIO_INTERFACE_1_4,
+        SLOT);
+    RadioInstance* instance = radio_instance_new_with_version
+        (test_modem_dev(modem), SLOT, RADIO_INTERFACE_1_4);
+    RadioMetrics* metrics = radio_metrics_new();
+    char* dir = g_dir_make_tmp("unit_metrics_XXXXXX", NULL);
+    char* file = g_build_filename(dir, "metrics", NULL);
+    char* bad_file = g_build_filename(dir, "no", "such", "file", NULL);
+    char* text = NULL;
+
+    radio_metrics_add_instance(metrics, instance);
+    g_assert(!radio_metrics_export_file(metrics, bad_file, 10));
+
+    /* Written right away */
+    g_assert(radio_metrics_export_file(metrics, file, 10));
+    g_assert(g_file_get_contents(file, &text, NULL, NULL));
+    test_assert_line(text, "radio_instance_dead" LABELS " 0");
+    g_free(text);
+
+    /* And then again */
+    g_assert(g_unlink(file) == 0);
+    while (!g_file_test(file, G_FILE_TEST_EXISTS)) {
+        g_main_context_iteration(NULL, TRUE);
+    }
+
+    /* Stop it */
+    g_assert(radio_metrics_export_file(metrics, NULL, 0));
+    g_assert(g_unlink(file) == 0);
+    test_drain();
+    g_assert(!g_file_test(file, G_FILE_TEST_EXISTS));
+
+    /* Write once */
+    radio_metrics_remove_instance(metrics, instance);
+    g_assert(radio_metrics_export_file(metrics, file, 0));
+    g_assert(g_file_get_contents(file, &text, NULL, NULL));
+    g_assert(!strstr(text, "{"));
+    g_free(text);
+    radio_metrics_unref(metrics);
+    g_assert(g_unlink(file) == 0);
+
+    g_rmdir(dir);
+    g_free(bad_file);
+    g_free(file);
+    g_free(dir);
+    radio_instance_unref(instance);
+    test_modem_free(modem);
+}
+
+/*==========================================================================*
+ * socket
+ *==========================================================================*/
+
+static
+char*
+test_socket_read(
+    const char* path)
+{
+    GByteArray* buf = g_byte_array_new();
+    struct sockaddr_un addr;
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    guint8 chunk[256];
+    ssize_t n;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    g_assert(connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0);
+
+    /* Let the server accept the connection and write the reply */
+    do {
+        test_drain();
+        n = read(fd, chunk, sizeof(chunk));
+        if (n > 0) {
+            g_byte_array_append(buf, chunk, n);
+        }
+    } while (n > 0);
+    close(fd);
+    g_byte_array_append(buf, (const guint8*) "", 1);
+    return (char*) g_byte_array_free(buf, FALSE);
+}
+
+static
+void
+test_socket(
+    void)
+{
+    TestModem* modem = test_modem_new(TEST_MODEM_RADIO, RADIO_INTERFACE_1_4,
+        SLOT);
+    RadioInstance* instance = radio_instance_new_with_version
+        (test_modem_dev(modem), SLOT, RADIO_INTERFACE_1_4);
+    RadioClient* client = radio_client_new(instance);
+    RadioMetrics* metrics = radio_metrics_new();
+    char* dir = g_dir_make_tmp("unit_metrics_XXXXXX", NULL);
+    char* path = g_build_filename(dir, "socket", NULL);
+    char* bad_path = g_build_filename(dir, "no", "such", "socket", NULL);
+    char* long_path = g_strnfill(200, 'x');
+    char* text;
+
+    radio_metrics_add_client(metrics, client);
+    g_assert(!radio_metrics_export_socket(metrics, long_path));
+    g_assert(!radio_metrics_export_socket(metrics, bad_path));
+    g_assert(radio_metrics_export_socket(metrics, path));
+
+    /* Each connection gets a snapshot */
+    text = test_socket_read(path);
+    test_assert_line(text, "radio_requests_queued" CLIENT_LABELS("0") " 0");
+    g_free(text);
+    text = test_socket_read(path);
+    test_assert_line(text, "radio_requests_pending" CLIENT_LABELS("0") " 0");
+    g_free(text);
+
+    /* Stopping removes the socket */
+    g_assert(radio_metrics_export_socket(metrics, NULL));
+    g_assert(!g_file_test(path, G_FILE_TEST_EXISTS));
+
+    /* And so does unref */
+    g_assert(radio_metrics_export_socket(metrics, path));
+    g_assert(g_file_test(path, G_FILE_TEST_EXISTS));
+    radio_metrics_unref(metrics);
+    g_assert(!g_file_test(path, G_FILE_TEST_EXISTS));
+
+    g_rmdir(dir);
+    g_free(long_path);
+    g_free(bad_path);
+    g_free(path);
+    g_free(dir);
+    radio_client_unref(client);
+    radio_instance_unref(instance);
+    test_modem_free(modem);
+}
+
+/*==========================================================================*
+ * Common
+ *==========================================================================*/
+
+#define TEST_PREFIX "/metrics/"
+#define TEST_(t) TEST_PREFIX t
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_null);
+    g_test_add_func(TEST_("basic"), test_basic);
+    g_test_add_func(TEST_("file"), test_file);
+    g_test_add_func(TEST_("socket"), test_socket);
+    test_init(&test_opt, argc, argv);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,844 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+#include "test_common.h"
+#include "test_gbinder.h"
+#include "test_modem.h"
+
+#include "radio_base.h"
+#include "radio_client.h"
+#include "radio_config.h"
+#include "radio_instance.h"
+#include "radio_request.h"
+#include "radio_util.h"
+
+#include <gutil_log.h>
+
+#define SLOT "slot1"
+
+static TestOpt test_opt;
+
+typedef struct test_result {
+    guint count;
+    RADIO_TX_STATUS status;
+    guint resp;
+    RADIO_ERROR error;
+    gint32 value;
+} TestResult;
+
+static
+void
+test_drain(
+    void)
+{
+    while (g_main_context_iteration(NULL, FALSE));
+}
+
+static
+void
+test_result_set(
+    TestResult* result,
+    RADIO_TX_STATUS status,
+    guint resp,
+    RADIO_ERROR error,
+    const GBinderReader* args)
+{
+    result->count++;
+    result->status = status;
+    result->resp = resp;
+    result->error = error;
+    if (args) {
+        GBinderReader reader;
+
+        gbinder_reader_copy(&reader, args);
+        gbinder_reader_read_int32(&reader, &result->value);
+    }
+}
+
+static
+void
+test_complete(
+    RadioRequest* req,
+    RADIO_TX_STATUS status,
+    RADIO_RESP resp,
+    RADIO_ERROR error,
+    const GBinderReader* args,
+    gpointer user_data)
+{
+    test_result_set(user_data, status, resp, error, args);
+}
+
+static
+void
+test_config_complete(
+    RadioRequest* req,
+    RADIO_TX_STATUS status,
+    RADIO_CONFIG_RESP resp,
+    RADIO_ERROR error,
+    const GBinderReader* args,
+    gpointer user_data)
+{
+    test_result_set(user_data, status, resp, error, args);
+}
+
+static
+void
+test_submit(
+    RadioClient* client,
+    RADIO_REQ code,
+    guint timeout_ms,
+    TestResult* result)
+{
+    RadioRequest* req = radio_request_new(client, code, NULL,
+        test_complete, NULL, result);
+
+    if (timeout_ms) {
+        radio_request_set_timeout(req, timeout_ms);
+    }
+    g_assert(radio_request_submit(req));
+    radio_request_unref(req);
+}
+
+static
+void
+test_submit_config(
+    RadioConfig* config,
+    RADIO_CONFIG_REQ code,
+    TestResult* result)
+{
+    RadioRequest* req = radio_config_request_new(config, code, NULL,
+        test_config_complete, NULL, result);
+
+    g_assert(radio_request_submit(req));
+    radio_request_unref(req);
+}
+
+static
+void
+test_count_ind(
+    RadioClient* client,
+    RADIO_IND code,
+    const GBinderReader* reader,
+    gpointer user_data)
+{
+    (*(guint*)user_data)++;
+}
+
+static
+void
+test_payload(
+    TestModem* modem,
+    guint req,
+    guint resp,
+    GBinderReader* args,
+    GBinderWriter* payload,
+    gpointer user_data)
+{
+    gbinder_writer_append_int32(payload, GPOINTER_TO_INT(user_data));
+}
+
+/*==========================================================================*
+ * radio
+ *==========================================================================*/
+
+static
+void
+test_radio(
+    void)
+{
+    int v;
+
+    for (v = RADIO_INTERFACE_1_0; v < RADIO_INTERFACE_COUNT; v++) {
+        TestModem* modem = test_modem_new(TEST_MODEM_RADIO, v, SLOT);
+        RadioInstance* instance = radio_instance_new_with_version
+            (test_modem_dev(modem), SLOT, v);
+        RadioClient* client = radio_client_new(instance);
+        TestModemStats stats;
+        TestResult result;
+
+        memset(&result, 0, sizeof(result));
+        g_assert(test_modem_connected(modem));
+        g_assert_cmpint(instance->version, == ,v);
+
+        /* rilConnected arrives from an idle callback */
+        g_assert(!radio_client_connected(client));
+        test_drain();
+        g_assert(radio_client_connected(client));
+
+        test_modem_set_payload_func(modem, test_payload, GINT_TO_POINTER(v));
+        test_submit(client, RADIO_REQ_GET_MUTE, 0, &result);
+        test_drain();
+        g_assert_cmpuint(result.count, == ,1);
+        g_assert_cmpint(result.status, == ,RADIO_TX_STATUS_OK);
+        g_assert_cmpint(result.error, == ,RADIO_ERROR_NONE);
+        g_assert_cmpuint(result.resp, == ,radio_req_resp2(RADIO_REQ_GET_MUTE,
+            v));
+        g_assert_cmpint(result.value, == ,v);
+
+        test_modem_get_stats(modem, &stats);
+        g_assert_cmpuint(stats.requests, == ,1);
+        g_assert_cmpuint(stats.responses, == ,1);
+        g_assert_cmpuint(stats.indications, == ,1);
+        g_assert_cmpuint(stats.errors, == ,0);
+
+        radio_client_unref(client);
+        radio_instance_unref(instance);
+        test_modem_free(modem);
+    }
+}
+
+/*==========================================================================*
+ * faults
+ *==========================================================================*/
+
+static
+void
+test_faults(
+    void)
+{
+    TestModem* modem = test_modem_new(TEST_MODEM_RADIO, RADIO_INTERFACE_1_4,
+        SLOT);
+    RadioInstance* instance = radio_instance_new_with_version
+        (test_modem_dev(modem), SLOT, RADIO_INTERFACE_1_4);
+    RadioClient* client = radio_client_new(instance);
+    TestClock* clock = test_clock_new();
+    TestModemParams params;
+    TestModemStats stats;
+    TestResult result;
+    RadioRequest* req;
+
+    test_drain();
+    test_modem_set_clock(modem, clock);
+    radio_base_set_clock(RADIO_BASE(client),
+        test_clock_radio_base_clock(clock));
+
+    /* Every response carries an error */
+    memset(&params, 0, sizeof(params));
+    params.error_percent = 100;
+    params.error = RADIO_ERROR_RADIO_NOT_AVAILABLE;
+    test_modem_set_params(modem, &params);
+    memset(&result, 0, sizeof(result));
+    test_submit(client, RADIO_REQ_GET_MUTE, 0, &result);
+    test_drain();
+    test_clock_advance(clock, 0);
+    test_drain();
+    g_assert_cmpuint(result.count, == ,1);
+    g_assert_cmpint(result.status, == ,RADIO_TX_STATUS_OK);
+    g_assert_cmpint(result.error, == ,RADIO_ERROR_RADIO_NOT_AVAILABLE);
+
+    /* No response ever comes back */
+    memset(&params, 0, sizeof(params));
+    params.drop_percent = 100;
+    test_modem_set_params(modem, &params);
+    memset(&result, 0, sizeof(result));
+    test_submit(client, RADIO_REQ_GET_MUTE, 1000, &result);
+    test_drain();
+    test_clock_advance(clock, 999000);
+    test_drain();
+    g_assert_cmpuint(result.count, == ,0);
+    test_clock_advance(clock, 1000);
+    test_drain();
+    g_assert_cmpuint(result.count, == ,1);
+    g_assert_cmpint(result.status, == ,RADIO_TX_STATUS_TIMEOUT);
+
+    /* Changing the timeout of a pending request follows the same clock */
+    memset(&result, 0, sizeof(result));
+    req = radio_request_new(client, RADIO_REQ_GET_MUTE, NULL,
+        test_complete, NULL, &result);
+    radio_request_set_timeout(req, 1000);
+    g_assert(radio_request_submit(req));
+    test_drain();
+    test_clock_advance(clock, 500000);
+    test_drain();
+    radio_request_set_timeout(req, 2000);
+    test_clock_advance(clock, 1999000);
+    test_drain();
+    g_assert_cmpuint(result.count, == ,0);
+    test_clock_advance(clock, 1000);
+    test_drain();
+    g_assert_cmpuint(result.count, == ,1);
+    g_assert_cmpint(result.status, == ,RADIO_TX_STATUS_TIMEOUT);
+    radio_request_unref(req);
+
+    test_modem_get_stats(modem, &stats);
+    g_assert_cmpuint(stats.requests, == ,3);
+    g_assert_cmpuint(stats.responses, == ,1);
+    g_assert_cmpuint(stats.errors, == ,1);
+    g_assert_cmpuint(stats.dropped, == ,2);
+    g_assert_cmpuint(stats.unknown, == ,0);
+
+    radio_client_unref(client);
+    radio_instance_unref(instance);
+    test_modem_free(modem);
+    test_clock_free(clock);
+}
+
+/*==========================================================================*
+ * latency
+ *==========================================================================*/
+
+static
+void
+test_latency(
+    void)
+{
+    TestModem* modem = test_modem_new(TEST_MODEM_RADIO, RADIO_INTERFACE_1_2,
+        SLOT);
+    RadioInstance* instance = radio_instance_new_with_version
+        (test_modem_dev(modem), SLOT, RADIO_INTERFACE_1_2);
+    RadioClient* client = radio_client_new(instance);
+    TestClock* clock = test_clock_new();
+    TestModemParams params;
+    TestModemStats stats;
+    TestResult result[2];
+
+    test_drain();
+    test_modem_set_clock(modem, clock);
+    radio_base_set_clock(RADIO_BASE(client),
+        test_clock_radio_base_clock(clock));
+
+    memset(&params, 0, sizeof(params));
+    params.min_latency_ms = 500;
+    params.max_latency_ms = 500;
+    params.ack_percent = 100;
+    test_modem_set_params(modem, &params);
+    memset(result, 0, sizeof(result));
+    test_submit(client, RADIO_REQ_GET_MUTE, 0, result);
+    test_submit(client, RADIO_REQ_GET_MUTE, 0, result + 1);
+    test_drain();
+
+    /* Acked right away, answered 500 ms later */
+    test_modem_get_stats(modem, &stats);
+    g_assert_cmpuint(stats.ack_requests, == ,2);
+    test_clock_advance(clock, 499000);
+    test_drain();
+    g_assert_cmpuint(result[0].count, == ,0);
+    g_assert_cmpuint(result[1].count, == ,0);
+    test_clock_advance(clock, 1000);
+    test_drain();
+    g_assert_cmpuint(result[0].count, == ,1);
+    g_assert_cmpuint(result[1].count, == ,1);
+    g_assert_cmpint(result[0].status, == ,RADIO_TX_STATUS_OK);
+    g_assert_cmpint(result[1].status, == ,RADIO_TX_STATUS_OK);
+
+    /* Pending responses are dropped together with the modem */
+    test_submit(client, RADIO_REQ_GET_MUTE, 0, result);
+    test_drain();
+    g_assert_cmpuint(test_clock_count(clock), > ,0);
+
+    radio_client_unref(client);
+    radio_instance_unref(instance);
+    test_modem_free(modem);
+    test_clock_free(clock);
+}
+
+/*==========================================================================*
+ * indications
+ *==========================================================================*/
+
+static
+void
+test_indications(
+    void)
+{
+    TestModem* modem = test_modem_new(TEST_MODEM_RADIO, RADIO_INTERFACE_1_0,
+        SLOT);
+    RadioInstance* instance = radio_instance_new_with_version
+        (test_modem_dev(modem), SLOT, RADIO_INTERFACE_1_0);
+    RadioClient* client = radio_client_new(instance);
+    TestClock* clock = test_clock_new();
+    TestModemStats stats;
+    guint count = 0;
+    gulong id;
+    guint stream;
+
+    test_drain();
+    test_modem_set_clock(modem, clock);
+    id = radio_client_add_indication_handler(client,
+        RADIO_IND_CALL_STATE_CHANGED, test_count_ind, &count);
+
+    /* 5 indications, 100 ms apart */
+    test_modem_add_indication_stream(modem, RADIO_IND_CALL_STATE_CHANGED,
+        RADIO_IND_ACK_EXP, 100, 5);
+    test_clock_advance(clock, 99000);
+    g_assert_cmpuint(count, == ,0);
+    test_clock_advance(clock, 1000);
+    g_assert_cmpuint(count, == ,1);
+    test_clock_advance(clock, 1000000);
+    g_assert_cmpuint(count, == ,5);
+    g_assert_cmpuint(test_clock_count(clock), == ,0);
+
+    /* Endless stream */
+    stream = test_modem_add_indication_stream(modem,
+        RADIO_IND_CALL_STATE_CHANGED, RADIO_IND_UNSOLICITED, 10, 0);
+    test_clock_advance(clock, 100000);
+    g_assert_cmpuint(count, == ,15);
+    test_modem_remove_indication_stream(modem, stream);
+    test_modem_remove_indication_stream(modem, stream);
+    g_assert_cmpuint(test_clock_count(clock), == ,0);
+
+    /* Unhandled ACK_EXP indications get acked */
+    test_modem_get_stats(modem, &stats);
+    g_assert_cmpuint(stats.indications, == ,16); /* Including rilConnected */
+    g_assert_cmpuint(stats.acks, == ,5);
+
+    radio_client_remove_handler(client, id);
+    radio_client_unref(client);
+    radio_instance_unref(instance);
+    test_modem_free(modem);
+    test_clock_free(clock);
+}
+
+/*==========================================================================*
+ * power_save
+ *==========================================================================*/
+
+typedef struct test_power_save {
+    guint requests;             /* getMute */
+    guint device_state;         /* sendDeviceState */
+    gboolean power_save;        /* Last sendDeviceState */
+    gint32 ind_filter;          /* Last setIndicationFilter */
+} TestPowerSave;
+
+static
+void
+test_power_save_payload(
+    TestModem* modem,
+    guint req,
+    guint resp,
+    GBinderReader* args,
+    GBinderWriter* payload,
+    gpointer user_data)
+{
+    TestPowerSave* test = user_data;
+    gint32 type = -1;
+
+    switch (req) {
+    case RADIO_REQ_GET_MUTE:
+        test->requests++;
+        break;
+    case RADIO_REQ_SEND_DEVICE_STATE:
+        test->device_state++;
+        g_assert(gbinder_reader_read_int32(args, &type));
+        g_assert_cmpint(type, == ,RADIO_DEVICE_STATE_POWER_SAVE_MODE);
+        g_assert(gbinder_reader_read_bool(args, &test->power_save));
+        break;
+    case RADIO_REQ_SET_INDICATION_FILTER_1_5:
+        g_assert(gbinder_reader_read_int32(args, &test->ind_filter));
+        break;
+    default:
+        g_assert_not_reached();
+    }
+}
+
+static
+void
+test_submit_background(
+    RadioClient* client,
+    TestResult* result)
+{
+    RadioRequest* req = radio_request_new(client, RADIO_REQ_GET_MUTE, NULL,
+        test_complete, NULL, result);
+
+    radio_request_set_background(req, TRUE);
+    g_assert(radio_request_submit(req));
+    radio_request_unref(req);
+}
+
+static
+void
+test_power_save(
+    void)
+{
+    TestModem* modem = test_modem_new(TEST_MODEM_RADIO, RADIO_INTERFACE_1_5,
+        SLOT);
+    RadioInstance* instance = radio_instance_new_with_version
+        (test_modem_dev(modem), SLOT, RADIO_INTERFACE_1_5);
+    RadioClient* client = radio_client_new(instance);
+    RadioClient* client2 = radio_client_new(instance);
+    TestClock* clock = test_clock_new();
+    const RADIO_IND_FILTER essential = RADIO_IND_FILTER_REGISTRATION_FAILURE |
+        RADIO_IND_FILTER_BARRING_INFO;
+    TestPowerSave test;
+    TestResult result[3];
+
+    memset(&test, 0, sizeof(test));
+    memset(result, 0, sizeof(result));
+    test.ind_filter = -1;
+    test_modem_set_payload_func(modem, test_power_save_payload, &test);
+    test_drain();
+    g_assert(radio_client_connected(client));
+    radio_base_set_clock(RADIO_BASE(client),
+        test_clock_radio_base_clock(clock));
+
+    /* NULL resistance */
+    radio_client_set_power_save(NULL, TRUE);
+    radio_client_set_batch_window(NULL, 1000);
+    radio_request_set_background(NULL, TRUE);
+
+    /* Background requests aren't held outside of power save */
+    test_submit_background(client, result);
+    test_drain();
+    g_assert_cmpuint(test.requests, == ,1);
+    g_assert_cmpuint(result[0].count, == ,1);
+
+    /* The modem is told about power save, indications are cut down */
+    radio_client_set_batch_window(client, 1000);
+    radio_client_set_power_save(client, TRUE);
+    radio_client_set_power_save(client, TRUE);
+    test_drain();
+    g_assert_cmpuint(test.device_state, == ,1);
+    g_assert(test.power_save);
+    g_assert_cmpint(test.ind_filter, == ,essential);
+    g_assert_cmpint(radio_instance_get_ind_filter(instance), == ,essential);
+
+    /* The modem only hears about the first and the last client */
+    radio_client_set_power_save(client2, TRUE);
+    test_drain();
+    g_assert_cmpuint(test.device_state, == ,1);
+    radio_client_set_power_save(client2, FALSE);
+    test_drain();
+    g_assert_cmpuint(test.device_state, == ,1);
+    g_assert(test.power_save);
+
+    /* Background requests are held until the batch window expires */
+    test_submit_background(client, result + 1);
+    test_submit_background(client, result + 2);
+    test_drain();
+    g_assert_cmpuint(test.requests, == ,1);
+    test_clock_advance(clock, 999000);
+    test_drain();
+    g_assert_cmpuint(test.requests, == ,1);
+    test_clock_advance(clock, 1000);
+    test_drain();
+    g_assert_cmpuint(test.requests, == ,3);
+    g_assert_cmpuint(result[1].count, == ,1);
+    g_assert_cmpuint(result[2].count, == ,1);
+    g_assert_cmpint(result[1].status, == ,RADIO_TX_STATUS_OK);
+    g_assert_cmpint(result[2].status, == ,RADIO_TX_STATUS_OK);
+
+    /* A regular request takes the batch along */
+    test_submit_background(client, result + 1);
+    test_drain();
+    g_assert_cmpuint(test.requests, == ,3);
+    test_submit(client, RADIO_REQ_GET_MUTE, 0, result + 2);
+    test_drain();
+    g_assert_cmpuint(test.requests, == ,5);
+    g_assert_cmpuint(result[1].count, == ,2);
+    g_assert_cmpuint(result[2].count, == ,2);
+
+    /* So does leaving power save */
+    test_submit_background(client, result + 1);
+    test_drain();
+    g_assert_cmpuint(test.requests, == ,5);
+    radio_client_set_power_save(client, FALSE);
+    test_drain();
+    g_assert_cmpuint(test.requests, == ,6);
+    g_assert_cmpuint(result[1].count, == ,3);
+    g_assert_cmpuint(test.device_state, == ,2);
+    g_assert(!test.power_save);
+    g_assert_cmpint(test.ind_filter, == ,RADIO_IND_FILTER_ALL_1_2 |
+        essential);
+
+    /* Power save is released together with the client */
+    radio_client_set_power_save(client, TRUE);
+    test_drain();
+    g_assert_cmpint(radio_instance_get_ind_filter(instance), == ,essential);
+    test_submit_background(client, result);
+    radio_client_unref(client);
+    test_drain();
+    g_assert_cmpuint(test.device_state, == ,4);
+    g_assert(!test.power_save);
+    g_assert_cmpint(radio_instance_get_ind_filter(instance), == ,
+        RADIO_IND_FILTER_ALL_1_2 | essential);
+    radio_client_unref(client2);
+
+    radio_instance_unref(instance);
+    test_modem_free(modem);
+    test_clock_free(clock);
+}
+
+/*==========================================================================*
+ * batch_timeout
+ *==========================================================================*/
+
+static
+void
+test_submit_held(
+    RadioClient* client,
+    guint timeout_ms,
+    TestResult* result)
+{
+    RadioRequest* req = radio_request_new(client, RADIO_REQ_GET_MUTE, NULL,
+        test_complete, NULL, result);
+
+    radio_request_set_background(req, TRUE);
+    radio_request_set_timeout(req, timeout_ms);
+    g_assert(radio_request_submit(req));
+    radio_request_unref(req);
+}
+
+static
+void
+test_batch_timeout(
+    void)
+{
+    TestModem* modem = test_modem_new(TEST_MODEM_RADIO, RADIO_INTERFACE_1_5,
+        SLOT);
+    RadioInstance* instance = radio_instance_new_with_version
+        (test_modem_dev(modem), SLOT, RADIO_INTERFACE_1_5);
+    RadioClient* client = radio_client_new(instance);
+    TestClock* clock = test_clock_new();
+    TestModemParams params;
+    TestPowerSave test;
+    TestResult result[2];
+
+    memset(&test, 0, sizeof(test));
+    memset(result, 0, sizeof(result));
+    test_modem_set_payload_func(modem, test_power_save_payload, &test);
+    test_drain();
+    g_assert(radio_client_connected(client));
+    radio_base_set_clock(RADIO_BASE(client),
+        test_clock_radio_base_clock(clock));
+    radio_client_set_batch_window(client, 10000);
+    radio_client_set_power_save(client, TRUE);
+    test_drain();
+    g_assert(test.power_save);
+
+    /* Nothing gets answered from now on */
+    memset(&params, 0, sizeof(params));
+    params.drop_percent = 100;
+    test_modem_set_params(modem, &params);
+
+    /* The batch is released early by a regular request */
+    test_submit_held(client, 1000, result);
+    test_drain();
+    test_clock_advance(clock, 5000000);
+    test_drain();
+    g_assert_cmpuint(test.requests, == ,0);
+    test_submit(client, RADIO_REQ_GET_MUTE, 2000, result + 1);
+    test_drain();
+    g_assert_cmpuint(test.requests, == ,2);
+
+    /* The held request times out a second after the release */
+    test_clock_advance(clock, 999000);
+    test_drain();
+    g_assert_cmpuint(result[0].count, == ,0);
+    test_clock_advance(clock, 1000);
+    test_drain();
+    g_assert_cmpuint(result[0].count, == ,1);
+    g_assert_cmpint(result[0].status, == ,RADIO_TX_STATUS_TIMEOUT);
+    test_clock_advance(clock, 1000000);
+    test_drain();
+    g_assert_cmpuint(result[1].count, == ,1);
+    g_assert_cmpint(result[1].status, == ,RADIO_TX_STATUS_TIMEOUT);
+
+    /* Same thing when power save is turned off */
+    memset(result, 0, sizeof(result));
+    test_submit_held(client, 1000, result);
+    test_drain();
+    test_clock_advance(clock, 5000000);
+    test_drain();
+    g_assert_cmpuint(test.requests, == ,2);
+    radio_client_set_power_save(client, FALSE);
+    test_drain();
+    g_assert_cmpuint(test.requests, == ,3);
+    test_clock_advance(clock, 999000);
+    test_drain();
+    g_assert_cmpuint(result[0].count, == ,0);
+    test_clock_advance(clock, 1000);
+    test_drain();
+    g_assert_cmpuint(result[0].count, == ,1);
+    g_assert_cmpint(result[0].status, == ,RADIO_TX_STATUS_TIMEOUT);
+
+    radio_client_unref(client);
+    radio_instance_unref(instance);
+    test_modem_free(modem);
+    test_clock_free(clock);
+}
+
+/*==========================================================================*
+ * aidl
+ *==========================================================================*/
+
+static
+void
+test_aidl(
+    void)
+{
+    TestModem* modem = test_modem_new(TEST_MODEM_RADIO_AIDL,
+        RADIO_MODEM_INTERFACE, SLOT);
+    TestModem* network = test_modem_new(TEST_MODEM_RADIO_AIDL,
+        RADIO_NETWORK_INTERFACE, SLOT);
+    const char* dev = test_modem_dev(modem);
+    RadioInstance* modem_instance =
+        radio_instance_new_with_modem_slot_version_and_interface(dev, SLOT,
+            NULL, 0, RADIO_INTERFACE_NONE, RADIO_MODEM_INTERFACE);
+    RadioInstance* network_instance =
+        radio_instance_new_with_modem_slot_version_and_interface(dev, SLOT,
+            NULL, 0, RADIO_INTERFACE_NONE, RADIO_NETWORK_INTERFACE);
+    RadioClient* modem_client = radio_client_new(modem_instance);
+    RadioClient* network_client = radio_client_new(network_instance);
+    TestResult result[2];
+
+    g_assert_cmpstr(dev, == ,GBINDER_DEFAULT_BINDER);
+    g_assert(test_modem_connected(modem));
+    g_assert(test_modem_connected(network));
+
+    /* Only IRadioModem sends rilConnected */
+    g_assert(!radio_client_connected(modem_client));
+    g_assert(radio_client_connected(network_client));
+    test_drain();
+    g_assert(radio_client_connected(modem_client));
+
+    memset(result, 0, sizeof(result));
+    test_submit(modem_client, RADIO_MODEM_REQ_GET_BASEBAND_VERSION, 0,
+        result);
+    test_submit(network_client, RADIO_NETWORK_REQ_GET_SIGNAL_STRENGTH, 0,
+        result + 1);
+    test_drain();
+    g_assert_cmpuint(result[0].count, == ,1);
+    g_assert_cmpuint(result[0].resp, == ,
+        RADIO_MODEM_RESP_GET_BASEBAND_VERSION);
+    g_assert_cmpuint(result[1].count, == ,1);
+    g_assert_cmpuint(result[1].resp, == ,
+        RADIO_NETWORK_RESP_GET_SIGNAL_STRENGTH);
+
+    radio_client_unref(modem_client);
+    radio_client_unref(network_client);
+    radio_instance_unref(modem_instance);
+    radio_instance_unref(network_instance);
+    test_modem_free(modem);
+    test_modem_free(network);
+}
+
+/*==========================================================================*
+ * config
+ *==========================================================================*/
+
+static
+void
+test_config(
+    void)
+{
+    TestModem* modem = test_modem_new(TEST_MODEM_CONFIG,
+        RADIO_CONFIG_INTERFACE_1_2, NULL);
+    RadioConfig* config = radio_config_new_with_version
+        (RADIO_CONFIG_INTERFACE_1_2);
+    TestModemStats stats;
+    TestResult result[2];
+
+    g_assert(config);
+    g_assert_cmpint(radio_config_interface(config), == ,
+        RADIO_CONFIG_INTERFACE_1_2);
+    g_assert(test_modem_connected(modem));
+
+    memset(result, 0, sizeof(result));
+    test_submit_config(config, RADIO_CONFIG_REQ_GET_SIM_SLOTS_STATUS, result);
+    test_submit_config(config, RADIO_CONFIG_REQ_GET_MODEMS_CONFIG,
+        result + 1);
+    test_drain();
+    g_assert_cmpuint(result[0].count, == ,1);
+    g_assert_cmpuint(result[0].resp, == ,
+        RADIO_CONFIG_RESP_GET_SIM_SLOTS_STATUS_1_2);
+    g_assert_cmpuint(result[1].count, == ,1);
+    g_assert_cmpuint(result[1].resp, == ,RADIO_CONFIG_RESP_GET_MODEMS_CONFIG);
+
+    test_modem_get_stats(modem, &stats);
+    g_assert_cmpuint(stats.requests, == ,2);
+    g_assert_cmpuint(stats.responses, == ,2);
+
+    radio_config_unref(config);
+    test_modem_free(modem);
+}
+
+/*==========================================================================*
+ * config_aidl
+ *==========================================================================*/
+
+static
+void
+test_config_aidl(
+    void)
+{
+    TestModem* modem = test_modem_new(TEST_MODEM_CONFIG_AIDL, 0, NULL);
+    RadioConfig* config = radio_config_new_with_version_and_interface_type
+        (RADIO_CONFIG_AIDL_INTERFACE_1, RADIO_INTERFACE_TYPE_AIDL);
+    TestResult result;
+
+    g_assert(config);
+    g_assert(test_modem_connected(modem));
+
+    memset(&result, 0, sizeof(result));
+    test_submit_config(config, (RADIO_CONFIG_REQ)
+        RADIO_CONFIG_AIDL_REQ_GET_NUM_OF_LIVE_MODEMS, &result);
+    test_drain();
+    g_assert_cmpuint(result.count, == ,1);
+    g_assert_cmpuint(result.resp, == ,
+        RADIO_CONFIG_AIDL_RESP_GET_NUM_OF_LIVE_MODEMS);
+
+    radio_config_unref(config);
+    test_modem_free(modem);
+}
+
+/*==========================================================================*
+ * Common
+ *==========================================================================*/
+
+#define TEST_PREFIX "/modem/"
+#define TEST_(t) TEST_PREFIX t
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("radio"), test_radio);
+    g_test_add_func(TEST_("faults"), test_faults);
+    g_test_add_func(TEST_("latency"), test_latency);
+    g_test_add_func(TEST_("indications"), test_indications);
+    g_test_add_func(TEST_("power_save"), test_power_save);
+    g_test_add_func(TEST_("batch_timeout"), test_batch_timeout);
+    g_test_add_func(TEST_("aidl"), test_aidl);
+    g_test_add_func(TEST_("config"), test_config);
+    g_test_add_func(TEST_("config_aidl"), test_config_aidl);
+    test_init(&test_opt, argc, argv);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,378 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "test_common.h"
+#include "test_gbinder.h"
+
+#include "radio_payload.h"
+
+#include <gbinder_writer.h>
+
+#define UNKNOWN_VALUE (0x7fffffff)
+#define UNKNOWN_IND ((RADIO_IND)UNKNOWN_VALUE)
+#define UNKNOWN_RESP ((RADIO_RESP)UNKNOWN_VALUE)
+
+static TestOpt test_opt;
+
+static
+TestGBinderData*
+test_data_new(
+    const void* buf,
+    gsize size)
+{
+    TestGBinderData* data = test_gbinder_data_new(NULL);
+    GBinderWriter writer;
+
+    test_gbinder_data_init_writer(data, &writer);
+    gbinder_writer_append_buffer_object(&writer, buf, size);
+    return data;
+}
+
+/*==========================================================================*
+ * null
+ *==========================================================================*/
+
+static
+void
+test_null(
+    void)
+{
+    gsize count = 1;
+
+    g_assert(!radio_resp_payload(RADIO_RESP_GET_SIGNAL_STRENGTH, NULL,
+        &count));
+    g_assert_cmpuint(count, == ,0);
+    g_assert(!radio_ind_payload(RADIO_IND_CELL_INFO_LIST_1_5, NULL, NULL));
+}
+
+/*==========================================================================*
+ * type
+ *==========================================================================*/
+
+static
+void
+test_type(
+    void)
+{
+    gsize size = 1;
+
+    g_assert_cmpint(radio_resp_payload_type(UNKNOWN_RESP, &size), == ,
+        RADIO_PAYLOAD_NONE);
+    g_assert_cmpuint(size, == ,0);
+    g_assert_cmpint(radio_resp_payload_type(RADIO_RESP_DIAL, NULL), == ,
+        RADIO_PAYLOAD_NONE);
+    g_assert_cmpint(radio_resp_payload_type(RADIO_RESP_GET_SIGNAL_STRENGTH_1_4,
+        &size), == ,RADIO_PAYLOAD_STRUCT);
+    g_assert_cmpuint(size, == ,sizeof(RadioSignalStrength_1_4));
+    g_assert_cmpint(radio_resp_payload_type(RADIO_RESP_GET_CELL_INFO_LIST_1_5,
+        &size), == ,RADIO_PAYLOAD_VEC);
+    g_assert_cmpuint(size, == ,sizeof(RadioCellInfo_1_5));
+
+    g_assert_cmpint(radio_ind_payload_type(UNKNOWN_IND, &size), == ,
+        RADIO_PAYLOAD_NONE);
+    g_assert_cmpuint(size, == ,0);
+    g_assert_cmpint(radio_ind_payload_type(RADIO_IND_MODEM_RESET, NULL), == ,
+        RADIO_PAYLOAD_NONE);
+    g_assert_cmpint(radio_ind_payload_type(RADIO_IND_NETWORK_SCAN_RESULT_1_5,
+        &size), == ,RADIO_PAYLOAD_STRUCT);
+    g_assert_cmpuint(size, == ,sizeof(RadioNetworkScanResult));
+    g_assert_cmpint(radio_ind_payload_type(RADIO_IND_DATA_CALL_LIST_CHANGED_1_5,
+        &size), == ,RADIO_PAYLOAD_VEC);
+    g_assert_cmpuint(size, == ,sizeof(RadioDataCall_1_5));
+}
+
+/*==========================================================================*
+ * struct
+ *==========================================================================*/
+
+static
+void
+test_struct(
+    void)
+{
+    RadioSignalStrength_1_4 ss;
+    const RadioSignalStrength_1_4* view;
+    TestGBinderData* data;
+    GBinderReader reader;
+    gsize count = 0;
+
+    memset(&ss, 0, sizeof(ss));
+    ss.lte.rsrp = 100;
+    data = test_data_new(&ss, sizeof(ss));
+
+    /* Size mismatch */
+    test_gbinder_data_init_reader(data, &reader);
+    g_assert(!RADIO_IND_VIEW(CURRENT_SIGNAL_STRENGTH_1_2, &reader));
+
+    /* No payload for this one */
+    test_gbinder_data_init_reader(data, &reader);
+    g_assert(!radio_ind_payload(RADIO_IND_MODEM_RESET, &reader, &count));
+    g_assert_cmpuint(count, == ,0);
+
+    /* This one is fine */
+    view = RADIO_IND_VIEW(CURRENT_SIGNAL_STRENGTH_1_4, &reader);
+    g_assert(view);
+    g_assert_cmpuint(view->lte.rsrp, == ,100);
+
+    /* Reader has been advanced */
+    g_assert(!RADIO_IND_VIEW(CURRENT_SIGNAL_STRENGTH_1_4, &reader));
+
+    /* Same thing for response */
+    test_gbinder_data_init_reader(data, &reader);
+    view = RADIO_RESP_VEC_VIEW(GET_SIGNAL_STRENGTH_1_4, &reader, &count);
+    g_assert(view);
+    g_assert_cmpuint(count, == ,1);
+    g_assert_cmpuint(view->lte.rsrp, == ,100);
+    test_gbinder_data_unref(data);
+}
+
+/*==========================================================================*
+ * vec
+ *==========================================================================*/
+
+static
+void
+test_vec(
+    void)
+{
+    RadioCellInfo_1_5 cells[3];
+    const RadioCellInfo_1_5* view;
+    TestGBinderData* data;
+    GBinderReader reader;
+    gsize count = 0;
+
+    memset(cells, 0, sizeof(cells));
+    cells[1].registered = TRUE;
+    data = test_data_new(cells, sizeof(cells));
+
+    /* Element size mismatch */
+    test_gbinder_data_init_reader(data, &reader);
+    g_assert(!RADIO_RESP_VEC_VIEW(GET_CELL_INFO_LIST_1_4, &reader, &count));
+    g_assert_cmpuint(count, == ,0);
+
+    view = RADIO_RESP_VEC_VIEW(GET_CELL_INFO_LIST_1_5, &reader, &count);
+    g_assert(view);
+    g_assert_cmpuint(count, == ,G_N_ELEMENTS(cells));
+    g_assert(!view[0].registered);
+    g_assert(view[1].registered);
+    g_assert(!view[2].registered);
+
+    test_gbinder_data_init_reader(data, &reader);
+    view = RADIO_IND_VEC_VIEW(CELL_INFO_LIST_1_5, &reader, &count);
+    g_assert(view);
+    g_assert_cmpuint(count, == ,G_N_ELEMENTS(cells));
+    test_gbinder_data_unref(data);
+
+    /* Empty vector */
+    data = test_data_new(NULL, 0);
+    test_gbinder_data_init_reader(data, &reader);
+    g_assert(RADIO_IND_VEC_VIEW(DATA_CALL_LIST_CHANGED_1_5, &reader, &count));
+    g_assert_cmpuint(count, == ,0);
+    test_gbinder_data_unref(data);
+}
+
+/*==========================================================================*
+ * iter
+ *==========================================================================*/
+
+static
+void
+test_iter(
+    void)
+{
+    RadioDataCall_1_5 calls[2];
+    const RadioDataCall_1_5* call;
+    TestGBinderData* data;
+    GBinderReader reader;
+    RadioVecIter it;
+    gsize size = 0;
+
+    g_assert(!radio_vec_iter_init(NULL, NULL, 0));
+    g_assert(!radio_vec_iter_init_hidl(NULL, NULL, 0));
+    g_assert(!radio_vec_iter_init_aidl(NULL, NULL));
+    g_assert(!radio_vec_iter_next(NULL, NULL));
+    g_assert(!radio_vec_iter_next(NULL, &size));
+    g_assert_cmpuint(size, == ,0);
+
+    memset(calls, 0, sizeof(calls));
+    calls[0].cid = 1;
+    calls[1].cid = 2;
+    data = test_data_new(calls, sizeof(calls));
+
+    /* Not a vector */
+    test_gbinder_data_init_reader(data, &reader);
+    g_assert(!radio_resp_vec_iter_init(&it, RADIO_RESP_SETUP_DATA_CALL_1_5,
+        &reader));
+    g_assert(!radio_ind_vec_iter_init(&it, RADIO_IND_MODEM_RESET, &reader));
+    g_assert(!radio_vec_iter_next(&it, NULL));
+
+    /* Wrong element size */
+    g_assert(!radio_resp_vec_iter_init(&it, RADIO_RESP_GET_CELL_INFO_LIST_1_5,
+        &reader));
+
+    g_assert(radio_resp_vec_iter_init(&it, RADIO_RESP_GET_DATA_CALL_LIST_1_5,
+        &reader));
+    g_assert_cmpuint(it.count, == ,2);
+    call = radio_vec_iter_next(&it, &size);
+    g_assert(call);
+    g_assert_cmpuint(size, == ,sizeof(*call));
+    g_assert_cmpint(call->cid, == ,1);
+    call = RADIO_VEC_ITER_NEXT(&it, RadioDataCall_1_5);
+    g_assert(call);
+    g_assert_cmpint(call->cid, == ,2);
+    g_assert(!RADIO_VEC_ITER_NEXT(&it, RadioDataCall_1_5));
+    g_assert_cmpuint(it.index, == ,2);
+
+    test_gbinder_data_init_reader(data, &reader);
+    g_assert(radio_ind_vec_iter_init(&it, RADIO_IND_DATA_CALL_LIST_CHANGED_1_5,
+        &reader));
+    g_assert_cmpuint(it.count, == ,2);
+    test_gbinder_data_unref(data);
+}
+
+/*==========================================================================*
+ * iter_hidl
+ *==========================================================================*/
+
+static
+void
+test_iter_hidl(
+    void)
+{
+    RadioCellInfo_1_5 cells[3];
+    RadioNetworkScanResult result;
+    const RadioCellInfo_1_5* cell;
+    RadioVecIter it;
+    guint n = 0;
+
+    memset(cells, 0, sizeof(cells));
+    memset(&result, 0, sizeof(result));
+    cells[0].registered = TRUE;
+    cells[2].registered = TRUE;
+
+    /* Empty vector */
+    g_assert(radio_vec_iter_init_hidl(&it, &result.networkInfos,
+        sizeof(RadioCellInfo_1_5)));
+    g_assert(!RADIO_VEC_ITER_NEXT(&it, RadioCellInfo_1_5));
+
+    /* Zero element size */
+    g_assert(!radio_vec_iter_init_hidl(&it, &result.networkInfos, 0));
+
+    result.networkInfos.data.ptr = cells;
+    result.networkInfos.count = G_N_ELEMENTS(cells);
+    g_assert(radio_vec_iter_init_hidl(&it, &result.networkInfos,
+        sizeof(RadioCellInfo_1_5)));
+    while ((cell = RADIO_VEC_ITER_NEXT(&it, RadioCellInfo_1_5))) {
+        if (cell->registered) {
+            n++;
+        }
+    }
+    g_assert_cmpuint(n, == ,2);
+    g_assert_cmpuint(it.index, == ,G_N_ELEMENTS(cells));
+}
+
+/*==========================================================================*
+ * iter_aidl
+ *==========================================================================*/
+
+static
+void
+test_iter_aidl(
+    void)
+{
+    static const guint8 elem1[] = { 0x01, 0x02 };
+    static const guint8 elem2[] = { 0x03 };
+    TestGBinderData* data = test_gbinder_data_new(NULL);
+    GBinderWriter writer;
+    GBinderReader reader;
+    RadioVecIter it;
+    const guint8* elem;
+    gsize size = 0;
+
+    /* Nothing to read */
+    test_gbinder_data_init_reader(data, &reader);
+    g_assert(!radio_vec_iter_init_aidl(&it, &reader));
+
+    /* Array claims 3 elements but only has 2 */
+    test_gbinder_data_init_writer(data, &writer);
+    gbinder_writer_append_int32(&writer, 3);
+    gbinder_writer_append_buffer_object(&writer, TEST_ARRAY_AND_SIZE(elem1));
+    gbinder_writer_append_buffer_object(&writer, TEST_ARRAY_AND_SIZE(elem2));
+
+    test_gbinder_data_init_reader(data, &reader);
+    g_assert(radio_vec_iter_init_aidl(&it, &reader));
+    g_assert_cmpuint(it.count, == ,3);
+    elem = radio_vec_iter_next(&it, &size);
+    g_assert(elem);
+    g_assert_cmpuint(size, == ,sizeof(elem1));
+    g_assert(!memcmp(elem, elem1, size));
+    elem = radio_vec_iter_next(&it, &size);
+    g_assert(elem);
+    g_assert_cmpuint(size, == ,sizeof(elem2));
+    g_assert(!memcmp(elem, elem2, size));
+    g_assert(!radio_vec_iter_next(&it, &size));
+    g_assert_cmpuint(size, == ,0);
+    g_assert_cmpuint(it.count, == ,2);
+    test_gbinder_data_unref(data);
+}
+
+/*==========================================================================*
+ * Common
+ *==========================================================================*/
+
+#define TEST_PREFIX "/payload/"
+#define TEST_(t) TEST_PREFIX t
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_null);
+    g_test_add_func(TEST_("type"), test_type);
+    g_test_add_func(TEST_("struct"), test_struct);
+    g_test_add_func(TEST_("vec"), test_vec);
+    g_test_add_func(TEST_("iter"), test_iter);
+    g_test_add_func(TEST_("iter_hidl"), test_iter_hidl);
+    g_test_add_func(TEST_("iter_aidl"), test_iter_aidl);
+    test_init(&test_opt, argc, argv);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
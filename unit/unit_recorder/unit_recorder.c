@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "test_common.h"
+
+#include "radio_recorder_p.h"
+
+#include <glib/gstdio.h>
+
+#include <sys/stat.h>
+
+static TestOpt test_opt;
+
+static
+const RadioRecord*
+test_record(
+    const void* image,
+    guint index)
+{
+    const RadioRecorderHeader* hdr = image;
+
+    return (const RadioRecord*)((const guint8*)image + hdr->header_size +
+        (gsize)(index & (hdr->count - 1)) * hdr->slot_size);
+}
+
+static
+void
+test_add(
+    RadioRecorder* recorder,
+    RADIO_RECORD_TYPE type,
+    guint code,
+    const void* data,
+    gsize size)
+{
+    RadioRecord rec;
+
+    memset(&rec, 0, sizeof(rec));
+    rec.type = type;
+    rec.code = code;
+    radio_recorder_add(recorder, &rec, data, size);
+}
+
+/*==========================================================================*
+ * null
+ *==========================================================================*/
+
+static
+void
+test_null(
+    void)
+{
+    g_assert(!radio_recorder_ref(NULL));
+    g_assert(!radio_recorder_new_mapped(NULL, 1, 1));
+    g_assert(!radio_recorder_count(NULL));
+    g_assert(!radio_recorder_dump(NULL, NULL));
+    radio_recorder_unref(NULL);
+}
+
+/*==========================================================================*
+ * basic
+ *==========================================================================*/
+
+static
+void
+test_basic(
+    void)
+{
+    static const guint8 data[] = { 0x01, 0x02, 0x03, 0x04, 0x05 };
+    RadioRecorder* recorder = radio_recorder_new(3, 4);
+    char* dir = g_dir_make_tmp("unit_recorder_XXXXXX", NULL);
+    char* file = g_build_filename(dir, "dump", NULL);
+    char* bad_file = g_build_filename(dir, "no", "such", "file", NULL);
+    const RadioRecorderHeader* hdr;
+    const RadioRecord* rec;
+    gchar* image = NULL;
+    gsize size = 0;
+
+    g_assert(radio_recorder_ref(recorder) == recorder);
+    radio_recorder_unref(recorder);
+    g_assert(!radio_recorder_dump(recorder, NULL));
+    g_assert(!radio_recorder_dump(recorder, bad_file));
+
+    /* Four slots (rounded up to the power of 2), five records */
+    test_add(recorder, RADIO_RECORD_REQUEST, 1, data, 1);
+    test_add(recorder, RADIO_RECORD_RESPONSE, 2, data, 2);
+    test_add(recorder, RADIO_RECORD_INDICATION, 3, data, 3);
+    test_add(recorder, RADIO_RECORD_INDICATION, 4, NULL, 0);
+    test_add(recorder, RADIO_RECORD_REQUEST, 5, data, sizeof(data));
+    g_assert_cmpuint(radio_recorder_count(recorder), == ,5);
+
+    g_assert(radio_recorder_dump(recorder, file));
+    g_assert(g_file_get_contents(file, &image, &size, NULL));
+    hdr = (const RadioRecorderHeader*) image;
+    g_assert_cmpuint(size, == ,sizeof(*hdr) + 4 * hdr->slot_size);
+    g_assert_cmpuint(hdr->magic, == ,RADIO_RECORDER_MAGIC);
+    g_assert_cmpuint(hdr->format, == ,RADIO_RECORDER_FORMAT);
+    g_assert_cmpuint(hdr->header_size, == ,sizeof(*hdr));
+    g_assert_cmpuint(hdr->count, == ,4);
+    g_assert_cmpuint(hdr->slot_size, == ,G_ALIGN8(sizeof(RadioRecord) + 4));
+    g_assert_cmpuint(hdr->next, == ,6);
+
+    /* The first record has been overwritten by the last one */
+    rec = test_record(image, 0);
+    g_assert_cmpuint(rec->seq, == ,5);
+    g_assert_cmpuint(rec->code, == ,5);
+    g_assert_cmpuint(rec->size, == ,sizeof(data));
+    g_assert_cmpuint(rec->flags, == ,RADIO_RECORD_FLAG_TRUNCATED);
+    g_assert(!memcmp(rec + 1, data, 4));
+
+    rec = test_record(image, 1);
+    g_assert_cmpuint(rec->seq, == ,2);
+    g_assert_cmpuint(rec->type, == ,RADIO_RECORD_RESPONSE);
+    g_assert_cmpuint(rec->code, == ,2);
+    g_assert_cmpuint(rec->size, == ,2);
+    g_assert_cmpuint(rec->flags, == ,RADIO_RECORD_FLAGS_NONE);
+    g_assert(!memcmp(rec + 1, data, 2));
+
+    rec = test_record(image, 3);
+    g_assert_cmpuint(rec->seq, == ,4);
+    g_assert_cmpuint(rec->type, == ,RADIO_RECORD_INDICATION);
+    g_assert_cmpuint(rec->size, == ,0);
+
+    radio_recorder_unref(recorder);
+    g_free(image);
+    g_unlink(file);
+    g_rmdir(dir);
+    g_free(bad_file);
+    g_free(file);
+    g_free(dir);
+}
+
+/*==========================================================================*
+ * mapped
+ *==========================================================================*/
+
+static
+void
+test_mapped(
+    void)
+{
+    static const guint8 data[] = { 0x01, 0x02, 0x03 };
+    char* dir = g_dir_make_tmp("unit_recorder_XXXXXX", NULL);
+    char* file = g_build_filename(dir, "ring", NULL);
+    char* file2 = g_build_filename(dir, "ring2", NULL);
+    char* bad_file = g_build_filename(dir, "no", "such", "file", NULL);
+    RadioRecorder* recorder;
+    RadioRecorder* recorder2;
+    const RadioRecord* rec;
+    struct stat st;
+    gchar* image = NULL;
+    gsize size = 0;
+
+    g_assert(!radio_recorder_new_mapped(bad_file, 1, 1));
+    recorder = radio_recorder_new_mapped(file, 0, 0);
+    g_assert(recorder);
+
+    /* The file reflects the ring without an explicit dump */
+    test_add(recorder, RADIO_RECORD_INDICATION, 7, data, sizeof(data));
+    g_assert(g_file_get_contents(file, &image, &size, NULL));
+    g_assert_cmpuint(size, == ,sizeof(RadioRecorderHeader) +
+        sizeof(RadioRecord));
+    g_assert_cmpuint(((RadioRecorderHeader*)image)->count, == ,1);
+    g_assert_cmpuint(((RadioRecorderHeader*)image)->next, == ,2);
+    rec = test_record(image, 0);
+    g_assert_cmpuint(rec->seq, == ,1);
+    g_assert_cmpuint(rec->code, == ,7);
+    g_assert_cmpuint(rec->size, == ,sizeof(data));
+    g_assert_cmpuint(rec->flags, == ,RADIO_RECORD_FLAG_TRUNCATED);
+    g_free(image);
+
+    /* Only the owner can read it */
+    g_assert_cmpint(stat(file, &st), == ,0);
+    g_assert_cmpuint(st.st_mode & 0777, == ,0600);
+
+    /* Dumping onto itself is refused */
+    g_assert(!radio_recorder_dump(recorder, file));
+
+    /* Dumping over another live capture replaces it without truncation */
+    recorder2 = radio_recorder_new_mapped(file2, 1, 0);
+    g_assert(recorder2);
+    g_assert(radio_recorder_dump(recorder, file2));
+    test_add(recorder2, RADIO_RECORD_INDICATION, 8, NULL, 0);
+    g_assert(g_file_get_contents(file2, &image, &size, NULL));
+    rec = test_record(image, 0);
+    g_assert_cmpuint(rec->seq, == ,1);
+    g_assert_cmpuint(rec->code, == ,7);
+    g_assert_cmpint(stat(file2, &st), == ,0);
+    g_assert_cmpuint(st.st_mode & 0777, == ,0600);
+
+    radio_recorder_unref(recorder2);
+    radio_recorder_unref(recorder);
+    g_free(image);
+    g_unlink(file);
+    g_unlink(file2);
+    g_assert_cmpint(g_rmdir(dir), == ,0); /* No temporary files left */
+    g_free(bad_file);
+    g_free(file2);
+    g_free(file);
+    g_free(dir);
+}
+
+/*==========================================================================*
+ * Common
+ *==========================================================================*/
+
+#define TEST_PREFIX "/recorder/"
+#define TEST_(t) TEST_PREFIX t
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_null);
+    g_test_add_func(TEST_("basic"), test_basic);
+    g_test_add_func(TEST_("mapped"), test_mapped);
+    test_init(&test_opt, argc, argv);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,296 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "test_common.h"
+#include "test_replay.h"
+
+#include "radio_recorder_p.h"
+
+#include <gutil_log.h>
+
+#include <glib/gstdio.h>
+
+#define TEST_REPLAY_FILE_ENV "RADIO_REPLAY_FILE"
+#define TEST_REPLAY_SPEED_ENV "RADIO_REPLAY_SPEED"
+
+static TestOpt test_opt;
+
+static
+void
+test_add(
+    RadioRecorder* recorder,
+    RADIO_RECORD_TYPE type,
+    guint code,
+    guint32 serial,
+    gint32 extra,
+    const void* data,
+    gsize size)
+{
+    RadioRecord rec;
+
+    memset(&rec, 0, sizeof(rec));
+    rec.type = type;
+    rec.interface_type = RADIO_INTERFACE_TYPE_HIDL;
+    rec.interface = RADIO_INTERFACE_1_0;
+    rec.code = code;
+    rec.serial = serial;
+    rec.extra = extra;
+    radio_recorder_add(recorder, &rec, data, size);
+}
+
+static
+TestReplay*
+test_session(
+    void)
+{
+    static const guint8 mute[] = { 0x01, 0x00, 0x00, 0x00 };
+    static const guint8 ims[12] = { 0 };
+    RadioRecorder* recorder = radio_recorder_new(16, 8);
+    char* dir = g_dir_make_tmp("unit_replay_XXXXXX", NULL);
+    char* file = g_build_filename(dir, "session", NULL);
+    TestReplay* replay;
+    RadioRecord rec;
+
+    /* Answered request, interleaved with an indication */
+    test_add(recorder, RADIO_RECORD_REQUEST, RADIO_REQ_GET_MUTE, 10, 0,
+        NULL, 0);
+    test_add(recorder, RADIO_RECORD_INDICATION, RADIO_IND_CALL_STATE_CHANGED,
+        0, RADIO_IND_UNSOLICITED, NULL, 0);
+    test_add(recorder, RADIO_RECORD_RESPONSE, RADIO_RESP_GET_MUTE, 10,
+        RADIO_ERROR_NONE, mute, sizeof(mute));
+
+    /* Indication which has to be acked */
+    test_add(recorder, RADIO_RECORD_INDICATION, RADIO_IND_CALL_STATE_CHANGED,
+        0, RADIO_IND_ACK_EXP, NULL, 0);
+
+    /* Request which never gets a response */
+    test_add(recorder, RADIO_RECORD_REQUEST, RADIO_REQ_GET_SIGNAL_STRENGTH,
+        11, 0, NULL, 0);
+
+    /* Response to a request which isn't in the capture */
+    test_add(recorder, RADIO_RECORD_RESPONSE, RADIO_RESP_GET_ICC_CARD_STATUS,
+        99, RADIO_ERROR_NONE, NULL, 0);
+
+    /* Ack sent by RadioInstance, not by the client */
+    test_add(recorder, RADIO_RECORD_REQUEST,
+        RADIO_REQ_RESPONSE_ACKNOWLEDGEMENT, 0, 0, NULL, 0);
+
+    /* Error response, with the payload truncated by the recorder */
+    test_add(recorder, RADIO_RECORD_REQUEST,
+        RADIO_REQ_GET_IMS_REGISTRATION_STATE, 12, 0, NULL, 0);
+    test_add(recorder, RADIO_RECORD_RESPONSE,
+        RADIO_RESP_GET_IMS_REGISTRATION_STATE, 12,
+        RADIO_ERROR_GENERIC_FAILURE, ims, sizeof(ims));
+
+    /* IRadioConfig records are not replayed */
+    memset(&rec, 0, sizeof(rec));
+    rec.type = RADIO_RECORD_INDICATION;
+    rec.flags = RADIO_RECORD_FLAG_CONFIG;
+    rec.interface_type = RADIO_INTERFACE_TYPE_HIDL;
+    radio_recorder_add(recorder, &rec, NULL, 0);
+
+    g_assert(radio_recorder_dump(recorder, file));
+    replay = test_replay_new_from_file(file);
+    g_assert(replay);
+    g_assert_cmpuint(test_replay_count(replay), == ,9);
+
+    radio_recorder_unref(recorder);
+    g_unlink(file);
+    g_rmdir(dir);
+    g_free(file);
+    g_free(dir);
+    return replay;
+}
+
+static
+void
+test_check_session(
+    const TestReplayStats* stats)
+{
+    g_assert_cmpuint(stats->requests, == ,3);
+    g_assert_cmpuint(stats->completed, == ,2);
+    g_assert_cmpuint(stats->failed, == ,0);
+    g_assert_cmpuint(stats->unanswered, == ,1);
+    g_assert_cmpuint(stats->responses, == ,2);
+    g_assert_cmpuint(stats->indications, == ,2);
+    g_assert_cmpuint(stats->acks, == ,1);
+    g_assert_cmpuint(stats->skipped, == ,2);
+}
+
+/*==========================================================================*
+ * null
+ *==========================================================================*/
+
+static
+void
+test_null(
+    void)
+{
+    static const guint8 junk[sizeof(RadioRecorderHeader)] = { 0 };
+
+    g_assert(!test_replay_new(NULL, 0));
+    g_assert(!test_replay_new(TEST_ARRAY_AND_SIZE(junk)));
+    g_assert(!test_replay_new_from_file("/no/such/file"));
+    g_assert(!test_replay_count(NULL));
+    test_replay_free(NULL);
+}
+
+/*==========================================================================*
+ * empty
+ *==========================================================================*/
+
+static
+void
+test_empty(
+    void)
+{
+    RadioRecorder* recorder = radio_recorder_new(1, 0);
+    char* dir = g_dir_make_tmp("unit_replay_XXXXXX", NULL);
+    char* file = g_build_filename(dir, "empty", NULL);
+    TestReplay* replay;
+    TestReplayStats stats;
+
+    g_assert(radio_recorder_dump(recorder, file));
+    replay = test_replay_new_from_file(file);
+    g_assert(replay);
+    g_assert_cmpuint(test_replay_count(replay), == ,0);
+    test_replay_run(replay, 0, &stats);
+    g_assert_cmpuint(stats.requests, == ,0);
+    g_assert_cmpuint(stats.indications, == ,0);
+    g_assert_cmpuint(stats.skipped, == ,0);
+    test_replay_free(replay);
+
+    radio_recorder_unref(recorder);
+    g_unlink(file);
+    g_rmdir(dir);
+    g_free(file);
+    g_free(dir);
+}
+
+/*==========================================================================*
+ * fast
+ *==========================================================================*/
+
+static
+void
+test_fast(
+    void)
+{
+    TestReplay* replay = test_session();
+    TestReplayStats stats;
+
+    test_replay_run(replay, 0, &stats);
+    test_check_session(&stats);
+
+    /* The result doesn't depend on the previous run */
+    test_replay_run(replay, 0, &stats);
+    test_check_session(&stats);
+    test_replay_free(replay);
+}
+
+/*==========================================================================*
+ * timed
+ *==========================================================================*/
+
+static
+void
+test_timed(
+    void)
+{
+    TestReplay* replay = test_session();
+    TestReplayStats stats;
+
+    /* The session was recorded in microseconds, real time is fine */
+    test_replay_run(replay, 1.0, &stats);
+    test_check_session(&stats);
+    test_replay_run(replay, 100.0, NULL);
+    test_replay_free(replay);
+}
+
+/*==========================================================================*
+ * file
+ *==========================================================================*/
+
+static
+void
+test_file(
+    void)
+{
+    const char* file = g_getenv(TEST_REPLAY_FILE_ENV);
+    const char* speed = g_getenv(TEST_REPLAY_SPEED_ENV);
+    TestReplay* replay = test_replay_new_from_file(file);
+    TestReplayStats stats;
+
+    g_assert(replay);
+    test_replay_run(replay, speed ? g_ascii_strtod(speed, NULL) : 0, &stats);
+    g_test_message("%u records replayed in %" G_GINT64_FORMAT " us",
+        test_replay_count(replay), stats.elapsed);
+    g_test_message("%u requests, %u completed, %u failed, %u unanswered",
+        stats.requests, stats.completed, stats.failed, stats.unanswered);
+    g_test_message("%u responses, %u indications, %u acks, %u skipped",
+        stats.responses, stats.indications, stats.acks, stats.skipped);
+    g_assert_cmpuint(stats.failed, == ,0);
+    test_replay_free(replay);
+}
+
+/*==========================================================================*
+ * Common
+ *==========================================================================*/
+
+#define TEST_PREFIX "/replay/"
+#define TEST_(t) TEST_PREFIX t
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("null"), test_null);
+    g_test_add_func(TEST_("empty"), test_empty);
+    g_test_add_func(TEST_("fast"), test_fast);
+    g_test_add_func(TEST_("timed"), test_timed);
+    if (g_getenv(TEST_REPLAY_FILE_ENV)) {
+        /* RADIO_REPLAY_FILE=capture [RADIO_REPLAY_SPEED=x] unit_replay */
+        g_test_add_func(TEST_("file"), test_file);
+    }
+    test_init(&test_opt, argc, argv);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
@@ -0,0 +1,514 @@
+/*
+ * Copyright (C) 2026 Jolla Mobile Ltd
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   1. Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *   2. Redistributions in binary form must reproduce the above copyright
+ *      notice, this list of conditions and the following disclaimer in the
+ *      documentation and/or other materials provided with the distribution.
+ *   3. Neither the names of the copyright holders nor the names of its
+ *      contributors may be used to endorse or promote products derived
+ *      from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "test_common.h"
+#include "test_clock.h"
+#include "test_gbinder.h"
+
+#include "radio_base.h"
+#include "radio_client.h"
+#include "radio_instance.h"
+#include "radio_request.h"
+#include "radio_request_group.h"
+
+#include <gutil_log.h>
+
+#define DEV GBINDER_DEFAULT_HWBINDER
+#define SLOT "slot1"
+
+#define TEST_STRESS_COUNT (100000)
+#define TEST_STRESS_WINDOW (100)    /* Max requests in flight */
+#define TEST_STRESS_BLOCK_EVERY (5000)
+#define TEST_STRESS_BLOCK_MS (3000)
+#define TEST_STRESS_SEED (1234)
+
+static TestOpt test_opt;
+
+static const GBinderClientIfaceInfo test_ind_iface_info[] = {
+    {RADIO_INDICATION_1_0, RADIO_1_0_IND_LAST }
+};
+
+static const GBinderClientIfaceInfo test_resp_iface_info[] = {
+    {RADIO_RESPONSE_1_0, RADIO_1_0_RESP_LAST }
+};
+
+/*==========================================================================*
+ * Fake IRadio service driven by the virtual clock
+ *==========================================================================*/
+
+typedef struct test_stress {
+    TestClock* clock;
+    GRand* rand;
+    GBinderServiceManager* sm;
+    GBinderLocalObject* obj;
+    GBinderRemoteObject* remote;
+    GBinderClient* resp_client;
+    GBinderClient* ind_client;
+    RadioInstance* instance;
+    RadioClient* client;
+    RadioRequestGroup* group;
+    gboolean blocked;
+    gboolean respond;       /* FALSE to ignore all requests */
+    guint count;
+    guint submitted;
+    guint completed;
+    guint destroyed;
+    guint received;
+    guint ok;
+    guint errors;
+    guint timeouts;
+    guint failed;
+    guint blocks;
+} TestStress;
+
+typedef struct test_stress_resp {
+    TestStress* test;
+    guint32 serial;
+    RADIO_ERROR error;
+} TestStressResp;
+
+typedef struct test_stress_req {
+    TestStress* test;
+    guint completions;
+} TestStressReq;
+
+static
+gboolean
+test_stress_respond(
+    gpointer user_data)
+{
+    TestStressResp* resp = user_data;
+    GBinderClient* client = resp->test->resp_client;
+    const RADIO_RESP code = RADIO_RESP_GET_MUTE;
+    GBinderLocalRequest* req = gbinder_client_new_request2(client, code);
+    RadioResponseInfo info;
+    GBinderWriter writer;
+
+    memset(&info, 0, sizeof(info));
+    info.type = RADIO_RESP_SOLICITED;
+    info.serial = resp->serial;
+    info.error = resp->error;
+    gbinder_local_request_init_writer(req, &writer);
+    gbinder_writer_append_buffer_object(&writer, &info, sizeof(info));
+    gbinder_writer_append_bool(&writer, FALSE);
+    gbinder_client_transact(client, code, GBINDER_TX_FLAG_ONEWAY, req,
+        NULL, NULL, NULL);
+    gbinder_local_request_unref(req);
+    return G_SOURCE_REMOVE;
+}
+
+static
+GBinderLocalReply*
+test_stress_txproc(
+    GBinderLocalObject* obj,
+    GBinderRemoteRequest* req,
+    guint code,
+    guint flags,
+    int* status,
+    void* user_data)
+{
+    TestStress* test = user_data;
+    GBinderReader reader;
+    guint32 serial;
+
+    gbinder_remote_request_init_reader(req, &reader);
+    if (code == RADIO_REQ_SET_RESPONSE_FUNCTIONS) {
+        GBinderRemoteObject* resp = gbinder_reader_read_object(&reader);
+        GBinderRemoteObject* ind = gbinder_reader_read_object(&reader);
+
+        gbinder_client_unref(test->resp_client);
+        gbinder_client_unref(test->ind_client);
+        test->resp_client = gbinder_client_new2(resp,
+            TEST_ARRAY_AND_COUNT(test_resp_iface_info));
+        test->ind_client = gbinder_client_new2(ind,
+            TEST_ARRAY_AND_COUNT(test_ind_iface_info));
+        gbinder_remote_object_unref(resp);
+        gbinder_remote_object_unref(ind);
+    } else if (code == RADIO_REQ_GET_MUTE &&
+        gbinder_reader_read_uint32(&reader, &serial)) {
+        const gint32 r = g_rand_int_range(test->rand, 0, 100);
+
+        test->received++;
+        if (test->respond && r < 90) {
+            TestStressResp* resp = g_new(TestStressResp, 1);
+
+            /* 75% succeed, 15% fail and 10% never get a response */
+            resp->test = test;
+            resp->serial = serial;
+            resp->error = (r < 75) ? RADIO_ERROR_NONE :
+                RADIO_ERROR_GENERIC_FAILURE;
+            test_clock_add(test->clock, g_rand_int_range(test->rand,
+                0, 2000), test_stress_respond, resp, g_free);
+        }
+    }
+    *status = GBINDER_STATUS_OK;
+    return NULL;
+}
+
+static
+void
+test_stress_init(
+    TestStress* test,
+    guint count)
+{
+    const RADIO_IND code = RADIO_IND_RIL_CONNECTED;
+    GBinderLocalRequest* ind;
+
+    memset(test, 0, sizeof(*test));
+    test->count = count;
+    test->respond = TRUE;
+    test->clock = test_clock_new();
+    test->rand = g_rand_new_with_seed(TEST_STRESS_SEED);
+    test->sm = gbinder_servicemanager_new(DEV);
+    test->obj = test_gbinder_local_object_new(NULL, test_stress_txproc, test);
+    test->remote = test_gbinder_servicemanager_new_service(test->sm,
+        RADIO_1_0 "/" SLOT, test->obj);
+    test->instance = radio_instance_new_with_version(DEV, SLOT,
+        RADIO_INTERFACE_1_0);
+    test->client = radio_client_new(test->instance);
+    test->group = radio_request_group_new(test->client);
+    radio_base_set_clock(RADIO_BASE(test->client),
+        test_clock_radio_base_clock(test->clock));
+
+    ind = gbinder_client_new_request2(test->ind_client, code);
+    gbinder_local_request_append_int32(ind, RADIO_IND_UNSOLICITED);
+    g_assert_cmpint(gbinder_client_transact_sync_oneway(test->ind_client,
+        code, ind), == ,GBINDER_STATUS_OK);
+    gbinder_local_request_unref(ind);
+    g_assert(radio_client_connected(test->client));
+}
+
+static
+void
+test_stress_cleanup(
+    TestStress* test)
+{
+    radio_request_group_unref(test->group);
+    radio_client_unref(test->client);
+    radio_instance_unref(test->instance);
+    gbinder_client_unref(test->resp_client);
+    gbinder_client_unref(test->ind_client);
+    gbinder_remote_object_unref(test->remote);
+    gbinder_local_object_unref(test->obj);
+    gbinder_servicemanager_unref(test->sm);
+    g_rand_free(test->rand);
+
+    /* Free the clock last, RadioBase removes its timer on finalize */
+    test_clock_free(test->clock);
+}
+
+static
+void
+test_stress_drain(
+    void)
+{
+    while (g_main_context_iteration(NULL, FALSE));
+}
+
+static
+void
+test_stress_complete(
+    RadioRequest* req,
+    RADIO_TX_STATUS status,
+    RADIO_RESP resp,
+    RADIO_ERROR error,
+    const GBinderReader* args,
+    gpointer user_data)
+{
+    TestStressReq* data = user_data;
+    TestStress* test = data->test;
+
+    data->completions++;
+    test->completed++;
+    switch (status) {
+    case RADIO_TX_STATUS_OK:
+        if (error == RADIO_ERROR_NONE) {
+            g_assert_cmpint(resp, == ,RADIO_RESP_GET_MUTE);
+            test->ok++;
+        } else {
+            test->errors++;
+        }
+        break;
+    case RADIO_TX_STATUS_TIMEOUT:
+        test->timeouts++;
+        break;
+    default:
+        test->failed++;
+        break;
+    }
+}
+
+static
+void
+test_stress_destroy(
+    gpointer user_data)
+{
+    TestStressReq* data = user_data;
+
+    /* Each request completes exactly once */
+    g_assert_cmpuint(data->completions, == ,1);
+    data->test->destroyed++;
+    g_free(data);
+}
+
+static
+gboolean
+test_stress_unblock(
+    gpointer user_data)
+{
+    TestStress* test = user_data;
+
+    radio_request_group_unblock(test->group);
+    test->blocked = FALSE;
+    return G_SOURCE_REMOVE;
+}
+
+static
+void
+test_stress_submit(
+    TestStress* test,
+    guint timeout_ms)
+{
+    TestStressReq* data = g_new0(TestStressReq, 1);
+    const gint32 r = g_rand_int_range(test->rand, 0, 100);
+    RadioRequest* req;
+
+    data->test = test;
+    if (r < 10) {
+        req = radio_request_new2(test->group, RADIO_REQ_GET_MUTE, NULL,
+            test_stress_complete, test_stress_destroy, data);
+    } else {
+        req = radio_request_new(test->client, RADIO_REQ_GET_MUTE, NULL,
+            test_stress_complete, test_stress_destroy, data);
+    }
+    if (r == 99) {
+        radio_request_set_blocking(req, TRUE);
+    }
+    if (g_rand_int_range(test->rand, 0, 100) < 30) {
+        radio_request_set_retry(req, g_rand_int_range(test->rand, 10, 500),
+            g_rand_int_range(test->rand, 1, 4));
+    }
+    radio_request_set_timeout(req, timeout_ms ? timeout_ms :
+        (guint) g_rand_int_range(test->rand, 1000, 30000));
+    g_assert(radio_request_submit(req));
+    radio_request_unref(req);
+    test->submitted++;
+
+    /* Block the group every once in a while */
+    if (!(test->submitted % TEST_STRESS_BLOCK_EVERY) && !test->blocked) {
+        radio_request_group_block(test->group);
+        test->blocked = TRUE;
+        test->blocks++;
+        test_clock_add(test->clock, TEST_STRESS_BLOCK_MS,
+            test_stress_unblock, test, NULL);
+    }
+}
+
+/*==========================================================================*
+ * clock
+ *==========================================================================*/
+
+static
+gboolean
+test_clock_inc(
+    gpointer user_data)
+{
+    (*(int*)user_data)++;
+    return G_SOURCE_REMOVE;
+}
+
+static
+gboolean
+test_clock_repeat(
+    gpointer user_data)
+{
+    int* count = user_data;
+
+    return ++(*count) < 3;
+}
+
+static
+void
+test_clock(
+    void)
+{
+    TestClock* clock = test_clock_new();
+    const gint64 start = test_clock_now(clock);
+    int first = 0, second = 0, removed = 0, repeat = 0;
+    guint id;
+
+    g_assert(!test_clock_next(clock));
+    test_clock_add(clock, 20, test_clock_inc, &second, NULL);
+    test_clock_add(clock, 10, test_clock_inc, &first, NULL);
+    id = test_clock_add(clock, 15, test_clock_inc, &removed, NULL);
+    test_clock_add(clock, 100, test_clock_repeat, &repeat, NULL);
+    g_assert_cmpuint(test_clock_count(clock), == ,4);
+    test_clock_remove(clock, id);
+    test_clock_remove(clock, id);
+    g_assert_cmpuint(test_clock_count(clock), == ,3);
+
+    /* Timers fire in the order of expiration */
+    g_assert(test_clock_next(clock));
+    g_assert_cmpint(first, == ,1);
+    g_assert_cmpint(second, == ,0);
+    g_assert_cmpint(test_clock_now(clock) - start, == ,10000);
+
+    test_clock_advance(clock, 5000);
+    g_assert_cmpint(second, == ,0);
+    g_assert_cmpint(test_clock_now(clock) - start, == ,15000);
+
+    /* The repeating timer fires 3 times and goes away */
+    test_clock_advance(clock, 1000000);
+    g_assert_cmpint(second, == ,1);
+    g_assert_cmpint(removed, == ,0);
+    g_assert_cmpint(repeat, == ,3);
+    g_assert_cmpuint(test_clock_count(clock), == ,0);
+    g_assert_cmpint(test_clock_now(clock) - start, == ,1015000);
+    test_clock_free(clock);
+}
+
+/*==========================================================================*
+ * timeout
+ *==========================================================================*/
+
+static
+void
+test_timeout(
+    void)
+{
+    TestStress test;
+
+    test_stress_init(&test, 1);
+    test.respond = FALSE;
+    test_stress_submit(&test, 5000);
+    test_stress_drain();
+    g_assert_cmpuint(test.received, == ,1);
+
+    /* Not a microsecond earlier than expected */
+    test_clock_advance(test.clock, 4999000);
+    test_stress_drain();
+    g_assert_cmpuint(test.completed, == ,0);
+    test_clock_advance(test.clock, 1000);
+    g_assert_cmpuint(test.completed, == ,1);
+    g_assert_cmpuint(test.timeouts, == ,1);
+    g_assert_cmpuint(test.destroyed, == ,1);
+    g_assert_cmpuint(test_clock_count(test.clock), == ,0);
+    test_stress_cleanup(&test);
+}
+
+/*==========================================================================*
+ * scale
+ *==========================================================================*/
+
+static
+void
+test_scale(
+    void)
+{
+    const gint64 real_start = g_get_monotonic_time();
+    TestStress test;
+    RadioBaseStats stats;
+    gint64 virtual_start;
+    guint64 visits;
+
+    test_stress_init(&test, TEST_STRESS_COUNT);
+    virtual_start = test_clock_now(test.clock);
+    while (test.completed < test.count) {
+        while (test.submitted < test.count &&
+            test.submitted - test.completed < TEST_STRESS_WINDOW) {
+            test_stress_submit(&test, 0);
+        }
+        test_stress_drain();
+        if (test.completed < test.count) {
+            /* Something must be scheduled, otherwise we are stuck */
+            g_assert(test_clock_next(test.clock));
+            test_stress_drain();
+        }
+    }
+
+    radio_base_get_stats(RADIO_BASE(test.client), &stats);
+    visits = stats.queue_visits + stats.table_visits;
+    g_test_message("%u requests, %u transactions, %u blocks", test.count,
+        test.received, test.blocks);
+    g_test_message("%u ok, %u errors, %u timeouts, %u failed", test.ok,
+        test.errors, test.timeouts, test.failed);
+    g_test_message("%" G_GINT64_FORMAT " s virtual, %" G_GINT64_FORMAT
+        " ms real", (test_clock_now(test.clock) - virtual_start) / 1000000,
+        (g_get_monotonic_time() - real_start) / 1000);
+    g_test_message("%" G_GUINT64_FORMAT " queue visits, %" G_GUINT64_FORMAT
+        " table visits", stats.queue_visits, stats.table_visits);
+
+    /* Every request has completed once and has been freed */
+    g_assert_cmpuint(test.ok + test.errors + test.timeouts + test.failed,
+        == ,test.count);
+    g_assert_cmpuint(test.failed, == ,0);
+    g_assert_cmpuint(test.destroyed, == ,test.count);
+    g_assert(test.ok && test.errors && test.timeouts && test.blocks);
+    g_assert_cmpuint(test.received, > ,test.count); /* Retries */
+
+    /*
+     * The scheduler scans what's in flight, not everything submitted so
+     * far. The cost per request must be bounded by the window size and
+     * not grow with the total number of requests.
+     */
+    g_assert_cmpuint(visits / test.count, < ,
+        TEST_STRESS_WINDOW * TEST_STRESS_WINDOW);
+    test_stress_cleanup(&test);
+}
+
+/*==========================================================================*
+ * Common
+ *==========================================================================*/
+
+#define TEST_PREFIX "/stress/"
+#define TEST_(t) TEST_PREFIX t
+
+int main(int argc, char* argv[])
+{
+    g_test_init(&argc, &argv, NULL);
+    g_test_add_func(TEST_("clock"), test_clock);
+    g_test_add_func(TEST_("timeout"), test_timeout);
+    g_test_add_func(TEST_("scale"), test_scale);
+    test_init(&test_opt, argc, argv);
+    return g_test_run();
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * c-basic-offset: 4
+ * indent-tabs-mode: nil
+ * End:
+ */
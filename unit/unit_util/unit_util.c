@@ -36,7 +36,9 @@
 
 #include "test_common.h"
 
+#include "radio_instance.h"
 #include "radio_util.h"
+#include "radio_voice_types.h"
 
 #define UNKNOWN_VALUE (0x7fffffff)
 #define UNKNOWN_REQ ((RADIO_REQ)UNKNOWN_VALUE)
@@ -126,6 +128,67 @@ test_ind_name(
         "registrationFailed");
 }
 
+/*==========================================================================*
+ * from_name
+ *==========================================================================*/
+
+static
+void
+test_from_name(
+    void)
+{
+    static const RADIO_REQ reqs[] = {
+        RADIO_REQ_SET_RESPONSE_FUNCTIONS,
+        RADIO_REQ_GET_ICC_CARD_STATUS,
+        RADIO_REQ_START_NETWORK_SCAN_1_2,
+        RADIO_REQ_START_NETWORK_SCAN_1_5,
+        RADIO_REQ_RESPONSE_ACKNOWLEDGEMENT
+    };
+    static const RADIO_RESP resps[] = {
+        RADIO_RESP_ACKNOWLEDGE_REQUEST,
+        RADIO_RESP_GET_ICC_CARD_STATUS,
+        RADIO_RESP_GET_CELL_INFO_LIST_1_5
+    };
+    static const RADIO_IND inds[] = {
+        RADIO_IND_RIL_CONNECTED,
+        RADIO_IND_CURRENT_SIGNAL_STRENGTH_1_4,
+        RADIO_IND_DATA_CALL_LIST_CHANGED_1_5
+    };
+    RadioInstance aidl;
+    guint i;
+
+    g_assert_cmpint(radio_req_from_name(NULL, NULL), == ,RADIO_REQ_NONE);
+    g_assert_cmpint(radio_req_from_name(NULL, "foo"), == ,RADIO_REQ_NONE);
+    g_assert_cmpint(radio_resp_from_name(NULL, ""), == ,RADIO_RESP_NONE);
+    g_assert_cmpint(radio_ind_from_name(NULL, "zzz"), == ,RADIO_IND_NONE);
+    g_assert_cmpint(radio_req_from_name(NULL, "dial"), == ,RADIO_REQ_DIAL);
+
+    /* Round trips */
+    for (i = 0; i < G_N_ELEMENTS(reqs); i++) {
+        g_assert_cmpint(radio_req_from_name(NULL,
+            radio_req_name(reqs[i])), == ,reqs[i]);
+    }
+    for (i = 0; i < G_N_ELEMENTS(resps); i++) {
+        g_assert_cmpint(radio_resp_from_name(NULL,
+            radio_resp_name(resps[i])), == ,resps[i]);
+    }
+    for (i = 0; i < G_N_ELEMENTS(inds); i++) {
+        g_assert_cmpint(radio_ind_from_name(NULL,
+            radio_ind_name(inds[i])), == ,inds[i]);
+    }
+
+    /* Only the fields describing the interface matter here */
+    memset(&aidl, 0, sizeof(aidl));
+    aidl.interface_type = RADIO_INTERFACE_TYPE_AIDL;
+    aidl.interface_aidl = RADIO_VOICE_INTERFACE;
+    g_assert_cmpint(radio_req_from_name(&aidl, "hangup"), == ,
+        (RADIO_REQ)RADIO_VOICE_REQ_HANGUP);
+    g_assert_cmpint(radio_resp_from_name(&aidl, "hangupConnectionResponse"),
+        == ,(RADIO_RESP)RADIO_VOICE_RESP_HANGUP_CONNECTION_RESPONSE);
+    g_assert_cmpint(radio_req_from_name(&aidl, "getIccCardStatus"), == ,
+        RADIO_REQ_NONE);
+}
+
 /*==========================================================================*
  * req_resp
  *==========================================================================*/
@@ -355,6 +418,7 @@ int main(int argc, char* argv[])
     g_test_add_func(TEST_("req_name"), test_req_name);
     g_test_add_func(TEST_("resp_name"), test_resp_name);
     g_test_add_func(TEST_("ind_name"), test_ind_name);
+    g_test_add_func(TEST_("from_name"), test_from_name);
     g_test_add_func(TEST_("req_resp"), test_req_resp);
     g_test_add_func(TEST_("req_resp2"), test_req_resp2);
     test_init(&test_opt, argc, argv);